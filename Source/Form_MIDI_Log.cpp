@@ -1,5 +1,6 @@
 #include "Form_MIDI_Log.h"
 #include "Theme_Manager.h"
+#include "Playback_MIDI_Engine_Native.h"
 
 
 #include <vcclr.h>
@@ -21,6 +22,9 @@ namespace MIDILightDrawer
 		_Update_Timer->Interval = UPDATE_INTERVAL_MS;
 		_Update_Timer->Tick += gcnew EventHandler(this, &Form_MIDI_Log::On_Update_Timer_Tick);
 		_Update_Timer->Start();
+
+		// The playback thread copies every sent event into the journal, the timer formats them
+		Playback_MIDI_Engine_Native::Set_Journal_Enabled(true);
 	}
 
 	void Form_MIDI_Log::Add_Log_Entry(MIDI_Log_Entry^ entry)
@@ -43,9 +47,21 @@ namespace MIDILightDrawer
 
 	void Form_MIDI_Log::On_Update_Timer_Tick(Object^ sender, EventArgs^ e)
 	{
+		Drain_Sent_Journal();
 		Flush_Event_Buffer();
 	}
 
+	void Form_MIDI_Log::Drain_Sent_Journal()
+	{
+		// At most one buffer per tick keeps the UI responsive, a larger burst waits in the journal or is dropped there
+		Playback_MIDI_Engine_Native::MIDI_Event Event;
+
+		for (int i = 0; i < MAX_BUFFER_SIZE && Playback_MIDI_Engine_Native::Pop_Journal_Event(Event); i++)
+		{
+			Add_MIDI_Event(Event.Timestamp_ms, Event.Track, Event.Channel, Event.Command, Event.Data1, Event.Data2);
+		}
+	}
+
 	void Form_MIDI_Log::Flush_Event_Buffer()
 	{
 		if (!this->IsHandleCreated || this->Disposing || this->IsDisposed) {
@@ -352,6 +368,8 @@ namespace MIDILightDrawer
 				_Update_Timer->Stop();
 				_Update_Timer = nullptr;
 			}
+
+			Playback_MIDI_Engine_Native::Set_Journal_Enabled(false);
 		}
 	}
 
@@ -48,7 +48,7 @@ namespace MIDILightDrawer
 
 		static const int MAX_LOG_ENTRIES = 10000;
 		static const int UPDATE_INTERVAL_MS = 100;  // Update UI every 100ms
-		static const int MAX_BUFFER_SIZE = 1000;    // Max events to buffer before forced flush
+		static const int MAX_BUFFER_SIZE = 1000;    // Max events taken from the journal per update
 
 	public:
 		Form_MIDI_Log();
@@ -70,6 +70,7 @@ namespace MIDILightDrawer
 		void On_Update_Timer_Tick(Object^ sender, EventArgs^ e);
 
 		// Buffer management
+		void Drain_Sent_Journal();
 		void Flush_Event_Buffer();
 		void Add_Entry_To_Grid(MIDI_Log_Entry^ entry);
 
@@ -1,6 +1,7 @@
 #include "Version.h"
 #include "Form_Main.h"
 #include "Theme_Manager.h"
+#include "MIDI_Raster_Mapping_Benchmark.h"
 
 using namespace System::Windows::Forms;
 using namespace System::Drawing;
@@ -350,6 +351,10 @@ namespace MIDILightDrawer
 		Menu_File_Export_MIDI->ShortcutKeys = Keys::Control | Keys::E;
 		Menu_File_Export_MIDI->Click += gcnew System::EventHandler(this, &Form_Main::Menu_File_Export_MIDI_Click);
 
+		// File -> Save Playback Metrics
+		ToolStripMenuItem^ Menu_File_Save_Metrics = gcnew ToolStripMenuItem("Save Playback Metrics CSV...");
+		Menu_File_Save_Metrics->Click += gcnew System::EventHandler(this, &Form_Main::Menu_File_Save_Metrics_Click);
+
 		// File -> Exit
 		ToolStripMenuItem^ Menu_File_Exit = gcnew ToolStripMenuItem("Exit");
 		Menu_File_Exit->ShortcutKeys = Keys::Alt | Keys::F4;
@@ -369,6 +374,7 @@ namespace MIDILightDrawer
 		Menu_File->DropDownItems->Add(Menu_Audio_Clear_File);
 		Menu_File->DropDownItems->Add(gcnew ToolStripSeparator());
 		Menu_File->DropDownItems->Add(Menu_File_Export_MIDI);
+		Menu_File->DropDownItems->Add(Menu_File_Save_Metrics);
 		Menu_File->DropDownItems->Add(gcnew ToolStripSeparator());
 		Menu_File->DropDownItems->Add(Menu_File_Exit);
 
@@ -431,6 +437,10 @@ namespace MIDILightDrawer
 		//_Menu_Edit_Auto_Generate->Image = (cli::safe_cast<System::Drawing::Image^>(_Resources->GetObject(L"MIDI_Log")));
 		_Menu_Edit_Auto_Generate->Click += gcnew System::EventHandler(this, &Form_Main::Menu_View_Auto_Generate_Click);
 
+		// Edit -> MIDI Bandwidth Report
+		ToolStripMenuItem^ Menu_Edit_Bandwidth_Report = gcnew ToolStripMenuItem("MIDI Bandwidth Report...");
+		Menu_Edit_Bandwidth_Report->Click += gcnew System::EventHandler(this, &Form_Main::Menu_View_Bandwidth_Report_Click);
+
 		// Build Edit menu
 		Menu_Edit->DropDownItems->Add(_Menu_Edit_Undo);
 		Menu_Edit->DropDownItems->Add(_Menu_Edit_UndoSteps);
@@ -444,6 +454,7 @@ namespace MIDILightDrawer
 		Menu_Edit->DropDownItems->Add(_Menu_Edit_BatchAction);
 		Menu_Edit->DropDownItems->Add(_Menu_Edit_MIDI_Log);
 		Menu_Edit->DropDownItems->Add(_Menu_Edit_Auto_Generate);
+		Menu_Edit->DropDownItems->Add(Menu_Edit_Bandwidth_Report);
 
 		_Menu_Edit_UndoSteps_Items = gcnew List<ToolStripMenuItem^>();
 
@@ -484,11 +495,18 @@ namespace MIDILightDrawer
 		Menu_Settings_Device->Image = (cli::safe_cast<System::Drawing::Image^>(_Resources->GetObject(L"Device")));
 		Menu_Settings_Device->Click += gcnew System::EventHandler(this, &Form_Main::Menu_Settings_Device_Click);
 
+		// Settings -> SysEx Light Frames
+		ToolStripMenuItem^ Menu_Settings_SysEx_Frames = gcnew ToolStripMenuItem("Send Lights as SysEx Frames");
+		Menu_Settings_SysEx_Frames->CheckOnClick = true;
+		Menu_Settings_SysEx_Frames->Checked = Settings::Get_Instance()->Playback_SysEx_Frames;
+		Menu_Settings_SysEx_Frames->Click += gcnew System::EventHandler(this, &Form_Main::Menu_Settings_SysEx_Frames_Click);
+
 		// Build Settings menu
 		Menu_Settings->DropDownItems->Add(Menu_Settings_Hotkeys);
 		Menu_Settings->DropDownItems->Add(gcnew ToolStripSeparator());
 		Menu_Settings->DropDownItems->Add(Menu_Settings_Midi);
 		Menu_Settings->DropDownItems->Add(Menu_Settings_Device);
+		Menu_Settings->DropDownItems->Add(Menu_Settings_SysEx_Frames);
 
 		ToolStripLabel^ Label_Version = gcnew ToolStripLabel();
 		Label_Version->Text = "v" + VERSION_BUILD_STRING;
@@ -530,10 +548,15 @@ namespace MIDILightDrawer
 			ToolStripMenuItem^ Menu_Debug_Test3 = gcnew ToolStripMenuItem("Test 3");
 			Menu_Debug_Test3->Click += gcnew System::EventHandler(this, &Form_Main::Button_3_Click);
 
+			// Raster benchmark button
+			ToolStripMenuItem^ Menu_Debug_Raster_Benchmark = gcnew ToolStripMenuItem("Raster Benchmark");
+			Menu_Debug_Raster_Benchmark->Click += gcnew System::EventHandler(this, &Form_Main::Button_Raster_Benchmark_Click);
+
 			// Add test buttons directly to menu strip
 			this->_Menu_Strip->Items->Add(Menu_Debug_Test1);
 			this->_Menu_Strip->Items->Add(Menu_Debug_Test2);
 			this->_Menu_Strip->Items->Add(Menu_Debug_Test3);
+			this->_Menu_Strip->Items->Add(Menu_Debug_Raster_Benchmark);
 	#endif
 	}
 
@@ -550,7 +573,7 @@ namespace MIDILightDrawer
 			}
 			
 			// Create Playback_Manager
-			this->_Playback_Manager = gcnew Playback_Manager(this->_Timeline, this->_MIDI_Event_Raster, this->_Audio_Container, this->_Form_MIDI_Log);
+			this->_Playback_Manager = gcnew Playback_Manager(this->_Timeline, this->_MIDI_Event_Raster, this->_Audio_Container);
 			this->_Timeline->Set_Playback_Manager(this->_Playback_Manager);
 			this->_Audio_Container->Set_Playback_Manager(this->_Playback_Manager);
 
@@ -577,6 +600,8 @@ namespace MIDILightDrawer
 				}
 			}
 
+			_Playback_Manager->MIDI_Engine->SysEx_Frame_Mode = Config->Playback_SysEx_Frames;
+
 			// Initialize Audio engine if device is configured
 			if (!String::IsNullOrEmpty(Audio_Device_Name))
 			{
@@ -827,6 +852,16 @@ namespace MIDILightDrawer
 
 			if(ErrorMessage == String::Empty) {
 				//MessageBox::Show(this, "MIDI file has been successfully exported.", "Export Successful", MessageBoxButtons::OK, MessageBoxIcon::Information);
+
+				// With merging on, the result is reported also when nothing could be merged
+				if (Settings::Get_Instance()->MIDI_Export_Merge_Identical_Notes)
+				{
+					int Written_Events	= _MIDI_Exporter->Last_Export_Note_Count * 2;
+					int Merged_Events	= _MIDI_Exporter->Last_Export_Merged_Note_Count * 2;
+					double Reduction	= (Written_Events + Merged_Events > 0) ? 100.0 * Merged_Events / (Written_Events + Merged_Events) : 0.0;
+
+					MessageBox::Show(this, String::Format("MIDI file has been exported with {0} note events, {1} merged.\n{2:F1}% of the events were saved by merging identical consecutive notes.", Written_Events, Merged_Events, Reduction), "Export Successful", MessageBoxButtons::OK, MessageBoxIcon::Information);
+				}
 			}
 			else {
 				MessageBox::Show(this, "Error:\n" + ErrorMessage, "Failed to export MIDI file", MessageBoxButtons::OK, MessageBoxIcon::Error);
@@ -834,6 +869,27 @@ namespace MIDILightDrawer
 		}
 	}
 
+	void Form_Main::Menu_File_Save_Metrics_Click(System::Object^ sender, System::EventArgs^ e)
+	{
+		if (_Playback_Manager == nullptr || _Playback_Manager->MIDI_Engine->Metrics_Sample_Count == 0) {
+			MessageBox::Show(this, "There are no playback metrics yet. They are recorded while the timeline plays.", "Save Playback Metrics", MessageBoxButtons::OK, MessageBoxIcon::Information);
+			return;
+		}
+
+		SaveFileDialog^ Save_Dialog_File = gcnew SaveFileDialog();
+		Save_Dialog_File->InitialDirectory = ".";
+		Save_Dialog_File->Filter = "CSV Files (*.csv)|*.csv|All Files (*.*)|*.*";
+		Save_Dialog_File->RestoreDirectory = true;
+		Save_Dialog_File->FileName = "Playback_Metrics.csv";
+
+		if (Save_Dialog_File->ShowDialog() == System::Windows::Forms::DialogResult::OK)
+		{
+			if (!_Playback_Manager->MIDI_Engine->Save_Metrics_CSV(Save_Dialog_File->FileName)) {
+				MessageBox::Show(this, "The file could not be written:\n" + Save_Dialog_File->FileName, "Failed to save playback metrics", MessageBoxButtons::OK, MessageBoxIcon::Error);
+			}
+		}
+	}
+
 	void Form_Main::Menu_File_Exit_Click(System::Object^ sender, System::EventArgs^ e)
 	{
 		this->Close();
@@ -1100,6 +1156,18 @@ namespace MIDILightDrawer
 		_Form_MIDI_Log->BringToFront();
 	}
 
+	void Form_Main::Menu_View_Bandwidth_Report_Click(System::Object^ sender, System::EventArgs^ e)
+	{
+		String^ Report = (_Playback_Manager != nullptr) ? _Playback_Manager->Create_Bandwidth_Report() : nullptr;
+
+		if (String::IsNullOrEmpty(Report)) {
+			MessageBox::Show(this, "There are no light events on the timeline to analyze.", "MIDI Bandwidth Report", MessageBoxButtons::OK, MessageBoxIcon::Information);
+			return;
+		}
+
+		MessageBox::Show(this, Report, "MIDI Bandwidth Report", MessageBoxButtons::OK, MessageBoxIcon::Information);
+	}
+
 	void Form_Main::Menu_View_Auto_Generate_Click(System::Object^ sender, System::EventArgs^ e)
 	{
 		// Check if we have tablature loaded
@@ -1164,6 +1232,18 @@ namespace MIDILightDrawer
 		Device_Form->ShowDialog();
 	}
 
+	void Form_Main::Menu_Settings_SysEx_Frames_Click(System::Object^ sender, System::EventArgs^ e)
+	{
+		bool Enabled = safe_cast<ToolStripMenuItem^>(sender)->Checked;
+
+		Settings::Get_Instance()->Playback_SysEx_Frames = Enabled;
+
+		// The scheduler picks the mode up with its next batch, also during playback
+		if (_Playback_Manager != nullptr) {
+			_Playback_Manager->MIDI_Engine->SysEx_Frame_Mode = Enabled;
+		}
+	}
+
 	void Form_Main::Form_Main_FormClosing(System::Object^ sender, System::Windows::Forms::FormClosingEventArgs^ e)
 	{
 		bool Events_Preset = false;
@@ -1860,4 +1940,23 @@ namespace MIDILightDrawer
 
 	#endif
 	}
+
+	void Form_Main::Button_Raster_Benchmark_Click(System::Object^ sender, System::EventArgs^ e)
+	{
+#ifdef _DEBUG
+		if (this->_Timeline->Tracks->Count == 0) {
+			MessageBox::Show("Load a file with tracks to run the raster benchmark.", "Raster Benchmark", MessageBoxButtons::OK, MessageBoxIcon::Information);
+			return;
+		}
+
+		this->Cursor = System::Windows::Forms::Cursors::WaitCursor;
+		Raster_Mapping_Benchmark_Report Report = MIDI_Raster_Mapping_Benchmark::Run(this->_MIDI_Event_Raster, this->_Timeline->Tracks);
+		this->Cursor = System::Windows::Forms::Cursors::Default;
+
+		String^ Text = MIDI_Raster_Mapping_Benchmark::Format_Report(Report);
+
+		Console::Write(Text);
+		MessageBox::Show(Text, "Raster Benchmark", MessageBoxButtons::OK, MessageBoxIcon::Information);
+#endif
+	}
 }
\ No newline at end of file
@@ -113,6 +113,7 @@ namespace MIDILightDrawer
 			void Menu_File_Audio_Open_Click(System::Object^ sender, System::EventArgs^ e);
 			void Menu_File_Audio_Clear_Click(System::Object^ sender, System::EventArgs^ e);
 			void Menu_File_Export_MIDI_Click(System::Object^ sender, System::EventArgs^ e);
+			void Menu_File_Save_Metrics_Click(System::Object^ sender, System::EventArgs^ e);
 			void Menu_File_Exit_Click(System::Object^ sender, System::EventArgs^ e);
 
 			// Opne (Recent) Files Handlers
@@ -133,10 +134,12 @@ namespace MIDILightDrawer
 			void Menu_Edit_BatchAction_Click(System::Object^ sender, System::EventArgs^ e);
 			void Menu_View_MIDI_Log_Click(System::Object^ sender, System::EventArgs^ e);
 			void Menu_View_Auto_Generate_Click(System::Object^ sender, System::EventArgs^ e);
+			void Menu_View_Bandwidth_Report_Click(System::Object^ sender, System::EventArgs^ e);
 
 			void Menu_Settings_Hotkeys_Click(System::Object^ sender, System::EventArgs^ e);
 			void Menu_Settings_Midi_Click(System::Object^ sender, System::EventArgs^ e);
 			void Menu_Settings_Device_Click(System::Object^ sender, System::EventArgs^ e);
+			void Menu_Settings_SysEx_Frames_Click(System::Object^ sender, System::EventArgs^ e);
 
 			// Form Callbacks
 			void Form_Main_FormClosing(System::Object^ sender, System::Windows::Forms::FormClosingEventArgs^ e);
@@ -189,5 +192,6 @@ namespace MIDILightDrawer
 			void Button_1_Click(System::Object^ sender, System::EventArgs^ e);
 			void Button_2_Click(System::Object^ sender, System::EventArgs^ e);
 			void Button_3_Click(System::Object^ sender, System::EventArgs^ e);
+			void Button_Raster_Benchmark_Click(System::Object^ sender, System::EventArgs^ e);
 	};
 }
@@ -40,7 +40,7 @@ namespace MIDILightDrawer
 		this->MinimizeBox = false;
 		this->ShowInTaskbar = false;
 		this->StartPosition = System::Windows::Forms::FormStartPosition::CenterParent;
-		this->Size = System::Drawing::Size(400, 630);
+		this->Size = System::Drawing::Size(400, 735);
 
 		_Resources = gcnew System::Resources::ResourceManager("MIDILightDrawer.Icons", System::Reflection::Assembly::GetExecutingAssembly());
 
@@ -50,7 +50,7 @@ namespace MIDILightDrawer
 		_Main_Layout->RowCount = 3;
 		_Main_Layout->Padding = System::Windows::Forms::Padding(10);
 
-		_Main_Layout->RowStyles->Add(gcnew System::Windows::Forms::RowStyle(System::Windows::Forms::SizeType::Absolute, 180));
+		_Main_Layout->RowStyles->Add(gcnew System::Windows::Forms::RowStyle(System::Windows::Forms::SizeType::Absolute, 285));
 		_Main_Layout->RowStyles->Add(gcnew System::Windows::Forms::RowStyle(System::Windows::Forms::SizeType::Absolute, 350));
 		_Main_Layout->RowStyles->Add(gcnew System::Windows::Forms::RowStyle(System::Windows::Forms::SizeType::Absolute, 50));
 
@@ -65,7 +65,7 @@ namespace MIDILightDrawer
 		_Notes_Layout->Dock = System::Windows::Forms::DockStyle::Fill;
 		_Notes_Layout->BackColor = Color::Transparent;
 		_Notes_Layout->ColumnCount = 3;
-		_Notes_Layout->RowCount = 4;
+		_Notes_Layout->RowCount = 7;
 		_Notes_Layout->RowStyles->Add(gcnew System::Windows::Forms::RowStyle(System::Windows::Forms::SizeType::Absolute, 35));
 		_Notes_Layout->RowStyles->Add(gcnew System::Windows::Forms::RowStyle(System::Windows::Forms::SizeType::Absolute, 35));
 		_Notes_Layout->RowStyles->Add(gcnew System::Windows::Forms::RowStyle(System::Windows::Forms::SizeType::Absolute, 35));
@@ -74,6 +74,7 @@ namespace MIDILightDrawer
 		_Notes_Layout->RowStyles->Add(gcnew System::Windows::Forms::RowStyle(System::Windows::Forms::SizeType::Absolute, 35));
 		_Notes_Layout->RowStyles->Add(gcnew System::Windows::Forms::RowStyle(System::Windows::Forms::SizeType::Absolute, 35));
 		_Notes_Layout->RowStyles->Add(gcnew System::Windows::Forms::RowStyle(System::Windows::Forms::SizeType::Absolute, 35));
+		_Notes_Layout->RowStyles->Add(gcnew System::Windows::Forms::RowStyle(System::Windows::Forms::SizeType::Absolute, 35));
 
 		System::Windows::Forms::Label^ Label_Red = gcnew System::Windows::Forms::Label();
 		Label_Red->Text = "Red Note:";
@@ -139,6 +140,39 @@ namespace MIDILightDrawer
 		_Notes_Layout->Controls->Add(_Checkbox_Anti_Flicker, 0, 3);
 		_Notes_Layout->SetColumnSpan(_Checkbox_Anti_Flicker, 3);
 
+		_Checkbox_Merge_Identical = gcnew CheckBox();
+		_Checkbox_Merge_Identical->Text = "Merge consecutive notes with identical color";
+		_Checkbox_Merge_Identical->AutoSize = true;
+		_Checkbox_Merge_Identical->Padding = System::Windows::Forms::Padding(0, 0, 20, 5);
+		_Checkbox_Merge_Identical->Anchor = System::Windows::Forms::AnchorStyles::Bottom;
+		_Notes_Layout->Controls->Add(_Checkbox_Merge_Identical, 0, 4);
+		_Notes_Layout->SetColumnSpan(_Checkbox_Merge_Identical, 3);
+
+		// Add Adaptive Fade options
+		_Checkbox_Adaptive_Fade = gcnew CheckBox();
+		_Checkbox_Adaptive_Fade->Text = "Adaptive fade steps (one step per velocity change)";
+		_Checkbox_Adaptive_Fade->AutoSize = true;
+		_Checkbox_Adaptive_Fade->Padding = System::Windows::Forms::Padding(0, 0, 20, 5);
+		_Checkbox_Adaptive_Fade->Anchor = System::Windows::Forms::AnchorStyles::Bottom;
+		_Checkbox_Adaptive_Fade->CheckStateChanged += gcnew System::EventHandler(this, &Form_Settings_MIDI::Checkbox_Adaptive_Fade_CheckStateChanged);
+		_Notes_Layout->Controls->Add(_Checkbox_Adaptive_Fade, 0, 5);
+		_Notes_Layout->SetColumnSpan(_Checkbox_Adaptive_Fade, 3);
+
+		System::Windows::Forms::Label^ Label_Fade_Step_Rate = gcnew System::Windows::Forms::Label();
+		Label_Fade_Step_Rate->Text = "Max. Steps/s:";
+		Label_Fade_Step_Rate->AutoSize = true;
+		Label_Fade_Step_Rate->Anchor = System::Windows::Forms::AnchorStyles::Right;
+		_Notes_Layout->Controls->Add(Label_Fade_Step_Rate, 0, 6);
+
+		_Combo_Box_Fade_Step_Rate = gcnew System::Windows::Forms::ComboBox();
+		_Combo_Box_Fade_Step_Rate->Anchor = System::Windows::Forms::AnchorStyles::Left | System::Windows::Forms::AnchorStyles::Right;
+		_Combo_Box_Fade_Step_Rate->DropDownStyle = System::Windows::Forms::ComboBoxStyle::DropDownList;
+		_Notes_Layout->Controls->Add(_Combo_Box_Fade_Step_Rate, 1, 6);
+
+		for each (int Rate in FADE_STEP_RATES) {
+			_Combo_Box_Fade_Step_Rate->Items->Add(Rate.ToString());
+		}
+
 		_Group_Box_Notes->Controls->Add(_Notes_Layout);
 		_Main_Layout->Controls->Add(_Group_Box_Notes, 0, 0);
 
@@ -193,7 +227,7 @@ namespace MIDILightDrawer
 		this->_Tool_Tip->InitialDelay = 200;
 		this->_Tool_Tip->ReshowDelay = 100;
 
-		this->Size = System::Drawing::Size(400, 630);
+		this->Size = System::Drawing::Size(400, 735);
 	}
 
 	void Form_Settings_MIDI::Load_Current_Settings()
@@ -216,6 +250,13 @@ namespace MIDILightDrawer
 			}
 		}
 
+		// Load the merge and fade options first, changing the Anti-Flicker checkbox already saves all settings
+		_Checkbox_Merge_Identical->Checked = Current_Settings->MIDI_Export_Merge_Identical_Notes;
+
+		_Checkbox_Adaptive_Fade->Checked = Current_Settings->MIDI_Fade_Adaptive_Steps;
+		_Combo_Box_Fade_Step_Rate->SelectedIndex = Math::Max(Array::IndexOf(FADE_STEP_RATES, Current_Settings->MIDI_Fade_Max_Step_Rate), 0);
+		_Combo_Box_Fade_Step_Rate->Enabled = _Checkbox_Adaptive_Fade->Checked;
+
 		_Checkbox_Anti_Flicker->Checked = Current_Settings->MIDI_Export_Anti_Flicker;
 
 		Update_Status_Icons();
@@ -230,6 +271,13 @@ namespace MIDILightDrawer
 		Current_Settings->MIDI_Note_Blue = Find_Note_Index_By_Name((String^)_Combo_Box_Blue->SelectedItem);
 
 		Current_Settings->MIDI_Export_Anti_Flicker = _Checkbox_Anti_Flicker->Checked;
+		Current_Settings->MIDI_Export_Merge_Identical_Notes = _Checkbox_Merge_Identical->Checked;
+
+		Current_Settings->MIDI_Fade_Adaptive_Steps = _Checkbox_Adaptive_Fade->Checked;
+
+		if (_Combo_Box_Fade_Step_Rate->SelectedIndex >= 0) {
+			Current_Settings->MIDI_Fade_Max_Step_Rate = FADE_STEP_RATES[_Combo_Box_Fade_Step_Rate->SelectedIndex];
+		}
 	}
 
 	void Form_Settings_MIDI::Update_Status_Icons()
@@ -362,6 +410,11 @@ namespace MIDILightDrawer
 		Save_Settings();
 	}
 
+	void Form_Settings_MIDI::Checkbox_Adaptive_Fade_CheckStateChanged(System::Object^ sender, System::EventArgs^ e)
+	{
+		_Combo_Box_Fade_Step_Rate->Enabled = _Checkbox_Adaptive_Fade->Checked;
+	}
+
 	void Form_Settings_MIDI::Button_OK_Click(System::Object^ sender, System::EventArgs^ e)
 	{
 		if (_Combo_Box_Red->SelectedIndex == -1 ||
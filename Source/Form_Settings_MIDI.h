@@ -46,6 +46,11 @@ namespace MIDILightDrawer {
 
 		// Additional Check for Anti-Flicker Option
 		CheckBox^ _Checkbox_Anti_Flicker;
+		CheckBox^ _Checkbox_Merge_Identical;
+
+		// Adaptive fade step options
+		CheckBox^ _Checkbox_Adaptive_Fade;
+		ComboBox^ _Combo_Box_Fade_Step_Rate;
 
 		// Status icons
 		PictureBox^ _Icon_Red;
@@ -68,6 +73,7 @@ namespace MIDILightDrawer {
 
 		array<Note_Entry>^ _Note_Names;
 		static array<int>^ VALID_OCTAVES = { -2, -1, 0, 1, 2, 3, 4, 5, 6, 7, 8 };
+		static array<int>^ FADE_STEP_RATES = { 25, 50, 100, 200, 400 };
 
 		void Initialize_Note_Names();
 		void Initialize_Component();
@@ -80,6 +86,7 @@ namespace MIDILightDrawer {
 
 		void ComboBox_Selected_Index_Changed(System::Object^ sender, System::EventArgs^ e);
 		void Checkbox_Anti_Flicker_CheckStateChanged(System::Object^ sender, System::EventArgs^ e);
+		void Checkbox_Adaptive_Fade_CheckStateChanged(System::Object^ sender, System::EventArgs^ e);
 		void Button_OK_Click(System::Object^ sender, System::EventArgs^ e);
 		
 		void Initialize_Octaves_Section();
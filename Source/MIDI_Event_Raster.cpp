@@ -8,10 +8,7 @@ namespace MIDILightDrawer
 	MIDI_Event_Raster::MIDI_Event_Raster(Widget_Timeline^ timeline)
 	{
 		this->_Timeline = timeline;
-		this->_Additional_Offset = 0;
-		this->_Last_End_Tick = -1;
-		this->_Next_Start_Tick = -1;
-		this->_Last_Color = Color();
+		this->_Parallel_Rasterization = true;
 	}
 
 	uint64_t MIDI_Event_Raster::Convert_Microseconds_To_Samples(uint64_t microseconds, uint32_t sample_rate)
@@ -38,9 +35,9 @@ namespace MIDILightDrawer
 		return RasteredEvents;
 	}
 
-	Export_MIDI_Track^ MIDI_Event_Raster::Raster_Track_For_Export(Track^ track)
+	Export_MIDI_Track^ MIDI_Event_Raster::Raster_Track_For_Export(Track^ track, Color_MIDI_Mapping mapping)
 	{
-		Export_MIDI_Track^ Export_Track = gcnew Export_MIDI_Track(track);
+		Export_MIDI_Track^ Export_Track = gcnew Export_MIDI_Track(track, mapping);
 		
 		for (int i = 0; i < track->Events->Count; i++)
 		{
@@ -54,40 +51,16 @@ namespace MIDILightDrawer
 				uint8_t Value_Green = (E.Color.G >> 1);
 				uint8_t Value_Blue	= (E.Color.B >> 1);
 
-				if (Value_Red > 0)
-				{
-					Export_MIDI_Color_Note^ Note_Event = gcnew Export_MIDI_Color_Note(E.TickStart, E.TickLength, Value_Red, Settings::Get_Instance()->MIDI_Note_Red);
-
-					if (Settings::Get_Instance()->MIDI_Export_Anti_Flicker && (Export_Track->Notes_Red->Count > 0) && (Export_Track->Notes_Red[Export_Track->Notes_Red->Count - 1]->Tick_End == Note_Event->Tick_Start)) {
-						Note_Event->Has_Offset = !Export_Track->Notes_Red[Export_Track->Notes_Red->Count - 1]->Has_Offset;
-						Note_Event->Is_Direct_Follower = true;
-					}
-
-					Export_Track->Notes_Red->Add(Note_Event);
+				if (Value_Red > 0) {
+					Export_Track->Merged_Note_Count += (int)Add_Color_Note(Export_Track->Notes_Red, E, Value_Red, mapping.Note_Red, mapping.Anti_Flicker, mapping.Merge_Identical);
 				}
 
-				if (Value_Green > 0)
-				{
-					Export_MIDI_Color_Note^ Note_Event = gcnew Export_MIDI_Color_Note(E.TickStart, E.TickLength, Value_Green, Settings::Get_Instance()->MIDI_Note_Green);
-
-					if (Settings::Get_Instance()->MIDI_Export_Anti_Flicker && (Export_Track->Notes_Green->Count > 0) && (Export_Track->Notes_Green[Export_Track->Notes_Green->Count - 1]->Tick_End == Note_Event->Tick_Start)) {
-						Note_Event->Has_Offset = !Export_Track->Notes_Green[Export_Track->Notes_Green->Count - 1]->Has_Offset;
-						Note_Event->Is_Direct_Follower = true;
-					}
-
-					Export_Track->Notes_Green->Add(Note_Event);
+				if (Value_Green > 0) {
+					Export_Track->Merged_Note_Count += (int)Add_Color_Note(Export_Track->Notes_Green, E, Value_Green, mapping.Note_Green, mapping.Anti_Flicker, mapping.Merge_Identical);
 				}
 
-				if (Value_Blue > 0)
-				{
-					Export_MIDI_Color_Note^ Note_Event = gcnew Export_MIDI_Color_Note(E.TickStart, E.TickLength, Value_Blue, Settings::Get_Instance()->MIDI_Note_Blue);
-
-					if (Settings::Get_Instance()->MIDI_Export_Anti_Flicker && (Export_Track->Notes_Blue->Count > 0) && (Export_Track->Notes_Blue[Export_Track->Notes_Blue->Count - 1]->Tick_End == Note_Event->Tick_Start)) {
-						Note_Event->Has_Offset = !Export_Track->Notes_Blue[Export_Track->Notes_Blue->Count - 1]->Has_Offset;
-						Note_Event->Is_Direct_Follower = true;
-					}
-
-					Export_Track->Notes_Blue->Add(Note_Event);
+				if (Value_Blue > 0) {
+					Export_Track->Merged_Note_Count += (int)Add_Color_Note(Export_Track->Notes_Blue, E, Value_Blue, mapping.Note_Blue, mapping.Anti_Flicker, mapping.Merge_Identical);
 				}
 			}
 
@@ -97,21 +70,53 @@ namespace MIDILightDrawer
 		return Export_Track;
 	}
 
-	List<Export_MIDI_Track^>^ MIDI_Event_Raster::Raster_Timeline_For_Export()
+	bool MIDI_Event_Raster::Add_Color_Note(List<Export_MIDI_Color_Note^>^ notes, Raw_Rasterized_Event% raw_event, Byte color_value, int base_note_in_octave, bool anti_flicker, bool merge_identical)
 	{
-		List<Export_MIDI_Track^>^ Timeline_Export_Events = gcnew List<Export_MIDI_Track^>;
-		
-		for each(Track ^ T in this->_Timeline->Tracks)
+		Export_MIDI_Color_Note^ Previous_Note = (notes->Count > 0) ? notes[notes->Count - 1] : nullptr;
+		bool Follows_Directly = (Previous_Note != nullptr) && (Previous_Note->Tick_End == raw_event.TickStart);
+
+		// Same value right after the previous note: extend that note instead of re-triggering it.
+		// The extended note keeps its anti-flicker offset, so the next direct follower still toggles against it
+		if (merge_identical && Follows_Directly && Previous_Note->Color_Value == color_value)
 		{
-			Timeline_Export_Events->Add(this->Raster_Track_For_Export(T));
+			Previous_Note->Tick_Length += raw_event.TickLength;
+			Previous_Note->Tick_End = Previous_Note->Tick_Start + Previous_Note->Tick_Length;
+
+			return true;
+		}
+
+		Export_MIDI_Color_Note^ Note_Event = gcnew Export_MIDI_Color_Note(raw_event.TickStart, raw_event.TickLength, color_value, base_note_in_octave);
+
+		if (anti_flicker && Follows_Directly) {
+			Note_Event->Has_Offset = !Previous_Note->Has_Offset;
+			Note_Event->Is_Direct_Follower = true;
 		}
 
-		return Timeline_Export_Events;
+		notes->Add(Note_Event);
+
+		return false;
+	}
+
+	List<Export_MIDI_Track^>^ MIDI_Event_Raster::Raster_Timeline_For_Export()
+	{
+		int Track_Count = _Timeline->Tracks->Count;
+
+		Track_Raster_Job^ Job = gcnew Track_Raster_Job();
+		Job->Raster = this;
+		Job->Tracks = _Timeline->Tracks;
+		Job->Mapping = Capture_Color_MIDI_Mapping();
+		Job->Export_Results = gcnew array<Export_MIDI_Track^>(Track_Count);
+
+		Run_Track_Jobs(Job, Track_Count, true);
+
+		// Results are stored per track slot, so the track order is kept regardless of which thread finished first
+		return gcnew List<Export_MIDI_Track^>(Job->Export_Results);
 	}
 	
-	List<Playback_MIDI_Event^>^ MIDI_Event_Raster::Raster_Bar_For_Playback(BarEvent^ bar, int track_index, uint8_t midi_channel, int octave_note_offset, bool use_anti_flicker)
+	List<Playback_MIDI_Event^>^ MIDI_Event_Raster::Raster_Bar_For_Playback(BarEvent^ bar, Color_MIDI_Mapping mapping)
 	{
 		List<Playback_MIDI_Event^>^ PlaybackEvents = gcnew List<Playback_MIDI_Event^>();
+		Raster_Anti_Flicker_State Anti_Flicker_State = Raster_Anti_Flicker_State::Create();
 
 		// First raster to export format
 		List<Raw_Rasterized_Event>^ ExportEvents = Raster_Bar_For_Export(bar);
@@ -119,7 +124,7 @@ namespace MIDILightDrawer
 		// Then convert to playback format
 		for each (Raw_Rasterized_Event ExportEvent in ExportEvents)
 		{
-			Color_To_MIDI_Events(PlaybackEvents, ExportEvent.Color, ExportEvent.TickStart, ExportEvent.TickLength, track_index, midi_channel, octave_note_offset);
+			Color_To_MIDI_Events(PlaybackEvents, ExportEvent.Color, ExportEvent.TickStart, ExportEvent.TickLength, mapping, Anti_Flicker_State);
 		}
 
 		return PlaybackEvents;
@@ -127,42 +132,27 @@ namespace MIDILightDrawer
 	
 	List<Playback_MIDI_Event^>^ MIDI_Event_Raster::Raster_Timeline_For_Playback()
 	{
-		List<int>^ Muted_Tracks = _Timeline->TrackNumbersMuted;
-		List<int>^ Soloed_Tracks = _Timeline->TrackNumbersSoloed;
-		uint8_t Global_MIDI_Channel = Settings::Get_Instance()->Global_MIDI_Output_Channel;
-		
-		List<Playback_MIDI_Event^>^ AllEvents = gcnew List<Playback_MIDI_Event^>();
-
-		for (int i = 0; i < _Timeline->Tracks->Count; i++)
-		{
-			// Check if track should play based on mute/solo
-			if (!Should_Track_Play(i, Muted_Tracks, Soloed_Tracks)) {
-				continue;
-			}
+		int Track_Count = _Timeline->Tracks->Count;
 
-			Export_MIDI_Track^ Export_Track = Raster_Track_For_Export(_Timeline->Tracks[i]);
-			List<Playback_MIDI_Event^>^ Track_Playback_Events = Export_Track_To_Playback_Events(Export_Track);
-			
-			AllEvents->AddRange(Track_Playback_Events);
-		}
+		Track_Raster_Job^ Job = gcnew Track_Raster_Job();
+		Job->Raster = this;
+		Job->Tracks = _Timeline->Tracks;
+		Job->Mapping = Capture_Playback_Color_MIDI_Mapping();
+		Job->Playback_Results = gcnew array<List<Playback_MIDI_Event^>^>(Track_Count);
 
-		// Sort by timestamp for sequential playback
-		AllEvents->Sort(gcnew Comparison<Playback_MIDI_Event^>(&MIDI_Event_Raster::Compare_Events_By_Timestamp));
+		// Every track is rastered, mute and solo switch tracks on and off in the playback engine
+		Run_Track_Jobs(Job, Track_Count, false);
 
-		return AllEvents;
+		// Every track is already sorted by timestamp, a k-way merge produces the sequential playback order
+		return Merge_Sorted_Track_Events(Job->Playback_Results);
 	}
 
-	List<Playback_MIDI_Event^>^ MIDI_Event_Raster::Get_Timeline_PreRastered_Playback_Events(List<Track^>^ tracks, List<int>^ muted_tracks, List<int>^ soloed_tracks)
+	List<Playback_MIDI_Event^>^ MIDI_Event_Raster::Get_Timeline_PreRastered_Playback_Events(List<Track^>^ tracks)
 	{
 		List<Playback_MIDI_Event^>^ AllEvents = gcnew List<Playback_MIDI_Event^>();
 
 		for (int i = 0; i < tracks->Count; i++)
 		{
-			// Check if track should play based on mute/solo
-			if (!Should_Track_Play(i, muted_tracks, soloed_tracks)) {
-				continue;
-			}
-
 			List<Playback_MIDI_Event^>^ TrackEvents = gcnew List<Playback_MIDI_Event^>();
 
 			for each(BarEvent ^ E in tracks[i]->Events) {
@@ -192,6 +182,11 @@ namespace MIDILightDrawer
 
 	void MIDI_Event_Raster::RasterBarFade(List<Raw_Rasterized_Event>^ rastered_events, BarEvent^ bar)
 	{
+		if (Settings::Get_Instance()->MIDI_Fade_Adaptive_Steps) {
+			RasterBarFadeAdaptive(rastered_events, bar);
+			return;
+		}
+
 		int Tick_Start = bar->StartTick;
 		int Tick_Length = bar->Duration;
 
@@ -204,15 +199,7 @@ namespace MIDILightDrawer
 			return;
 		}
 
-		Color ColorCenter;
-		if (bar->FadeInfo->Type == FadeType::Two_Colors) {
-			ColorCenter = Color::FromArgb(Math::Abs(bar->FadeInfo->ColorEnd.R - bar->FadeInfo->ColorStart.R) / 2,
-				Math::Abs(bar->FadeInfo->ColorEnd.G - bar->FadeInfo->ColorStart.G) / 2,
-				Math::Abs(bar->FadeInfo->ColorEnd.B - bar->FadeInfo->ColorStart.B) / 2);
-		}
-		else {
-			ColorCenter = bar->FadeInfo->ColorCenter;
-		}
+		Color ColorCenter = Get_Fade_Center_Color(bar->FadeInfo);
 
 		for (int i = 0; i < NumBars; i++)
 		{
@@ -222,44 +209,61 @@ namespace MIDILightDrawer
 				Ratio = 0;
 			}
 
-			Color BarColor;
-			bool IsFirstHalf = Ratio <= 0.5f;
+			Color BarColor = Evaluate_Fade_Color(bar->FadeInfo, ColorCenter, Ratio);
 
-			Easing CurrentEasing = IsFirstHalf ? bar->FadeInfo->EaseIn : bar->FadeInfo->EaseOut;
+			int BarTickStart = Tick_Start + (i * bar->FadeInfo->QuantizationTicks);
+			int BarTickDuration = bar->FadeInfo->QuantizationTicks;
 
-			if (IsFirstHalf)
-			{
-				// First half: interpolate between start and center colors
-				float AdjustedRatio = Ratio * 2.0f;
+			Add_Raw_Event(rastered_events, BarTickStart, BarTickDuration, BarColor);
+		}
+	}
 
-				int R = (int)Easings::ApplyEasing(AdjustedRatio, bar->FadeInfo->ColorStart.R, ColorCenter.R, CurrentEasing);
-				int G = (int)Easings::ApplyEasing(AdjustedRatio, bar->FadeInfo->ColorStart.G, ColorCenter.G, CurrentEasing);
-				int B = (int)Easings::ApplyEasing(AdjustedRatio, bar->FadeInfo->ColorStart.B, ColorCenter.B, CurrentEasing);
+	void MIDI_Event_Raster::RasterBarFadeAdaptive(List<Raw_Rasterized_Event>^ rastered_events, BarEvent^ bar)
+	{
+		int Tick_Start = bar->StartTick;
+		int Tick_Length = bar->Duration;
 
-				BarColor = Color::FromArgb(255, R, G, B);
-			}
-			else
-			{
-				// Second half: interpolate between center and end colors
-				float AdjustedRatio = (Ratio - 0.5f) * 2.0f;
+		if (Tick_Length <= 0) {
+			return;
+		}
 
-				int R = (int)Easings::ApplyEasing(AdjustedRatio, ColorCenter.R, bar->FadeInfo->ColorEnd.R, CurrentEasing);
-				int G = (int)Easings::ApplyEasing(AdjustedRatio, ColorCenter.G, bar->FadeInfo->ColorEnd.G, CurrentEasing);
-				int B = (int)Easings::ApplyEasing(AdjustedRatio, ColorCenter.B, bar->FadeInfo->ColorEnd.B, CurrentEasing);
+		Color ColorCenter = Get_Fade_Center_Color(bar->FadeInfo);
 
-				BarColor = Color::FromArgb(255, R, G, B);
-			}
+		// Smallest distance between two steps, derived from the maximum step rate and the tempo at the start of the fade
+		int Min_Step_Ticks = 1;
 
-			int BarTickStart = Tick_Start + (i * bar->FadeInfo->QuantizationTicks);
-			int BarTickDuration = bar->FadeInfo->QuantizationTicks;
+		Measure^ Start_Measure = _Timeline->GetMeasureAtTick(Tick_Start);
+		if (Start_Measure != nullptr && Start_Measure->Length_Per_Tick_ms > 0.0)
+		{
+			double Min_Step_ms = 1000.0 / Math::Max(Settings::Get_Instance()->MIDI_Fade_Max_Step_Rate, 1);
+			Min_Step_Ticks = Math::Max(1, (int)Math::Ceiling(Min_Step_ms / Start_Measure->Length_Per_Tick_ms));
+		}
 
-			Raw_Rasterized_Event Event;
-			Event.TickStart = BarTickStart;
-			Event.TickLength = BarTickDuration;
-			Event.Color = BarColor;
+		// Candidate positions are multiples of the minimum step distance, the last candidate carries the end color
+		int Last_Offset = ((Tick_Length - 1) / Min_Step_Ticks) * Min_Step_Ticks;
 
-			rastered_events->Add(Event);
+		int Step_Offset = 0;
+		Color Step_Color = Evaluate_Fade_Color(bar->FadeInfo, ColorCenter, 0.0f);
+
+		for (int Offset = Min_Step_Ticks; Offset <= Last_Offset; Offset += Min_Step_Ticks)
+		{
+			Color Candidate_Color = Evaluate_Fade_Color(bar->FadeInfo, ColorCenter, (float)Offset / Last_Offset);
+
+			// A new step is only placed once a channel changes by at least one 7-bit velocity unit
+			if ((Candidate_Color.R >> 1) == (Step_Color.R >> 1) &&
+				(Candidate_Color.G >> 1) == (Step_Color.G >> 1) &&
+				(Candidate_Color.B >> 1) == (Step_Color.B >> 1)) {
+				continue;
+			}
+
+			Add_Raw_Event(rastered_events, Tick_Start + Step_Offset, Offset - Step_Offset, Step_Color);
+
+			Step_Offset = Offset;
+			Step_Color = Candidate_Color;
 		}
+
+		// The last step lasts until the end of the fade
+		Add_Raw_Event(rastered_events, Tick_Start + Step_Offset, Tick_Length - Step_Offset, Step_Color);
 	}
 
 	void MIDI_Event_Raster::RasterBarStrobe(List<Raw_Rasterized_Event>^ rastered_events, BarEvent^ bar)
@@ -285,24 +289,23 @@ namespace MIDILightDrawer
 	}
 
 	
-	void MIDI_Event_Raster::Color_To_MIDI_Events(List<Playback_MIDI_Event^>^ output, Color color, int tick_start, int tick_length, int track_index, uint8_t midi_channel, int octave_note_offset)
+	void MIDI_Event_Raster::Color_To_MIDI_Events(List<Playback_MIDI_Event^>^ output, Color color, int tick_start, int tick_length, Color_MIDI_Mapping% mapping, Raster_Anti_Flicker_State% anti_flicker_state)
 	{
-		Settings^ Settings = Settings::Get_Instance();
-
 		int AppliedTickLength = tick_length;
+		int Octave_Note_Offset = mapping.Octave_Note_Offset;
 
 		// Apply anti-flicker logic if enabled
-		if (Settings->MIDI_Export_Anti_Flicker == true)
+		if (mapping.Anti_Flicker == true)
 		{
-			if (_Last_End_Tick == tick_start) {
-				Toggle_Additional_Offset();
+			if (anti_flicker_state.Last_End_Tick == tick_start) {
+				Toggle_Additional_Offset(anti_flicker_state);
 			}
 
-			if (_Next_Start_Tick == tick_start + tick_length) {
+			if (anti_flicker_state.Next_Start_Tick == tick_start + tick_length) {
 				AppliedTickLength += 1;
 			}
 
-			octave_note_offset += _Additional_Offset;
+			Octave_Note_Offset += anti_flicker_state.Additional_Offset;
 		}
 
 		// Convert RGB color to MIDI note values (halved to fit 0-127 range)
@@ -314,93 +317,51 @@ namespace MIDILightDrawer
 		double Timestamp_Start_ms	= _Timeline->TicksToMilliseconds(tick_start);
 		double Timestamp_End_ms		= _Timeline->TicksToMilliseconds(tick_start + AppliedTickLength);
 
-		int Applicable_MIDI_Channel = Math::Max(midi_channel - 1, 0);	// Ensure minimum MIDI Channel is 0 (Channel 1 in terms of 1 to 16)
-
-		// Create Note On events for each color channel
-		if (ValueRed > 0)
-		{
-			Playback_MIDI_Event^ NoteOn = gcnew Playback_MIDI_Event();
-			NoteOn->Timestamp_ms = Timestamp_Start_ms;
-			NoteOn->Tick = tick_start;
-			NoteOn->Timeline_Track_ID = track_index;
-			NoteOn->MIDI_Channel = Applicable_MIDI_Channel;
-			NoteOn->MIDI_Command = MIDI_Writer::MIDI_EVENT_NOTE_ON;
-			NoteOn->MIDI_Data1 = octave_note_offset + Settings->MIDI_Note_Red;
-			NoteOn->MIDI_Data2 = ValueRed;
-			
-			output->Add(NoteOn);
-
+		int Tick_End = tick_start + AppliedTickLength;
 
-			Playback_MIDI_Event^ NoteOff = gcnew Playback_MIDI_Event();
-			NoteOff->Timestamp_ms = Timestamp_End_ms;
-			NoteOff->Tick = tick_start + AppliedTickLength;
-			NoteOff->Timeline_Track_ID = track_index;
-			NoteOff->MIDI_Channel = Applicable_MIDI_Channel;
-			NoteOff->MIDI_Command = MIDI_Writer::MIDI_EVENT_NOTE_OFF;  // Note Off
-			NoteOff->MIDI_Data1 = octave_note_offset + Settings->MIDI_Note_Red;
-			NoteOff->MIDI_Data2 = 0;
-			
-			output->Add(NoteOff);
+		// Create Note On and Note Off events for each color channel
+		if (ValueRed > 0) {
+			Add_Note_On_Off(output, mapping, Octave_Note_Offset + mapping.Note_Red, ValueRed, tick_start, Tick_End, Timestamp_Start_ms, Timestamp_End_ms);
 		}
 
-		if (ValueGreen > 0)
-		{
-			Playback_MIDI_Event^ NoteOn = gcnew Playback_MIDI_Event();
-			NoteOn->Timestamp_ms = Timestamp_Start_ms;
-			NoteOn->Tick = tick_start;
-			NoteOn->Timeline_Track_ID = track_index;
-			NoteOn->MIDI_Channel = Applicable_MIDI_Channel;
-			NoteOn->MIDI_Command = MIDI_Writer::MIDI_EVENT_NOTE_ON;
-			NoteOn->MIDI_Data1 = octave_note_offset + Settings->MIDI_Note_Green;
-			NoteOn->MIDI_Data2 = ValueGreen;
-			
-			output->Add(NoteOn);
-
-
-			Playback_MIDI_Event^ NoteOff = gcnew Playback_MIDI_Event();
-			NoteOff->Timestamp_ms = Timestamp_End_ms;
-			NoteOff->Tick = tick_start + AppliedTickLength;
-			NoteOff->MIDI_Channel = Applicable_MIDI_Channel;
-			NoteOff->MIDI_Command = MIDI_Writer::MIDI_EVENT_NOTE_OFF;
-			NoteOff->MIDI_Data1 = octave_note_offset + Settings->MIDI_Note_Green;
-			NoteOff->MIDI_Data2 = 0;
-			NoteOff->Timeline_Track_ID = track_index;
-			
-			output->Add(NoteOff);
+		if (ValueGreen > 0) {
+			Add_Note_On_Off(output, mapping, Octave_Note_Offset + mapping.Note_Green, ValueGreen, tick_start, Tick_End, Timestamp_Start_ms, Timestamp_End_ms);
 		}
 
-		if (ValueBlue > 0)
-		{
-			Playback_MIDI_Event^ NoteOn = gcnew Playback_MIDI_Event();
-			NoteOn->Timestamp_ms = Timestamp_Start_ms;
-			NoteOn->Tick = tick_start;
-			NoteOn->Timeline_Track_ID = track_index;
-			NoteOn->MIDI_Channel = Applicable_MIDI_Channel;
-			NoteOn->MIDI_Command = MIDI_Writer::MIDI_EVENT_NOTE_ON;
-			NoteOn->MIDI_Data1 = octave_note_offset + Settings->MIDI_Note_Blue;
-			NoteOn->MIDI_Data2 = ValueBlue;
-			
-			output->Add(NoteOn);
-
-
-			Playback_MIDI_Event^ NoteOff = gcnew Playback_MIDI_Event();
-			NoteOff->Timestamp_ms = Timestamp_End_ms;
-			NoteOff->Tick = tick_start + AppliedTickLength;
-			NoteOff->Timeline_Track_ID = track_index;
-			NoteOff->MIDI_Channel = Applicable_MIDI_Channel;
-			NoteOff->MIDI_Command = MIDI_Writer::MIDI_EVENT_NOTE_OFF;
-			NoteOff->MIDI_Data1 = octave_note_offset + Settings->MIDI_Note_Blue;
-			NoteOff->MIDI_Data2 = 0;
-
-			output->Add(NoteOff);
+		if (ValueBlue > 0) {
+			Add_Note_On_Off(output, mapping, Octave_Note_Offset + mapping.Note_Blue, ValueBlue, tick_start, Tick_End, Timestamp_Start_ms, Timestamp_End_ms);
 		}
 	}
+
+	void MIDI_Event_Raster::Add_Note_On_Off(List<Playback_MIDI_Event^>^ output, Color_MIDI_Mapping% mapping, int note_number, Byte value, int tick_start, int tick_end, double timestamp_start_ms, double timestamp_end_ms)
+	{
+		Playback_MIDI_Event^ NoteOn = gcnew Playback_MIDI_Event();
+		NoteOn->Timestamp_ms = timestamp_start_ms;
+		NoteOn->Tick = tick_start;
+		NoteOn->Timeline_Track_ID = mapping.Track_Index;
+		NoteOn->MIDI_Channel = mapping.Applicable_MIDI_Channel;
+		NoteOn->MIDI_Command = MIDI_Writer::MIDI_EVENT_NOTE_ON;
+		NoteOn->MIDI_Data1 = note_number;
+		NoteOn->MIDI_Data2 = value;
+
+		output->Add(NoteOn);
+
+
+		Playback_MIDI_Event^ NoteOff = gcnew Playback_MIDI_Event();
+		NoteOff->Timestamp_ms = timestamp_end_ms;
+		NoteOff->Tick = tick_end;
+		NoteOff->Timeline_Track_ID = mapping.Track_Index;
+		NoteOff->MIDI_Channel = mapping.Applicable_MIDI_Channel;
+		NoteOff->MIDI_Command = MIDI_Writer::MIDI_EVENT_NOTE_OFF;
+		NoteOff->MIDI_Data1 = note_number;
+		NoteOff->MIDI_Data2 = 0;
+
+		output->Add(NoteOff);
+	}
 	
 
 	List<Playback_MIDI_Event^>^ MIDI_Event_Raster::Export_Track_To_Playback_Events(Export_MIDI_Track^ export_track)
 	{
-		Settings^ Settings = Settings::Get_Instance();
-		
 		List<Playback_MIDI_Event^>^ Playback_Events = gcnew List<Playback_MIDI_Event^>();
 		
 		List<Export_MIDI_Color_Note^>^ All_Notes = gcnew List<Export_MIDI_Color_Note^>();
@@ -409,12 +370,11 @@ namespace MIDILightDrawer
 		All_Notes->AddRange(export_track->Notes_Green);
 		All_Notes->AddRange(export_track->Notes_Blue);
 
-		int Octave = export_track->Timeline_Track->Octave;
-		int Octave_Note_Offset = (Octave + MIDI_Event_Raster::OCTAVE_OFFSET) * MIDI_Event_Raster::NOTES_PER_OCTAVE;
+		Color_MIDI_Mapping Mapping = export_track->Mapping;
 		
 		for each (Export_MIDI_Color_Note^ Note in All_Notes)
 		{
-			Playback_OnOff_Pair OnOff_Pair = Color_Note_To_Playback_Events(Note, Octave_Note_Offset, export_track->Timeline_Track->Index);
+			Playback_OnOff_Pair OnOff_Pair = Color_Note_To_Playback_Events(Note, Mapping);
 			
 			Playback_Events->Add(OnOff_Pair.Note_On);
 			Playback_Events->Add(OnOff_Pair.Note_Off);
@@ -423,22 +383,18 @@ namespace MIDILightDrawer
 		return Playback_Events;
 	}
 
-	Playback_OnOff_Pair MIDI_Event_Raster::Color_Note_To_Playback_Events(Export_MIDI_Color_Note^ note, int note_octave_offset, int track_index)
+	Playback_OnOff_Pair MIDI_Event_Raster::Color_Note_To_Playback_Events(Export_MIDI_Color_Note^ note, Color_MIDI_Mapping% mapping)
 	{
-		Settings^ Settings = Settings::Get_Instance();
-
-		int Note_Number = note->Base_Note_In_Octave + note_octave_offset + (int)note->Has_Offset;
+		int Note_Number = note->Base_Note_In_Octave + mapping.Octave_Note_Offset + (int)note->Has_Offset;
 
 		double Time_Start_ms = _Timeline->TicksToMilliseconds(note->Tick_Start - (int)note->Is_Direct_Follower);
 		double Time_End_ms = _Timeline->TicksToMilliseconds(note->Tick_End);
 
-		int Applicable_MIDI_Channel = Math::Max(Settings->Global_MIDI_Output_Channel - 1, 0);	// Ensure minimum MIDI Channel is 0 (Channel 1 in terms of 1 to 16) 
-
 		Playback_MIDI_Event^ Note_On = gcnew Playback_MIDI_Event();
 		Note_On->Timestamp_ms = Time_Start_ms;
 		Note_On->Tick = note->Tick_Start - (int)note->Is_Direct_Follower;
-		Note_On->Timeline_Track_ID = track_index;
-		Note_On->MIDI_Channel = Applicable_MIDI_Channel;
+		Note_On->Timeline_Track_ID = mapping.Track_Index;
+		Note_On->MIDI_Channel = mapping.Applicable_MIDI_Channel;
 		Note_On->MIDI_Command = MIDI_Writer::MIDI_EVENT_NOTE_ON;
 		Note_On->MIDI_Data1 = Note_Number;
 		Note_On->MIDI_Data2 = note->Color_Value;
@@ -446,8 +402,8 @@ namespace MIDILightDrawer
 		Playback_MIDI_Event^ Note_Off = gcnew Playback_MIDI_Event();
 		Note_Off->Timestamp_ms = Time_End_ms;
 		Note_Off->Tick = note->Tick_End;
-		Note_Off->Timeline_Track_ID = track_index;
-		Note_Off->MIDI_Channel = Applicable_MIDI_Channel;
+		Note_Off->Timeline_Track_ID = mapping.Track_Index;
+		Note_Off->MIDI_Channel = mapping.Applicable_MIDI_Channel;
 		Note_Off->MIDI_Command = MIDI_Writer::MIDI_EVENT_NOTE_OFF;
 		Note_Off->MIDI_Data1 = Note_Number;
 		Note_Off->MIDI_Data2 = 0;
@@ -459,24 +415,245 @@ namespace MIDILightDrawer
 		return OnOff_Pair;
 	}
 
-	void MIDI_Event_Raster::Toggle_Additional_Offset()
+	Color_MIDI_Mapping MIDI_Event_Raster::Capture_Color_MIDI_Mapping()
+	{
+		Settings^ Settings = Settings::Get_Instance();
+
+		Color_MIDI_Mapping Mapping;
+		Mapping.Track_Index				= 0;
+		Mapping.Octave_Note_Offset		= 0;
+		Mapping.Note_Red				= Settings->MIDI_Note_Red;
+		Mapping.Note_Green				= Settings->MIDI_Note_Green;
+		Mapping.Note_Blue				= Settings->MIDI_Note_Blue;
+		Mapping.MIDI_Channel			= Settings->Global_MIDI_Output_Channel;
+		Mapping.Applicable_MIDI_Channel = Math::Max(Settings->Global_MIDI_Output_Channel - 1, 0);	// Ensure minimum MIDI Channel is 0 (Channel 1 in terms of 1 to 16)
+		Mapping.Anti_Flicker			= Settings->MIDI_Export_Anti_Flicker;
+		Mapping.Merge_Identical			= Settings->MIDI_Export_Merge_Identical_Notes;
+
+		return Mapping;
+	}
+
+	Color_MIDI_Mapping MIDI_Event_Raster::Capture_Playback_Color_MIDI_Mapping()
 	{
-		this->_Additional_Offset = (this->_Additional_Offset + 1) & 1;
+		Color_MIDI_Mapping Mapping = Capture_Color_MIDI_Mapping();
+		Mapping.Merge_Identical = false;
+
+		return Mapping;
+	}
+
+	Color_MIDI_Mapping Color_MIDI_Mapping::For_Track(int track_index, int octave)
+	{
+		Color_MIDI_Mapping Mapping = *this;
+		Mapping.Track_Index = track_index;
+		Mapping.Octave_Note_Offset = (octave + MIDI_Event_Raster::OCTAVE_OFFSET) * MIDI_Event_Raster::NOTES_PER_OCTAVE;
+
+		return Mapping;
+	}
+
+	void MIDI_Event_Raster::Run_Track_Jobs(Track_Raster_Job^ job, int track_count, bool for_export)
+	{
+		Action<int>^ Job_Action;
+
+		if (for_export) {
+			Job_Action = gcnew Action<int>(job, &Track_Raster_Job::Raster_For_Export);
+		}
+		else {
+			Job_Action = gcnew Action<int>(job, &Track_Raster_Job::Raster_For_Playback);
+		}
+
+		if (_Parallel_Rasterization && track_count > 1)
+		{
+			System::Threading::Tasks::Parallel::For(0, track_count, Job_Action);
+		}
+		else
+		{
+			for (int i = 0; i < track_count; i++) {
+				Job_Action(i);
+			}
+		}
+	}
+
+	void MIDI_Event_Raster::Track_Raster_Job::Raster_For_Export(int track_index)
+	{
+		Track^ Timeline_Track = Tracks[track_index];
+
+		Export_Results[track_index] = Raster->Raster_Track_For_Export(Timeline_Track, Mapping.For_Track(Timeline_Track->Index, Timeline_Track->Octave));
+	}
+
+	void MIDI_Event_Raster::Track_Raster_Job::Raster_For_Playback(int track_index)
+	{
+		Track^ Timeline_Track = Tracks[track_index];
+
+		Export_MIDI_Track^ Export_Track = Raster->Raster_Track_For_Export(Timeline_Track, Mapping.For_Track(Timeline_Track->Index, Timeline_Track->Octave));
+		List<Playback_MIDI_Event^>^ Track_Playback_Events = Raster->Export_Track_To_Playback_Events(Export_Track);
+
+		Sort_Track_Events(Track_Playback_Events);
+
+		Playback_Results[track_index] = Track_Playback_Events;
+	}
+
+	Color MIDI_Event_Raster::Get_Fade_Center_Color(BarEventFadeInfo^ fade_info)
+	{
+		if (fade_info->Type == FadeType::Two_Colors) {
+			return Color::FromArgb(Math::Abs(fade_info->ColorEnd.R - fade_info->ColorStart.R) / 2,
+				Math::Abs(fade_info->ColorEnd.G - fade_info->ColorStart.G) / 2,
+				Math::Abs(fade_info->ColorEnd.B - fade_info->ColorStart.B) / 2);
+		}
+
+		return fade_info->ColorCenter;
+	}
+
+	Color MIDI_Event_Raster::Evaluate_Fade_Color(BarEventFadeInfo^ fade_info, Color color_center, float ratio)
+	{
+		bool IsFirstHalf = ratio <= 0.5f;
+
+		Easing CurrentEasing = IsFirstHalf ? fade_info->EaseIn : fade_info->EaseOut;
+
+		if (IsFirstHalf)
+		{
+			// First half: interpolate between start and center colors
+			float AdjustedRatio = ratio * 2.0f;
+
+			int R = (int)Easings::ApplyEasing(AdjustedRatio, fade_info->ColorStart.R, color_center.R, CurrentEasing);
+			int G = (int)Easings::ApplyEasing(AdjustedRatio, fade_info->ColorStart.G, color_center.G, CurrentEasing);
+			int B = (int)Easings::ApplyEasing(AdjustedRatio, fade_info->ColorStart.B, color_center.B, CurrentEasing);
+
+			return Color::FromArgb(255, R, G, B);
+		}
+
+		// Second half: interpolate between center and end colors
+		float AdjustedRatio = (ratio - 0.5f) * 2.0f;
+
+		int R = (int)Easings::ApplyEasing(AdjustedRatio, color_center.R, fade_info->ColorEnd.R, CurrentEasing);
+		int G = (int)Easings::ApplyEasing(AdjustedRatio, color_center.G, fade_info->ColorEnd.G, CurrentEasing);
+		int B = (int)Easings::ApplyEasing(AdjustedRatio, color_center.B, fade_info->ColorEnd.B, CurrentEasing);
+
+		return Color::FromArgb(255, R, G, B);
+	}
+
+	void MIDI_Event_Raster::Add_Raw_Event(List<Raw_Rasterized_Event>^ rastered_events, int tick_start, int tick_length, Color color)
+	{
+		Raw_Rasterized_Event Event;
+		Event.TickStart = tick_start;
+		Event.TickLength = tick_length;
+		Event.Color = color;
+
+		rastered_events->Add(Event);
+	}
+
+	void MIDI_Event_Raster::Toggle_Additional_Offset(Raster_Anti_Flicker_State% anti_flicker_state)
+	{
+		anti_flicker_state.Additional_Offset = (anti_flicker_state.Additional_Offset + 1) & 1;
 	}
 
-	bool MIDI_Event_Raster::Should_Track_Play(int track_index, List<int>^ muted_tracks, List<int>^ soloed_tracks)
+	void MIDI_Event_Raster::Sort_Track_Events(List<Playback_MIDI_Event^>^ events)
 	{
-		// Check if muted
-		if (muted_tracks->Contains(track_index)) {
-			return false;
+		array<Playback_MIDI_Event^>^ Items = events->ToArray();
+		array<Playback_Event_Sort_Key>^ Keys = gcnew array<Playback_Event_Sort_Key>(Items->Length);
+
+		for (int i = 0; i < Items->Length; i++)
+		{
+			Keys[i].Timestamp_ms = Items[i]->Timestamp_ms;
+			Keys[i].Sequence = i;
+		}
+
+		// Keys are unique, so the resulting order does not depend on the sort algorithm
+		Array::Sort<Playback_Event_Sort_Key, Playback_MIDI_Event^>(Keys, Items);
+
+		events->Clear();
+		events->AddRange(Items);
+	}
+
+	List<Playback_MIDI_Event^>^ MIDI_Event_Raster::Merge_Sorted_Track_Events(array<List<Playback_MIDI_Event^>^>^ track_events)
+	{
+		int Total_Count = 0;
+
+		for each (List<Playback_MIDI_Event^>^ Events in track_events) {
+			if (Events != nullptr) {
+				Total_Count += Events->Count;
+			}
+		}
+
+		List<Playback_MIDI_Event^>^ AllEvents = gcnew List<Playback_MIDI_Event^>(Total_Count);
+
+		// Binary min-heap of track indices, ordered by the timestamp of each track's next event.
+		// Ties are resolved by the track index, which keeps the merge deterministic
+		array<int>^ Positions = gcnew array<int>(track_events->Length);
+		array<int>^ Heap = gcnew array<int>(track_events->Length);
+		int Heap_Count = 0;
+
+		for (int Track_Index = 0; Track_Index < track_events->Length; Track_Index++)
+		{
+			if (track_events[Track_Index] == nullptr || track_events[Track_Index]->Count == 0) {
+				continue;
+			}
+
+			int Child = Heap_Count++;
+			Heap[Child] = Track_Index;
+
+			while (Child > 0)
+			{
+				int Parent = (Child - 1) >> 1;
+
+				if (!Merge_Head_Less(track_events, Positions, Heap[Child], Heap[Parent])) {
+					break;
+				}
+
+				int Temp = Heap[Parent]; Heap[Parent] = Heap[Child]; Heap[Child] = Temp;
+				Child = Parent;
+			}
 		}
 
-		// If any solos active, only play soloed tracks
-		if (soloed_tracks->Count > 0) {
-			return soloed_tracks->Contains(track_index);
+		while (Heap_Count > 0)
+		{
+			int Track_Index = Heap[0];
+
+			AllEvents->Add(track_events[Track_Index][Positions[Track_Index]]);
+			Positions[Track_Index]++;
+
+			// Track exhausted, move the last heap entry to the top
+			if (Positions[Track_Index] >= track_events[Track_Index]->Count) {
+				Heap[0] = Heap[--Heap_Count];
+			}
+
+			int Parent = 0;
+
+			while (true)
+			{
+				int Left = (Parent << 1) + 1;
+				int Right = Left + 1;
+				int Smallest = Parent;
+
+				if (Left < Heap_Count && Merge_Head_Less(track_events, Positions, Heap[Left], Heap[Smallest])) {
+					Smallest = Left;
+				}
+
+				if (Right < Heap_Count && Merge_Head_Less(track_events, Positions, Heap[Right], Heap[Smallest])) {
+					Smallest = Right;
+				}
+
+				if (Smallest == Parent) {
+					break;
+				}
+
+				int Temp = Heap[Parent]; Heap[Parent] = Heap[Smallest]; Heap[Smallest] = Temp;
+				Parent = Smallest;
+			}
+		}
+
+		return AllEvents;
+	}
+
+	bool MIDI_Event_Raster::Merge_Head_Less(array<List<Playback_MIDI_Event^>^>^ track_events, array<int>^ positions, int track_a, int track_b)
+	{
+		double Timestamp_A = track_events[track_a][positions[track_a]]->Timestamp_ms;
+		double Timestamp_B = track_events[track_b][positions[track_b]]->Timestamp_ms;
+
+		if (Timestamp_A != Timestamp_B) {
+			return Timestamp_A < Timestamp_B;
 		}
 
-		return true;
+		return track_a < track_b;
 	}
 
 	int MIDI_Event_Raster::Compare_Events_By_Timestamp(Playback_MIDI_Event^ a, Playback_MIDI_Event^ b)
@@ -45,6 +45,56 @@ namespace MIDILightDrawer
 		Playback_MIDI_Event^ Note_Off;
 	};
 
+	// Anti-flicker state of one rasterization pass. Kept per pass (and per track) instead of in
+	// the raster object so that tracks can be rasterized concurrently without sharing state
+	public value struct Raster_Anti_Flicker_State
+	{
+		int Last_End_Tick;
+		int Next_Start_Tick;
+		int Additional_Offset;		// Toggles 0/1 for anti-flicker
+
+		static Raster_Anti_Flicker_State Create() {
+			Raster_Anti_Flicker_State State;
+			State.Last_End_Tick = -1;
+			State.Next_Start_Tick = -1;
+			State.Additional_Offset = 0;
+
+			return State;
+		}
+	};
+
+	// Color-to-MIDI mapping of one track. Captured from the settings once per rasterization pass and
+	// passed by value, so the per-event conversion neither touches the settings singleton nor shared state
+	public value struct Color_MIDI_Mapping
+	{
+		int Track_Index;
+		int Octave_Note_Offset;			// First note number of the track octave
+		int Note_Red;					// Note within the octave per color channel
+		int Note_Green;
+		int Note_Blue;
+		int MIDI_Channel;				// Output channel as configured (1 to 16)
+		int Applicable_MIDI_Channel;	// Channel used in the status byte (0 to 15)
+		bool Anti_Flicker;
+		bool Merge_Identical;
+
+		Color_MIDI_Mapping For_Track(int track_index, int octave);
+	};
+
+	// Sort key used to order the events of one track by timestamp. The sequence number makes
+	// the order of events with equal timestamps deterministic
+	public value struct Playback_Event_Sort_Key : public IComparable<Playback_Event_Sort_Key>
+	{
+		double Timestamp_ms;
+		int Sequence;
+
+		virtual int CompareTo(Playback_Event_Sort_Key other) {
+			if (Timestamp_ms < other.Timestamp_ms)	{ return -1; }
+			if (Timestamp_ms > other.Timestamp_ms)	{ return  1; }
+
+			return Sequence.CompareTo(other.Sequence);
+		}
+	};
+
 	public ref struct Export_MIDI_Track
 	{
 		Track^ Timeline_Track;
@@ -54,8 +104,14 @@ namespace MIDILightDrawer
 		List<Export_MIDI_Color_Note^>^ Notes_Green;
 		List<Export_MIDI_Color_Note^>^ Notes_Blue;
 
-		Export_MIDI_Track(Track^ track) {
+		int Merged_Note_Count;	// Notes folded into their predecessor because of an identical color value
+
+		Color_MIDI_Mapping Mapping;
+
+		Export_MIDI_Track(Track^ track, Color_MIDI_Mapping mapping) {
 			Timeline_Track = track;
+			Mapping = mapping;
+			Merged_Note_Count = 0;
 
 			Raw_Events	= gcnew List<Raw_Rasterized_Event>();
 			
@@ -68,12 +124,24 @@ namespace MIDILightDrawer
 	public ref class MIDI_Event_Raster
 	{
 	private:
-		Widget_Timeline^ _Timeline;
+		// Work item for rasterizing the tracks of a timeline concurrently. Every track writes into its own result slot
+		ref class Track_Raster_Job
+		{
+		public:
+			MIDI_Event_Raster^ Raster;
+			List<Track^>^ Tracks;
+			Color_MIDI_Mapping Mapping;
 
-		int _Last_End_Tick;
-		int _Next_Start_Tick;
-		Color _Last_Color;
-		int _Additional_Offset;         // Toggles 0/1 for anti-flicker
+			array<Export_MIDI_Track^>^ Export_Results;
+			array<List<Playback_MIDI_Event^>^>^ Playback_Results;
+
+			void Raster_For_Export(int track_index);
+			void Raster_For_Playback(int track_index);
+		};
+
+	private:
+		Widget_Timeline^ _Timeline;
+		bool _Parallel_Rasterization;
 
 	public:
 		static const int TICKS_PER_QUARTER	= Timeline_Direct2DRenderer::TICKS_PER_QUARTER;
@@ -87,30 +155,54 @@ namespace MIDILightDrawer
 		uint64_t Convert_Samples_To_Microseconds(uint64_t samples, uint32_t sample_rate);
 
 		List<Raw_Rasterized_Event>^ Raster_Bar_For_Export(BarEvent^ bar);
-		Export_MIDI_Track^ Raster_Track_For_Export(Track^ track);
+		Export_MIDI_Track^ Raster_Track_For_Export(Track^ track, Color_MIDI_Mapping mapping);
 		List<Export_MIDI_Track^>^ Raster_Timeline_For_Export();
 
 		// Method can probalby be deleted, it is only need to pre-rasterizing events
-		List<Playback_MIDI_Event^>^ Raster_Bar_For_Playback(BarEvent^ bar, int track_index, uint8_t midi_channel, int octave_note_offset, bool use_anti_flicker);
+		List<Playback_MIDI_Event^>^ Raster_Bar_For_Playback(BarEvent^ bar, Color_MIDI_Mapping mapping);
 		
 		List<Playback_MIDI_Event^>^ Raster_Timeline_For_Playback();
 
-		List<Playback_MIDI_Event^>^ Get_Timeline_PreRastered_Playback_Events(List<Track^>^ tracks, List<int>^ muted_tracks, List<int>^ soloed_tracks);
+		List<Playback_MIDI_Event^>^ Get_Timeline_PreRastered_Playback_Events(List<Track^>^ tracks);
+
+		// Reads the color notes, output channel and export options from the settings. The octave and track are set per track with For_Track
+		static Color_MIDI_Mapping Capture_Color_MIDI_Mapping();
+
+		// As above, but merging identical notes is an export option only, playback keeps every note
+		static Color_MIDI_Mapping Capture_Playback_Color_MIDI_Mapping();
+
+		// One color note of a rastered track as Note On and Off, with the timestamps of the current tempo map
+		Playback_OnOff_Pair Color_Note_To_Playback_Events(Export_MIDI_Color_Note^ note, Color_MIDI_Mapping% mapping);
+
+		// Rasterize tracks on the thread pool. The result is identical to the serial path
+		property bool Parallel_Rasterization {
+			bool get() { return _Parallel_Rasterization; }
+			void set(bool value) { _Parallel_Rasterization = value; }
+		}
 
 	private:
+		void Run_Track_Jobs(Track_Raster_Job^ job, int track_count, bool for_export);
+
 		void RasterBarSolid(List<Raw_Rasterized_Event>^ rastered_events, BarEvent^ bar);
 		void RasterBarFade(List<Raw_Rasterized_Event>^ rastered_events, BarEvent^ bar);
+		void RasterBarFadeAdaptive(List<Raw_Rasterized_Event>^ rastered_events, BarEvent^ bar);
 		void RasterBarStrobe(List<Raw_Rasterized_Event>^ rastered_events, BarEvent^ bar);
 
 		// Method can probalby be deleted, it is only need to pre-rasterizing events
-		void Color_To_MIDI_Events(List<Playback_MIDI_Event^>^ output, Color color, int tick_start, int tick_length, int track_index, uint8_t midi_channel, int octave_note_offset);
+		void Color_To_MIDI_Events(List<Playback_MIDI_Event^>^ output, Color color, int tick_start, int tick_length, Color_MIDI_Mapping% mapping, Raster_Anti_Flicker_State% anti_flicker_state);
 		
 		List<Playback_MIDI_Event^>^ Export_Track_To_Playback_Events(Export_MIDI_Track^ export_track);
-		Playback_OnOff_Pair Color_Note_To_Playback_Events(Export_MIDI_Color_Note^ note, int note_octave_offset, int track_index);
-		void Toggle_Additional_Offset();
-		bool Should_Track_Play(int track_index, List<int>^ muted_tracks, List<int>^ soloed_tracks);
 
 	private:
+		static Color Get_Fade_Center_Color(BarEventFadeInfo^ fade_info);
+		static Color Evaluate_Fade_Color(BarEventFadeInfo^ fade_info, Color color_center, float ratio);
+		static void Add_Raw_Event(List<Raw_Rasterized_Event>^ rastered_events, int tick_start, int tick_length, Color color);
+		static bool Add_Color_Note(List<Export_MIDI_Color_Note^>^ notes, Raw_Rasterized_Event% raw_event, Byte color_value, int base_note_in_octave, bool anti_flicker, bool merge_identical);
+		static void Add_Note_On_Off(List<Playback_MIDI_Event^>^ output, Color_MIDI_Mapping% mapping, int note_number, Byte value, int tick_start, int tick_end, double timestamp_start_ms, double timestamp_end_ms);
+		static void Toggle_Additional_Offset(Raster_Anti_Flicker_State% anti_flicker_state);
+		static void Sort_Track_Events(List<Playback_MIDI_Event^>^ events);
+		static List<Playback_MIDI_Event^>^ Merge_Sorted_Track_Events(array<List<Playback_MIDI_Event^>^>^ track_events);
+		static bool Merge_Head_Less(array<List<Playback_MIDI_Event^>^>^ track_events, array<int>^ positions, int track_a, int track_b);
 		static int Compare_Events_By_Timestamp(Playback_MIDI_Event^ a, Playback_MIDI_Event^ b);
 	};
 }
@@ -14,12 +14,13 @@ namespace MIDILightDrawer
 		_LastEndTick		= -1;
 		_NextStartTick		= -1;
 		_LastColor			= Color();
+
+		_Last_Export_Note_Count			= 0;
+		_Last_Export_Merged_Note_Count	= 0;
 	}
 
 	String^ MIDI_Exporter::Export(String^ filename, gp_parser::Parser* tab)
 	{
-		Settings^ Settings = Settings::Get_Instance();
-
 		MIDI_Writer Writer(MIDI_Event_Raster::TICKS_PER_QUARTER);  // Use 960 ticks per quarter note
 		
 		if (tab == NULL) {
@@ -36,11 +37,15 @@ namespace MIDILightDrawer
 			Writer.Add_Measure(MH->timeSignature.numerator, MH->timeSignature.denominator.value, MH->tempo.value);
 		}
 
+		int Note_Count = 0;
+		int Merged_Note_Count = 0;
+
 		List<Export_MIDI_Track^>^ Timeline_Export_Events = _MIDI_Event_Raster->Raster_Timeline_For_Export();
 		for each(Export_MIDI_Track^ Export_Track in Timeline_Export_Events)
 		{
-			int Octave = Export_Track->Timeline_Track->Octave;
-			int Octave_Note_Offset = (Octave + MIDI_Event_Raster::OCTAVE_OFFSET) * MIDI_Event_Raster::NOTES_PER_OCTAVE;
+			Merged_Note_Count += Export_Track->Merged_Note_Count;
+
+			Color_MIDI_Mapping Mapping = Export_Track->Mapping;
 
 			// CRITICAL FIX: Merge all color notes into a single sorted list to ensure proper ordering
 			List<Export_MIDI_Color_Note^>^ All_Notes = gcnew List<Export_MIDI_Color_Note^>();
@@ -55,16 +60,21 @@ namespace MIDILightDrawer
 			// Now add notes to writer in chronological order
 			for each(Export_MIDI_Color_Note^ Note in All_Notes)
 			{
-				int Note_Number = Note->Base_Note_In_Octave + Octave_Note_Offset + (int)Note->Has_Offset;
+				int Note_Number = Note->Base_Note_In_Octave + Mapping.Octave_Note_Offset + (int)Note->Has_Offset;
 
-				Writer.Add_Note(Note->Tick_Start - (uint32_t)Note->Is_Direct_Follower, Note->Tick_Length + (uint32_t)Note->Is_Direct_Follower, Settings->Global_MIDI_Output_Channel, Note_Number, Note->Color_Value);
+				Writer.Add_Note(Note->Tick_Start - (uint32_t)Note->Is_Direct_Follower, Note->Tick_Length + (uint32_t)Note->Is_Direct_Follower, Mapping.MIDI_Channel, Note_Number, Note->Color_Value);
 			}
+
+			Note_Count += All_Notes->Count;
 		}
 
 		if (!Writer.Save_To_File(ConvertToStdString(filename))) {
 			return "Failed to write MIDI file";
 		}
 
+		_Last_Export_Note_Count			= Note_Count;
+		_Last_Export_Merged_Note_Count	= Merged_Note_Count;
+
 		return String::Empty;
 	}
 
@@ -27,11 +27,23 @@ namespace MIDILightDrawer
 		int _NextStartTick;
 		Color _LastColor;
 
+		int _Last_Export_Note_Count;
+		int _Last_Export_Merged_Note_Count;
+
 	public:
 		MIDI_Exporter(MIDI_Event_Raster^ midi_event_raster);
 
 		String^ Export(String^ filename, gp_parser::Parser* tab);
 
+		// Statistics of the last successful export. Each note is one Note-On and one Note-Off event
+		property int Last_Export_Note_Count {
+			int get() { return _Last_Export_Note_Count; }
+		}
+
+		property int Last_Export_Merged_Note_Count {
+			int get() { return _Last_Export_Merged_Note_Count; }
+		}
+
 		std::string ConvertToStdString(System::String^ input_string);
 
 	private:
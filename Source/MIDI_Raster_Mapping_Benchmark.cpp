@@ -0,0 +1,143 @@
+#include "MIDI_Raster_Mapping_Benchmark.h"
+
+using namespace System::Diagnostics;
+
+namespace MIDILightDrawer
+{
+	Raster_Mapping_Benchmark_Report MIDI_Raster_Mapping_Benchmark::Run(MIDI_Event_Raster^ raster, List<Track^>^ tracks, int repetitions)
+	{
+		Raster_Mapping_Benchmark_Report Report;
+		Report.Track_Count = tracks->Count;
+		Report.Repetitions = Math::Max(repetitions, 1);
+
+		List<Playback_MIDI_Event^>^ Settings_Output = gcnew List<Playback_MIDI_Event^>();
+		List<Playback_MIDI_Event^>^ Mapping_Output = gcnew List<Playback_MIDI_Event^>();
+
+		Stopwatch^ Timer = gcnew Stopwatch();
+		double Settings_Best_ms = Double::MaxValue;
+		double Mapping_Best_ms = Double::MaxValue;
+
+		// Alternating passes, so both see the same state of the garbage collector and the caches
+		for (int i = 0; i < Report.Repetitions; i++)
+		{
+			Settings_Output->Clear();
+			GC::Collect();
+			Timer->Restart();
+			Raster_With_Settings_Lookup(raster, tracks, Settings_Output);
+			Timer->Stop();
+			Settings_Best_ms = Math::Min(Settings_Best_ms, Timer->Elapsed.TotalMilliseconds);
+
+			Mapping_Output->Clear();
+			GC::Collect();
+			Timer->Restart();
+			Report.Color_Note_Count = Raster_With_Mapping(raster, tracks, MIDI_Event_Raster::Capture_Playback_Color_MIDI_Mapping(), Mapping_Output);
+			Timer->Stop();
+			Mapping_Best_ms = Math::Min(Mapping_Best_ms, Timer->Elapsed.TotalMilliseconds);
+		}
+
+		Report.MIDI_Event_Count = Mapping_Output->Count;
+		Report.Settings_Lookup_ms = Settings_Best_ms;
+		Report.Captured_Mapping_ms = Mapping_Best_ms;
+		Report.Settings_Lookup_ns_Per_Note = (Report.Color_Note_Count > 0) ? Settings_Best_ms * 1000000.0 / Report.Color_Note_Count : 0.0;
+		Report.Captured_Mapping_ns_Per_Note = (Report.Color_Note_Count > 0) ? Mapping_Best_ms * 1000000.0 / Report.Color_Note_Count : 0.0;
+		Report.Speedup = (Mapping_Best_ms > 0.0) ? Settings_Best_ms / Mapping_Best_ms : 0.0;
+		Report.Results_Match = Events_Equal(Settings_Output, Mapping_Output);
+
+		return Report;
+	}
+
+	Raster_Mapping_Benchmark_Report MIDI_Raster_Mapping_Benchmark::Run(MIDI_Event_Raster^ raster, List<Track^>^ tracks)
+	{
+		return Run(raster, tracks, DEFAULT_REPETITIONS);
+	}
+
+	String^ MIDI_Raster_Mapping_Benchmark::Format_Report(Raster_Mapping_Benchmark_Report report)
+	{
+		String^ Text = "";
+
+		Text += String::Format("Timeline: {0} tracks, {1} color notes, {2} MIDI events, best of {3} passes\n", report.Track_Count, report.Color_Note_Count, report.MIDI_Event_Count, report.Repetitions);
+		Text += String::Format("Settings lookup per note: {0:F2} ms ({1:F1} ns per note)\n", report.Settings_Lookup_ms, report.Settings_Lookup_ns_Per_Note);
+		Text += String::Format("Captured mapping:         {0:F2} ms ({1:F1} ns per note)\n", report.Captured_Mapping_ms, report.Captured_Mapping_ns_Per_Note);
+		Text += String::Format("Speedup: {0:F2}x, results {1}\n", report.Speedup, report.Results_Match ? "identical" : "DIFFERENT");
+
+		return Text;
+	}
+
+	int MIDI_Raster_Mapping_Benchmark::Raster_With_Settings_Lookup(MIDI_Event_Raster^ raster, List<Track^>^ tracks, List<Playback_MIDI_Event^>^ output)
+	{
+		int Color_Note_Count = 0;
+
+		for each (Track^ Timeline_Track in tracks)
+		{
+			Export_MIDI_Track^ Export_Track = raster->Raster_Track_For_Export(Timeline_Track, MIDI_Event_Raster::Capture_Playback_Color_MIDI_Mapping().For_Track(Timeline_Track->Index, Timeline_Track->Octave));
+
+			array<List<Export_MIDI_Color_Note^>^>^ Color_Notes = { Export_Track->Notes_Red, Export_Track->Notes_Green, Export_Track->Notes_Blue };
+
+			for each (List<Export_MIDI_Color_Note^>^ Notes in Color_Notes)
+			{
+				for each (Export_MIDI_Color_Note^ Note in Notes)
+				{
+					// Same reads as the conversion did per note before the mapping was captured
+					Color_MIDI_Mapping Note_Mapping = MIDI_Event_Raster::Capture_Playback_Color_MIDI_Mapping().For_Track(Timeline_Track->Index, Timeline_Track->Octave);
+
+					Playback_OnOff_Pair OnOff_Pair = raster->Color_Note_To_Playback_Events(Note, Note_Mapping);
+
+					output->Add(OnOff_Pair.Note_On);
+					output->Add(OnOff_Pair.Note_Off);
+				}
+
+				Color_Note_Count += Notes->Count;
+			}
+		}
+
+		return Color_Note_Count;
+	}
+
+	int MIDI_Raster_Mapping_Benchmark::Raster_With_Mapping(MIDI_Event_Raster^ raster, List<Track^>^ tracks, Color_MIDI_Mapping mapping, List<Playback_MIDI_Event^>^ output)
+	{
+		int Color_Note_Count = 0;
+
+		for each (Track^ Timeline_Track in tracks)
+		{
+			Color_MIDI_Mapping Track_Mapping = mapping.For_Track(Timeline_Track->Index, Timeline_Track->Octave);
+
+			Export_MIDI_Track^ Export_Track = raster->Raster_Track_For_Export(Timeline_Track, Track_Mapping);
+
+			Add_Color_Notes(raster, Export_Track->Notes_Red, Track_Mapping, output);
+			Add_Color_Notes(raster, Export_Track->Notes_Green, Track_Mapping, output);
+			Add_Color_Notes(raster, Export_Track->Notes_Blue, Track_Mapping, output);
+
+			Color_Note_Count += Export_Track->Notes_Red->Count + Export_Track->Notes_Green->Count + Export_Track->Notes_Blue->Count;
+		}
+
+		return Color_Note_Count;
+	}
+
+	void MIDI_Raster_Mapping_Benchmark::Add_Color_Notes(MIDI_Event_Raster^ raster, List<Export_MIDI_Color_Note^>^ notes, Color_MIDI_Mapping% mapping, List<Playback_MIDI_Event^>^ output)
+	{
+		for each (Export_MIDI_Color_Note^ Note in notes)
+		{
+			Playback_OnOff_Pair OnOff_Pair = raster->Color_Note_To_Playback_Events(Note, mapping);
+
+			output->Add(OnOff_Pair.Note_On);
+			output->Add(OnOff_Pair.Note_Off);
+		}
+	}
+
+	bool MIDI_Raster_Mapping_Benchmark::Events_Equal(List<Playback_MIDI_Event^>^ a, List<Playback_MIDI_Event^>^ b)
+	{
+		if (a->Count != b->Count) {
+			return false;
+		}
+
+		for (int i = 0; i < a->Count; i++)
+		{
+			if (a[i]->Timestamp_ms != b[i]->Timestamp_ms || a[i]->Tick != b[i]->Tick || a[i]->Timeline_Track_ID != b[i]->Timeline_Track_ID || a[i]->MIDI_Channel != b[i]->MIDI_Channel ||
+				a[i]->MIDI_Command != b[i]->MIDI_Command || a[i]->MIDI_Data1 != b[i]->MIDI_Data1 || a[i]->MIDI_Data2 != b[i]->MIDI_Data2) {
+				return false;
+			}
+		}
+
+		return true;
+	}
+}
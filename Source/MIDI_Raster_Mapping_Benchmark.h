@@ -0,0 +1,43 @@
+#pragma once
+
+#include "MIDI_Event_Raster.h"
+
+using namespace System;
+using namespace System::Collections::Generic;
+
+namespace MIDILightDrawer
+{
+	public value struct Raster_Mapping_Benchmark_Report
+	{
+		int Track_Count;
+		int Color_Note_Count;			// Color notes rastered per pass
+		int MIDI_Event_Count;			// Note On and Off events produced per pass
+		int Repetitions;
+		double Settings_Lookup_ms;		// Best pass, mapping read from the settings for every track and color note
+		double Captured_Mapping_ms;		// Best pass, mapping captured once before the pass
+		double Settings_Lookup_ns_Per_Note;
+		double Captured_Mapping_ns_Per_Note;
+		double Speedup;
+		bool Results_Match;				// Both passes produced the same events
+	};
+
+	// Rasters the timeline tracks for playback twice through Raster_Track_For_Export and Color_Note_To_Playback_Events:
+	// once reading the color mapping from the settings singleton for every track and every color note, as the
+	// rasterizer used to, once with a Color_MIDI_Mapping captured before the pass. Both passes raster and allocate the
+	// same events, the difference is the lookup. Run from the debug menu on the loaded timeline
+	public ref class MIDI_Raster_Mapping_Benchmark
+	{
+	public:
+		static const int DEFAULT_REPETITIONS = 5;
+
+		static Raster_Mapping_Benchmark_Report Run(MIDI_Event_Raster^ raster, List<Track^>^ tracks, int repetitions);
+		static Raster_Mapping_Benchmark_Report Run(MIDI_Event_Raster^ raster, List<Track^>^ tracks);
+		static String^ Format_Report(Raster_Mapping_Benchmark_Report report);
+
+	private:
+		static int Raster_With_Settings_Lookup(MIDI_Event_Raster^ raster, List<Track^>^ tracks, List<Playback_MIDI_Event^>^ output);
+		static int Raster_With_Mapping(MIDI_Event_Raster^ raster, List<Track^>^ tracks, Color_MIDI_Mapping mapping, List<Playback_MIDI_Event^>^ output);
+		static void Add_Color_Notes(MIDI_Event_Raster^ raster, List<Export_MIDI_Color_Note^>^ notes, Color_MIDI_Mapping% mapping, List<Playback_MIDI_Event^>^ output);
+		static bool Events_Equal(List<Playback_MIDI_Event^>^ a, List<Playback_MIDI_Event^>^ b);
+	};
+}
@@ -0,0 +1,105 @@
+#ifdef _MSC_VER
+#pragma managed(push, off)
+#endif
+
+#include "Playback_Audio_Clock.h"
+
+namespace MIDILightDrawer
+{
+	Playback_Audio_Clock::Playback_Audio_Clock()
+	{
+		_Sequence.store(0);
+		_Audio_Position_us.store(0);
+		_Host_Time_us.store(0);
+		_Is_Valid.store(false);
+	}
+
+	void Playback_Audio_Clock::Publish(int64_t audio_position_us, int64_t host_time_us)
+	{
+		uint32_t Sequence = _Sequence.load(std::memory_order_relaxed);
+
+		_Sequence.store(Sequence + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+
+		_Audio_Position_us.store(audio_position_us, std::memory_order_relaxed);
+		_Host_Time_us.store(host_time_us, std::memory_order_relaxed);
+		_Is_Valid.store(true, std::memory_order_relaxed);
+
+		_Sequence.store(Sequence + 2, std::memory_order_release);
+	}
+
+	void Playback_Audio_Clock::Invalidate()
+	{
+		uint32_t Sequence = _Sequence.load(std::memory_order_relaxed);
+
+		_Sequence.store(Sequence + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+
+		_Is_Valid.store(false, std::memory_order_relaxed);
+
+		_Sequence.store(Sequence + 2, std::memory_order_release);
+	}
+
+	bool Playback_Audio_Clock::Get_Anchor(Anchor& anchor) const
+	{
+		while (true)
+		{
+			uint32_t Sequence_Before = _Sequence.load(std::memory_order_acquire);
+
+			if (Sequence_Before & 1) {
+				continue;	// Writer is in the middle of an update
+			}
+
+			bool Is_Valid = _Is_Valid.load(std::memory_order_relaxed);
+			anchor.Audio_Position_us = _Audio_Position_us.load(std::memory_order_relaxed);
+			anchor.Host_Time_us = _Host_Time_us.load(std::memory_order_relaxed);
+
+			std::atomic_thread_fence(std::memory_order_acquire);
+
+			if (_Sequence.load(std::memory_order_relaxed) == Sequence_Before) {
+				return Is_Valid;
+			}
+		}
+	}
+
+	bool Playback_Audio_Clock::Get_Position_us(int64_t host_time_us, int64_t& position_us) const
+	{
+		Anchor Current_Anchor;
+
+		if (!Get_Anchor(Current_Anchor)) {
+			return false;
+		}
+
+		position_us = Interpolate_us(Current_Anchor, host_time_us);
+
+		return true;
+	}
+
+	int64_t Playback_Audio_Clock::Interpolate_us(const Anchor& anchor, int64_t host_time_us)
+	{
+		int64_t Elapsed_us = host_time_us - anchor.Host_Time_us;
+
+		if (Elapsed_us > MAX_EXTRAPOLATION_US) {
+			Elapsed_us = MAX_EXTRAPOLATION_US;
+		}
+
+		return anchor.Audio_Position_us + Elapsed_us;
+	}
+
+	int64_t Playback_Audio_Clock::Device_Position_To_us(uint64_t device_position, uint64_t device_frequency)
+	{
+		if (device_frequency == 0) {
+			return 0;
+		}
+
+		// Split to avoid overflowing the multiplication on long streams
+		uint64_t Seconds = device_position / device_frequency;
+		uint64_t Remainder = device_position % device_frequency;
+
+		return (int64_t)(Seconds * 1000000ULL + (Remainder * 1000000ULL) / device_frequency);
+	}
+}
+
+#ifdef _MSC_VER
+#pragma managed(pop)
+#endif
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace MIDILightDrawer
+{
+	// Maps host time to the audio timeline. The audio thread publishes pairs of the position the device has played
+	// and the host time it was sampled at, any other thread interpolates the audio position between two publications.
+	// Host time has to come from the same time base as the IClock of the scheduler
+	class Playback_Audio_Clock
+	{
+	public:
+		struct Anchor
+		{
+			int64_t Audio_Position_us;
+			int64_t Host_Time_us;
+		};
+
+		// Interpolation stops this far after the last anchor, e.g. when the audio thread stalls or the stream ran dry
+		static const int64_t MAX_EXTRAPOLATION_US = 100000;
+
+	private:
+		// Seqlock: odd while the writer updates the anchor
+		std::atomic<uint32_t> _Sequence;
+		std::atomic<int64_t> _Audio_Position_us;
+		std::atomic<int64_t> _Host_Time_us;
+		std::atomic<bool> _Is_Valid;
+
+	public:
+		Playback_Audio_Clock();
+
+		// Writer side, audio thread only
+		void Publish(int64_t audio_position_us, int64_t host_time_us);
+		void Invalidate();
+
+		// Reader side, any thread. Returns false if no anchor was published since the last Invalidate
+		bool Get_Anchor(Anchor& anchor) const;
+		bool Get_Position_us(int64_t host_time_us, int64_t& position_us) const;
+
+		static int64_t Interpolate_us(const Anchor& anchor, int64_t host_time_us);
+		static int64_t Device_Position_To_us(uint64_t device_position, uint64_t device_frequency);
+	};
+}
@@ -32,6 +32,7 @@ namespace MIDILightDrawer
 	void* Playback_Audio_Engine_Native::_Audio_Client = nullptr;
 	void* Playback_Audio_Engine_Native::_Render_Client = nullptr;
 	void* Playback_Audio_Engine_Native::_Audio_Event = nullptr;
+	void* Playback_Audio_Engine_Native::_Audio_Clock = nullptr;
 	float* Playback_Audio_Engine_Native::_Audio_Buffer = nullptr;
 	int Playback_Audio_Engine_Native::_Audio_Buffer_Size = 0;
 	int Playback_Audio_Engine_Native::_Audio_Sample_Rate_WASAPI = 0;
@@ -53,6 +54,8 @@ namespace MIDILightDrawer
 	std::mutex Playback_Audio_Engine_Native::_Buffer_Mutex;
 	int64_t Playback_Audio_Engine_Native::_Total_Audio_Samples = 0;
 	int64_t Playback_Audio_Engine_Native::_Current_Sample_Position = 0;
+	int64_t Playback_Audio_Engine_Native::_Stream_Start_Sample_Position = 0;
+	Playback_Audio_Clock Playback_Audio_Engine_Native::_Render_Clock;
 
 	bool Playback_Audio_Engine_Native::Initialize(const wchar_t* device_id, int buffer_size_samples)
 	{
@@ -309,6 +312,12 @@ namespace MIDILightDrawer
 			_Current_Position_ms.store(0.0);
 		}
 
+		// The client was reset by the last stop, its device position starts at 0 again
+		{
+			std::lock_guard<std::mutex> Lock(_Buffer_Mutex);
+			_Stream_Start_Sample_Position = _Current_Sample_Position;
+		}
+
 		_Should_Stop.store(false);
 		_Is_Playing.store(true);
 
@@ -356,8 +365,11 @@ namespace MIDILightDrawer
 
 		// Reset position
 		_Current_Sample_Position = 0;
+		_Stream_Start_Sample_Position = 0;
 		_Current_Position_ms.store(0.0);
 
+		_Render_Clock.Invalidate();
+
 		return true;
 	}
 
@@ -372,6 +384,9 @@ namespace MIDILightDrawer
 		// Stop WASAPI (but don't reset position)
 		((IAudioClient*)_Audio_Client)->Stop();
 
+		// The device position holds while stopped, but the host time keeps running
+		_Render_Clock.Invalidate();
+
 		// Do NOT set _Should_Stop or kill thread
 		// Thread stays alive, waiting for resume
 
@@ -387,6 +402,11 @@ namespace MIDILightDrawer
 		// If thread doesn't exist, start it
 		if (_Audio_Thread == nullptr) {
 			// Thread was stopped - need to restart it completely
+			{
+				std::lock_guard<std::mutex> Lock(_Buffer_Mutex);
+				_Stream_Start_Sample_Position = _Current_Sample_Position;
+			}
+
 			_Should_Stop.store(false);
 			_Is_Playing.store(true);
 
@@ -428,9 +448,14 @@ namespace MIDILightDrawer
 			_Is_Playing.store(false);
 			if (_Audio_Client) {
 				((IAudioClient*)_Audio_Client)->Stop();
-				((IAudioClient*)_Audio_Client)->Reset();
 			}
 		}
+
+		// Also when paused: drops the audio queued for the old position and restarts the device position at 0.
+		// Fails harmlessly if the client was never started
+		if (_Audio_Client) {
+			((IAudioClient*)_Audio_Client)->Reset();
+		}
 		
 		{
 			std::lock_guard<std::mutex> Lock(_Buffer_Mutex);
@@ -440,7 +465,11 @@ namespace MIDILightDrawer
 			New_Sample_Position = std::min(New_Sample_Position, _Total_Audio_Samples);
 
 			_Current_Sample_Position = New_Sample_Position;
+			_Stream_Start_Sample_Position = New_Sample_Position;
 			_Current_Position_ms.store(position_ms);
+
+			// Under the lock, so the audio thread cannot publish an anchor of the old position afterwards
+			_Render_Clock.Invalidate();
 		}
 
 		// Resume if it was playing
@@ -582,16 +611,29 @@ namespace MIDILightDrawer
 		return _Total_Audio_Samples;
 	}
 
+	const Playback_Audio_Clock* Playback_Audio_Engine_Native::Get_Render_Clock()
+	{
+		return &_Render_Clock;
+	}
+
 	void Playback_Audio_Engine_Native::Audio_Playback_Thread_Function()
 	{
 		IAudioClient* Audio_Client = (IAudioClient*)_Audio_Client;
 		IAudioRenderClient* Render_Client = (IAudioRenderClient*)_Render_Client;
+		IAudioClock* Audio_Clock = (IAudioClock*)_Audio_Clock;
 		HANDLE Audio_Event = (HANDLE)_Audio_Event;
 
 		if (!Audio_Client || !Render_Client || !Audio_Event) {
 			return;
 		}
 
+		// Units of the device position reported by the render clock
+		UINT64 Device_Frequency = 0;
+
+		if (Audio_Clock != nullptr && FAILED(Audio_Clock->GetFrequency(&Device_Frequency))) {
+			Device_Frequency = 0;
+		}
+
 		// Get buffer frame count
 		UINT32 Buffer_Frame_Count = 0;
 		Audio_Client->GetBufferSize(&Buffer_Frame_Count);
@@ -726,9 +768,25 @@ namespace MIDILightDrawer
 
 				double Position_Ms = (_Current_Sample_Position * 1000.0) / _Audio_Sample_Rate_File;
 
-				// Account for hardware latency
-				int64_t Hardware_Latency_Samples = Buffer_Frame_Count / 2;
-				Position_Ms -= (Hardware_Latency_Samples * 1000.0) / _Audio_Sample_Rate_File;
+				UINT64 Device_Position = 0;
+				UINT64 QPC_Position = 0;
+
+				if (Device_Frequency > 0 && SUCCEEDED(Audio_Clock->GetPosition(&Device_Position, &QPC_Position)))
+				{
+					// What the device has actually played, together with the QPC time it was sampled at (in 100 ns units)
+					int64_t Stream_Start_us = (_Stream_Start_Sample_Position * 1000000LL) / _Audio_Sample_Rate_File;
+					int64_t Played_us = Stream_Start_us + Playback_Audio_Clock::Device_Position_To_us(Device_Position, Device_Frequency);
+
+					_Render_Clock.Publish(Played_us, (int64_t)(QPC_Position / 10));
+
+					Position_Ms = Played_us / 1000.0;
+				}
+				else
+				{
+					// Account for hardware latency
+					int64_t Hardware_Latency_Samples = Buffer_Frame_Count / 2;
+					Position_Ms -= (Hardware_Latency_Samples * 1000.0) / _Audio_Sample_Rate_File;
+				}
 
 				if (Position_Ms < 0.0) Position_Ms = 0.0;
 
@@ -860,9 +918,17 @@ namespace MIDILightDrawer
 			return false;
 		}
 
+		// Render clock for the played position, playback works without it
+		IAudioClock* Audio_Clock = nullptr;
+		Hr = Audio_Client->GetService(__uuidof(IAudioClock), (void**)&Audio_Clock);
+		if (FAILED(Hr)) {
+			Audio_Clock = nullptr;
+		}
+
 		// Store interfaces as void pointers
 		_Audio_Client = (void*)Audio_Client;
 		_Render_Client = (void*)Render_Client;
+		_Audio_Clock = (void*)Audio_Clock;
 		_Audio_Event = (void*)Audio_Event;
 
 		_Is_Initialized = true;
@@ -872,6 +938,11 @@ namespace MIDILightDrawer
 	void Playback_Audio_Engine_Native::Cleanup_WASAPI()
 	{
 		// Release WASAPI resources
+		if (_Audio_Clock) {
+			((IAudioClock*)_Audio_Clock)->Release();
+			_Audio_Clock = nullptr;
+		}
+
 		if (_Render_Client) {
 			((IAudioRenderClient*)_Render_Client)->Release();
 			_Render_Client = nullptr;
@@ -5,6 +5,8 @@
 #include <mutex>
 #include <vector>
 
+#include "Playback_Audio_Clock.h"
+
 namespace MIDILightDrawer
 {
 	class Playback_Audio_Engine_Native
@@ -22,6 +24,7 @@ namespace MIDILightDrawer
 		static void* _Audio_Client;				// IAudioClient*
 		static void* _Render_Client;			// IAudioRenderClient*
 		static void* _Audio_Event;				// HANDLE for event-driven mode
+		static void* _Audio_Clock;				// IAudioClock*, optional
 		static float* _Audio_Buffer;			// Decoded PCM buffer (interleaved)
 		static int _Audio_Buffer_Size;			// WASAPI buffer size
 		static int _Audio_Sample_Rate_WASAPI;	// WASAPI output sample rate
@@ -46,6 +49,10 @@ namespace MIDILightDrawer
 		// Audio buffer management
 		static int64_t _Total_Audio_Samples;       // Total samples in file (per channel)
 		static int64_t _Current_Sample_Position;   // Current playback position (in samples)
+		static int64_t _Stream_Start_Sample_Position;	// Playback position at device position 0, set whenever the client is reset
+
+		// Played position published from the render clock for the MIDI scheduler
+		static Playback_Audio_Clock _Render_Clock;
 
 	public:
 		static bool Initialize(const wchar_t* device_id, int buffer_size_samples);
@@ -75,6 +82,7 @@ namespace MIDILightDrawer
 		static bool Get_Audio_Samples(int64_t start_sample, int64_t sample_count, float* output_buffer);
 		static float* Get_Audio_Buffer_Pointer();
 		static int64_t Get_Sample_Count();
+		static const Playback_Audio_Clock* Get_Render_Clock();
 
 	private:
 		// Thread function
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstdint>
+
+namespace MIDILightDrawer
+{
+	// Time source and sleep primitive of the MIDI scheduler
+	class IClock
+	{
+	public:
+		virtual ~IClock() {}
+
+		// Monotonic time in microseconds, the origin is implementation defined
+		virtual int64_t Now_us() = 0;
+
+		// Blocks for up to timeout_us. Returns early when Wake was called, also if it was called before the wait started
+		virtual void Wait_For_us(int64_t timeout_us) = 0;
+		virtual void Wake() = 0;
+	};
+}
@@ -0,0 +1,46 @@
+#ifdef _MSC_VER
+#pragma managed(push, off)
+#endif
+
+#include "Playback_Clock_Steady.h"
+
+#include <chrono>
+
+namespace MIDILightDrawer
+{
+	Playback_Clock_Steady::Playback_Clock_Steady()
+	{
+		_Wake_Pending = false;
+	}
+
+	int64_t Playback_Clock_Steady::Now_us()
+	{
+		return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	void Playback_Clock_Steady::Wait_For_us(int64_t timeout_us)
+	{
+		if (timeout_us <= 0) {
+			return;
+		}
+
+		std::unique_lock<std::mutex> Lock(_Wake_Mutex);
+
+		_Wake_Condition.wait_for(Lock, std::chrono::microseconds(timeout_us), [this] { return _Wake_Pending; });
+		_Wake_Pending = false;
+	}
+
+	void Playback_Clock_Steady::Wake()
+	{
+		{
+			std::lock_guard<std::mutex> Lock(_Wake_Mutex);
+			_Wake_Pending = true;
+		}
+
+		_Wake_Condition.notify_one();
+	}
+}
+
+#ifdef _MSC_VER
+#pragma managed(pop)
+#endif
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <mutex>
+#include <condition_variable>
+
+#include "Playback_Clock.h"
+
+namespace MIDILightDrawer
+{
+	// Portable clock on std::chrono::steady_clock, sleeps on a condition variable.
+	// Used where the Windows clock is not available, e.g. with the ALSA output
+	class Playback_Clock_Steady : public IClock
+	{
+	private:
+		std::mutex _Wake_Mutex;
+		std::condition_variable _Wake_Condition;
+		bool _Wake_Pending;
+
+	public:
+		Playback_Clock_Steady();
+
+		int64_t Now_us() override;
+		void Wait_For_us(int64_t timeout_us) override;
+		void Wake() override;
+	};
+}
@@ -0,0 +1,120 @@
+#ifdef _MSC_VER
+#pragma managed(push, off)
+#endif
+
+#include "Playback_Clock_Sync_Filter.h"
+
+namespace MIDILightDrawer
+{
+	// Loop bandwidth of a few updates: follows drift within about a second, spreads a single late observation over many updates
+	const double Playback_Clock_Sync_Filter::POSITION_GAIN = 0.1;
+	const double Playback_Clock_Sync_Filter::RATE_GAIN = 0.005;
+	const double Playback_Clock_Sync_Filter::MAX_RATE_DEVIATION = 0.05;
+
+	Playback_Clock_Sync_Filter::Playback_Clock_Sync_Filter()
+	{
+		_Resync_Count = 0;
+		Reset();
+	}
+
+	void Playback_Clock_Sync_Filter::Reset()
+	{
+		_Is_Locked = false;
+		_Position_us = 0.0;
+		_Host_Time_us = 0;
+		_Rate = 1.0;
+		_Last_Output_us = INT64_MIN;
+	}
+
+	void Playback_Clock_Sync_Filter::Update(int64_t audio_position_us, int64_t host_time_us)
+	{
+		if (!_Is_Locked)
+		{
+			_Position_us = (double)audio_position_us;
+			_Host_Time_us = host_time_us;
+			_Is_Locked = true;
+			return;
+		}
+
+		int64_t Elapsed_us = host_time_us - _Host_Time_us;
+
+		if (Elapsed_us <= 0) {
+			return;		// Out of order or repeated observation
+		}
+
+		double Predicted_us = _Position_us + _Rate * (double)Elapsed_us;
+		double Error_us = (double)audio_position_us - Predicted_us;
+
+		if (Error_us > RESYNC_THRESHOLD_US || Error_us < -RESYNC_THRESHOLD_US)
+		{
+			// Jump of the audio timeline, start over from the observation
+			_Resync_Count++;
+
+			Reset();
+			_Position_us = (double)audio_position_us;
+			_Host_Time_us = host_time_us;
+			_Is_Locked = true;
+			return;
+		}
+
+		_Position_us = Predicted_us + POSITION_GAIN * Error_us;
+		_Rate += RATE_GAIN * Error_us / (double)Elapsed_us;
+		_Host_Time_us = host_time_us;
+
+		if (_Rate > 1.0 + MAX_RATE_DEVIATION) {
+			_Rate = 1.0 + MAX_RATE_DEVIATION;
+		}
+		else if (_Rate < 1.0 - MAX_RATE_DEVIATION) {
+			_Rate = 1.0 - MAX_RATE_DEVIATION;
+		}
+	}
+
+	bool Playback_Clock_Sync_Filter::Get_Position_us(int64_t host_time_us, int64_t& position_us)
+	{
+		if (!_Is_Locked) {
+			return false;
+		}
+
+		int64_t Predicted_us = (int64_t)Predict_us(host_time_us);
+
+		// A correction pulling the estimate back is absorbed by holding the position until the estimate catches up
+		if (Predicted_us < _Last_Output_us) {
+			Predicted_us = _Last_Output_us;
+		}
+
+		_Last_Output_us = Predicted_us;
+		position_us = Predicted_us;
+
+		return true;
+	}
+
+	bool Playback_Clock_Sync_Filter::Is_Locked() const
+	{
+		return _Is_Locked;
+	}
+
+	double Playback_Clock_Sync_Filter::Get_Rate() const
+	{
+		return _Rate;
+	}
+
+	uint64_t Playback_Clock_Sync_Filter::Get_Resync_Count() const
+	{
+		return _Resync_Count;
+	}
+
+	double Playback_Clock_Sync_Filter::Predict_us(int64_t host_time_us) const
+	{
+		int64_t Elapsed_us = host_time_us - _Host_Time_us;
+
+		if (Elapsed_us > MAX_EXTRAPOLATION_US) {
+			Elapsed_us = MAX_EXTRAPOLATION_US;
+		}
+
+		return _Position_us + _Rate * (double)Elapsed_us;
+	}
+}
+
+#ifdef _MSC_VER
+#pragma managed(pop)
+#endif
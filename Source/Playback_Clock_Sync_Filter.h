@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+
+namespace MIDILightDrawer
+{
+	// Recovers a smooth audio timeline from noisy (audio position, host time) observations. A second order tracking loop
+	// (alpha-beta filter, the discrete form of a PLL) estimates the position offset and the rate of the audio clock
+	// against the host clock. Get_Position_us never runs backwards unless the filter was reset by a seek.
+	// Not thread safe, owned by the thread that reads the position
+	class Playback_Clock_Sync_Filter
+	{
+	public:
+		// Share of the position error corrected on each observation, and its integral part that trims the rate
+		static const double POSITION_GAIN;
+		static const double RATE_GAIN;
+
+		// Errors beyond this are a seek or a stall, not jitter. The filter locks to the new position immediately
+		static const int64_t RESYNC_THRESHOLD_US = 50000;
+
+		// Estimated rates are kept in this range around 1.0
+		static const double MAX_RATE_DEVIATION;
+
+		// Prediction stops this far after the last observation
+		static const int64_t MAX_EXTRAPOLATION_US = 100000;
+
+	private:
+		bool _Is_Locked;
+		double _Position_us;		// Estimated audio position at _Host_Time_us
+		int64_t _Host_Time_us;
+		double _Rate;				// Audio microseconds per host microsecond
+		int64_t _Last_Output_us;
+		uint64_t _Resync_Count;
+
+	public:
+		Playback_Clock_Sync_Filter();
+
+		void Reset();
+		void Update(int64_t audio_position_us, int64_t host_time_us);
+
+		// Returns false until the first observation after a reset
+		bool Get_Position_us(int64_t host_time_us, int64_t& position_us);
+
+		bool Is_Locked() const;
+		double Get_Rate() const;
+		uint64_t Get_Resync_Count() const;
+
+	private:
+		double Predict_us(int64_t host_time_us) const;
+	};
+}
@@ -0,0 +1,54 @@
+#ifdef _MSC_VER
+#pragma managed(push, off)
+#endif
+
+#include "Playback_Clock_Virtual.h"
+
+namespace MIDILightDrawer
+{
+	Playback_Clock_Virtual::Playback_Clock_Virtual(int64_t start_us)
+	{
+		_Now_us.store(start_us);
+		_Wake_Pending.store(false);
+	}
+
+	int64_t Playback_Clock_Virtual::Now_us()
+	{
+		return _Now_us.fetch_add(READ_STEP_US, std::memory_order_relaxed);
+	}
+
+	void Playback_Clock_Virtual::Wait_For_us(int64_t timeout_us)
+	{
+		if (timeout_us <= 0) {
+			return;
+		}
+
+		// A wake-up ends the wait right away, like on a real clock the time until then has not passed
+		if (_Wake_Pending.exchange(false, std::memory_order_acq_rel)) {
+			return;
+		}
+
+		_Now_us.fetch_add(timeout_us, std::memory_order_relaxed);
+	}
+
+	void Playback_Clock_Virtual::Wake()
+	{
+		_Wake_Pending.store(true, std::memory_order_release);
+	}
+
+	int64_t Playback_Clock_Virtual::Peek_us() const
+	{
+		return _Now_us.load(std::memory_order_relaxed);
+	}
+
+	void Playback_Clock_Virtual::Advance_us(int64_t duration_us)
+	{
+		if (duration_us > 0) {
+			_Now_us.fetch_add(duration_us, std::memory_order_relaxed);
+		}
+	}
+}
+
+#ifdef _MSC_VER
+#pragma managed(pop)
+#endif
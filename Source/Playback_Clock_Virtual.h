@@ -0,0 +1,32 @@
+#pragma once
+
+#include <atomic>
+
+#include "Playback_Clock.h"
+
+namespace MIDILightDrawer
+{
+	// Simulated time for offline runs. A wait moves the time forward by its full timeout instead of sleeping,
+	// every reading moves it by READ_STEP_US, so busy waits end as well.
+	// Driven by a single thread the run is deterministic and as fast as the code allows
+	class Playback_Clock_Virtual : public IClock
+	{
+	public:
+		static const int64_t READ_STEP_US = 1;
+
+	private:
+		std::atomic<int64_t> _Now_us;
+		std::atomic<bool> _Wake_Pending;
+
+	public:
+		Playback_Clock_Virtual(int64_t start_us = 0);
+
+		int64_t Now_us() override;
+		void Wait_For_us(int64_t timeout_us) override;
+		void Wake() override;
+
+		// Current time without moving it
+		int64_t Peek_us() const;
+		void Advance_us(int64_t duration_us);
+	};
+}
@@ -0,0 +1,89 @@
+#pragma managed(push, off)
+
+#include "Playback_Clock_Windows.h"
+
+#ifdef _WIN32
+
+#include <Windows.h>
+
+// Available since Windows 10 1803, older SDKs do not define it
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+
+namespace MIDILightDrawer
+{
+	Playback_Clock_Windows::Playback_Clock_Windows()
+	{
+		LARGE_INTEGER Frequency;
+		QueryPerformanceFrequency(&Frequency);
+		_Frequency = Frequency.QuadPart;
+
+		// Auto-reset event for early wake-ups, high resolution timer for the regular ones
+		_Wake_Event = CreateEvent(NULL, FALSE, FALSE, NULL);
+		_Wake_Timer = CreateWaitableTimerEx(NULL, NULL, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+
+		if (_Wake_Timer == NULL) {
+			_Wake_Timer = CreateWaitableTimer(NULL, FALSE, NULL);
+		}
+	}
+
+	Playback_Clock_Windows::~Playback_Clock_Windows()
+	{
+		if (_Wake_Timer != nullptr) {
+			CloseHandle((HANDLE)_Wake_Timer);
+			_Wake_Timer = nullptr;
+		}
+
+		if (_Wake_Event != nullptr) {
+			CloseHandle((HANDLE)_Wake_Event);
+			_Wake_Event = nullptr;
+		}
+	}
+
+	int64_t Playback_Clock_Windows::Now_us()
+	{
+		LARGE_INTEGER Counter;
+		QueryPerformanceCounter(&Counter);
+
+		// Split to avoid overflowing the multiplication on long uptimes
+		int64_t Seconds = Counter.QuadPart / _Frequency;
+		int64_t Remainder = Counter.QuadPart % _Frequency;
+
+		return Seconds * 1000000LL + (Remainder * 1000000LL) / _Frequency;
+	}
+
+	void Playback_Clock_Windows::Wait_For_us(int64_t timeout_us)
+	{
+		if (timeout_us <= 0) {
+			return;
+		}
+
+		if (_Wake_Timer == nullptr || _Wake_Event == nullptr) {
+			Sleep((DWORD)((timeout_us + 999) / 1000));
+			return;
+		}
+
+		// Relative due time in 100ns units
+		LARGE_INTEGER Due_Time;
+		Due_Time.QuadPart = -(timeout_us * 10LL);
+
+		SetWaitableTimer((HANDLE)_Wake_Timer, &Due_Time, 0, NULL, NULL, FALSE);
+
+		HANDLE Handles[2] = { (HANDLE)_Wake_Event, (HANDLE)_Wake_Timer };
+		WaitForMultipleObjects(2, Handles, FALSE, INFINITE);
+
+		CancelWaitableTimer((HANDLE)_Wake_Timer);
+	}
+
+	void Playback_Clock_Windows::Wake()
+	{
+		if (_Wake_Event != nullptr) {
+			SetEvent((HANDLE)_Wake_Event);
+		}
+	}
+}
+
+#endif
+
+#pragma managed(pop)
@@ -0,0 +1,23 @@
+#pragma once
+
+#include "Playback_Clock.h"
+
+namespace MIDILightDrawer
+{
+	// QueryPerformanceCounter time, sleeps on a high resolution waitable timer that an event can interrupt
+	class Playback_Clock_Windows : public IClock
+	{
+	private:
+		int64_t _Frequency;
+		void* _Wake_Event;
+		void* _Wake_Timer;
+
+	public:
+		Playback_Clock_Windows();
+		~Playback_Clock_Windows();
+
+		int64_t Now_us() override;
+		void Wait_For_us(int64_t timeout_us) override;
+		void Wake() override;
+	};
+}
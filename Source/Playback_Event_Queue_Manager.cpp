@@ -4,21 +4,18 @@
 
 namespace MIDILightDrawer
 {
-	Playback_Event_Queue_Manager::Playback_Event_Queue_Manager(Playback_MIDI_Engine^ midi_engine, MIDI_Event_Raster^ midi_event_raster, Form_MIDI_Log^ form_midi_log)
+	Playback_Event_Queue_Manager::Playback_Event_Queue_Manager(Playback_MIDI_Engine^ midi_engine, MIDI_Event_Raster^ midi_event_raster)
 	{
 		_MIDI_Engine = midi_engine;
 		_MIDI_Event_Raster = midi_event_raster;
-		_Form_MIDI_Log = form_midi_log;
 		_Unfiltered_Events = gcnew List<Playback_MIDI_Event^>();
-		_Filtered_Events = gcnew List<Playback_MIDI_Event^>();
 		_Current_Muted_Tracks = gcnew List<int>();
 		_Current_Soloed_Tracks = gcnew List<int>();
-		_Active_Notes = gcnew List<Active_Note>();
-		_Active_Notes_Lock = gcnew Object();
+		_Active_Notes = new Playback_MIDI_Active_Notes();
 		_Timeline_Tracks = nullptr;
 		_Timeline_Measures = nullptr;
-		_Global_MIDI_Channel = 0;
 		_Cache_Valid = false;
+		_Schedule_Loaded = false;
 	}
 
 	Playback_Event_Queue_Manager::~Playback_Event_Queue_Manager()
@@ -26,9 +23,17 @@ namespace MIDILightDrawer
 		// Send Note Off for any remaining active notes
 		Send_All_Active_Notes_Off();
 		Clear_Cache();
+
+		this->!Playback_Event_Queue_Manager();
+	}
+
+	Playback_Event_Queue_Manager::!Playback_Event_Queue_Manager()
+	{
+		delete _Active_Notes;
+		_Active_Notes = nullptr;
 	}
 
-	bool Playback_Event_Queue_Manager::Raster_And_Cache_Events(List<Track^>^ tracks, List<Measure^>^ measures, List<int>^ muted_tracks, List<int>^ soloed_tracks, uint8_t global_midi_channel)
+	bool Playback_Event_Queue_Manager::Raster_And_Cache_Events(List<Track^>^ tracks, List<Measure^>^ measures, List<int>^ muted_tracks, List<int>^ soloed_tracks)
 	{
 		if (!tracks || !measures)
 		{
@@ -40,20 +45,10 @@ namespace MIDILightDrawer
 			// Store timeline references for real-time filtering
 			_Timeline_Tracks = tracks;
 			_Timeline_Measures = measures;
-			_Global_MIDI_Channel = global_midi_channel;
 
-			// Raster ALL tracks WITHOUT filtering (pass empty lists)
+			// Raster ALL tracks WITHOUT filtering
 			// This allows us to filter dynamically during playback
-			List<int>^ Empty_Muted = gcnew List<int>();
-			List<int>^ Empty_Soloed = gcnew List<int>();
-
 			List<Playback_MIDI_Event^>^ Rastered_Events = _MIDI_Event_Raster->Raster_Timeline_For_Playback();
-			//List<Playback_MIDI_Event^>^ Rastered_Events = _MIDI_Event_Raster->Get_Timeline_PreRastered_Playback_Events(
-			//	tracks,
-			//	Empty_Muted,    // Don't filter during rastering
-			//	Empty_Soloed,   // We'll filter later
-			//	global_midi_channel
-			//);
 
 			if (!Rastered_Events) {
 				return false;
@@ -62,6 +57,7 @@ namespace MIDILightDrawer
 			// Store the unfiltered events
 			_Unfiltered_Events->Clear();
 			_Unfiltered_Events->AddRange(Rastered_Events);
+			_Schedule_Loaded = false;
 
 			// Update current track state
 			_Current_Muted_Tracks->Clear();
@@ -75,19 +71,11 @@ namespace MIDILightDrawer
 				_Current_Soloed_Tracks->AddRange(soloed_tracks);
 			}
 
-			// Apply initial filtering
-			Apply_Track_Filtering(_Current_Muted_Tracks, _Current_Soloed_Tracks);
+			// Apply initial mute and solo state
+			Apply_Track_Mask(_Current_Muted_Tracks, _Current_Soloed_Tracks);
 
 			// Clear any old active notes
-			System::Threading::Monitor::Enter(_Active_Notes_Lock);
-			try
-			{
-				_Active_Notes->Clear();
-			}
-			finally
-			{
-				System::Threading::Monitor::Exit(_Active_Notes_Lock);
-			}
+			_Active_Notes->Clear();
 
 			// Mark cache as valid
 			_Cache_Valid = true;
@@ -108,52 +96,16 @@ namespace MIDILightDrawer
 			return false;
 		}
 
-		if (_Filtered_Events->Count == 0) {
-			// No events to queue (empty timeline or all tracks muted)
-			return true;
-		}
-
 		try
 		{
-			// Clear any existing events in the MIDI engine
-			_MIDI_Engine->Clear_Event_Queue();
+			// The schedule only changes with the filtered events, a start at another position reuses it
+			if (!_Schedule_Loaded) {
+				Load_Schedule();
+			}
 
-			// Use Dictionary to track Note Ons that will be played (for filtering orphan Note Offs)
-			// Key format: "TrackID_Channel_NoteNumber"
-			Dictionary<String^, int>^ Active_Notes_Set = gcnew Dictionary<String^, int>();
+			// The engine binary-searches its cursor and switches on the notes still sounding at the start position
+			_MIDI_Engine->Set_Current_Position_ms(start_position_ms);
 
-			// Single pass: queue events and track active notes
-			for each (Playback_MIDI_Event^ Event in _Filtered_Events)
-			{
-				if (Event->Timestamp_ms < start_position_ms) {
-					continue;
-				}
-
-				unsigned char Command_Type = Event->MIDI_Command & 0xF0;
-				String^ Note_Key = String::Format("{0}_{1}_{2}", Event->Timeline_Track_ID, Event->MIDI_Channel, Event->MIDI_Data1);
-
-				if (Command_Type == 0x90 && Event->MIDI_Data2 > 0)
-				{
-					// Note On - queue and track
-					Active_Notes_Set[Note_Key] = 1;
-					_MIDI_Engine->Queue_Event(Event);
-				}
-				else if (Command_Type == 0x80 || (Command_Type == 0x90 && Event->MIDI_Data2 == 0))
-				{
-					// Note Off - only queue if matching Note On was queued
-					if (Active_Notes_Set->ContainsKey(Note_Key))
-					{
-						Active_Notes_Set->Remove(Note_Key);
-						_MIDI_Engine->Queue_Event(Event);
-					}
-					// else: orphan Note Off, skip it
-				}
-				else
-				{
-					// Other MIDI events (CC, etc.) - queue normally
-					_MIDI_Engine->Queue_Event(Event);
-				}
-			}
 			return true;
 		}
 		catch (...)
@@ -172,14 +124,10 @@ namespace MIDILightDrawer
 
 		try
 		{
-			// Get list of tracks that changed state
-			List<int>^ Changed_Tracks = Get_Changed_Tracks(_Current_Muted_Tracks, _Current_Soloed_Tracks, new_muted_tracks, new_soloed_tracks);
-
-			// Send Note Off for active notes on tracks that are being muted/de-soloed
-			if (Changed_Tracks->Count > 0)
-			{
-				Send_Active_Notes_Off_For_Tracks(Changed_Tracks);
-			}
+			// Every track is set again: a solo switches off all other tracks, not only the ones in the lists.
+			// The engine only acts on tracks whose state changes, the playback thread sends the Note Offs of a
+			// disabled track and restores the sounding notes of an enabled one. The schedule stays as it is
+			Apply_Track_Mask(new_muted_tracks, new_soloed_tracks);
 
 			// Update current state
 			_Current_Muted_Tracks->Clear();
@@ -195,101 +143,106 @@ namespace MIDILightDrawer
 				_Current_Soloed_Tracks->AddRange(new_soloed_tracks);
 			}
 
-			// Re-filter events based on new state
-			Apply_Track_Filtering(_Current_Muted_Tracks, _Current_Soloed_Tracks);
+			return true;
+		}
+		catch (...)
+		{
+			// Log error if needed
+			return false;
+		}
+	}
 
-			// Clear MIDI engine queue
-			_MIDI_Engine->Clear_Event_Queue();
+	bool Playback_Event_Queue_Manager::Rebuild_During_Playback(List<Track^>^ tracks, List<Measure^>^ measures, List<int>^ muted_tracks, List<int>^ soloed_tracks)
+	{
+		if (!_Cache_Valid || !tracks || !measures)
+		{
+			return false;
+		}
 
-			// Re-queue only future events (after current position)
-			List<Playback_MIDI_Event^>^ Future_Events = gcnew List<Playback_MIDI_Event^>();
+		try
+		{
+			List<Playback_MIDI_Event^>^ Rastered_Events = _MIDI_Event_Raster->Raster_Timeline_For_Playback();
 
-			for each (Playback_MIDI_Event ^ Event in _Filtered_Events)
-			{
-				// Only queue events that haven't played yet
-				if (Event->Timestamp_ms >= current_position_ms)
-				{
-					Future_Events->Add(Event);
-				}
+			if (!Rastered_Events) {
+				return false;
 			}
 
-			// Queue future events
-			if (Future_Events->Count > 0)
-			{
-				_MIDI_Engine->Queue_Events(Future_Events);
+			_Timeline_Tracks = tracks;
+			_Timeline_Measures = measures;
+
+			_Unfiltered_Events->Clear();
+			_Unfiltered_Events->AddRange(Rastered_Events);
+
+			// Tracks may have been added, removed or moved by the edit
+			_Current_Muted_Tracks->Clear();
+			_Current_Soloed_Tracks->Clear();
+
+			if (muted_tracks) {
+				_Current_Muted_Tracks->AddRange(muted_tracks);
 			}
 
+			if (soloed_tracks) {
+				_Current_Soloed_Tracks->AddRange(soloed_tracks);
+			}
+
+			Apply_Track_Mask(_Current_Muted_Tracks, _Current_Soloed_Tracks);
+
+			// The playback thread swaps the schedules with a pointer exchange, carries its cursor over by time
+			// and switches the notes that differ between the two. The old schedule is deleted here later
+			Load_Schedule();
+
 			return true;
 		}
 		catch (...)
 		{
-			// Log error if needed
+			// Playback goes on with the previous schedule
 			return false;
 		}
 	}
 
-	void Playback_Event_Queue_Manager::On_Event_Sent(Playback_MIDI_Event^ event)
+	bool Playback_Event_Queue_Manager::Render_Offline_Log(String^ filename, String^% report)
 	{
-		if (!event)
+		if (!_Cache_Valid || !_MIDI_Engine)
 		{
-			return;
+			return false;
 		}
 
-		if (_Form_MIDI_Log != nullptr)
+		return _MIDI_Engine->Render_Offline_Log(_Unfiltered_Events, Create_Checkpoint_Times(_Timeline_Measures), Create_Tempo_Segments(_Timeline_Measures), 0.0, filename, report);
+	}
+
+	String^ Playback_Event_Queue_Manager::Create_Bandwidth_Report()
+	{
+		if (!_Cache_Valid || !_MIDI_Engine)
 		{
-			_Form_MIDI_Log->Add_MIDI_Event(
-				event->Timestamp_ms,
-				event->Timeline_Track_ID,
-				event->MIDI_Channel,
-				event->MIDI_Command,
-				event->MIDI_Data1,
-				event->MIDI_Data2
-			);
+			return nullptr;
 		}
 
-		unsigned char Command_Type = event->MIDI_Command & 0xF0;
+		return _MIDI_Engine->Create_Bandwidth_Report(_Unfiltered_Events);
+	}
+
+	void Playback_Event_Queue_Manager::On_Event_Sent(int track, int channel, unsigned char command, unsigned char data1, unsigned char data2)
+	{
+		unsigned char Command_Type = command & 0xF0;
 
-		if (Command_Type == MIDI_Writer::MIDI_EVENT_NOTE_ON && event->MIDI_Data2 > 0)
+		if (Command_Type == MIDI_Writer::MIDI_EVENT_NOTE_ON && data2 > 0)
 		{
 			// Note On event (velocity > 0)
-			Track_Note_On(
-				event->Timeline_Track_ID,
-				event->MIDI_Channel,
-				event->MIDI_Data1,  // Note number
-				event->Timestamp_ms
-			);
+			_Active_Notes->Note_On(track, channel, data1);
 		}
-		else if (Command_Type == MIDI_Writer::MIDI_EVENT_NOTE_OFF || (Command_Type == MIDI_Writer::MIDI_EVENT_NOTE_ON && event->MIDI_Data2 == 0))
+		else if (Command_Type == MIDI_Writer::MIDI_EVENT_NOTE_OFF || (Command_Type == MIDI_Writer::MIDI_EVENT_NOTE_ON && data2 == 0))
 		{
 			// Note Off event (0x80) or Note On with velocity 0
-			Track_Note_Off(
-				event->Timeline_Track_ID,
-				event->MIDI_Channel,
-				event->MIDI_Data1  // Note number
-			);
+			_Active_Notes->Note_Off(track, channel, data1);
 		}
 	}
 
 	void Playback_Event_Queue_Manager::Send_All_Active_Notes_Off()
 	{
-		System::Threading::Monitor::Enter(_Active_Notes_Lock);
-		try
-		{
-			// Create a copy to iterate over (in case list is modified)
-			List<Active_Note>^ Notes_To_Stop = gcnew List<Active_Note>(_Active_Notes);
+		// Taking the notes clears them, a second call sends nothing
+		std::vector<uint32_t> Note_Keys;
+		_Active_Notes->Take_All_Notes(Note_Keys);
 
-			for each (Active_Note Note in Notes_To_Stop)
-			{
-				Send_Note_Off_Immediate(Note.MIDI_Channel, Note.Note_Number);
-			}
-
-			// Clear the active notes list
-			_Active_Notes->Clear();
-		}
-		finally
-		{
-			System::Threading::Monitor::Exit(_Active_Notes_Lock);
-		}
+		Send_Note_Offs(Note_Keys);
 	}
 
 	void Playback_Event_Queue_Manager::Send_Active_Notes_Off_For_Tracks(List<int>^ track_indices)
@@ -299,46 +252,19 @@ namespace MIDILightDrawer
 			return;
 		}
 
-		System::Threading::Monitor::Enter(_Active_Notes_Lock);
-		try
-		{
-			// Find all active notes on these tracks
-			List<Active_Note>^ Notes_To_Stop = gcnew List<Active_Note>();
-
-			for each (Active_Note Note in _Active_Notes)
-			{
-				if (track_indices->Contains(Note.Track_Index))
-				{
-					Notes_To_Stop->Add(Note);
-				}
-			}
-
-			// Send Note Off for each one
-			for each (Active_Note Note in Notes_To_Stop)
-			{
-				Send_Note_Off_Immediate(Note.MIDI_Channel, Note.Note_Number);
+		std::vector<uint32_t> Note_Keys;
 
-				// Remove from active notes list
-				_Active_Notes->Remove(Note);
-			}
-		}
-		finally
+		for each (int Track_Index in track_indices)
 		{
-			System::Threading::Monitor::Exit(_Active_Notes_Lock);
+			_Active_Notes->Take_Track_Notes(Track_Index, Note_Keys);
 		}
+
+		Send_Note_Offs(Note_Keys);
 	}
 
 	int Playback_Event_Queue_Manager::Get_Active_Note_Count()
 	{
-		System::Threading::Monitor::Enter(_Active_Notes_Lock);
-		try
-		{
-			return _Active_Notes->Count;
-		}
-		finally
-		{
-			System::Threading::Monitor::Exit(_Active_Notes_Lock);
-		}
+		return _Active_Notes->Get_Count();
 	}
 
 	void Playback_Event_Queue_Manager::Invalidate_Cache()
@@ -346,21 +272,6 @@ namespace MIDILightDrawer
 		_Cache_Valid = false;
 	}
 
-	bool Playback_Event_Queue_Manager::Should_Invalidate_Cache_For_Track_State(List<int>^ current_muted_tracks, List<int>^ current_soloed_tracks)
-	{
-		// If cache is already invalid, no need to check
-		if (!_Cache_Valid)
-		{
-			return true;
-		}
-
-		// Check if mute/solo state has changed
-		bool Mute_Changed = !Track_Lists_Equal(_Current_Muted_Tracks, current_muted_tracks);
-		bool Solo_Changed = !Track_Lists_Equal(_Current_Soloed_Tracks, current_soloed_tracks);
-
-		return Mute_Changed || Solo_Changed;
-	}
-
 	int Playback_Event_Queue_Manager::Get_Cached_Event_Count()
 	{
 		if (!_Cache_Valid)
@@ -371,16 +282,6 @@ namespace MIDILightDrawer
 		return _Unfiltered_Events->Count;
 	}
 
-	int Playback_Event_Queue_Manager::Get_Active_Event_Count()
-	{
-		if (!_Cache_Valid)
-		{
-			return 0;
-		}
-
-		return _Filtered_Events->Count;
-	}
-
 	bool Playback_Event_Queue_Manager::Is_Cache_Valid()
 	{
 		return _Cache_Valid;
@@ -392,158 +293,69 @@ namespace MIDILightDrawer
 		Send_All_Active_Notes_Off();
 
 		_Unfiltered_Events->Clear();
-		_Filtered_Events->Clear();
 		_Current_Muted_Tracks->Clear();
 		_Current_Soloed_Tracks->Clear();
 		_Timeline_Tracks = nullptr;
 		_Timeline_Measures = nullptr;
 		_Cache_Valid = false;
+		_Schedule_Loaded = false;
 	}
 
-	void Playback_Event_Queue_Manager::Apply_Track_Filtering(List<int>^ muted_tracks, List<int>^ soloed_tracks)
+	void Playback_Event_Queue_Manager::Apply_Track_Mask(List<int>^ muted_tracks, List<int>^ soloed_tracks)
 	{
-		_Filtered_Events->Clear();
-
-		for each (Playback_MIDI_Event ^ Event in _Unfiltered_Events)
+		if (!_MIDI_Engine || !_Timeline_Tracks)
 		{
-			// Check if this track should play
-			if (Should_Track_Play(Event->Timeline_Track_ID, muted_tracks, soloed_tracks))
-			{
-				_Filtered_Events->Add(Event);
-			}
+			return;
 		}
+
+		_MIDI_Engine->Set_Track_Mute_Solo(_Timeline_Tracks->Count, muted_tracks, soloed_tracks);
 	}
 
-	bool Playback_Event_Queue_Manager::Should_Track_Play(int track_index, List<int>^ muted_tracks, List<int>^ soloed_tracks)
+	void Playback_Event_Queue_Manager::Load_Schedule()
 	{
-		// Check if track is muted
-		bool Is_Muted = muted_tracks && muted_tracks->Contains(track_index);
-
-		if (Is_Muted)
-		{
-			return false;
-		}
-
-		// Check solo logic
-		bool Has_Any_Solo = soloed_tracks && soloed_tracks->Count > 0;
-
-		if (Has_Any_Solo)
-		{
-			// If any track is soloed, only soloed tracks play
-			bool Is_Soloed = soloed_tracks->Contains(track_index);
-			return Is_Soloed;
+		if (!_MIDI_Engine) {
+			return;
 		}
 
-		// No solos active, track is not muted, so it plays
-		return true;
+		_MIDI_Engine->Load_Schedule(_Unfiltered_Events, Create_Checkpoint_Times(_Timeline_Measures), Create_Tempo_Segments(_Timeline_Measures));
+		_Schedule_Loaded = true;
 	}
 
-	List<int>^ Playback_Event_Queue_Manager::Get_Changed_Tracks(List<int>^ old_muted, List<int>^ old_soloed, List<int>^ new_muted, List<int>^ new_soloed)
+	List<double>^ Playback_Event_Queue_Manager::Create_Checkpoint_Times(List<Measure^>^ measures)
 	{
-		List<int>^ Changed = gcnew List<int>();
-
-		// Get all unique track indices
-		List<int>^ All_Tracks = gcnew List<int>();
+		// One checkpoint per measure, a start in the middle of a song replays at most one measure to restore the sounding notes
+		List<double>^ Checkpoint_Times_ms = gcnew List<double>();
 
-		if (old_muted)
+		if (measures != nullptr)
 		{
-			for each (int Track in old_muted)
-			{
-				All_Tracks->Add(Track);
+			for each (Measure^ Current_Measure in measures) {
+				Checkpoint_Times_ms->Add(Current_Measure->StartTime_ms);
 			}
 		}
 
-		if (old_soloed)
-		{
-			for each (int Track in old_soloed)
-			{
-				All_Tracks->Add(Track);
-			}
-		}
+		return Checkpoint_Times_ms;
+	}
 
-		if (new_muted)
-		{
-			for each (int Track in new_muted)
-			{
-				All_Tracks->Add(Track);
-			}
-		}
+	List<Playback_Tempo_Segment>^ Playback_Event_Queue_Manager::Create_Tempo_Segments(List<Measure^>^ measures)
+	{
+		List<Playback_Tempo_Segment>^ Segments = gcnew List<Playback_Tempo_Segment>();
 
-		if (new_soloed)
-		{
-			for each (int Track in new_soloed)
-			{
-				All_Tracks->Add(Track);
-			}
+		if (measures == nullptr) {
+			return Segments;
 		}
 
-		// Check each track to see if its play state changed
-		for each (int Track_Index in All_Tracks)
+		// Same mapping as Widget_Timeline::TicksToMilliseconds, one segment per measure
+		for each (Measure^ Current_Measure in measures)
 		{
-			bool Old_Should_Play = Should_Track_Play(Track_Index, old_muted, old_soloed);
-			bool New_Should_Play = Should_Track_Play(Track_Index, new_muted, new_soloed);
-
-			if (Old_Should_Play != New_Should_Play)
-			{
-				Changed->Add(Track_Index);
-			}
-		}
+			Playback_Tempo_Segment Segment;
+			Segment.Start_Tick = Current_Measure->StartTick;
+			Segment.Start_ms = Current_Measure->StartTime_ms;
+			Segment.Ms_Per_Tick = Current_Measure->Length_Per_Tick_ms;
 
-		return Changed;
-	}
-
-	void Playback_Event_Queue_Manager::Track_Note_On(
-		int track_index,
-		uint8_t midi_channel,
-		uint8_t note_number,
-		double timestamp_ms
-	)
-	{
-		System::Threading::Monitor::Enter(_Active_Notes_Lock);
-		try
-		{
-			Active_Note New_Note;
-			New_Note.Track_Index = track_index;
-			New_Note.MIDI_Channel = midi_channel;
-			New_Note.Note_Number = note_number;
-			New_Note.Note_On_Time = timestamp_ms;
-
-			// Add to active notes list
-			_Active_Notes->Add(New_Note);
-		}
-		finally
-		{
-			System::Threading::Monitor::Exit(_Active_Notes_Lock);
+			Segments->Add(Segment);
 		}
-	}
 
-	void Playback_Event_Queue_Manager::Track_Note_Off(
-		int track_index,
-		uint8_t midi_channel,
-		uint8_t note_number
-	)
-	{
-		System::Threading::Monitor::Enter(_Active_Notes_Lock);
-		try
-		{
-			// Find and remove the matching active note
-			for (int i = 0; i < _Active_Notes->Count; i++)
-			{
-				Active_Note Note = _Active_Notes[i];
-
-				if (Note.Track_Index == track_index &&
-					Note.MIDI_Channel == midi_channel &&
-					Note.Note_Number == note_number)
-				{
-					_Active_Notes->RemoveAt(i);
-					break;  // Remove only the first match
-				}
-			}
-		}
-		finally
-		{
-			System::Threading::Monitor::Exit(_Active_Notes_Lock);
-		}
+		return Segments;
 	}
 
 	void Playback_Event_Queue_Manager::Send_Note_Off_Immediate(
@@ -569,41 +381,11 @@ namespace MIDILightDrawer
 		_MIDI_Engine->Send_Event(Note_Off);
 	}
 
-	bool Playback_Event_Queue_Manager::Track_Lists_Equal(List<int>^ list_a, List<int>^ list_b)
+	void Playback_Event_Queue_Manager::Send_Note_Offs(const std::vector<uint32_t>& note_keys)
 	{
-		// Null check
-		if (!list_a && !list_b)
-		{
-			return true;
-		}
-
-		if (!list_a || !list_b)
-		{
-			return false;
-		}
-
-		// Count check
-		if (list_a->Count != list_b->Count)
+		for (size_t i = 0; i < note_keys.size(); i++)
 		{
-			return false;
+			Send_Note_Off_Immediate((uint8_t)Playback_MIDI_Active_Notes::Get_Channel(note_keys[i]), (uint8_t)Playback_MIDI_Active_Notes::Get_Note(note_keys[i]));
 		}
-
-		// Create sorted copies for comparison
-		List<int>^ Sorted_A = gcnew List<int>(list_a);
-		List<int>^ Sorted_B = gcnew List<int>(list_b);
-
-		Sorted_A->Sort();
-		Sorted_B->Sort();
-
-		// Element-by-element comparison
-		for (int Index = 0; Index < Sorted_A->Count; Index++)
-		{
-			if (Sorted_A[Index] != Sorted_B[Index])
-			{
-				return false;
-			}
-		}
-
-		return true;
 	}
 }
\ No newline at end of file
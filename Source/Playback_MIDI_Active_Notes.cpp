@@ -0,0 +1,167 @@
+#ifdef _MSC_VER
+#pragma managed(push, off)
+#include <intrin.h>
+#endif
+
+#include "Playback_MIDI_Active_Notes.h"
+
+namespace MIDILightDrawer
+{
+	static int Lowest_Bit_Index(uint64_t bits)
+	{
+#ifdef _MSC_VER
+		unsigned long Index = 0;
+		_BitScanForward64(&Index, bits);
+		return (int)Index;
+#else
+		return __builtin_ctzll(bits);
+#endif
+	}
+
+	Playback_MIDI_Active_Notes::Playback_MIDI_Active_Notes()
+	{
+		for (int i = 0; i < ROW_COUNT * (int)WORDS_PER_ROW; i++) {
+			_Bits[i].store(0);
+		}
+
+		_Count.store(0);
+		_Row_Limit.store(0);
+	}
+
+	bool Playback_MIDI_Active_Notes::Note_On(int track, int channel, int note)
+	{
+		int Row = Get_Row(track);
+		uint32_t Key = Get_Key(Row, channel, note);
+		uint64_t Bit = 1ull << (Key % 64);
+
+		if ((_Bits[Key / 64].fetch_or(Bit, std::memory_order_acq_rel) & Bit) != 0) {
+			return false;
+		}
+
+		_Count.fetch_add(1, std::memory_order_relaxed);
+
+		// Raised after the bit is set, a scan that sees the limit sees the bit as well
+		int Row_Limit = _Row_Limit.load(std::memory_order_relaxed);
+
+		while (Row_Limit <= Row && !_Row_Limit.compare_exchange_weak(Row_Limit, Row + 1, std::memory_order_release, std::memory_order_relaxed)) {
+		}
+
+		return true;
+	}
+
+	bool Playback_MIDI_Active_Notes::Note_Off(int track, int channel, int note)
+	{
+		uint32_t Key = Get_Key(Get_Row(track), channel, note);
+		uint64_t Bit = 1ull << (Key % 64);
+
+		if ((_Bits[Key / 64].fetch_and(~Bit, std::memory_order_acq_rel) & Bit) == 0) {
+			return false;
+		}
+
+		_Count.fetch_sub(1, std::memory_order_relaxed);
+
+		return true;
+	}
+
+	bool Playback_MIDI_Active_Notes::Is_Sounding(int track, int channel, int note) const
+	{
+		uint32_t Key = Get_Key(Get_Row(track), channel, note);
+
+		return (_Bits[Key / 64].load(std::memory_order_acquire) & (1ull << (Key % 64))) != 0;
+	}
+
+	int Playback_MIDI_Active_Notes::Get_Count() const
+	{
+		return _Count.load(std::memory_order_relaxed);
+	}
+
+	size_t Playback_MIDI_Active_Notes::Take_Track_Notes(int track, std::vector<uint32_t>& keys)
+	{
+		return Take_Row(Get_Row(track), keys);
+	}
+
+	size_t Playback_MIDI_Active_Notes::Take_All_Notes(std::vector<uint32_t>& keys)
+	{
+		size_t Taken = 0;
+		int Row_Limit = _Row_Limit.load(std::memory_order_acquire);
+
+		for (int Row = 0; Row < Row_Limit; Row++) {
+			Taken += Take_Row(Row, keys);
+		}
+
+		return Taken;
+	}
+
+	void Playback_MIDI_Active_Notes::Clear()
+	{
+		int Row_Limit = _Row_Limit.load(std::memory_order_acquire);
+
+		for (int i = 0; i < Row_Limit * (int)WORDS_PER_ROW; i++)
+		{
+			uint64_t Bits = _Bits[i].exchange(0, std::memory_order_acq_rel);
+
+			while (Bits != 0) {
+				Bits &= Bits - 1;
+				_Count.fetch_sub(1, std::memory_order_relaxed);
+			}
+		}
+	}
+
+	int Playback_MIDI_Active_Notes::Get_Track(uint32_t key)
+	{
+		int Row = (int)(key / KEYS_PER_ROW);
+
+		return (Row < MAX_TRACKS) ? Row : -1;
+	}
+
+	int Playback_MIDI_Active_Notes::Get_Channel(uint32_t key)
+	{
+		return (int)((key >> Playback_MIDI_Schedule::NOTE_BITS) & 0x0F);
+	}
+
+	int Playback_MIDI_Active_Notes::Get_Note(uint32_t key)
+	{
+		return (int)(key & 0x7F);
+	}
+
+	int Playback_MIDI_Active_Notes::Get_Row(int track)
+	{
+		return (track >= 0 && track < MAX_TRACKS) ? track : MAX_TRACKS;
+	}
+
+	uint32_t Playback_MIDI_Active_Notes::Get_Key(int row, int channel, int note)
+	{
+		return Playback_MIDI_Schedule::Pack_Note_Key(row, channel, note);
+	}
+
+	size_t Playback_MIDI_Active_Notes::Take_Row(int row, std::vector<uint32_t>& keys)
+	{
+		size_t Taken = 0;
+		uint32_t First_Word = (uint32_t)row * WORDS_PER_ROW;
+
+		for (uint32_t Word = First_Word; Word < First_Word + WORDS_PER_ROW; Word++)
+		{
+			// Most words are empty, a plain load avoids writing to them
+			if (_Bits[Word].load(std::memory_order_relaxed) == 0) {
+				continue;
+			}
+
+			uint64_t Bits = _Bits[Word].exchange(0, std::memory_order_acq_rel);
+
+			while (Bits != 0)
+			{
+				keys.push_back(Word * 64 + (uint32_t)Lowest_Bit_Index(Bits));
+				Bits &= Bits - 1;
+				Taken++;
+			}
+		}
+
+		_Count.fetch_sub((int)Taken, std::memory_order_relaxed);
+
+		return Taken;
+	}
+}
+
+#ifdef _MSC_VER
+#pragma managed(pop)
+#endif
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <atomic>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+#include "Playback_MIDI_Schedule.h"
+
+namespace MIDILightDrawer
+{
+	// Notes switched on and not yet off, one bit per track, channel and note. Bits are set and cleared
+	// with single atomic operations, so updates never lock and can come from any thread.
+	// Keys are packed like Playback_MIDI_Schedule::Pack_Note_Key, the row of events without a track
+	// or with a track above MAX_TRACKS is unpacked as track -1
+	class Playback_MIDI_Active_Notes
+	{
+	public:
+		static const int MAX_TRACKS = 256;
+
+	private:
+		static const int ROW_COUNT = MAX_TRACKS + 1;	// The last row collects all other tracks
+		static const uint32_t KEYS_PER_ROW = Playback_MIDI_Schedule::NOTE_KEYS_PER_TRACK;
+		static const uint32_t WORDS_PER_ROW = KEYS_PER_ROW / 64;
+
+		std::atomic<uint64_t> _Bits[ROW_COUNT * WORDS_PER_ROW];
+		std::atomic<int> _Count;
+		std::atomic<int> _Row_Limit;	// One past the highest row ever used, bounds the scans
+
+	public:
+		Playback_MIDI_Active_Notes();
+
+		// Both return whether the state of the note changed. A second Note On of a sounding note is one note,
+		// as on the receiving device
+		bool Note_On(int track, int channel, int note);
+		bool Note_Off(int track, int channel, int note);
+		bool Is_Sounding(int track, int channel, int note) const;
+		int Get_Count() const;
+
+		// Clear the notes and append their keys. Each word is taken with one exchange, a note switched on
+		// at the same time is either taken or stays
+		size_t Take_Track_Notes(int track, std::vector<uint32_t>& keys);
+		size_t Take_All_Notes(std::vector<uint32_t>& keys);
+		void Clear();
+
+		static int Get_Track(uint32_t key);
+		static int Get_Channel(uint32_t key);
+		static int Get_Note(uint32_t key);
+
+	private:
+		static int Get_Row(int track);
+		static uint32_t Get_Key(int row, int channel, int note);
+		size_t Take_Row(int row, std::vector<uint32_t>& keys);
+	};
+}
@@ -0,0 +1,169 @@
+#ifdef _MSC_VER
+#pragma managed(push, off)
+#endif
+
+#include "Playback_MIDI_Bandwidth_Report.h"
+#include "Playback_MIDI_Frame_Builder.h"
+#include "Playback_MIDI_Scheduler.h"
+
+#include <cstdio>
+
+namespace MIDILightDrawer
+{
+	Playback_MIDI_Bandwidth_Report::Report Playback_MIDI_Bandwidth_Report::Analyze(const Playback_MIDI_Schedule& schedule)
+	{
+		Report Result = {};
+
+		Playback_MIDI_Frame_Builder Builder;
+
+		int64_t Note_Link_Free_us = INT64_MIN;
+		int64_t Frame_Link_Free_us = INT64_MIN;
+		int64_t First_Time_us = 0;
+		int64_t Last_Time_us = 0;
+
+		size_t Index = 0;
+
+		while (Index < schedule.Size())
+		{
+			int64_t Batch_Time_us = schedule.Get_Entry(Index).Execute_Time_Us;
+
+			size_t Note_Messages = 0;
+			size_t Note_Bytes = 0;
+			size_t Frame_Messages = 0;
+			size_t Frame_Bytes = 0;
+
+			// Same grouping as the playback thread
+			for (; Index < schedule.Size() && schedule.Get_Entry(Index).Execute_Time_Us <= Batch_Time_us + Playback_MIDI_Scheduler::BATCH_WINDOW_US; Index++)
+			{
+				const Playback_MIDI_Schedule::Entry& Entry = schedule.Get_Entry(Index);
+
+				// Never sent by the scheduler either
+				if (Playback_MIDI_Schedule::Is_Note_Off(Entry.Event) && Entry.Note_On_Index == Playback_MIDI_Schedule::NO_NOTE_ON) {
+					continue;
+				}
+
+				size_t Bytes = Short_Message_Bytes(Entry.Event.Command);
+
+				Note_Messages++;
+				Note_Bytes += Bytes;
+
+				if (!Builder.Add((unsigned char)(Entry.Event.Command | Entry.Event.Channel), Entry.Event.Data1, Entry.Event.Data2)) {
+					Frame_Messages++;
+					Frame_Bytes += Bytes;
+				}
+
+				if (Result.Event_Count == 0) {
+					First_Time_us = Entry.Execute_Time_Us;
+				}
+
+				Last_Time_us = Entry.Execute_Time_Us;
+				Result.Event_Count++;
+			}
+
+			if (Note_Messages == 0) {
+				continue;
+			}
+
+			size_t Frame_Count = Builder.Finish();
+
+			for (size_t i = 0; i < Frame_Count; i++)
+			{
+				size_t Length = 0;
+				Builder.Get_Frame(i, Length);
+
+				Frame_Messages++;
+				Frame_Bytes += Length;
+			}
+
+			Add_Batch(Result.Note_Messages, Note_Link_Free_us, Batch_Time_us, Note_Messages, Note_Bytes);
+			Add_Batch(Result.SysEx_Frames, Frame_Link_Free_us, Batch_Time_us, Frame_Messages, Frame_Bytes);
+
+			Result.Batch_Count++;
+		}
+
+		Result.Duration_ms = (double)(Last_Time_us - First_Time_us) / 1000.0;
+
+		Finish_Usage(Result.Note_Messages, Result.Duration_ms);
+		Finish_Usage(Result.SysEx_Frames, Result.Duration_ms);
+
+		return Result;
+	}
+
+	std::string Playback_MIDI_Bandwidth_Report::Format_Report(const Report& report)
+	{
+		char Line[256];
+		std::string Text;
+
+		snprintf(Line, sizeof(Line), "Events: %zu in %zu batches over %.1f s\n", report.Event_Count, report.Batch_Count, report.Duration_ms / 1000.0);
+		Text += Line;
+
+		const Mode_Usage* Modes[2] = { &report.Note_Messages, &report.SysEx_Frames };
+		const char* Mode_Names[2] = { "Note messages", "SysEx frames" };
+
+		for (int i = 0; i < 2; i++)
+		{
+			const Mode_Usage& Usage = *Modes[i];
+
+			snprintf(Line, sizeof(Line), "%s: %llu messages, %llu bytes, largest batch %zu bytes (%.2f ms on the link)\n", Mode_Names[i],
+				(unsigned long long)Usage.Message_Count, (unsigned long long)Usage.Byte_Count, Usage.Batch_Bytes_Max, (double)(Usage.Batch_Bytes_Max * DIN_BYTE_TIME_US) / 1000.0);
+			Text += Line;
+			snprintf(Line, sizeof(Line), "  DIN link load %.1f%%, max backlog %.2f ms, %zu batches late by more than %lld us\n",
+				Usage.Link_Load_Percent, Usage.Backlog_Max_ms, Usage.Late_Batches, (long long)LATE_THRESHOLD_US);
+			Text += Line;
+		}
+
+		if (report.Note_Messages.Byte_Count > 0)
+		{
+			double Saving_Percent = 100.0 * (1.0 - (double)report.SysEx_Frames.Byte_Count / (double)report.Note_Messages.Byte_Count);
+
+			snprintf(Line, sizeof(Line), "SysEx frames use %.1f%% fewer bytes\n", Saving_Percent);
+			Text += Line;
+		}
+
+		return Text;
+	}
+
+	void Playback_MIDI_Bandwidth_Report::Add_Batch(Mode_Usage& usage, int64_t& link_free_us, int64_t batch_time_us, size_t message_count, size_t byte_count)
+	{
+		usage.Message_Count += message_count;
+		usage.Byte_Count += byte_count;
+
+		if (byte_count > usage.Batch_Bytes_Max) {
+			usage.Batch_Bytes_Max = byte_count;
+		}
+
+		// The batch starts when it is due or when the link has finished the previous ones
+		int64_t Start_us = (link_free_us > batch_time_us) ? link_free_us : batch_time_us;
+		link_free_us = Start_us + (int64_t)byte_count * DIN_BYTE_TIME_US;
+
+		double Backlog_ms = (double)(Start_us - batch_time_us) / 1000.0;
+
+		if (Backlog_ms > usage.Backlog_Max_ms) {
+			usage.Backlog_Max_ms = Backlog_ms;
+		}
+
+		if (Start_us - batch_time_us > LATE_THRESHOLD_US) {
+			usage.Late_Batches++;
+		}
+	}
+
+	void Playback_MIDI_Bandwidth_Report::Finish_Usage(Mode_Usage& usage, double duration_ms)
+	{
+		if (duration_ms <= 0.0) {
+			usage.Link_Load_Percent = 0.0;
+			return;
+		}
+
+		usage.Link_Load_Percent = 100.0 * (double)usage.Byte_Count * (double)DIN_BYTE_TIME_US / (duration_ms * 1000.0);
+	}
+
+	size_t Playback_MIDI_Bandwidth_Report::Short_Message_Bytes(unsigned char command)
+	{
+		// Program change and channel pressure only have one data byte
+		return (command == 0xC0 || command == 0xD0) ? 2 : 3;
+	}
+}
+
+#ifdef _MSC_VER
+#pragma managed(pop)
+#endif
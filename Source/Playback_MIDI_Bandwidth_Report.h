@@ -0,0 +1,49 @@
+#pragma once
+
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+#include "Playback_MIDI_Schedule.h"
+
+namespace MIDILightDrawer
+{
+	// Compares the link usage of a schedule sent as note messages and as SysEx light frames. Events are grouped
+	// into batches like the scheduler does, and each batch is pushed through a model of a 31.25 kbaud DIN link
+	// to see how far the link falls behind. All tracks are assumed to share one link
+	class Playback_MIDI_Bandwidth_Report
+	{
+	public:
+		struct Mode_Usage
+		{
+			uint64_t Message_Count;
+			uint64_t Byte_Count;
+			size_t Batch_Bytes_Max;
+			double Link_Load_Percent;		// Byte count relative to what the link carries over the whole schedule
+			double Backlog_Max_ms;			// Longest wait of a batch for the link to finish the batches before it
+			size_t Late_Batches;			// Batches that waited longer than LATE_THRESHOLD_US
+		};
+
+		struct Report
+		{
+			size_t Event_Count;
+			size_t Batch_Count;
+			double Duration_ms;
+
+			Mode_Usage Note_Messages;
+			Mode_Usage SysEx_Frames;
+		};
+
+		// 31250 baud with start and stop bit, 320 us per byte
+		static const int64_t DIN_BYTE_TIME_US = 320;
+		static const int64_t LATE_THRESHOLD_US = 1000;
+
+		static Report Analyze(const Playback_MIDI_Schedule& schedule);
+		static std::string Format_Report(const Report& report);
+
+	private:
+		static void Add_Batch(Mode_Usage& usage, int64_t& link_free_us, int64_t batch_time_us, size_t message_count, size_t byte_count);
+		static void Finish_Usage(Mode_Usage& usage, double duration_ms);
+		static size_t Short_Message_Bytes(unsigned char command);
+	};
+}
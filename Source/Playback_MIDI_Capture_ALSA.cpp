@@ -0,0 +1,159 @@
+#include "Playback_MIDI_Capture_ALSA.h"
+#include "Playback_MIDI_Output_ALSA.h"
+
+#ifdef __linux__
+
+#include <alsa/asoundlib.h>
+
+namespace MIDILightDrawer
+{
+	Playback_MIDI_Capture_ALSA::Playback_MIDI_Capture_ALSA()
+	{
+		_Sequencer = nullptr;
+		_Decoder = nullptr;
+		_Port = -1;
+		_Queue = -1;
+		_Clock = nullptr;
+		_Queue_Origin_us = 0;
+	}
+
+	Playback_MIDI_Capture_ALSA::~Playback_MIDI_Capture_ALSA()
+	{
+		Close();
+	}
+
+	bool Playback_MIDI_Capture_ALSA::Open(const char* client_name, int source_client, int source_port, IClock* clock)
+	{
+		Close();
+
+		if (clock == nullptr) {
+			return false;
+		}
+
+		// Duplex, starting the queue is an event sent to the system client
+		snd_seq_t* Sequencer = nullptr;
+
+		if (snd_seq_open(&Sequencer, "default", SND_SEQ_OPEN_DUPLEX, SND_SEQ_NONBLOCK) < 0) {
+			return false;
+		}
+
+		snd_seq_set_client_name(Sequencer, client_name);
+		snd_seq_set_client_pool_input(Sequencer, INPUT_POOL_SIZE);
+
+		int Queue = snd_seq_alloc_named_queue(Sequencer, "Light Capture");
+
+		if (Queue < 0) {
+			snd_seq_close(Sequencer);
+			return false;
+		}
+
+		// Every event delivered to the port gets the real time of the queue at its arrival
+		snd_seq_port_info_t* Port_Info = nullptr;
+		snd_seq_port_info_alloca(&Port_Info);
+		snd_seq_port_info_set_name(Port_Info, "Light Capture");
+		snd_seq_port_info_set_capability(Port_Info, SND_SEQ_PORT_CAP_WRITE | SND_SEQ_PORT_CAP_SUBS_WRITE);
+		snd_seq_port_info_set_type(Port_Info, SND_SEQ_PORT_TYPE_MIDI_GENERIC | SND_SEQ_PORT_TYPE_APPLICATION);
+		snd_seq_port_info_set_timestamping(Port_Info, 1);
+		snd_seq_port_info_set_timestamp_real(Port_Info, 1);
+		snd_seq_port_info_set_timestamp_queue(Port_Info, Queue);
+
+		if (snd_seq_create_port(Sequencer, Port_Info) < 0) {
+			snd_seq_close(Sequencer);
+			return false;
+		}
+
+		int Port = snd_seq_port_info_get_port(Port_Info);
+
+		if (snd_seq_connect_from(Sequencer, Port, source_client, source_port) < 0) {
+			snd_seq_close(Sequencer);
+			return false;
+		}
+
+		if (snd_seq_start_queue(Sequencer, Queue, nullptr) < 0 || snd_seq_drain_output(Sequencer) < 0) {
+			snd_seq_close(Sequencer);
+			return false;
+		}
+
+		snd_midi_event_t* Decoder = nullptr;
+
+		if (snd_midi_event_new(16, &Decoder) < 0) {
+			snd_seq_close(Sequencer);
+			return false;
+		}
+
+		snd_midi_event_no_status(Decoder, 1);
+
+		if (!Playback_MIDI_Output_ALSA::Get_Queue_Origin_us(Sequencer, Queue, clock, _Queue_Origin_us)) {
+			snd_midi_event_free(Decoder);
+			snd_seq_close(Sequencer);
+			return false;
+		}
+
+		_Sequencer = Sequencer;
+		_Decoder = Decoder;
+		_Port = Port;
+		_Queue = Queue;
+		_Clock = clock;
+
+		return true;
+	}
+
+	bool Playback_MIDI_Capture_ALSA::Is_Open()
+	{
+		return _Sequencer != nullptr;
+	}
+
+	void Playback_MIDI_Capture_ALSA::Close()
+	{
+		if (_Decoder != nullptr) {
+			snd_midi_event_free((snd_midi_event_t*)_Decoder);
+			_Decoder = nullptr;
+		}
+
+		// Closing the client frees its queue and port
+		if (_Sequencer != nullptr) {
+			snd_seq_close((snd_seq_t*)_Sequencer);
+			_Sequencer = nullptr;
+		}
+
+		_Port = -1;
+		_Queue = -1;
+		_Clock = nullptr;
+	}
+
+	size_t Playback_MIDI_Capture_ALSA::Read(std::vector<Captured_Message>& messages)
+	{
+		if (_Sequencer == nullptr) {
+			return 0;
+		}
+
+		size_t Count = 0;
+		snd_seq_event_t* Event = nullptr;
+
+		// Non-blocking, ends with -EAGAIN once nothing is left
+		while (snd_seq_event_input((snd_seq_t*)_Sequencer, &Event) >= 0 && Event != nullptr)
+		{
+			unsigned char Bytes[16];
+
+			snd_midi_event_reset_decode((snd_midi_event_t*)_Decoder);
+			long Length = snd_midi_event_decode((snd_midi_event_t*)_Decoder, Bytes, sizeof(Bytes), Event);
+
+			if (Length <= 0 || Bytes[0] == 0xF0) {
+				continue;
+			}
+
+			Captured_Message Message;
+			Message.Time_us = _Queue_Origin_us + (int64_t)Event->time.time.tv_sec * 1000000 + Event->time.time.tv_nsec / 1000;
+			Message.Status = Bytes[0];
+			Message.Data1 = (Length > 1) ? Bytes[1] : 0;
+			Message.Data2 = (Length > 2) ? Bytes[2] : 0;
+
+			messages.push_back(Message);
+			Count++;
+		}
+
+		return Count;
+	}
+}
+
+#endif
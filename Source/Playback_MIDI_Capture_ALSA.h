@@ -0,0 +1,48 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+#include "Playback_Clock.h"
+
+namespace MIDILightDrawer
+{
+	// Linux ALSA sequencer input subscribed to a source port, e.g. the port of a Playback_MIDI_Output_ALSA.
+	// The sequencer stamps every event on arrival with the time of a queue related to the IClock,
+	// so how late the messages are read does not change their measured time
+	class Playback_MIDI_Capture_ALSA
+	{
+	public:
+		struct Captured_Message
+		{
+			int64_t Time_us;		// Arrival on the clock
+			unsigned char Status;
+			unsigned char Data1;
+			unsigned char Data2;
+		};
+
+		// Events the sequencer keeps for this client until they are read
+		static const int INPUT_POOL_SIZE = 2000;
+
+	private:
+		void* _Sequencer;		// snd_seq_t*
+		void* _Decoder;			// snd_midi_event_t*
+		int _Port;
+		int _Queue;
+		IClock* _Clock;
+		int64_t _Queue_Origin_us;
+
+	public:
+		Playback_MIDI_Capture_ALSA();
+		~Playback_MIDI_Capture_ALSA();
+
+		bool Open(const char* client_name, int source_client, int source_port, IClock* clock);
+		bool Is_Open();
+		void Close();
+
+		// Appends the messages that arrived since the last call and returns their number, does not wait.
+		// SysEx messages are skipped
+		size_t Read(std::vector<Captured_Message>& messages);
+	};
+}
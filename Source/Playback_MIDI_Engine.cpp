@@ -1,73 +1,46 @@
 #include "Playback_MIDI_Engine.h"
 #include "Playback_Event_Queue_Manager.h"
-#include <msclr/lock.h>
+#include "Playback_MIDI_Bandwidth_Report.h"
+#include "Playback_MIDI_Offline_Render.h"
+
+#include <vector>
+#include <msclr\marshal_cppstd.h>
 
 namespace MIDILightDrawer
 {
-	ref class Engine_Callback_Helper {
-	public:
-		static Playback_MIDI_Engine^ Instance = nullptr;
-		static Object^ SyncLock = gcnew Object();
-	};
-
-	void Native_Event_Sent_Callback(const Playback_MIDI_Engine_Native::MIDI_Event& event)
-	{
-		// Get the managed instance with thread-safe access
-		Playback_MIDI_Engine^ Managed_Instance = nullptr;
-		Playback_Event_Queue_Manager^ Queue_Manager = nullptr;
-
-		{
-			msclr::lock Lock(Engine_Callback_Helper::SyncLock);
-			Managed_Instance = Engine_Callback_Helper::Instance;
-			if (Managed_Instance != nullptr) {
-				Queue_Manager = Managed_Instance->_Event_Queue_Manager;
-			}
-		}
-
-		if (Managed_Instance != nullptr && Queue_Manager != nullptr)
-		{
-			// Convert native event to managed
-			Playback_MIDI_Event^ Managed_Event = gcnew Playback_MIDI_Event();
-			Managed_Event->Timestamp_ms = event.Timestamp_ms;
-			Managed_Event->Timeline_Track_ID = event.Track;
-			Managed_Event->MIDI_Channel = event.Channel;
-			Managed_Event->MIDI_Command = event.Command;
-			Managed_Event->MIDI_Data1 = event.Data1;
-			Managed_Event->MIDI_Data2 = event.Data2;
-
-			// Notify queue manager
-			Queue_Manager->On_Event_Sent(Managed_Event);
-		}
-	}
-	
 	Playback_MIDI_Engine::Playback_MIDI_Engine()
 	{
 		_Is_Initialized = false;
+		_Event_Queue_Manager = nullptr;
+
+		_Pending_Events = gcnew List<Playback_MIDI_Event^>();
+		_Pending_Index = 0;
+
+		_Last_Metrics = new Playback_MIDI_Engine_Metrics::Snapshot();
+		_Metrics_History = new std::vector<Playback_MIDI_Engine_Metrics::Snapshot>();
+		_Metrics_Recording = false;
+		_Metrics_Interval_ms = 100.0;
 	}
 
 	Playback_MIDI_Engine::~Playback_MIDI_Engine()
 	{
 		Cleanup();
 
-		{
-			msclr::lock Lock(Engine_Callback_Helper::SyncLock);
-			if (Engine_Callback_Helper::Instance == this) {
-				Engine_Callback_Helper::Instance = nullptr;
-			}
-		}
+		this->!Playback_MIDI_Engine();
 	}
 
-	void Playback_MIDI_Engine::Set_Event_Queue_Manager(Playback_Event_Queue_Manager^ manager)
+	Playback_MIDI_Engine::!Playback_MIDI_Engine()
 	{
-		_Event_Queue_Manager = manager;
+		delete _Last_Metrics;
+		_Last_Metrics = nullptr;
 
-		{
-			msclr::lock Lock(Engine_Callback_Helper::SyncLock);
-			Engine_Callback_Helper::Instance = this;
-		}
+		delete _Metrics_History;
+		_Metrics_History = nullptr;
+	}
 
-		// Set native callback
-		Playback_MIDI_Engine_Native::Set_Event_Sent_Callback(&Native_Event_Sent_Callback);
+	void Playback_MIDI_Engine::Set_Event_Queue_Manager(Playback_Event_Queue_Manager^ manager)
+	{
+		_Event_Queue_Manager = manager;
 	}
 
 	bool Playback_MIDI_Engine::Initialize(int device_id)
@@ -97,15 +70,7 @@ namespace MIDILightDrawer
 			return false;
 		}
 
-		Playback_MIDI_Engine_Native::MIDI_Event Native_Event;
-		Native_Event.Timestamp_ms = event->Timestamp_ms;
-		Native_Event.Track = event->Timeline_Track_ID;
-		Native_Event.Channel = event->MIDI_Channel;
-		Native_Event.Command = event->MIDI_Command;
-		Native_Event.Data1 = event->MIDI_Data1;
-		Native_Event.Data2 = event->MIDI_Data2;
-
-		return Playback_MIDI_Engine_Native::Send_MIDI_Event(Native_Event);
+		return Playback_MIDI_Engine_Native::Send_MIDI_Event(MIDI_Playback_Event_To_Native(event));
 	}
 
 	bool Playback_MIDI_Engine::Send_All_Notes_Off(int channel)
@@ -113,6 +78,62 @@ namespace MIDILightDrawer
 		return Playback_MIDI_Engine_Native::Send_All_Notes_Off(channel);
 	}
 
+	int Playback_MIDI_Engine::Add_Output_Port(int device_id)
+	{
+		if (!_Is_Initialized) {
+			return -1;
+		}
+
+		return Playback_MIDI_Engine_Native::Add_Output_Port(device_id);
+	}
+
+	bool Playback_MIDI_Engine::Remove_Output_Ports()
+	{
+		return Playback_MIDI_Engine_Native::Remove_Output_Ports();
+	}
+
+	void Playback_MIDI_Engine::Set_Track_Port(int track_index, int port)
+	{
+		Playback_MIDI_Engine_Native::Set_Track_Port(track_index, port);
+	}
+
+	void Playback_MIDI_Engine::Set_Track_Enabled(int track_index, bool enabled)
+	{
+		Playback_MIDI_Engine_Native::Set_Track_Enabled(track_index, enabled);
+	}
+
+	void Playback_MIDI_Engine::Set_Track_Mute_Solo(int track_count, List<int>^ muted_tracks, List<int>^ soloed_tracks)
+	{
+		std::vector<int> Muted_Tracks;
+		std::vector<int> Soloed_Tracks;
+
+		if (muted_tracks != nullptr)
+		{
+			for each (int Track_Index in muted_tracks) {
+				Muted_Tracks.push_back(Track_Index);
+			}
+		}
+
+		if (soloed_tracks != nullptr)
+		{
+			for each (int Track_Index in soloed_tracks) {
+				Soloed_Tracks.push_back(Track_Index);
+			}
+		}
+
+		Playback_MIDI_Engine_Native::Set_Track_Mute_Solo(track_count, Muted_Tracks.data(), Muted_Tracks.size(), Soloed_Tracks.data(), Soloed_Tracks.size());
+	}
+
+	void Playback_MIDI_Engine::Set_Port_Bytes_Per_Second(int port, int bytes_per_second)
+	{
+		Playback_MIDI_Engine_Native::Set_Port_Bytes_Per_Second(port, bytes_per_second);
+	}
+
+	void Playback_MIDI_Engine::Set_Batch_Window_ms(double window_ms)
+	{
+		Playback_MIDI_Engine_Native::Set_Batch_Window_us(static_cast<int64_t>(window_ms * 1000.0));
+	}
+
 	void Playback_MIDI_Engine::Set_Audio_Available(bool available)
 	{
 		Playback_MIDI_Engine_Native::Set_Audio_Available(available);
@@ -134,7 +155,13 @@ namespace MIDILightDrawer
 
 	bool Playback_MIDI_Engine::Stop_Playback()
 	{
-		return Playback_MIDI_Engine_Native::Stop_Playback_Thread();
+		bool Success = Playback_MIDI_Engine_Native::Stop_Playback_Thread();
+
+		// The native queue is cleared by the stopped thread, drop the events still waiting for it as well
+		_Pending_Events->Clear();
+		_Pending_Index = 0;
+
+		return Success;
 	}
 
 	void Playback_MIDI_Engine::Queue_Event(Playback_MIDI_Event^ event)
@@ -143,12 +170,27 @@ namespace MIDILightDrawer
 			return;
 		}
 
-		Playback_MIDI_Engine_Native::Queue_MIDI_Event(Playback_MIDI_Engine::MIDI_Playback_Event_To_Native(event));
+		// Keep the order: once events are pending, new ones have to wait behind them
+		if (_Pending_Index < _Pending_Events->Count || !Playback_MIDI_Engine_Native::Queue_MIDI_Event(Playback_MIDI_Engine::MIDI_Playback_Event_To_Native(event))) {
+			_Pending_Events->Add(event);
+		}
 	}
 
 	void Playback_MIDI_Engine::Queue_Event(Playback_MIDI_Engine_Native::MIDI_Event event)
 	{
-		Playback_MIDI_Engine_Native::Queue_MIDI_Event(event);
+		if (_Pending_Index < _Pending_Events->Count || !Playback_MIDI_Engine_Native::Queue_MIDI_Event(event))
+		{
+			Playback_MIDI_Event^ Pending_Event = gcnew Playback_MIDI_Event();
+			Pending_Event->Timestamp_ms = event.Timestamp_ms;
+			Pending_Event->Tick = event.Tick;
+			Pending_Event->Timeline_Track_ID = event.Track;
+			Pending_Event->MIDI_Channel = event.Channel;
+			Pending_Event->MIDI_Command = event.Command;
+			Pending_Event->MIDI_Data1 = event.Data1;
+			Pending_Event->MIDI_Data2 = event.Data2;
+
+			_Pending_Events->Add(Pending_Event);
+		}
 	}
 
 	void Playback_MIDI_Engine::Queue_Events(List<Playback_MIDI_Event^>^ events)
@@ -158,11 +200,251 @@ namespace MIDILightDrawer
 		}
 	}
 
+	void Playback_MIDI_Engine::Load_Schedule(List<Playback_MIDI_Event^>^ events, List<double>^ checkpoint_times_ms, List<Playback_Tempo_Segment>^ tempo_segments)
+	{
+		std::vector<Playback_MIDI_Engine_Native::MIDI_Event> Native_Events;
+		Fill_Native_Events(events, Native_Events);
+
+		std::vector<int64_t> Checkpoint_Times_us;
+		Fill_Native_Checkpoints(checkpoint_times_ms, Checkpoint_Times_us);
+
+		Playback_MIDI_Engine_Native::Load_Schedule(Native_Events.data(), Native_Events.size(), Checkpoint_Times_us.data(), Checkpoint_Times_us.size(), Create_Native_Tempo_Map(tempo_segments));
+	}
+
+	void Playback_MIDI_Engine::Set_Playback_Speed(double speed)
+	{
+		Playback_MIDI_Engine_Native::Set_Playback_Speed(speed);
+	}
+
+	String^ Playback_MIDI_Engine::Create_Bandwidth_Report(List<Playback_MIDI_Event^>^ events)
+	{
+		std::vector<Playback_MIDI_Engine_Native::MIDI_Event> Native_Events;
+		Fill_Native_Events(events, Native_Events);
+
+		// Same sorting and note pairing as the schedule the playback thread sends from
+		Playback_MIDI_Schedule Schedule(Native_Events.data(), Native_Events.size(), nullptr, 0);
+		std::string Report = Playback_MIDI_Bandwidth_Report::Format_Report(Playback_MIDI_Bandwidth_Report::Analyze(Schedule));
+
+		return gcnew String(Report.c_str());
+	}
+
+	bool Playback_MIDI_Engine::Render_Offline_Log(List<Playback_MIDI_Event^>^ events, List<double>^ checkpoint_times_ms, List<Playback_Tempo_Segment>^ tempo_segments, double start_position_ms, String^ filename, String^% report)
+	{
+		if (String::IsNullOrEmpty(filename)) {
+			return false;
+		}
+
+		std::vector<Playback_MIDI_Engine_Native::MIDI_Event> Native_Events;
+		Fill_Native_Events(events, Native_Events);
+
+		std::vector<int64_t> Checkpoint_Times_us;
+		Fill_Native_Checkpoints(checkpoint_times_ms, Checkpoint_Times_us);
+
+		// A schedule of its own, the one of the engine may be playing at the same time
+		Playback_MIDI_Schedule* Schedule = new Playback_MIDI_Schedule(Native_Events.data(), Native_Events.size(), Checkpoint_Times_us.data(), Checkpoint_Times_us.size(), Create_Native_Tempo_Map(tempo_segments));
+
+		Playback_MIDI_Render_Log Log;
+		Playback_MIDI_Offline_Render::Report Render_Report = Playback_MIDI_Offline_Render::Render(Schedule, static_cast<int64_t>(start_position_ms * 1000.0), Log);
+
+		report = gcnew String(Playback_MIDI_Offline_Render::Format_Report(Render_Report).c_str());
+
+		if (!Render_Report.Success) {
+			return false;
+		}
+
+		return Log.Save_To_File(msclr::interop::marshal_as<std::string>(filename));
+	}
+
+	Playback_Engine_Metrics Playback_MIDI_Engine::Get_Metrics()
+	{
+		Playback_MIDI_Engine_Metrics::Snapshot Snapshot = Playback_MIDI_Engine_Native::Get_Metrics();
+		Playback_Engine_Metrics Metrics = Metrics_To_Managed(Snapshot, *_Last_Metrics);
+
+		*_Last_Metrics = Snapshot;
+
+		return Metrics;
+	}
+
+	void Playback_MIDI_Engine::Start_Metrics_Recording(double interval_ms)
+	{
+		// Shorter intervals add rows faster than they add information at the rate the UI services the queues
+		_Metrics_Interval_ms = Math::Max(interval_ms, 10.0);
+		_Metrics_History->clear();
+		_Metrics_Recording = true;
+
+		Sample_Metrics();
+	}
+
+	void Playback_MIDI_Engine::Stop_Metrics_Recording()
+	{
+		_Metrics_Recording = false;
+	}
+
+	bool Playback_MIDI_Engine::Save_Metrics_CSV(String^ filename)
+	{
+		if (String::IsNullOrEmpty(filename)) {
+			return false;
+		}
+
+		return Playback_MIDI_Engine_Metrics::Save_CSV(msclr::interop::marshal_as<std::string>(filename), *_Metrics_History);
+	}
+
+	String^ Playback_MIDI_Engine::Compare_Render_Log(String^ log_filename, String^ reference_filename, double tolerance_ms)
+	{
+		if (String::IsNullOrEmpty(log_filename) || String::IsNullOrEmpty(reference_filename)) {
+			return nullptr;
+		}
+
+		Playback_MIDI_Render_Log Log;
+
+		if (!Log.Load_From_File(msclr::interop::marshal_as<std::string>(log_filename))) {
+			return nullptr;
+		}
+
+		std::string Reference_Filename = msclr::interop::marshal_as<std::string>(reference_filename);
+		std::vector<Playback_MIDI_Render_Log::Record> Reference_Records;
+		int64_t Time_Offset_us = Playback_MIDI_Scheduler::LOOKAHEAD_US;
+
+		Playback_MIDI_Render_Log Reference_Log;
+
+		if (Reference_Log.Load_From_File(Reference_Filename))
+		{
+			// Both are renders, their sends are compared as they are
+			Reference_Records = Reference_Log.Get_Records();
+			Time_Offset_us = 0;
+		}
+		else if (!Playback_MIDI_Render_Log::Read_Standard_MIDI_File(Reference_Filename, Reference_Records)) {
+			return nullptr;
+		}
+
+		Playback_MIDI_Render_Log::Comparison Comparison = Playback_MIDI_Render_Log::Compare(Log.Get_Records(), Reference_Records, Time_Offset_us, static_cast<int64_t>(tolerance_ms * 1000.0));
+
+		return gcnew String(Playback_MIDI_Render_Log::Format_Comparison(Comparison).c_str());
+	}
+
 	void Playback_MIDI_Engine::Clear_Event_Queue()
 	{
+		_Pending_Events->Clear();
+		_Pending_Index = 0;
+
 		Playback_MIDI_Engine_Native::Clear_Event_Queue();
 	}
 
+	void Playback_MIDI_Engine::Service_Event_Queues()
+	{
+		Feed_Pending_Events();
+
+		if (_Metrics_Recording) {
+			Sample_Metrics();
+		}
+
+		// A schedule published during playback is only taken over while the thread can retire the one it replaces
+		Playback_MIDI_Engine_Native::Free_Retired_Schedules();
+
+		// Report the events the playback thread has sent since the last call. No managed event per sent event,
+		// the MIDI log reads its own copy from the journal
+		Playback_MIDI_Engine_Native::MIDI_Event Sent_Event;
+
+		while (Playback_MIDI_Engine_Native::Pop_Sent_Event(Sent_Event))
+		{
+			if (_Event_Queue_Manager == nullptr) {
+				continue;
+			}
+
+			_Event_Queue_Manager->On_Event_Sent(Sent_Event.Track, Sent_Event.Channel, Sent_Event.Command, Sent_Event.Data1, Sent_Event.Data2);
+		}
+	}
+
+	void Playback_MIDI_Engine::Feed_Pending_Events()
+	{
+		while (_Pending_Index < _Pending_Events->Count)
+		{
+			if (!Playback_MIDI_Engine_Native::Queue_MIDI_Event(MIDI_Playback_Event_To_Native(_Pending_Events[_Pending_Index]))) {
+				return;
+			}
+
+			_Pending_Index++;
+		}
+
+		_Pending_Events->Clear();
+		_Pending_Index = 0;
+	}
+
+	void Playback_MIDI_Engine::Sample_Metrics()
+	{
+		Playback_MIDI_Engine_Metrics::Snapshot Snapshot = Playback_MIDI_Engine_Native::Get_Metrics();
+
+		if (!_Metrics_History->empty() && (double)(Snapshot.Time_us - _Metrics_History->back().Time_us) < _Metrics_Interval_ms * 1000.0) {
+			return;
+		}
+
+		_Metrics_History->push_back(Snapshot);
+	}
+
+	Playback_Engine_Metrics Playback_MIDI_Engine::Metrics_To_Managed(const Playback_MIDI_Engine_Metrics::Snapshot& snapshot, const Playback_MIDI_Engine_Metrics::Snapshot& previous)
+	{
+		Playback_Engine_Metrics Metrics;
+		Metrics.Time_ms = (double)snapshot.Time_us / 1000.0;
+		Metrics.Position_ms = (double)snapshot.Position_us / 1000.0;
+		Metrics.Events_Sent = snapshot.Events_Sent;
+		Metrics.Events_Per_Second = Playback_MIDI_Engine_Metrics::Get_Events_Per_Second(previous, snapshot);
+		Metrics.Batch_Count = snapshot.Batch_Count;
+		Metrics.Wakeup_Count = snapshot.Wakeup_Count;
+		Metrics.Spin_Count = snapshot.Spin_Count;
+		Metrics.Queue_Depth = (int)snapshot.Queue_Depth;
+		Metrics.Queue_Depth_Max = (int)snapshot.Queue_Depth_Max;
+		Metrics.Late_Count = snapshot.Late_Count;
+		Metrics.Lateness_Max_ms = (double)snapshot.Lateness_Max_us / 1000.0;
+		Metrics.Lateness_Average_ms = snapshot.Lateness_Average_us / 1000.0;
+		Metrics.Send_Call_Count = snapshot.Send_Call_Count;
+		Metrics.Send_Time_Max_ms = (double)snapshot.Send_Time_Max_us / 1000.0;
+		Metrics.Send_Time_Average_ms = snapshot.Send_Time_Average_us / 1000.0;
+
+		return Metrics;
+	}
+
+	void Playback_MIDI_Engine::Fill_Native_Events(List<Playback_MIDI_Event^>^ events, std::vector<Playback_MIDI_Engine_Native::MIDI_Event>& native_events)
+	{
+		int Event_Count = (events != nullptr) ? events->Count : 0;
+
+		native_events.reserve(Event_Count);
+
+		for (int i = 0; i < Event_Count; i++) {
+			native_events.push_back(MIDI_Playback_Event_To_Native(events[i]));
+		}
+	}
+
+	void Playback_MIDI_Engine::Fill_Native_Checkpoints(List<double>^ checkpoint_times_ms, std::vector<int64_t>& checkpoint_times_us)
+	{
+		int Checkpoint_Count = (checkpoint_times_ms != nullptr) ? checkpoint_times_ms->Count : 0;
+
+		checkpoint_times_us.reserve(Checkpoint_Count);
+
+		for (int i = 0; i < Checkpoint_Count; i++) {
+			checkpoint_times_us.push_back(static_cast<int64_t>(checkpoint_times_ms[i] * 1000.0));
+		}
+	}
+
+	Playback_Tempo_Map Playback_MIDI_Engine::Create_Native_Tempo_Map(List<Playback_Tempo_Segment>^ tempo_segments)
+	{
+		int Segment_Count = (tempo_segments != nullptr) ? tempo_segments->Count : 0;
+
+		std::vector<Playback_Tempo_Map::Segment> Native_Segments;
+		Native_Segments.reserve(Segment_Count);
+
+		for (int i = 0; i < Segment_Count; i++)
+		{
+			Playback_Tempo_Map::Segment Native_Segment;
+			Native_Segment.Start_Tick = tempo_segments[i].Start_Tick;
+			Native_Segment.Start_us = tempo_segments[i].Start_ms * 1000.0;
+			Native_Segment.Us_Per_Tick = tempo_segments[i].Ms_Per_Tick * 1000.0;
+
+			Native_Segments.push_back(Native_Segment);
+		}
+
+		return Playback_Tempo_Map(Native_Segments.data(), Native_Segments.size());
+	}
+
 	double Playback_MIDI_Engine::Get_Current_Position_ms()
 	{
 		int64_t Position_Us = Playback_MIDI_Engine_Native::Get_Current_Position_us();
@@ -184,6 +466,7 @@ namespace MIDILightDrawer
 	{
 		Playback_MIDI_Engine_Native::MIDI_Event Native_Event;
 		Native_Event.Timestamp_ms = event->Timestamp_ms;
+		Native_Event.Tick = event->Tick;
 		Native_Event.Track = event->Timeline_Track_ID;
 		Native_Event.Channel = event->MIDI_Channel;
 		Native_Event.Command = event->MIDI_Command;
@@ -20,7 +20,35 @@ namespace MIDILightDrawer
 		unsigned char MIDI_Data1;
 		unsigned char MIDI_Data2;
 
-		Playback_MIDI_Event() : Timestamp_ms(0), Timeline_Track_ID(0), MIDI_Channel(0), MIDI_Command(0), MIDI_Data1(0), MIDI_Data2(0) { }
+		Playback_MIDI_Event() : Timestamp_ms(0), Tick(0), Timeline_Track_ID(0), MIDI_Channel(0), MIDI_Command(0), MIDI_Data1(0), MIDI_Data2(0) { }
+	};
+
+	// One tempo of the timeline, typically a measure: from Start_Tick on, every tick lasts Ms_Per_Tick
+	public value struct Playback_Tempo_Segment
+	{
+		int Start_Tick;
+		double Start_ms;
+		double Ms_Per_Tick;
+	};
+
+	// Playback_MIDI_Engine_Metrics::Snapshot for the UI, times in milliseconds
+	public value struct Playback_Engine_Metrics
+	{
+		double Time_ms;
+		double Position_ms;
+		UInt64 Events_Sent;
+		double Events_Per_Second;	// Since the previous snapshot of the same kind
+		UInt64 Batch_Count;
+		UInt64 Wakeup_Count;
+		UInt64 Spin_Count;
+		int Queue_Depth;
+		int Queue_Depth_Max;
+		UInt64 Late_Count;
+		double Lateness_Max_ms;
+		double Lateness_Average_ms;
+		UInt64 Send_Call_Count;
+		double Send_Time_Max_ms;
+		double Send_Time_Average_ms;
 	};
 
 	public ref class Playback_MIDI_Engine
@@ -28,13 +56,22 @@ namespace MIDILightDrawer
 	private:
 		bool _Is_Initialized;
 
-	public:
-		// Neets to be public in order to be accesible from Engine_Callback_Helper class
 		Playback_Event_Queue_Manager^ _Event_Queue_Manager;
 
+		// Events that did not fit into the native queue yet. Only touched on the UI thread
+		List<Playback_MIDI_Event^>^ _Pending_Events;
+		int _Pending_Index;
+
+		// Metrics sampled while servicing the queues, for the CSV dump. Only touched on the UI thread
+		Playback_MIDI_Engine_Metrics::Snapshot* _Last_Metrics;
+		std::vector<Playback_MIDI_Engine_Metrics::Snapshot>* _Metrics_History;
+		bool _Metrics_Recording;
+		double _Metrics_Interval_ms;
+
 	public:
 		Playback_MIDI_Engine();
 		~Playback_MIDI_Engine();
+		!Playback_MIDI_Engine();
 
 		void Set_Event_Queue_Manager(Playback_Event_Queue_Manager^ manager);
 		bool Initialize(int device_id);
@@ -42,6 +79,21 @@ namespace MIDILightDrawer
 		void Cleanup();
 		bool Send_Event(Playback_MIDI_Event^ event);
 		bool Send_All_Notes_Off(int channel);
+
+		// Additional output devices, tracks are routed to port 0 (the device of Initialize) unless mapped otherwise
+		int Add_Output_Port(int device_id);
+		bool Remove_Output_Ports();
+		void Set_Track_Port(int track_index, int port);
+
+		// A disabled track stays in the schedule, its sounding notes are switched off by the playback thread
+		void Set_Track_Enabled(int track_index, bool enabled);
+
+		// Sets every track below track_count from the mute and solo lists, see Playback_MIDI_Scheduler::Set_Track_Mute_Solo
+		void Set_Track_Mute_Solo(int track_count, List<int>^ muted_tracks, List<int>^ soloed_tracks);
+
+		// Paces a port to its link capacity, 0 sends without pacing. Updates of the same light within the window are merged
+		void Set_Port_Bytes_Per_Second(int port, int bytes_per_second);
+		void Set_Batch_Window_ms(double window_ms);
 	
 		void Set_Audio_Available(bool available);
 		void Set_Audio_Position_us(int64_t position_us);
@@ -52,11 +104,80 @@ namespace MIDILightDrawer
 		void Queue_Event(Playback_MIDI_Event^ event);
 		void Queue_Event(Playback_MIDI_Engine_Native::MIDI_Event event);
 		void Queue_Events(List<Playback_MIDI_Event^>^ events);
+		void Load_Schedule(List<Playback_MIDI_Event^>^ events, List<double>^ checkpoint_times_ms, List<Playback_Tempo_Segment>^ tempo_segments);
+
+		// MIDI-only playback runs at this rate of real time, changes take effect right away
+		void Set_Playback_Speed(double speed);
+
+		// Link usage of the events sent as note messages compared to SysEx frames
+		String^ Create_Bandwidth_Report(List<Playback_MIDI_Event^>^ events);
+
+		// Plays the events through the scheduler on a virtual clock, as fast as it runs, and saves every sent event
+		// with its intended and actual time to a binary log. Needs no device, the report sums up the lateness
+		bool Render_Offline_Log(List<Playback_MIDI_Event^>^ events, List<double>^ checkpoint_times_ms, List<Playback_Tempo_Segment>^ tempo_segments, double start_position_ms, String^ filename, String^% report);
+
+		// Counters of the playback thread since the last start. Cheap enough to call on every UI update
+		Playback_Engine_Metrics Get_Metrics();
+
+		// Samples the metrics every interval while the queues are serviced, from the start of recording on
+		void Start_Metrics_Recording(double interval_ms);
+		void Stop_Metrics_Recording();
+		bool Save_Metrics_CSV(String^ filename);
+
+		// Reference is another render log or a Standard MIDI File. The sends of the log count at their timestamp, i.e. plus the lookahead
+		static String^ Compare_Render_Log(String^ log_filename, String^ reference_filename, double tolerance_ms);
 		void Clear_Event_Queue();
+		void Service_Event_Queues();
 		double Get_Current_Position_ms();
 		void Set_Current_Position_ms(double position_ms);
 		bool Is_Playing();
 
+		property UInt64 Sent_Events_Dropped {
+			UInt64 get() { return Playback_MIDI_Engine_Native::Get_Sent_Events_Dropped(); }
+		}
+
+		property int Output_Port_Count {
+			int get() { return Playback_MIDI_Engine_Native::Get_Output_Port_Count(); }
+		}
+
+		property UInt64 Link_Coalesced_Count {
+			UInt64 get() { return Playback_MIDI_Engine_Native::Get_Link_Statistics().Coalesced_Count; }
+		}
+
+		property UInt64 Link_Dropped_Count {
+			UInt64 get() { return Playback_MIDI_Engine_Native::Get_Link_Statistics().Dropped_Count; }
+		}
+
+		property UInt64 Link_Late_Count {
+			UInt64 get() { return Playback_MIDI_Engine_Native::Get_Link_Statistics().Late_Count; }
+		}
+
+		property double Link_Wait_Max_ms {
+			double get() { return (double)Playback_MIDI_Engine_Native::Get_Link_Statistics().Wait_Max_us / 1000.0; }
+		}
+
+		property bool Is_Metrics_Recording {
+			bool get() { return _Metrics_Recording; }
+		}
+
+		property int Metrics_Sample_Count {
+			int get() { return (int)_Metrics_History->size(); }
+		}
+
+		property bool SysEx_Frame_Mode {
+			bool get() { return Playback_MIDI_Engine_Native::Is_SysEx_Frame_Mode(); }
+			void set(bool value) { Playback_MIDI_Engine_Native::Set_SysEx_Frame_Mode(value); }
+		}
+
+	private:
+		void Feed_Pending_Events();
+		void Sample_Metrics();
+		static Playback_Engine_Metrics Metrics_To_Managed(const Playback_MIDI_Engine_Metrics::Snapshot& snapshot, const Playback_MIDI_Engine_Metrics::Snapshot& previous);
+		static void Fill_Native_Events(List<Playback_MIDI_Event^>^ events, std::vector<Playback_MIDI_Engine_Native::MIDI_Event>& native_events);
+		static void Fill_Native_Checkpoints(List<double>^ checkpoint_times_ms, std::vector<int64_t>& checkpoint_times_us);
+		static Playback_Tempo_Map Create_Native_Tempo_Map(List<Playback_Tempo_Segment>^ tempo_segments);
+
+	public:
 		static Playback_MIDI_Engine_Native::MIDI_Event MIDI_Playback_Event_To_Native(Playback_MIDI_Event^ event);
 	};
 }
\ No newline at end of file
@@ -0,0 +1,161 @@
+#ifdef _MSC_VER
+#pragma managed(push, off)
+#endif
+
+#include "Playback_MIDI_Engine_Metrics.h"
+
+#include <fstream>
+#include <cstdio>
+
+namespace MIDILightDrawer
+{
+	Playback_MIDI_Engine_Metrics::Playback_MIDI_Engine_Metrics()
+	{
+		Reset();
+	}
+
+	void Playback_MIDI_Engine_Metrics::Reset()
+	{
+		_Events_Sent.store(0, std::memory_order_relaxed);
+		_Batch_Count.store(0, std::memory_order_relaxed);
+		_Wakeup_Count.store(0, std::memory_order_relaxed);
+		_Spin_Count.store(0, std::memory_order_relaxed);
+		_Queue_Depth.store(0, std::memory_order_relaxed);
+		_Queue_Depth_Max.store(0, std::memory_order_relaxed);
+		_Late_Count.store(0, std::memory_order_relaxed);
+		_Lateness_Count.store(0, std::memory_order_relaxed);
+		_Lateness_Total_us.store(0, std::memory_order_relaxed);
+		_Lateness_Max_us.store(0, std::memory_order_relaxed);
+	}
+
+	void Playback_MIDI_Engine_Metrics::Add_Event_Sent()
+	{
+		Increment(_Events_Sent, 1);
+	}
+
+	void Playback_MIDI_Engine_Metrics::Add_Batch()
+	{
+		Increment(_Batch_Count, 1);
+	}
+
+	void Playback_MIDI_Engine_Metrics::Add_Wakeup()
+	{
+		Increment(_Wakeup_Count, 1);
+	}
+
+	void Playback_MIDI_Engine_Metrics::Add_Spin()
+	{
+		Increment(_Spin_Count, 1);
+	}
+
+	void Playback_MIDI_Engine_Metrics::Add_Lateness(int64_t lateness_us)
+	{
+		// Events of a batch may go out a little early, that is no lateness
+		if (lateness_us < 0) {
+			lateness_us = 0;
+		}
+
+		Increment(_Lateness_Count, 1);
+		_Lateness_Total_us.store(_Lateness_Total_us.load(std::memory_order_relaxed) + lateness_us, std::memory_order_relaxed);
+
+		if (lateness_us > _Lateness_Max_us.load(std::memory_order_relaxed)) {
+			_Lateness_Max_us.store(lateness_us, std::memory_order_relaxed);
+		}
+
+		if (lateness_us > LATE_THRESHOLD_US) {
+			Increment(_Late_Count, 1);
+		}
+	}
+
+	void Playback_MIDI_Engine_Metrics::Set_Queue_Depth(size_t depth)
+	{
+		_Queue_Depth.store(depth, std::memory_order_relaxed);
+
+		if (depth > _Queue_Depth_Max.load(std::memory_order_relaxed)) {
+			_Queue_Depth_Max.store(depth, std::memory_order_relaxed);
+		}
+	}
+
+	Playback_MIDI_Engine_Metrics::Snapshot Playback_MIDI_Engine_Metrics::Get_Snapshot() const
+	{
+		Snapshot Result = Snapshot();
+		Result.Events_Sent = _Events_Sent.load(std::memory_order_relaxed);
+		Result.Batch_Count = _Batch_Count.load(std::memory_order_relaxed);
+		Result.Wakeup_Count = _Wakeup_Count.load(std::memory_order_relaxed);
+		Result.Spin_Count = _Spin_Count.load(std::memory_order_relaxed);
+		Result.Queue_Depth = (size_t)_Queue_Depth.load(std::memory_order_relaxed);
+		Result.Queue_Depth_Max = (size_t)_Queue_Depth_Max.load(std::memory_order_relaxed);
+		Result.Late_Count = _Late_Count.load(std::memory_order_relaxed);
+		Result.Lateness_Max_us = _Lateness_Max_us.load(std::memory_order_relaxed);
+
+		uint64_t Lateness_Count = _Lateness_Count.load(std::memory_order_relaxed);
+		Result.Lateness_Average_us = (Lateness_Count > 0) ? (double)_Lateness_Total_us.load(std::memory_order_relaxed) / (double)Lateness_Count : 0.0;
+
+		return Result;
+	}
+
+	double Playback_MIDI_Engine_Metrics::Get_Events_Per_Second(const Snapshot& previous, const Snapshot& current)
+	{
+		if (current.Time_us <= previous.Time_us || current.Events_Sent < previous.Events_Sent) {
+			return 0.0;
+		}
+
+		return (double)(current.Events_Sent - previous.Events_Sent) * 1000000.0 / (double)(current.Time_us - previous.Time_us);
+	}
+
+	std::string Playback_MIDI_Engine_Metrics::Format_CSV_Header()
+	{
+		return "Time_ms,Position_ms,Events_Sent,Events_Per_Second,Batches,Wakeups,Spins,Queue_Depth,Queue_Depth_Max,"
+			"Late_Events,Lateness_Max_us,Lateness_Average_us,Send_Calls,Send_Time_Max_us,Send_Time_Average_us\n";
+	}
+
+	std::string Playback_MIDI_Engine_Metrics::Format_CSV_Row(const Snapshot& snapshot, const Snapshot* previous)
+	{
+		char Line[512];
+
+		snprintf(Line, sizeof(Line), "%.3f,%.3f,%llu,%.1f,%llu,%llu,%llu,%zu,%zu,%llu,%lld,%.1f,%llu,%lld,%.2f\n",
+			(double)snapshot.Time_us / 1000.0,
+			(double)snapshot.Position_us / 1000.0,
+			(unsigned long long)snapshot.Events_Sent,
+			(previous != nullptr) ? Get_Events_Per_Second(*previous, snapshot) : 0.0,
+			(unsigned long long)snapshot.Batch_Count,
+			(unsigned long long)snapshot.Wakeup_Count,
+			(unsigned long long)snapshot.Spin_Count,
+			snapshot.Queue_Depth,
+			snapshot.Queue_Depth_Max,
+			(unsigned long long)snapshot.Late_Count,
+			(long long)snapshot.Lateness_Max_us,
+			snapshot.Lateness_Average_us,
+			(unsigned long long)snapshot.Send_Call_Count,
+			(long long)snapshot.Send_Time_Max_us,
+			snapshot.Send_Time_Average_us);
+
+		return Line;
+	}
+
+	bool Playback_MIDI_Engine_Metrics::Save_CSV(const std::string& filename, const std::vector<Snapshot>& snapshots)
+	{
+		std::ofstream File(filename, std::ios::binary);
+
+		if (!File) {
+			return false;
+		}
+
+		File << Format_CSV_Header();
+
+		for (size_t i = 0; i < snapshots.size(); i++) {
+			File << Format_CSV_Row(snapshots[i], (i > 0) ? &snapshots[i - 1] : nullptr);
+		}
+
+		return (bool)File;
+	}
+
+	void Playback_MIDI_Engine_Metrics::Increment(std::atomic<uint64_t>& counter, uint64_t amount)
+	{
+		counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+	}
+}
+
+#ifdef _MSC_VER
+#pragma managed(pop)
+#endif
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <atomic>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace MIDILightDrawer
+{
+	// Counters of the playback thread. Only the playback thread writes them, any thread can read them at any time.
+	// The values of a snapshot are read one by one, they may be a few events apart from each other
+	class Playback_MIDI_Engine_Metrics
+	{
+	public:
+		// Events sent later than this after they were due count as late
+		static const int64_t LATE_THRESHOLD_US = 1000;
+
+		struct Snapshot
+		{
+			int64_t Time_us;				// Clock time the snapshot was taken
+			int64_t Position_us;
+			uint64_t Events_Sent;
+			uint64_t Batch_Count;
+			uint64_t Wakeup_Count;			// Returns from the clock wait while playing
+			uint64_t Spin_Count;			// Busy waits for the last part before an event is due
+			size_t Queue_Depth;				// Queued events not sent yet, at the last wakeup
+			size_t Queue_Depth_Max;
+			uint64_t Late_Count;
+			int64_t Lateness_Max_us;		// Position at the send compared to Execute_Time_Us minus the lookahead
+			double Lateness_Average_us;
+			uint64_t Send_Call_Count;		// Calls into the output API, filled in by the engine from its outputs
+			int64_t Send_Time_Total_us;
+			int64_t Send_Time_Max_us;
+			double Send_Time_Average_us;
+		};
+
+	private:
+		std::atomic<uint64_t> _Events_Sent;
+		std::atomic<uint64_t> _Batch_Count;
+		std::atomic<uint64_t> _Wakeup_Count;
+		std::atomic<uint64_t> _Spin_Count;
+		std::atomic<uint64_t> _Queue_Depth;
+		std::atomic<uint64_t> _Queue_Depth_Max;
+		std::atomic<uint64_t> _Late_Count;
+		std::atomic<uint64_t> _Lateness_Count;
+		std::atomic<int64_t> _Lateness_Total_us;
+		std::atomic<int64_t> _Lateness_Max_us;
+
+	public:
+		Playback_MIDI_Engine_Metrics();
+
+		// Only while the playback thread is stopped
+		void Reset();
+
+		// Playback thread only
+		void Add_Event_Sent();
+		void Add_Batch();
+		void Add_Wakeup();
+		void Add_Spin();
+		void Add_Lateness(int64_t lateness_us);
+		void Set_Queue_Depth(size_t depth);
+
+		// Time and position are left to the caller
+		Snapshot Get_Snapshot() const;
+
+		// Events per second of clock time between two snapshots of the same run, 0 if the counters were reset in between
+		static double Get_Events_Per_Second(const Snapshot& previous, const Snapshot& current);
+
+		static std::string Format_CSV_Header();
+		static std::string Format_CSV_Row(const Snapshot& snapshot, const Snapshot* previous);
+		static bool Save_CSV(const std::string& filename, const std::vector<Snapshot>& snapshots);
+
+	private:
+		// Single writer: a plain load and store instead of a locked read-modify-write
+		static void Increment(std::atomic<uint64_t>& counter, uint64_t amount);
+	};
+}
@@ -1,35 +1,25 @@
 #pragma managed(push, off)
 
 #include "Playback_MIDI_Engine_Native.h"
+#include "Playback_MIDI_Output_WinMM.h"
+#include "Playback_Clock_Windows.h"
+#include "Playback_Audio_Engine_Native.h"
+
 #include <Windows.h>
 #include <mmsystem.h>
-#include <algorithm>
-#include <chrono>
-
-#include <string>
-#include <sstream>
-#include <iomanip>
 
 #pragma comment(lib, "winmm.lib")
 
 namespace MIDILightDrawer
 {
 	// Static member initialization
-	void* Playback_MIDI_Engine_Native::_MIDI_Handle = nullptr;
+	Playback_MIDI_Output_WinMM* Playback_MIDI_Engine_Native::_Output = nullptr;
+	Playback_Clock_Windows* Playback_MIDI_Engine_Native::_Clock = nullptr;
+	Playback_MIDI_Scheduler* Playback_MIDI_Engine_Native::_Scheduler = nullptr;
 	bool Playback_MIDI_Engine_Native::_Is_Initialized = false;
-	void (*Playback_MIDI_Engine_Native::_Event_Sent_Callback)(const MIDI_Event&) = nullptr;
-
-	// Threading members initialization
-	std::thread* Playback_MIDI_Engine_Native::_Midi_Thread = nullptr;
-	std::atomic<bool> Playback_MIDI_Engine_Native::_Is_Playing(false);
-	std::atomic<bool> Playback_MIDI_Engine_Native::_Should_Stop(false);
-	std::atomic<bool> Playback_MIDI_Engine_Native::_Reset_Timing(false);
-	std::atomic<int64_t> Playback_MIDI_Engine_Native::_Current_Position_us(0);
-	std::deque<Playback_MIDI_Engine_Native::Scheduled_MIDI_Event> Playback_MIDI_Engine_Native::_Event_Queue;
-	std::mutex Playback_MIDI_Engine_Native::_Event_Queue_Mutex;
-
-	std::atomic<bool> Playback_MIDI_Engine_Native::_Audio_Is_Available(false);
-	std::atomic<int64_t> Playback_MIDI_Engine_Native::_Audio_Position_us(0);
+	Playback_MIDI_Port_Router* Playback_MIDI_Engine_Native::_Router = nullptr;
+	std::vector<Playback_MIDI_Output_WinMM*> Playback_MIDI_Engine_Native::_Port_Outputs;
+	std::vector<Playback_Clock_Windows*> Playback_MIDI_Engine_Native::_Port_Clocks;
 
 	bool Playback_MIDI_Engine_Native::Initialize(int device_id)
 	{
@@ -37,17 +27,11 @@ namespace MIDILightDrawer
 			Cleanup();
 		}
 
-		HMIDIOUT Midi_Out;
-		MMRESULT Result = midiOutOpen(&Midi_Out, device_id, 0, 0, CALLBACK_NULL);
+		Get_Scheduler();
 
-		if (Result == MMSYSERR_NOERROR)
-		{
-			_MIDI_Handle = (void*)Midi_Out;
-			_Is_Initialized = true;
-			return true;
-		}
+		_Is_Initialized = _Output->Open(device_id);
 
-		return false;
+		return _Is_Initialized;
 	}
 
 	void Playback_MIDI_Engine_Native::Cleanup()
@@ -55,313 +39,358 @@ namespace MIDILightDrawer
 		// Stop playback thread first
 		Stop_Playback_Thread();
 
-		if (_MIDI_Handle)
-		{
-			midiOutClose((HMIDIOUT)_MIDI_Handle);
-			_MIDI_Handle = nullptr;
+		Remove_Output_Ports();
+
+		if (_Output != nullptr) {
+			_Output->Close();
 		}
 
 		_Is_Initialized = false;
 	}
 
-	void Playback_MIDI_Engine_Native::Set_Event_Sent_Callback(void (*callback)(const MIDI_Event&))
-	{
-		_Event_Sent_Callback = callback;
-	}
-
 	bool Playback_MIDI_Engine_Native::Send_MIDI_Event(const MIDI_Event& event)
 	{
-		if (!_Is_Initialized || !_MIDI_Handle) {
+		if (!_Is_Initialized) {
 			return false;
 		}
 
-		// Pack MIDI message into DWORD (status | data1 << 8 | data2 << 16)
-		DWORD Midi_Message = (event.Command | event.Channel) | (event.Data1 << 8) | (event.Data2 << 16);
-
-		MMRESULT Result = midiOutShortMsg((HMIDIOUT)_MIDI_Handle, Midi_Message);
-		return (Result == MMSYSERR_NOERROR);
+		return _Scheduler->Send_Event(event);
 	}
 
 	bool Playback_MIDI_Engine_Native::Send_All_Notes_Off(int channel)
 	{
-		if (!_Is_Initialized || !_MIDI_Handle) {
+		if (!_Is_Initialized) {
 			return false;
 		}
 
 		// Send CC 123 (All Notes Off) on the specified channel
-		DWORD Midi_Message = (0xB0 | channel) | (123 << 8) | (0 << 16);
-		MMRESULT Result = midiOutShortMsg((HMIDIOUT)_MIDI_Handle, Midi_Message);
+		if (_Scheduler->Get_Port_Router() != nullptr) {
+			return _Router->Send_Immediate_To_All_Ports((unsigned char)(0xB0 | channel), 123, 0);
+		}
 
-		return (Result == MMSYSERR_NOERROR);
+		return _Output->Send_Short_Message((unsigned char)(0xB0 | channel), 123, 0);
 	}
 
 	bool Playback_MIDI_Engine_Native::Is_Device_Open()
 	{
-		return _Is_Initialized && (_MIDI_Handle != nullptr);
+		return _Is_Initialized && _Output->Is_Open();
 	}
 
-	void Playback_MIDI_Engine_Native::Set_Audio_Available(bool available)
+	int Playback_MIDI_Engine_Native::Add_Output_Port(int device_id)
 	{
-		_Audio_Is_Available.store(available, std::memory_order_release);
+		if (!_Is_Initialized || _Scheduler->Is_Running()) {
+			return -1;
+		}
+
+		Playback_MIDI_Output_WinMM* Port_Output = new Playback_MIDI_Output_WinMM();
 
-		if (!available) {
-			// Clear audio position when audio stops
-			_Audio_Position_us.store(0, std::memory_order_release);
+		if (!Port_Output->Open(device_id)) {
+			delete Port_Output;
+			return -1;
 		}
-	}
 
-	void Playback_MIDI_Engine_Native::Set_Audio_Position_us(int64_t position_us)
-	{
-		_Audio_Position_us.store(position_us, std::memory_order_release);
+		// Ports are only added while the router is stopped
+		_Router->Stop();
+
+		if (_Router->Get_Port_Count() == 0)
+		{
+			_Port_Clocks.push_back(new Playback_Clock_Windows());
+			_Router->Add_Port(_Output, _Port_Clocks.back());
+		}
+
+		Playback_Clock_Windows* Port_Clock = new Playback_Clock_Windows();
+		int Port_Index = _Router->Add_Port(Port_Output, Port_Clock);
+
+		if (Port_Index < 0)
+		{
+			Port_Output->Close();
+			delete Port_Output;
+			delete Port_Clock;
+		}
+		else
+		{
+			_Port_Outputs.push_back(Port_Output);
+			_Port_Clocks.push_back(Port_Clock);
+		}
+
+		_Router->Start();
+		_Scheduler->Set_Port_Router(_Router);
+
+		return Port_Index;
 	}
 
-	bool Playback_MIDI_Engine_Native::Start_Playback_Thread()
+	bool Playback_MIDI_Engine_Native::Remove_Output_Ports()
 	{
-		if (!_Is_Initialized || !_MIDI_Handle) {
-			return false;
+		if (_Scheduler == nullptr) {
+			return true;
 		}
 
-		if (_Midi_Thread != nullptr) {
-			// Thread already running
+		if (_Scheduler->Is_Running()) {
 			return false;
 		}
 
-		// Set Windows timer resolution to 1ms for better precision
-		timeBeginPeriod(1);
+		// Back to sending on the calling thread, the port threads send what they still hold before they end
+		_Scheduler->Set_Port_Router(nullptr);
+		_Router->Stop();
+		_Router->Remove_All_Ports();
 
-		_Should_Stop.store(false, std::memory_order_release);
-		_Is_Playing.store(true, std::memory_order_release);
+		for (size_t i = 0; i < _Port_Outputs.size(); i++)
+		{
+			_Port_Outputs[i]->Close();
+			delete _Port_Outputs[i];
+		}
 
-		_Reset_Timing.store(true, std::memory_order_release);
+		for (size_t i = 0; i < _Port_Clocks.size(); i++) {
+			delete _Port_Clocks[i];
+		}
 
-		// Create and start the thread
-		_Midi_Thread = new std::thread(MIDI_Playback_Thread_Function);
+		_Port_Outputs.clear();
+		_Port_Clocks.clear();
 
 		return true;
 	}
 
-	bool Playback_MIDI_Engine_Native::Stop_Playback_Thread()
+	int Playback_MIDI_Engine_Native::Get_Output_Port_Count()
 	{
-		if (_Midi_Thread == nullptr) {
-			return true;  // Already stopped
-		}
+		// The single device counts as one port without the router
+		int Router_Port_Count = Get_Scheduler()->Get_Port_Router() != nullptr ? _Router->Get_Port_Count() : 0;
 
-		// Signal thread to stop
-		_Should_Stop.store(true, std::memory_order_release);
-		_Is_Playing.store(false, std::memory_order_release);
+		return Router_Port_Count > 0 ? Router_Port_Count : (Is_Device_Open() ? 1 : 0);
+	}
 
-		// Wait for thread to finish
-		if (_Midi_Thread->joinable()) {
-			_Midi_Thread->join();
-		}
+	void Playback_MIDI_Engine_Native::Set_Track_Port(int track, int port)
+	{
+		Get_Scheduler();
 
-		delete _Midi_Thread;
-		_Midi_Thread = nullptr;
+		// Kept by the router even while only one port exists, so the mapping can be set before the devices are opened
+		_Router->Set_Track_Port(track, port);
+	}
 
-		// Clear any remaining events
-		Clear_Event_Queue();
+	uint64_t Playback_MIDI_Engine_Native::Get_Port_Dropped_Count(int port)
+	{
+		Get_Scheduler();
 
-		// Restore timer resolution
-		timeEndPeriod(1);
+		return _Router->Get_Dropped_Count(port);
+	}
 
-		return true;
+	void Playback_MIDI_Engine_Native::Set_Track_Enabled(int track, bool enabled)
+	{
+		Get_Scheduler()->Set_Track_Enabled(track, enabled);
 	}
 
-	void Playback_MIDI_Engine_Native::Queue_MIDI_Event(const MIDI_Event& event)
+	void Playback_MIDI_Engine_Native::Set_Track_Mute_Solo(int track_count, const int* muted_tracks, size_t muted_count, const int* soloed_tracks, size_t soloed_count)
 	{
-		std::lock_guard<std::mutex> Lock(_Event_Queue_Mutex);
+		Get_Scheduler()->Set_Track_Mute_Solo(track_count, muted_tracks, muted_count, soloed_tracks, soloed_count);
+	}
 
-		Scheduled_MIDI_Event Scheduled;
-		Scheduled.Execute_Time_Us = static_cast<int64_t>(event.Timestamp_ms * 1000.0);
-		Scheduled.Event = event;
+	void Playback_MIDI_Engine_Native::Set_SysEx_Frame_Mode(bool enabled)
+	{
+		Get_Scheduler()->Set_Output_Mode(enabled ? Playback_MIDI_Scheduler::Output_Mode::SysEx_Frames : Playback_MIDI_Scheduler::Output_Mode::Note_Messages);
+	}
 
-		_Event_Queue.push_back(Scheduled);
+	bool Playback_MIDI_Engine_Native::Is_SysEx_Frame_Mode()
+	{
+		return Get_Scheduler()->Get_Output_Mode() == Playback_MIDI_Scheduler::Output_Mode::SysEx_Frames;
 	}
 
-	void Playback_MIDI_Engine_Native::Clear_Event_Queue()
+	void Playback_MIDI_Engine_Native::Set_Port_Bytes_Per_Second(int port, int bytes_per_second)
 	{
-		std::lock_guard<std::mutex> Lock(_Event_Queue_Mutex);
-		_Event_Queue.clear();
+		Get_Scheduler();
+
+		// Port 0 is paced by the scheduler while it sends directly, by its port thread once the router is in use
+		if (port == 0) {
+			_Scheduler->Set_Link_Bytes_Per_Second(bytes_per_second);
+		}
+
+		_Router->Set_Port_Bytes_Per_Second(port, bytes_per_second);
 	}
 
-	int64_t Playback_MIDI_Engine_Native::Get_Current_Position_us()
+	void Playback_MIDI_Engine_Native::Set_Batch_Window_us(int64_t window_us)
 	{
-		return _Current_Position_us.load(std::memory_order_acquire);
+		Get_Scheduler()->Set_Batch_Window_us(window_us);
 	}
 
-	void Playback_MIDI_Engine_Native::Set_Current_Position_us(int64_t position_us)
+	Playback_MIDI_Link_Shaper::Statistics Playback_MIDI_Engine_Native::Get_Link_Statistics()
 	{
-		_Current_Position_us.store(position_us, std::memory_order_release);
+		Playback_MIDI_Link_Shaper::Statistics Total = Get_Scheduler()->Get_Link_Statistics();
+
+		for (int i = 0; i < _Router->Get_Port_Count(); i++)
+		{
+			Playback_MIDI_Link_Shaper::Statistics Port_Statistics = _Router->Get_Link_Statistics(i);
 
-		if (_Audio_Is_Available.load()) {
-			_Audio_Position_us.store(position_us, std::memory_order_release);
+			Total.Sent_Count += Port_Statistics.Sent_Count;
+			Total.Coalesced_Count += Port_Statistics.Coalesced_Count;
+			Total.Dropped_Count += Port_Statistics.Dropped_Count;
+			Total.Late_Count += Port_Statistics.Late_Count;
+
+			if (Port_Statistics.Wait_Max_us > Total.Wait_Max_us) {
+				Total.Wait_Max_us = Port_Statistics.Wait_Max_us;
+			}
 		}
+
+		return Total;
 	}
 
-	bool Playback_MIDI_Engine_Native::Is_Playing_Threaded()
+	void Playback_MIDI_Engine_Native::Set_Audio_Available(bool available)
+	{
+		Get_Scheduler()->Set_Audio_Available(available);
+	}
+
+	void Playback_MIDI_Engine_Native::Set_Audio_Position_us(int64_t position_us)
 	{
-		return _Is_Playing.load(std::memory_order_acquire);
+		Get_Scheduler()->Set_Audio_Position_us(position_us);
 	}
 
-	// Precise sleep function for better timing
-	void Precise_Sleep_us(int64_t microseconds)
+	Playback_MIDI_Engine_Metrics::Snapshot Playback_MIDI_Engine_Native::Get_Metrics()
 	{
-		if (microseconds <= 0) return;
+		Playback_MIDI_Engine_Metrics::Snapshot Result = Get_Scheduler()->Get_Metrics();
 
-		// For very short sleeps, use pure busy-wait
-		if (microseconds < 500)
+		Playback_MIDI_Output_WinMM::Send_Statistics Total = _Output->Get_Send_Statistics();
+
+		for (size_t i = 0; i < _Port_Outputs.size(); i++)
 		{
-			LARGE_INTEGER Frequency, Start, Current;
-			QueryPerformanceFrequency(&Frequency);
-			QueryPerformanceCounter(&Start);
+			Playback_MIDI_Output_WinMM::Send_Statistics Port_Statistics = _Port_Outputs[i]->Get_Send_Statistics();
+
+			Total.Call_Count += Port_Statistics.Call_Count;
+			Total.Time_Total_us += Port_Statistics.Time_Total_us;
+
+			if (Port_Statistics.Time_Max_us > Total.Time_Max_us) {
+				Total.Time_Max_us = Port_Statistics.Time_Max_us;
+			}
+		}
 
-			int64_t Target_Ticks = (microseconds * Frequency.QuadPart) / 1000000LL;
+		Result.Send_Call_Count = Total.Call_Count;
+		Result.Send_Time_Total_us = Total.Time_Total_us;
+		Result.Send_Time_Max_us = Total.Time_Max_us;
+		Result.Send_Time_Average_us = (Total.Call_Count > 0) ? (double)Total.Time_Total_us / (double)Total.Call_Count : 0.0;
 
-			do {
-				QueryPerformanceCounter(&Current);
-			} while ((Current.QuadPart - Start.QuadPart) < Target_Ticks);
+		return Result;
+	}
 
-			return;
+	bool Playback_MIDI_Engine_Native::Start_Playback_Thread()
+	{
+		if (!_Is_Initialized) {
+			return false;
 		}
 
-		// For longer sleeps, sleep for most of the time, then busy-wait
-		if (microseconds > 1000)
-		{
-			int64_t Sleep_Time_Us = microseconds - 500;
-			std::this_thread::sleep_for(std::chrono::microseconds(Sleep_Time_Us));
+		if (_Scheduler->Is_Running()) {
+			// Thread already running
+			return false;
 		}
 
-		// Busy-wait for the last portion
-		LARGE_INTEGER Frequency, Start, Current;
-		QueryPerformanceFrequency(&Frequency);
-		QueryPerformanceCounter(&Start);
+		// Set Windows timer resolution to 1ms for better precision
+		timeBeginPeriod(1);
+
+		// The scheduler resets its counters when it starts, the driver call times start with it
+		_Output->Reset_Send_Statistics();
 
-		int64_t Remaining_Us = (microseconds > 1000) ? 500 : microseconds;
-		int64_t Target_Ticks = (Remaining_Us * Frequency.QuadPart) / 1000000LL;
+		for (size_t i = 0; i < _Port_Outputs.size(); i++) {
+			_Port_Outputs[i]->Reset_Send_Statistics();
+		}
+
+		if (!_Scheduler->Start()) {
+			timeEndPeriod(1);
+			return false;
+		}
 
-		do {
-			QueryPerformanceCounter(&Current);
-		} while ((Current.QuadPart - Start.QuadPart) < Target_Ticks);
+		return true;
 	}
 
-	void Playback_MIDI_Engine_Native::MIDI_Playback_Thread_Function()
+	bool Playback_MIDI_Engine_Native::Stop_Playback_Thread()
 	{
-		// MIDI thread does not maintains its own clock
-		// It now purely reads from audio position and processes events reactively (If Audio is available)
+		if (_Scheduler == nullptr || !_Scheduler->Is_Running()) {
+			return true;  // Already stopped
+		}
 
-		// Use high-resolution timer only for precise sleeping, NOT for timekeeping
-		LARGE_INTEGER Frequency;
-		QueryPerformanceFrequency(&Frequency);
+		bool Success = _Scheduler->Stop();
 
-		// Lookahead time: Process events slightly ahead of current position
-		// This compensates for MIDI output latency (~2-5ms typical)
-		const int64_t LOOKAHEAD_US = 5000;  // 5ms lookahead
+		// Restore timer resolution
+		timeEndPeriod(1);
 
-		// Polling interval: Check for events every 0.5ms
-		const int64_t POLL_INTERVAL_US = 500;
+		return Success;
+	}
 
-		while (!_Should_Stop.load(std::memory_order_acquire))
-		{
-			if (!_Is_Playing.load(std::memory_order_acquire))
-			{
-				Precise_Sleep_us(5000);  // 5ms when paused
-				continue;
-			}
+	void Playback_MIDI_Engine_Native::Load_Schedule(const MIDI_Event* events, size_t count, const int64_t* checkpoint_times_us, size_t checkpoint_count, const Playback_Tempo_Map& tempo_map)
+	{
+		Get_Scheduler()->Set_Schedule(new Playback_MIDI_Schedule(events, count, checkpoint_times_us, checkpoint_count, tempo_map));
+	}
 
-			// Read current position from audio (or fallback)
-			int64_t Current_Pos_us = 0;
+	void Playback_MIDI_Engine_Native::Free_Retired_Schedules()
+	{
+		Get_Scheduler()->Free_Retired_Schedules();
+	}
 
-			bool Audio_Available = _Audio_Is_Available.load(std::memory_order_acquire);
+	void Playback_MIDI_Engine_Native::Set_Playback_Speed(double speed)
+	{
+		Get_Scheduler()->Set_Playback_Speed(speed);
+	}
 
-			if (Audio_Available)
-			{
-				// Audio is master: Use its position directly
-				Current_Pos_us = _Audio_Position_us.load(std::memory_order_acquire);
-			}
-			else
-			{
-				// MIDI-only playback: Use stored position
-				Current_Pos_us = _Current_Position_us.load(std::memory_order_acquire);
-
-				// In MIDI-only mode, we need to advance the position ourselves
-				// This is acceptable because there's no drift to worry about
-				static LARGE_INTEGER Last_Update_Time;
-				static bool First_Update = true;
-
-				if (_Reset_Timing.load(std::memory_order_acquire)) {
-					First_Update = true;
-					_Reset_Timing.store(false, std::memory_order_release);
-				}
-
-				LARGE_INTEGER Now;
-				QueryPerformanceCounter(&Now);
-
-				if (!First_Update)
-				{
-					int64_t Elapsed_Ticks = Now.QuadPart - Last_Update_Time.QuadPart;
-					int64_t Elapsed_Us = (Elapsed_Ticks * 1000000LL) / Frequency.QuadPart;
-					Current_Pos_us += Elapsed_Us;
-				}
-
-				Last_Update_Time = Now;
-				First_Update = false;
-			}
+	bool Playback_MIDI_Engine_Native::Queue_MIDI_Event(const MIDI_Event& event)
+	{
+		return Get_Scheduler()->Queue_Event(event);
+	}
 
-			// Update shared position for UI
-			_Current_Position_us.store(Current_Pos_us, std::memory_order_release);
-
-			// Process MIDI events based on audio's time
-			{
-				std::lock_guard<std::mutex> Lock(_Event_Queue_Mutex);
-
-				// Batch process all events at the same timestamp
-				while (!_Event_Queue.empty())
-				{
-					const Scheduled_MIDI_Event& Next_Event = _Event_Queue.front();
-
-					// Send events that are due (with lookahead)
-					if (Next_Event.Execute_Time_Us <= Current_Pos_us + LOOKAHEAD_US)
-					{
-						// Store the timestamp of the first event we're processing
-						int64_t Current_Batch_Timestamp = Next_Event.Execute_Time_Us;
-
-						// Send ALL events at this timestamp (within 100us tolerance)
-						// This ensures simultaneous MIDI events are sent together
-						while (!_Event_Queue.empty())
-						{
-							const Scheduled_MIDI_Event& Batch_Event = _Event_Queue.front();
-
-							// Check if this event is at the same timestamp (within 100us tolerance)
-							if (Batch_Event.Execute_Time_Us <= Current_Batch_Timestamp + 100)
-							{
-								Send_MIDI_Event(Batch_Event.Event);
-
-								if (_Event_Sent_Callback != nullptr) {
-									_Event_Sent_Callback(Batch_Event.Event);
-								}
-
-								_Event_Queue.pop_front();
-							}
-							else
-							{
-								break;  // Different timestamp, stop batching
-							}
-						}
-
-						// Exit outer loop to re-check timing after batch
-						break;
-					}
-					else
-					{
-						break;  // Events are sorted, so we're done
-					}
-				}
-			}
+	void Playback_MIDI_Engine_Native::Clear_Event_Queue()
+	{
+		Get_Scheduler()->Clear_Queue();
+	}
+
+	bool Playback_MIDI_Engine_Native::Pop_Sent_Event(MIDI_Event& event)
+	{
+		return Get_Scheduler()->Pop_Sent_Event(event);
+	}
+
+	uint64_t Playback_MIDI_Engine_Native::Get_Sent_Events_Dropped()
+	{
+		return Get_Scheduler()->Get_Sent_Events_Dropped();
+	}
+
+	void Playback_MIDI_Engine_Native::Set_Journal_Enabled(bool enabled)
+	{
+		Get_Scheduler()->Set_Journal_Enabled(enabled);
+	}
+
+	bool Playback_MIDI_Engine_Native::Pop_Journal_Event(MIDI_Event& event)
+	{
+		return Get_Scheduler()->Pop_Journal_Event(event);
+	}
+
+	uint64_t Playback_MIDI_Engine_Native::Get_Journal_Dropped()
+	{
+		return Get_Scheduler()->Get_Journal_Dropped();
+	}
+
+	int64_t Playback_MIDI_Engine_Native::Get_Current_Position_us()
+	{
+		return Get_Scheduler()->Get_Position_us();
+	}
+
+	void Playback_MIDI_Engine_Native::Set_Current_Position_us(int64_t position_us)
+	{
+		Get_Scheduler()->Set_Position_us(position_us);
+	}
+
+	bool Playback_MIDI_Engine_Native::Is_Playing_Threaded()
+	{
+		return Get_Scheduler()->Is_Playing();
+	}
 
-			// Precise sleep until next poll
-			Precise_Sleep_us(POLL_INTERVAL_US);
+	Playback_MIDI_Scheduler* Playback_MIDI_Engine_Native::Get_Scheduler()
+	{
+		// Created on first use and kept for the lifetime of the process, queueing works before a device is opened
+		if (_Scheduler == nullptr)
+		{
+			_Output = new Playback_MIDI_Output_WinMM();
+			_Clock = new Playback_Clock_Windows();
+			_Scheduler = new Playback_MIDI_Scheduler(_Output, _Clock);
+			_Router = new Playback_MIDI_Port_Router();
+
+			// The render clock publishes QPC based host times, the same time base as the Windows clock
+			_Scheduler->Set_Audio_Clock(Playback_Audio_Engine_Native::Get_Render_Clock());
 		}
+
+		return _Scheduler;
 	}
 }
 
-#pragma managed(pop)
\ No newline at end of file
+#pragma managed(pop)
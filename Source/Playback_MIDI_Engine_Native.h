@@ -1,63 +1,63 @@
 #pragma once
 
-#include <thread>
-#include <atomic>
-#include <mutex>
 #include <vector>
-#include <deque>
+
+#include "Playback_MIDI_Scheduler.h"
+#include "Playback_MIDI_Port_Router.h"
 
 namespace MIDILightDrawer
 {
+	// Forward Declaration
+	class Playback_MIDI_Output_WinMM;
+	class Playback_Clock_Windows;
+
+	// Windows playback engine: the platform independent scheduler driving the WinMM output on the QueryPerformanceCounter clock
 	class Playback_MIDI_Engine_Native
 	{
 	public:
-		struct MIDI_Event
-		{
-			double Timestamp_ms;		// Timestamp in milliseconds
-			int Track;					// Track number
-			int Channel;				// MIDI channel (0-15)
-			unsigned char Command;		// MIDI command byte
-			unsigned char Data1;		// First data byte
-			unsigned char Data2;		// Second data byte
-		};
+		typedef Playback_MIDI_Scheduler::MIDI_Event MIDI_Event;
 
 	private:
-		static void* _MIDI_Handle;
+		static Playback_MIDI_Output_WinMM* _Output;
+		static Playback_Clock_Windows* _Clock;
+		static Playback_MIDI_Scheduler* _Scheduler;
 		static bool _Is_Initialized;
 
-		// Threading members
-		static std::thread* _Midi_Thread;
-		static std::atomic<bool> _Is_Playing;
-		static std::atomic<bool> _Should_Stop;
-		static std::atomic<bool> _Reset_Timing;
-		static std::atomic<int64_t> _Current_Position_us;  // Microseconds
-
-		// MIDI event queue (sorted by timestamp)
-		struct Scheduled_MIDI_Event
-		{
-			int64_t Execute_Time_Us;  // When to send this event
-			MIDI_Event Event;
-
-			bool operator>(const Scheduled_MIDI_Event& other) const {
-				return Execute_Time_Us > other.Execute_Time_Us;  // For min-heap
-			}
-		};
-
-		static std::deque<Scheduled_MIDI_Event> _Event_Queue;
-		static std::mutex _Event_Queue_Mutex;
-		static void (*_Event_Sent_Callback)(const MIDI_Event&);
-
-		static std::atomic<bool> _Audio_Is_Available;
-		static std::atomic<int64_t> _Audio_Position_us;
+		// Additional devices. Port 0 is always _Output, the router is only used by the scheduler once a second port exists
+		static Playback_MIDI_Port_Router* _Router;
+		static std::vector<Playback_MIDI_Output_WinMM*> _Port_Outputs;	// Ports 1 and up
+		static std::vector<Playback_Clock_Windows*> _Port_Clocks;		// Wake primitive of every port thread, including port 0
 
 	public:
 		static bool Initialize(int device_id);
 		static void Cleanup();
-		static void Set_Event_Sent_Callback(void (*callback)(const MIDI_Event&));
 		static bool Send_MIDI_Event(const MIDI_Event& event);
 		static bool Send_All_Notes_Off(int channel);
 		static bool Is_Device_Open();
 
+		// Multi-device output. Ports can only be added or removed while the playback thread is stopped
+		static int Add_Output_Port(int device_id);
+		static bool Remove_Output_Ports();
+		static int Get_Output_Port_Count();
+		static void Set_Track_Port(int track, int port);
+		static uint64_t Get_Port_Dropped_Count(int port);
+
+		// Mute and solo, takes effect right away also during playback
+		static void Set_Track_Enabled(int track, bool enabled);
+		static void Set_Track_Mute_Solo(int track_count, const int* muted_tracks, size_t muted_count, const int* soloed_tracks, size_t soloed_count);
+
+		// Packs the notes of every batch into SysEx light frames instead of single note messages
+		static void Set_SysEx_Frame_Mode(bool enabled);
+		static bool Is_SysEx_Frame_Mode();
+
+		// Link pacing. 0 bytes per second sends without pacing, Playback_MIDI_Link_Shaper::DIN_BYTES_PER_SECOND models a DIN cable
+		static void Set_Port_Bytes_Per_Second(int port, int bytes_per_second);
+		static void Set_Batch_Window_us(int64_t window_us);
+		static Playback_MIDI_Link_Shaper::Statistics Get_Link_Statistics();
+
+		// Counters of the playback thread since it was started, with the driver call times of all ports
+		static Playback_MIDI_Engine_Metrics::Snapshot Get_Metrics();
+
 		// Audio state management
 		static void Set_Audio_Available(bool available);
 		static void Set_Audio_Position_us(int64_t position_us);
@@ -65,14 +65,26 @@ namespace MIDILightDrawer
 		// Threading control
 		static bool Start_Playback_Thread();
 		static bool Stop_Playback_Thread();
-		static void Queue_MIDI_Event(const MIDI_Event& event);
+		static void Load_Schedule(const MIDI_Event* events, size_t count, const int64_t* checkpoint_times_us, size_t checkpoint_count, const Playback_Tempo_Map& tempo_map);
+
+		// Deletes the schedules replaced during playback, the playback thread hands them back instead of deleting them
+		static void Free_Retired_Schedules();
+
+		static void Set_Playback_Speed(double speed);
+		static bool Queue_MIDI_Event(const MIDI_Event& event);
 		static void Clear_Event_Queue();
+		static bool Pop_Sent_Event(MIDI_Event& event);
+		static uint64_t Get_Sent_Events_Dropped();
+
+		// Sent events for the MIDI log, read by the log on its own timer
+		static void Set_Journal_Enabled(bool enabled);
+		static bool Pop_Journal_Event(MIDI_Event& event);
+		static uint64_t Get_Journal_Dropped();
 		static int64_t Get_Current_Position_us();
 		static void Set_Current_Position_us(int64_t position_us);
 		static bool Is_Playing_Threaded();
 
 	private:
-		// Thread function
-		static void MIDI_Playback_Thread_Function();
+		static Playback_MIDI_Scheduler* Get_Scheduler();
 	};
 }
@@ -0,0 +1,150 @@
+#ifdef _MSC_VER
+#pragma managed(push, off)
+#endif
+
+#include "Playback_MIDI_Frame_Builder.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace MIDILightDrawer
+{
+	Playback_MIDI_Frame_Builder::Playback_MIDI_Frame_Builder()
+	{
+		std::memset(_Values, 0, sizeof(_Values));
+		std::memset(_Is_Changed, 0, sizeof(_Is_Changed));
+
+		// Sized for the worst case, building frames never allocates on the playback thread
+		_Changed_Keys.reserve(KEY_COUNT);
+		_Frame_Data.reserve(KEY_COUNT * 3);
+		_Frame_Offsets.reserve(KEY_COUNT / 8);
+	}
+
+	bool Playback_MIDI_Frame_Builder::Add(unsigned char status, unsigned char data1, unsigned char data2)
+	{
+		unsigned char Command = status & 0xF0;
+
+		if (Command != 0x90 && Command != 0x80) {
+			return false;
+		}
+
+		uint16_t Key = (uint16_t)(((status & 0x0F) << 7) | (data1 & 0x7F));
+
+		// Note On with velocity 0 is a Note Off as well. The last change of a light within the batch wins
+		_Values[Key] = (Command == 0x90) ? (unsigned char)(data2 & 0x7F) : 0;
+
+		if (!_Is_Changed[Key]) {
+			_Is_Changed[Key] = true;
+			_Changed_Keys.push_back(Key);
+		}
+
+		return true;
+	}
+
+	bool Playback_MIDI_Frame_Builder::Is_Empty() const
+	{
+		return _Changed_Keys.empty();
+	}
+
+	size_t Playback_MIDI_Frame_Builder::Finish()
+	{
+		_Frame_Data.clear();
+		_Frame_Offsets.clear();
+
+		if (_Changed_Keys.empty()) {
+			return 0;
+		}
+
+		// Sorted keys are grouped by channel
+		std::sort(_Changed_Keys.begin(), _Changed_Keys.end());
+
+		size_t Group_Count_Position = 0;
+		size_t Group_Count = 0;
+		int Group_Channel = -1;
+
+		Begin_Frame();
+
+		for (size_t i = 0; i < _Changed_Keys.size(); i++)
+		{
+			uint16_t Key = _Changed_Keys[i];
+			int Channel = Key >> 7;
+
+			bool New_Group = (Channel != Group_Channel || Group_Count == MAX_GROUP_NOTES);
+			size_t Needed_Bytes = (New_Group ? 2 : 0) + 2 + 1;
+
+			if (_Frame_Data.size() - _Frame_Offsets.back() + Needed_Bytes > MAX_FRAME_BYTES)
+			{
+				_Frame_Data[Group_Count_Position] = (unsigned char)Group_Count;
+				End_Frame();
+				Begin_Frame();
+				New_Group = true;
+			}
+
+			if (New_Group)
+			{
+				if (Group_Channel >= 0) {
+					_Frame_Data[Group_Count_Position] = (unsigned char)Group_Count;
+				}
+
+				_Frame_Data.push_back((unsigned char)Channel);
+				Group_Count_Position = _Frame_Data.size();
+				_Frame_Data.push_back(0);
+
+				Group_Channel = Channel;
+				Group_Count = 0;
+			}
+
+			_Frame_Data.push_back((unsigned char)(Key & 0x7F));
+			_Frame_Data.push_back(_Values[Key]);
+			Group_Count++;
+
+			_Is_Changed[Key] = false;
+		}
+
+		_Frame_Data[Group_Count_Position] = (unsigned char)Group_Count;
+		End_Frame();
+
+		// End marker of the last frame
+		_Frame_Offsets.push_back(_Frame_Data.size());
+		_Changed_Keys.clear();
+
+		return Get_Frame_Count();
+	}
+
+	size_t Playback_MIDI_Frame_Builder::Get_Frame_Count() const
+	{
+		return _Frame_Offsets.empty() ? 0 : _Frame_Offsets.size() - 1;
+	}
+
+	const unsigned char* Playback_MIDI_Frame_Builder::Get_Frame(size_t index, size_t& length) const
+	{
+		if (index >= Get_Frame_Count()) {
+			length = 0;
+			return nullptr;
+		}
+
+		length = _Frame_Offsets[index + 1] - _Frame_Offsets[index];
+
+		return &_Frame_Data[_Frame_Offsets[index]];
+	}
+
+	void Playback_MIDI_Frame_Builder::Begin_Frame()
+	{
+		_Frame_Offsets.push_back(_Frame_Data.size());
+
+		_Frame_Data.push_back((unsigned char)SYSEX_START);
+		_Frame_Data.push_back((unsigned char)MANUFACTURER_ID);
+		_Frame_Data.push_back((unsigned char)SIGNATURE_1);
+		_Frame_Data.push_back((unsigned char)SIGNATURE_2);
+		_Frame_Data.push_back((unsigned char)FORMAT_VERSION);
+	}
+
+	void Playback_MIDI_Frame_Builder::End_Frame()
+	{
+		_Frame_Data.push_back((unsigned char)SYSEX_END);
+	}
+}
+
+#ifdef _MSC_VER
+#pragma managed(pop)
+#endif
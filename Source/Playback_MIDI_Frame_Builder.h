@@ -0,0 +1,63 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace MIDILightDrawer
+{
+	// Packs the note messages of one scheduler batch into SysEx light frames. A frame carries the new value of
+	// every light that changed, so a Note Off followed by the Note On of the next color costs one entry instead of two messages.
+	//
+	// Frame format (all bytes after F0 are 7 bit):
+	//
+	//   F0 7D 4C 44 01  <group> ... <group>  F7
+	//
+	//   7D          Manufacturer ID for non-commercial use
+	//   4C 44       Signature "LD"
+	//   01          Format version
+	//   <group>     <channel 0-15> <count 1-127> followed by count pairs of <note> <value>
+	//
+	// A value is the velocity of the Note On, 0 switches the light off. Groups are sorted by channel, the notes
+	// of a group are ascending. Long batches are split into several complete frames of at most MAX_FRAME_BYTES
+	class Playback_MIDI_Frame_Builder
+	{
+	public:
+		static const unsigned char SYSEX_START			= 0xF0;
+		static const unsigned char SYSEX_END			= 0xF7;
+		static const unsigned char MANUFACTURER_ID		= 0x7D;
+		static const unsigned char SIGNATURE_1			= 0x4C;
+		static const unsigned char SIGNATURE_2			= 0x44;
+		static const unsigned char FORMAT_VERSION		= 0x01;
+
+		static const size_t HEADER_BYTES				= 5;
+		static const size_t MAX_FRAME_BYTES				= 256;
+		static const size_t MAX_GROUP_NOTES				= 127;
+
+	private:
+		static const size_t KEY_COUNT = 16 * 128;
+
+		unsigned char _Values[KEY_COUNT];
+		bool _Is_Changed[KEY_COUNT];
+		std::vector<uint16_t> _Changed_Keys;		// Channel << 7 | note
+
+		std::vector<unsigned char> _Frame_Data;
+		std::vector<size_t> _Frame_Offsets;			// Start of every frame in _Frame_Data, one extra entry marks the end
+
+	public:
+		Playback_MIDI_Frame_Builder();
+
+		// Returns false for everything but Note On and Note Off, such messages have to be sent as they are
+		bool Add(unsigned char status, unsigned char data1, unsigned char data2);
+		bool Is_Empty() const;
+
+		// Turns the collected changes into frames and starts a new batch. The frames stay valid until the next Finish
+		size_t Finish();
+		size_t Get_Frame_Count() const;
+		const unsigned char* Get_Frame(size_t index, size_t& length) const;
+
+	private:
+		void Begin_Frame();
+		void End_Frame();
+	};
+}
@@ -0,0 +1,335 @@
+#ifdef _MSC_VER
+#pragma managed(push, off)
+#endif
+
+#include "Playback_MIDI_Link_Shaper.h"
+
+#include <cstring>
+
+namespace MIDILightDrawer
+{
+	Playback_MIDI_Link_Shaper::Playback_MIDI_Link_Shaper()
+	{
+		_Bytes_Per_Second.store(0);
+		_Link_Free_us = 0;
+
+		std::memset(_Keys, 0, sizeof(_Keys));
+
+		// Sized for the worst case, queueing never allocates on the sending thread
+		_Pending_Keys.reserve(KEY_COUNT);
+		_Other_Messages.reserve(OTHER_QUEUE_CAPACITY);
+		_Other_Head = 0;
+
+		Reset_Statistics();
+	}
+
+	void Playback_MIDI_Link_Shaper::Set_Bytes_Per_Second(int bytes_per_second)
+	{
+		_Bytes_Per_Second.store(bytes_per_second > 0 ? bytes_per_second : 0, std::memory_order_relaxed);
+	}
+
+	int Playback_MIDI_Link_Shaper::Get_Bytes_Per_Second() const
+	{
+		return _Bytes_Per_Second.load(std::memory_order_relaxed);
+	}
+
+	bool Playback_MIDI_Link_Shaper::Is_Limited() const
+	{
+		return Get_Bytes_Per_Second() > 0;
+	}
+
+	size_t Playback_MIDI_Link_Shaper::Submit(unsigned char status, unsigned char data1, unsigned char data2, int64_t now_us, IMidiOutput* output)
+	{
+		// Nothing may overtake what is already waiting
+		if (!Has_Pending() && Has_Room(now_us)) {
+			return Send_Now(status, data1, data2, now_us, now_us, output) ? 1 : 0;
+		}
+
+		unsigned char Command = status & 0xF0;
+
+		if (Command == 0x80 || Command == 0x90)
+		{
+			Queue_Note(status, data1, data2, now_us);
+		}
+		else if (_Other_Messages.size() >= OTHER_QUEUE_CAPACITY)
+		{
+			_Dropped_Count.fetch_add(1, std::memory_order_relaxed);
+		}
+		else
+		{
+			// The notes queued before switch off anyway, sending them afterwards would switch them on again
+			if (Command == 0xB0 && (data1 == 120 || data1 == 123)) {
+				Discard_Channel(status & 0x0F);
+			}
+
+			Message Queued;
+			Queued.Status = status;
+			Queued.Data1 = data1;
+			Queued.Data2 = data2;
+			Queued.Submit_us = now_us;
+
+			_Other_Messages.push_back(Queued);
+		}
+
+		return Drain(now_us, output);
+	}
+
+	bool Playback_MIDI_Link_Shaper::Send_Immediate(unsigned char status, unsigned char data1, unsigned char data2, int64_t now_us, IMidiOutput* output)
+	{
+		if ((status & 0xF0) == 0xB0 && (data1 == 120 || data1 == 123)) {
+			Discard_Channel(status & 0x0F);
+		}
+
+		return Send_Now(status, data1, data2, now_us, now_us, output);
+	}
+
+	void Playback_MIDI_Link_Shaper::Account_Sent(size_t byte_count, int64_t now_us)
+	{
+		Occupy_Link(byte_count, now_us);
+
+		_Sent_Count.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	void Playback_MIDI_Link_Shaper::Occupy_Link(size_t byte_count, int64_t now_us)
+	{
+		int Bytes_Per_Second = Get_Bytes_Per_Second();
+
+		if (Bytes_Per_Second <= 0) {
+			return;
+		}
+
+		int64_t Start_us = (_Link_Free_us > now_us) ? _Link_Free_us : now_us;
+		_Link_Free_us = Start_us + (int64_t)byte_count * 1000000 / Bytes_Per_Second;
+	}
+
+	size_t Playback_MIDI_Link_Shaper::Drain(int64_t now_us, IMidiOutput* output)
+	{
+		size_t Sent = 0;
+
+		// Lights that go dark first, a light that stays on too long is worse than one that changes late
+		for (size_t i = 0; i < _Pending_Keys.size() && Has_Room(now_us); i++)
+		{
+			uint16_t Key = _Pending_Keys[i];
+			Key_Update& Update = _Keys[Key];
+
+			if (!Update.Off_Pending || Update.On_Pending) {
+				continue;
+			}
+
+			Update.Off_Pending = false;
+			Sent += Send_Now((unsigned char)(0x80 | (Key >> 7)), (unsigned char)(Key & 0x7F), 0, Update.Off_Submit_us, now_us, output) ? 1 : 0;
+		}
+
+		// Controller and other state changes in their order
+		while (_Other_Head < _Other_Messages.size() && Has_Room(now_us))
+		{
+			const Message& Queued = _Other_Messages[_Other_Head++];
+			Sent += Send_Now(Queued.Status, Queued.Data1, Queued.Data2, Queued.Submit_us, now_us, output) ? 1 : 0;
+		}
+
+		if (_Other_Head >= _Other_Messages.size()) {
+			_Other_Messages.clear();
+			_Other_Head = 0;
+		}
+
+		// Note Ons last, oldest first. A color change sends its Note Off right before the Note On
+		for (size_t i = 0; i < _Pending_Keys.size() && Has_Room(now_us); i++)
+		{
+			uint16_t Key = _Pending_Keys[i];
+			Key_Update& Update = _Keys[Key];
+
+			if (!Update.On_Pending) {
+				continue;
+			}
+
+			if (Update.Off_Pending)
+			{
+				Update.Off_Pending = false;
+				Sent += Send_Now((unsigned char)(0x80 | (Key >> 7)), (unsigned char)(Key & 0x7F), 0, Update.Off_Submit_us, now_us, output) ? 1 : 0;
+
+				if (!Has_Room(now_us)) {
+					break;
+				}
+			}
+
+			Update.On_Pending = false;
+			Sent += Send_Now((unsigned char)(0x90 | (Key >> 7)), (unsigned char)(Key & 0x7F), Update.On_Velocity, Update.On_Submit_us, now_us, output) ? 1 : 0;
+		}
+
+		Compact_Pending_Keys();
+
+		return Sent;
+	}
+
+	int64_t Playback_MIDI_Link_Shaper::Get_Next_Drain_us() const
+	{
+		if (!Has_Pending()) {
+			return INT64_MAX;
+		}
+
+		return _Link_Free_us - MAX_BURST_US;
+	}
+
+	bool Playback_MIDI_Link_Shaper::Has_Pending() const
+	{
+		return !_Pending_Keys.empty() || _Other_Head < _Other_Messages.size();
+	}
+
+	void Playback_MIDI_Link_Shaper::Clear()
+	{
+		for (size_t i = 0; i < _Pending_Keys.size(); i++) {
+			std::memset(&_Keys[_Pending_Keys[i]], 0, sizeof(Key_Update));
+		}
+
+		_Pending_Keys.clear();
+		_Other_Messages.clear();
+		_Other_Head = 0;
+	}
+
+	Playback_MIDI_Link_Shaper::Statistics Playback_MIDI_Link_Shaper::Get_Statistics() const
+	{
+		Statistics Result;
+		Result.Sent_Count = _Sent_Count.load(std::memory_order_relaxed);
+		Result.Coalesced_Count = _Coalesced_Count.load(std::memory_order_relaxed);
+		Result.Dropped_Count = _Dropped_Count.load(std::memory_order_relaxed);
+		Result.Late_Count = _Late_Count.load(std::memory_order_relaxed);
+		Result.Wait_Max_us = _Wait_Max_us.load(std::memory_order_relaxed);
+
+		return Result;
+	}
+
+	void Playback_MIDI_Link_Shaper::Reset_Statistics()
+	{
+		_Sent_Count.store(0, std::memory_order_relaxed);
+		_Coalesced_Count.store(0, std::memory_order_relaxed);
+		_Dropped_Count.store(0, std::memory_order_relaxed);
+		_Late_Count.store(0, std::memory_order_relaxed);
+		_Wait_Max_us.store(0, std::memory_order_relaxed);
+	}
+
+	bool Playback_MIDI_Link_Shaper::Has_Room(int64_t now_us) const
+	{
+		return !Is_Limited() || _Link_Free_us <= now_us + MAX_BURST_US;
+	}
+
+	bool Playback_MIDI_Link_Shaper::Send_Now(unsigned char status, unsigned char data1, unsigned char data2, int64_t submit_us, int64_t now_us, IMidiOutput* output)
+	{
+		if (output == nullptr || !output->Send_Short_Message(status, data1, data2)) {
+			return false;
+		}
+
+		Occupy_Link(Message_Bytes(status), now_us);
+
+		int64_t Wait_us = now_us - submit_us;
+
+		// Single writer, the atomics only make the values readable from other threads
+		if (Wait_us > _Wait_Max_us.load(std::memory_order_relaxed)) {
+			_Wait_Max_us.store(Wait_us, std::memory_order_relaxed);
+		}
+
+		if (Wait_us > LATE_THRESHOLD_US) {
+			_Late_Count.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		_Sent_Count.fetch_add(1, std::memory_order_relaxed);
+
+		return true;
+	}
+
+	void Playback_MIDI_Link_Shaper::Queue_Note(unsigned char status, unsigned char data1, unsigned char data2, int64_t now_us)
+	{
+		uint16_t Key = (uint16_t)(((status & 0x0F) << 7) | (data1 & 0x7F));
+		Key_Update& Update = _Keys[Key];
+
+		// Note On with velocity 0 is a Note Off as well
+		bool Is_Note_Off = ((status & 0xF0) == 0x80) || data2 == 0;
+
+		if (Is_Note_Off)
+		{
+			// A Note On that has not been sent yet is cancelled by the Note Off
+			if (Update.On_Pending) {
+				Update.On_Pending = false;
+				_Coalesced_Count.fetch_add(1, std::memory_order_relaxed);
+			}
+
+			if (Update.Off_Pending) {
+				_Coalesced_Count.fetch_add(1, std::memory_order_relaxed);
+			}
+			else {
+				Update.Off_Pending = true;
+				Update.Off_Submit_us = now_us;
+			}
+		}
+		else
+		{
+			// The newer velocity replaces the waiting one, the wait is counted from the first
+			if (Update.On_Pending) {
+				_Coalesced_Count.fetch_add(1, std::memory_order_relaxed);
+			}
+			else {
+				Update.On_Pending = true;
+				Update.On_Submit_us = now_us;
+			}
+
+			Update.On_Velocity = data2;
+		}
+
+		if (!Update.Is_Listed) {
+			Update.Is_Listed = true;
+			_Pending_Keys.push_back(Key);
+		}
+	}
+
+	void Playback_MIDI_Link_Shaper::Discard_Channel(int channel)
+	{
+		for (size_t i = 0; i < _Pending_Keys.size(); i++)
+		{
+			uint16_t Key = _Pending_Keys[i];
+			Key_Update& Update = _Keys[Key];
+
+			if ((Key >> 7) != channel) {
+				continue;
+			}
+
+			uint64_t Discarded = (Update.On_Pending ? 1 : 0) + (Update.Off_Pending ? 1 : 0);
+			_Coalesced_Count.fetch_add(Discarded, std::memory_order_relaxed);
+
+			Update.On_Pending = false;
+			Update.Off_Pending = false;
+		}
+
+		Compact_Pending_Keys();
+	}
+
+	void Playback_MIDI_Link_Shaper::Compact_Pending_Keys()
+	{
+		size_t Kept = 0;
+
+		for (size_t i = 0; i < _Pending_Keys.size(); i++)
+		{
+			uint16_t Key = _Pending_Keys[i];
+			Key_Update& Update = _Keys[Key];
+
+			if (Update.On_Pending || Update.Off_Pending) {
+				_Pending_Keys[Kept++] = Key;
+			}
+			else {
+				Update.Is_Listed = false;
+			}
+		}
+
+		_Pending_Keys.resize(Kept);
+	}
+
+	size_t Playback_MIDI_Link_Shaper::Message_Bytes(unsigned char status)
+	{
+		// Program change and channel pressure only have one data byte
+		unsigned char Command = status & 0xF0;
+
+		return (Command == 0xC0 || Command == 0xD0) ? 2 : 3;
+	}
+}
+
+#ifdef _MSC_VER
+#pragma managed(pop)
+#endif
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <atomic>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+#include "Playback_MIDI_Output.h"
+
+namespace MIDILightDrawer
+{
+	// Paces the messages of one output to the byte rate of its link. While the link is busy, messages wait here:
+	// a newer update of the same note replaces the waiting one, lights that switch off go out before everything else
+	// and color changes (Note Off and Note On) last. Times are passed in by the caller, so the shaper runs on any clock, also a simulated one.
+	// Used by one thread only, the statistics can be read from any thread
+	class Playback_MIDI_Link_Shaper
+	{
+	public:
+		struct Statistics
+		{
+			uint64_t Sent_Count;			// Including messages passed by the shaper with Account_Sent
+			uint64_t Coalesced_Count;		// Updates replaced by a newer one of the same note before they were sent
+			uint64_t Dropped_Count;			// Other messages that did not fit into the queue
+			uint64_t Late_Count;			// Messages that waited longer than LATE_THRESHOLD_US
+			int64_t Wait_Max_us;
+		};
+
+		// 31250 baud with start and stop bit
+		static const int DIN_BYTES_PER_SECOND = 3125;
+
+		// Bytes the interface and its driver buffer, sending goes on while the modeled link is this far ahead
+		static const int64_t MAX_BURST_US = 1000;
+
+		static const int64_t LATE_THRESHOLD_US = 1000;
+		static const size_t OTHER_QUEUE_CAPACITY = 1024;
+
+	private:
+		static const size_t KEY_COUNT = 16 * 128;
+
+		struct Message
+		{
+			unsigned char Status;
+			unsigned char Data1;
+			unsigned char Data2;
+			int64_t Submit_us;
+		};
+
+		struct Key_Update
+		{
+			int64_t Off_Submit_us;
+			int64_t On_Submit_us;
+			unsigned char On_Velocity;
+			bool Off_Pending;
+			bool On_Pending;
+			bool Is_Listed;
+		};
+
+		std::atomic<int> _Bytes_Per_Second;		// 0 sends everything right away
+		int64_t _Link_Free_us;					// Time the modeled link has sent everything handed to it
+
+		Key_Update _Keys[KEY_COUNT];
+		std::vector<uint16_t> _Pending_Keys;	// In submit order, Channel << 7 | note
+		std::vector<Message> _Other_Messages;
+		size_t _Other_Head;
+
+		std::atomic<uint64_t> _Sent_Count;
+		std::atomic<uint64_t> _Coalesced_Count;
+		std::atomic<uint64_t> _Dropped_Count;
+		std::atomic<uint64_t> _Late_Count;
+		std::atomic<int64_t> _Wait_Max_us;
+
+	public:
+		Playback_MIDI_Link_Shaper();
+
+		// Can be changed from any thread, takes effect with the next message
+		void Set_Bytes_Per_Second(int bytes_per_second);
+		int Get_Bytes_Per_Second() const;
+		bool Is_Limited() const;
+
+		// Sends right away while the link has room, queues otherwise. Returns the number of messages sent
+		size_t Submit(unsigned char status, unsigned char data1, unsigned char data2, int64_t now_us, IMidiOutput* output);
+
+		// Sends ahead of everything queued. All Notes Off and All Sound Off remove the queued notes of their channel
+		bool Send_Immediate(unsigned char status, unsigned char data1, unsigned char data2, int64_t now_us, IMidiOutput* output);
+
+		// Accounts for a message sent around the shaper, e.g. a SysEx frame
+		void Account_Sent(size_t byte_count, int64_t now_us);
+
+		// Sends queued messages as far as the link allows. Returns the number of messages sent
+		size_t Drain(int64_t now_us, IMidiOutput* output);
+
+		// Time the next queued message fits onto the link, INT64_MAX if nothing is queued
+		int64_t Get_Next_Drain_us() const;
+		bool Has_Pending() const;
+
+		// Drops everything queued, e.g. on a seek. Does not change the statistics
+		void Clear();
+
+		Statistics Get_Statistics() const;
+		void Reset_Statistics();
+
+	private:
+		bool Has_Room(int64_t now_us) const;
+		void Occupy_Link(size_t byte_count, int64_t now_us);
+		bool Send_Now(unsigned char status, unsigned char data1, unsigned char data2, int64_t submit_us, int64_t now_us, IMidiOutput* output);
+		void Queue_Note(unsigned char status, unsigned char data1, unsigned char data2, int64_t now_us);
+		void Discard_Channel(int channel);
+		void Compact_Pending_Keys();
+		static size_t Message_Bytes(unsigned char status);
+	};
+}
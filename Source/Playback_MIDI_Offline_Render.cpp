@@ -0,0 +1,87 @@
+#ifdef _MSC_VER
+#pragma managed(push, off)
+#endif
+
+#include "Playback_MIDI_Offline_Render.h"
+#include "Playback_Clock_Virtual.h"
+#include "Playback_MIDI_Output_Recording.h"
+#include "Playback_MIDI_Scheduler.h"
+
+#include <chrono>
+#include <cstdio>
+
+namespace MIDILightDrawer
+{
+	Playback_MIDI_Offline_Render::Report Playback_MIDI_Offline_Render::Render(Playback_MIDI_Schedule* schedule, int64_t start_position_us, Playback_MIDI_Render_Log& log)
+	{
+		Report Result = Report();
+
+		log.Clear();
+
+		if (schedule == nullptr) {
+			return Result;
+		}
+
+		Result.Event_Count = schedule->Size();
+
+		int64_t End_Position_us = start_position_us + END_MARGIN_US;
+
+		if (schedule->Size() > 0 && schedule->Get_Entry(schedule->Size() - 1).Execute_Time_Us + END_MARGIN_US > End_Position_us) {
+			End_Position_us = schedule->Get_Entry(schedule->Size() - 1).Execute_Time_Us + END_MARGIN_US;
+		}
+
+		log.Reserve(schedule->Size());
+
+		Playback_Clock_Virtual Clock;
+		Playback_MIDI_Output_Recording Output(nullptr);
+		Playback_MIDI_Scheduler Scheduler(&Output, &Clock);
+
+		Scheduler.Set_Schedule(schedule);
+		Scheduler.Set_Render_Log(&log);
+
+		std::chrono::steady_clock::time_point Start_Time = std::chrono::steady_clock::now();
+
+		Result.Success = Scheduler.Render_Offline(start_position_us, End_Position_us);
+
+		Result.Wall_Time_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - Start_Time).count();
+		Result.Rendered_us = Scheduler.Get_Position_us() - start_position_us;
+
+		const std::vector<Playback_MIDI_Render_Log::Record>& Records = log.Get_Records();
+		Result.Sent_Count = Records.size();
+
+		double Lateness_Sum_us = 0.0;
+
+		for (size_t i = 0; i < Records.size(); i++)
+		{
+			int64_t Lateness_us = Records[i].Actual_us - (Records[i].Intended_us - Playback_MIDI_Scheduler::LOOKAHEAD_US);
+
+			Result.Lateness_Max_us = (i == 0 || Lateness_us > Result.Lateness_Max_us) ? Lateness_us : Result.Lateness_Max_us;
+			Lateness_Sum_us += (double)Lateness_us;
+		}
+
+		Result.Lateness_Average_us = Records.empty() ? 0.0 : Lateness_Sum_us / Records.size();
+
+		return Result;
+	}
+
+	std::string Playback_MIDI_Offline_Render::Format_Report(const Report& report)
+	{
+		char Line[256];
+		std::string Text;
+
+		snprintf(Line, sizeof(Line), "Render: %s\n", report.Success ? "complete" : "failed");
+		Text += Line;
+		snprintf(Line, sizeof(Line), "Events: %zu scheduled, %zu sent\n", report.Event_Count, report.Sent_Count);
+		Text += Line;
+		snprintf(Line, sizeof(Line), "Time: %.1f s of playback in %.1f ms\n", report.Rendered_us / 1000000.0, report.Wall_Time_ms);
+		Text += Line;
+		snprintf(Line, sizeof(Line), "Lateness (us): average %.1f, max %lld\n", report.Lateness_Average_us, (long long)report.Lateness_Max_us);
+		Text += Line;
+
+		return Text;
+	}
+}
+
+#ifdef _MSC_VER
+#pragma managed(pop)
+#endif
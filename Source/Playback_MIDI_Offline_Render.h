@@ -0,0 +1,37 @@
+#pragma once
+
+#include <string>
+#include <cstdint>
+
+#include "Playback_MIDI_Schedule.h"
+#include "Playback_MIDI_Render_Log.h"
+
+namespace MIDILightDrawer
+{
+	// Plays a schedule faster than real time: the scheduler runs on the calling thread against a Playback_Clock_Virtual
+	// and writes every sent event to a Playback_MIDI_Render_Log. Needs no MIDI device, audio or UI, and the same
+	// schedule always gives the same log
+	class Playback_MIDI_Offline_Render
+	{
+	public:
+		struct Report
+		{
+			bool Success;
+			size_t Event_Count;			// Entries in the schedule
+			size_t Sent_Count;
+			int64_t Rendered_us;		// Playback time covered
+			double Wall_Time_ms;
+
+			// Actual minus intended time, plus the lookahead: how late an event left against the time it was due to be sent
+			int64_t Lateness_Max_us;
+			double Lateness_Average_us;
+		};
+
+		// Playback goes on this long after the last event, the last Note Offs are sent well before
+		static const int64_t END_MARGIN_US = 100000;
+
+		// Takes ownership of the schedule. The log is cleared first
+		static Report Render(Playback_MIDI_Schedule* schedule, int64_t start_position_us, Playback_MIDI_Render_Log& log);
+		static std::string Format_Report(const Report& report);
+	};
+}
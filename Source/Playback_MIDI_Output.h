@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace MIDILightDrawer
+{
+	// Destination of the MIDI scheduler. Opening is backend specific and done before the output is handed over
+	class IMidiOutput
+	{
+	public:
+		virtual ~IMidiOutput() {}
+
+		virtual bool Is_Open() = 0;
+		virtual void Close() = 0;
+
+		// Status byte including the channel, followed by up to two data bytes
+		virtual bool Send_Short_Message(unsigned char status, unsigned char data1, unsigned char data2) = 0;
+
+		// Complete SysEx message from F0 to F7. Returns once the data is no longer needed by the output
+		virtual bool Send_Long_Message(const unsigned char* data, size_t length) = 0;
+
+		// Outputs with a timestamped API (e.g. an ALSA queue) deliver messages at a given time on their own.
+		// The scheduler hands events to them this far ahead of their time, 0 sends every message when it is due
+		virtual int64_t Get_Timestamp_Lead_us() { return 0; }
+
+		// Delivered at time_us of the IClock the output was set up with. Outputs without timestamps send right away
+		virtual bool Send_Short_Message_At(int64_t /*time_us*/, unsigned char status, unsigned char data1, unsigned char data2) { return Send_Short_Message(status, data1, data2); }
+		virtual bool Send_Long_Message_At(int64_t /*time_us*/, const unsigned char* data, size_t length) { return Send_Long_Message(data, length); }
+
+		// Drops the messages handed over with a time that has not been reached yet, e.g. after a seek
+		virtual void Cancel_Pending() { }
+	};
+}
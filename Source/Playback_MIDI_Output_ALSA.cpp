@@ -0,0 +1,272 @@
+#include "Playback_MIDI_Output_ALSA.h"
+
+#ifdef __linux__
+
+#include <alsa/asoundlib.h>
+
+namespace MIDILightDrawer
+{
+	Playback_MIDI_Output_ALSA::Playback_MIDI_Output_ALSA()
+	{
+		_Sequencer = nullptr;
+		_Encoder = nullptr;
+		_Port = -1;
+
+		_Queue = -1;
+		_Clock = nullptr;
+		_Timestamp_Lead_us = 0;
+		_Queue_Origin_us = 0;
+		_Last_Sync_us = 0;
+	}
+
+	Playback_MIDI_Output_ALSA::~Playback_MIDI_Output_ALSA()
+	{
+		Close();
+	}
+
+	bool Playback_MIDI_Output_ALSA::Open(const char* client_name, int destination_client, int destination_port)
+	{
+		Close();
+
+		snd_seq_t* Sequencer = nullptr;
+
+		if (snd_seq_open(&Sequencer, "default", SND_SEQ_OPEN_OUTPUT, 0) < 0) {
+			return false;
+		}
+
+		snd_seq_set_client_name(Sequencer, client_name);
+
+		int Port = snd_seq_create_simple_port(Sequencer, "Light Output", SND_SEQ_PORT_CAP_READ | SND_SEQ_PORT_CAP_SUBS_READ, SND_SEQ_PORT_TYPE_MIDI_GENERIC | SND_SEQ_PORT_TYPE_APPLICATION);
+
+		if (Port < 0) {
+			snd_seq_close(Sequencer);
+			return false;
+		}
+
+		if (destination_client >= 0 && snd_seq_connect_to(Sequencer, Port, destination_client, destination_port) < 0) {
+			snd_seq_close(Sequencer);
+			return false;
+		}
+
+		// Encoder turns raw MIDI bytes into sequencer events. Every message carries its own status byte
+		snd_midi_event_t* Encoder = nullptr;
+
+		if (snd_midi_event_new(3, &Encoder) < 0) {
+			snd_seq_close(Sequencer);
+			return false;
+		}
+
+		snd_midi_event_no_status(Encoder, 1);
+
+		_Sequencer = Sequencer;
+		_Encoder = Encoder;
+		_Port = Port;
+
+		return true;
+	}
+
+	bool Playback_MIDI_Output_ALSA::Enable_Queue(IClock* clock, int64_t lead_us)
+	{
+		if (_Sequencer == nullptr || clock == nullptr || _Queue >= 0) {
+			return false;
+		}
+
+		snd_seq_t* Sequencer = (snd_seq_t*)_Sequencer;
+
+		int Queue = snd_seq_alloc_named_queue(Sequencer, "Light Output");
+
+		if (Queue < 0) {
+			return false;
+		}
+
+		// Scheduled events wait in the output pool of the client until they are dispatched
+		snd_seq_set_client_pool_output(Sequencer, QUEUE_POOL_SIZE);
+
+		if (snd_seq_start_queue(Sequencer, Queue, nullptr) < 0 || snd_seq_drain_output(Sequencer) < 0) {
+			snd_seq_free_queue(Sequencer, Queue);
+			return false;
+		}
+
+		_Queue = Queue;
+		_Clock = clock;
+		_Timestamp_Lead_us = (lead_us > 0) ? lead_us : 0;
+
+		Sync_Queue_Time();
+
+		return true;
+	}
+
+	int Playback_MIDI_Output_ALSA::Get_Client_ID()
+	{
+		return (_Sequencer != nullptr) ? snd_seq_client_id((snd_seq_t*)_Sequencer) : -1;
+	}
+
+	int Playback_MIDI_Output_ALSA::Get_Port()
+	{
+		return _Port;
+	}
+
+	bool Playback_MIDI_Output_ALSA::Is_Open()
+	{
+		return _Sequencer != nullptr;
+	}
+
+	void Playback_MIDI_Output_ALSA::Close()
+	{
+		if (_Queue >= 0)
+		{
+			Cancel_Pending();
+
+			snd_seq_stop_queue((snd_seq_t*)_Sequencer, _Queue, nullptr);
+			snd_seq_drain_output((snd_seq_t*)_Sequencer);
+			snd_seq_free_queue((snd_seq_t*)_Sequencer, _Queue);
+
+			_Queue = -1;
+			_Clock = nullptr;
+			_Timestamp_Lead_us = 0;
+		}
+
+		if (_Encoder != nullptr) {
+			snd_midi_event_free((snd_midi_event_t*)_Encoder);
+			_Encoder = nullptr;
+		}
+
+		if (_Sequencer != nullptr) {
+			snd_seq_close((snd_seq_t*)_Sequencer);
+			_Sequencer = nullptr;
+		}
+
+		_Port = -1;
+	}
+
+	bool Playback_MIDI_Output_ALSA::Send_Short_Message(unsigned char status, unsigned char data1, unsigned char data2)
+	{
+		return Send_Short_Message_At(INT64_MIN, status, data1, data2);
+	}
+
+	bool Playback_MIDI_Output_ALSA::Send_Long_Message(const unsigned char* data, size_t length)
+	{
+		return Send_Long_Message_At(INT64_MIN, data, length);
+	}
+
+	int64_t Playback_MIDI_Output_ALSA::Get_Timestamp_Lead_us()
+	{
+		return (_Queue >= 0) ? _Timestamp_Lead_us : 0;
+	}
+
+	bool Playback_MIDI_Output_ALSA::Send_Short_Message_At(int64_t time_us, unsigned char status, unsigned char data1, unsigned char data2)
+	{
+		if (_Sequencer == nullptr) {
+			return false;
+		}
+
+		// Program change and channel pressure only have one data byte
+		unsigned char Command = status & 0xF0;
+		long Length = (Command == 0xC0 || Command == 0xD0) ? 2 : 3;
+		unsigned char Bytes[3] = { status, data1, data2 };
+
+		snd_seq_event_t Event;
+		snd_seq_ev_clear(&Event);
+
+		snd_midi_event_reset_encode((snd_midi_event_t*)_Encoder);
+
+		if (snd_midi_event_encode((snd_midi_event_t*)_Encoder, Bytes, Length, &Event) != Length || Event.type == SND_SEQ_EVENT_NONE) {
+			return false;
+		}
+
+		return Output_Event(&Event, time_us);
+	}
+
+	bool Playback_MIDI_Output_ALSA::Send_Long_Message_At(int64_t time_us, const unsigned char* data, size_t length)
+	{
+		if (_Sequencer == nullptr || length == 0) {
+			return false;
+		}
+
+		// Variable length event, the data is copied by the direct output
+		snd_seq_event_t Event;
+		snd_seq_ev_clear(&Event);
+		snd_seq_ev_set_sysex(&Event, (unsigned int)length, (void*)data);
+
+		return Output_Event(&Event, time_us);
+	}
+
+	void Playback_MIDI_Output_ALSA::Cancel_Pending()
+	{
+		if (_Sequencer == nullptr || _Queue < 0) {
+			return;
+		}
+
+		// Everything this client still has waiting on the queue, Note Offs included
+		snd_seq_remove_events_t* Remove = nullptr;
+		snd_seq_remove_events_alloca(&Remove);
+		snd_seq_remove_events_set_queue(Remove, _Queue);
+		snd_seq_remove_events_set_condition(Remove, SND_SEQ_REMOVE_OUTPUT);
+
+		snd_seq_remove_events((snd_seq_t*)_Sequencer, Remove);
+	}
+
+	bool Playback_MIDI_Output_ALSA::Output_Event(void* event, int64_t time_us)
+	{
+		snd_seq_event_t* Event = (snd_seq_event_t*)event;
+
+		snd_seq_ev_set_source(Event, _Port);
+		snd_seq_ev_set_subs(Event);
+
+		if (_Queue >= 0 && time_us != INT64_MIN)
+		{
+			if (_Clock->Now_us() - _Last_Sync_us >= QUEUE_SYNC_INTERVAL_US) {
+				Sync_Queue_Time();
+			}
+
+			// A time that has passed already is dispatched right away by the queue
+			int64_t Queue_Time_us = time_us - _Queue_Origin_us;
+
+			if (Queue_Time_us < 0) {
+				Queue_Time_us = 0;
+			}
+
+			snd_seq_real_time_t Time;
+			Time.tv_sec = (unsigned int)(Queue_Time_us / 1000000);
+			Time.tv_nsec = (unsigned int)((Queue_Time_us % 1000000) * 1000);
+
+			snd_seq_ev_schedule_real(Event, _Queue, 0, &Time);
+		}
+		else
+		{
+			snd_seq_ev_set_direct(Event);
+		}
+
+		return snd_seq_event_output_direct((snd_seq_t*)_Sequencer, Event) >= 0;
+	}
+
+	bool Playback_MIDI_Output_ALSA::Get_Queue_Origin_us(void* sequencer, int queue, IClock* clock, int64_t& origin_us)
+	{
+		snd_seq_queue_status_t* Status = nullptr;
+		snd_seq_queue_status_alloca(&Status);
+
+		// The queue time was read somewhere between the two clock readings
+		int64_t Before_us = clock->Now_us();
+
+		if (snd_seq_get_queue_status((snd_seq_t*)sequencer, queue, Status) < 0) {
+			return false;
+		}
+
+		int64_t After_us = clock->Now_us();
+
+		const snd_seq_real_time_t* Real_Time = snd_seq_queue_status_get_real_time(Status);
+		int64_t Queue_Time_us = (int64_t)Real_Time->tv_sec * 1000000 + Real_Time->tv_nsec / 1000;
+
+		origin_us = (Before_us + After_us) / 2 - Queue_Time_us;
+
+		return true;
+	}
+
+	void Playback_MIDI_Output_ALSA::Sync_Queue_Time()
+	{
+		Get_Queue_Origin_us(_Sequencer, _Queue, _Clock, _Queue_Origin_us);
+		_Last_Sync_us = _Clock->Now_us();
+	}
+}
+
+#endif
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstdint>
+
+#include "Playback_Clock.h"
+#include "Playback_MIDI_Output.h"
+
+namespace MIDILightDrawer
+{
+	// Linux ALSA sequencer output. Creates its own sequencer port and optionally connects it to a destination,
+	// otherwise other clients subscribe to the port (e.g. with aconnect).
+	// With a queue, messages handed over with a time are kept by the sequencer and dispatched at that time
+	class Playback_MIDI_Output_ALSA : public IMidiOutput
+	{
+	public:
+		// Events the sequencer holds for this client. A few tens of milliseconds of dense light shows fit easily
+		static const int QUEUE_POOL_SIZE = 2048;
+
+		// The queue runs on the sequencer timer, its offset to the IClock is measured again at this interval
+		static const int64_t QUEUE_SYNC_INTERVAL_US = 1000000;
+
+	private:
+		void* _Sequencer;		// snd_seq_t*
+		void* _Encoder;			// snd_midi_event_t*
+		int _Port;
+
+		int _Queue;					// -1 without a queue
+		IClock* _Clock;
+		int64_t _Timestamp_Lead_us;
+		int64_t _Queue_Origin_us;	// Clock time of queue time zero
+		int64_t _Last_Sync_us;
+
+	public:
+		Playback_MIDI_Output_ALSA();
+		~Playback_MIDI_Output_ALSA();
+
+		// A negative destination client only creates the port
+		bool Open(const char* client_name, int destination_client, int destination_port);
+
+		// Creates and starts a queue on the time base of the clock. The scheduler hands events over lead_us ahead.
+		// Call after Open and before the output is handed to the scheduler
+		bool Enable_Queue(IClock* clock, int64_t lead_us);
+
+		int Get_Client_ID();
+		int Get_Port();
+
+		bool Is_Open() override;
+		void Close() override;
+		bool Send_Short_Message(unsigned char status, unsigned char data1, unsigned char data2) override;
+		bool Send_Long_Message(const unsigned char* data, size_t length) override;
+
+		int64_t Get_Timestamp_Lead_us() override;
+		bool Send_Short_Message_At(int64_t time_us, unsigned char status, unsigned char data1, unsigned char data2) override;
+		bool Send_Long_Message_At(int64_t time_us, const unsigned char* data, size_t length) override;
+		void Cancel_Pending() override;
+
+		// Clock time of queue time zero of a running queue, measured around a status query of the queue
+		static bool Get_Queue_Origin_us(void* sequencer, int queue, IClock* clock, int64_t& origin_us);
+
+	private:
+		bool Output_Event(void* event, int64_t time_us);
+		void Sync_Queue_Time();
+	};
+}
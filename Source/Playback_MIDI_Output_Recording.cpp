@@ -0,0 +1,138 @@
+#ifdef _MSC_VER
+#pragma managed(push, off)
+#endif
+
+#include "Playback_MIDI_Output_Recording.h"
+
+namespace MIDILightDrawer
+{
+	Playback_MIDI_Output_Recording::Playback_MIDI_Output_Recording(IClock* clock)
+	{
+		_Clock = clock;
+		_Is_Open = true;
+		_Timestamp_Lead_us = 0;
+
+		// Avoid reallocations while recording a typical song
+		_Messages.reserve(1 << 16);
+	}
+
+	bool Playback_MIDI_Output_Recording::Is_Open()
+	{
+		return _Is_Open;
+	}
+
+	void Playback_MIDI_Output_Recording::Close()
+	{
+		_Is_Open = false;
+	}
+
+	bool Playback_MIDI_Output_Recording::Send_Short_Message(unsigned char status, unsigned char data1, unsigned char data2)
+	{
+		return Send_Short_Message_At(INT64_MIN, status, data1, data2);
+	}
+
+	bool Playback_MIDI_Output_Recording::Send_Long_Message(const unsigned char* data, size_t length)
+	{
+		return Send_Long_Message_At(INT64_MIN, data, length);
+	}
+
+	int64_t Playback_MIDI_Output_Recording::Get_Timestamp_Lead_us()
+	{
+		return _Timestamp_Lead_us;
+	}
+
+	bool Playback_MIDI_Output_Recording::Send_Short_Message_At(int64_t time_us, unsigned char status, unsigned char data1, unsigned char data2)
+	{
+		if (!_Is_Open) {
+			return false;
+		}
+
+		Recorded_Message Message;
+		Message.Time_us = Get_Delivery_Time_us(time_us);
+		Message.Status = status;
+		Message.Data1 = data1;
+		Message.Data2 = data2;
+		Message.Long_Data_Offset = 0;
+		Message.Long_Data_Length = 0;
+
+		_Messages.push_back(Message);
+
+		return true;
+	}
+
+	bool Playback_MIDI_Output_Recording::Send_Long_Message_At(int64_t time_us, const unsigned char* data, size_t length)
+	{
+		if (!_Is_Open || length == 0) {
+			return false;
+		}
+
+		Recorded_Message Message;
+		Message.Time_us = Get_Delivery_Time_us(time_us);
+		Message.Status = data[0];
+		Message.Data1 = 0;
+		Message.Data2 = 0;
+		Message.Long_Data_Offset = _Long_Data.size();
+		Message.Long_Data_Length = length;
+
+		_Long_Data.insert(_Long_Data.end(), data, data + length);
+		_Messages.push_back(Message);
+
+		return true;
+	}
+
+	void Playback_MIDI_Output_Recording::Cancel_Pending()
+	{
+		if (_Timestamp_Lead_us <= 0 || _Clock == nullptr) {
+			return;
+		}
+
+		// Handed over in time order, the pending ones are at the end
+		int64_t Now_us = _Clock->Now_us();
+
+		while (!_Messages.empty() && _Messages.back().Time_us > Now_us)
+		{
+			if (_Messages.back().Long_Data_Length > 0) {
+				_Long_Data.resize(_Messages.back().Long_Data_Offset);
+			}
+
+			_Messages.pop_back();
+		}
+	}
+
+	void Playback_MIDI_Output_Recording::Set_Timestamp_Lead_us(int64_t lead_us)
+	{
+		_Timestamp_Lead_us = (lead_us > 0) ? lead_us : 0;
+	}
+
+	const std::vector<Playback_MIDI_Output_Recording::Recorded_Message>& Playback_MIDI_Output_Recording::Get_Messages() const
+	{
+		return _Messages;
+	}
+
+	const std::vector<unsigned char>& Playback_MIDI_Output_Recording::Get_Long_Data() const
+	{
+		return _Long_Data;
+	}
+
+	void Playback_MIDI_Output_Recording::Clear()
+	{
+		_Messages.clear();
+		_Long_Data.clear();
+	}
+
+	int64_t Playback_MIDI_Output_Recording::Get_Delivery_Time_us(int64_t time_us)
+	{
+		int64_t Now_us = (_Clock != nullptr) ? _Clock->Now_us() : 0;
+
+		// A time that has passed already is delivered right away, as a driver would
+		if (_Timestamp_Lead_us > 0 && time_us > Now_us) {
+			return time_us;
+		}
+
+		return Now_us;
+	}
+}
+
+#ifdef _MSC_VER
+#pragma managed(pop)
+#endif
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+#include "Playback_Clock.h"
+#include "Playback_MIDI_Output.h"
+
+namespace MIDILightDrawer
+{
+	// In-memory sink that stores every message with the clock time it was sent at.
+	// With a timestamp lead, it stands in for a timestamped output: messages are stored with the time they were handed over for,
+	// as a driver without any jitter would deliver them. Written by the scheduler thread, read it only while the scheduler is stopped
+	class Playback_MIDI_Output_Recording : public IMidiOutput
+	{
+	public:
+		struct Recorded_Message
+		{
+			int64_t Time_us;
+			unsigned char Status;
+			unsigned char Data1;
+			unsigned char Data2;
+			size_t Long_Data_Offset;	// SysEx only: range in Get_Long_Data(), Status is F0
+			size_t Long_Data_Length;
+		};
+
+	private:
+		IClock* _Clock;
+		std::vector<Recorded_Message> _Messages;
+		std::vector<unsigned char> _Long_Data;
+		bool _Is_Open;
+		int64_t _Timestamp_Lead_us;
+
+	public:
+		Playback_MIDI_Output_Recording(IClock* clock);
+
+		bool Is_Open() override;
+		void Close() override;
+		bool Send_Short_Message(unsigned char status, unsigned char data1, unsigned char data2) override;
+		bool Send_Long_Message(const unsigned char* data, size_t length) override;
+
+		int64_t Get_Timestamp_Lead_us() override;
+		bool Send_Short_Message_At(int64_t time_us, unsigned char status, unsigned char data1, unsigned char data2) override;
+		bool Send_Long_Message_At(int64_t time_us, const unsigned char* data, size_t length) override;
+		void Cancel_Pending() override;
+
+		// 0 records every message at the time it is sent. Set before the scheduler starts
+		void Set_Timestamp_Lead_us(int64_t lead_us);
+
+		const std::vector<Recorded_Message>& Get_Messages() const;
+		const std::vector<unsigned char>& Get_Long_Data() const;
+		void Clear();
+
+	private:
+		int64_t Get_Delivery_Time_us(int64_t time_us);
+	};
+}
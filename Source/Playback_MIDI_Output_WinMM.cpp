@@ -0,0 +1,151 @@
+#pragma managed(push, off)
+
+#include "Playback_MIDI_Output_WinMM.h"
+
+#ifdef _WIN32
+
+#include <Windows.h>
+#include <mmsystem.h>
+
+#pragma comment(lib, "winmm.lib")
+
+namespace MIDILightDrawer
+{
+	Playback_MIDI_Output_WinMM::Playback_MIDI_Output_WinMM()
+	{
+		_MIDI_Handle = nullptr;
+
+		LARGE_INTEGER Frequency;
+		QueryPerformanceFrequency(&Frequency);
+		_Counter_Frequency = Frequency.QuadPart;
+
+		Reset_Send_Statistics();
+	}
+
+	Playback_MIDI_Output_WinMM::~Playback_MIDI_Output_WinMM()
+	{
+		Close();
+	}
+
+	bool Playback_MIDI_Output_WinMM::Open(int device_id)
+	{
+		Close();
+
+		HMIDIOUT Midi_Out;
+		MMRESULT Result = midiOutOpen(&Midi_Out, device_id, 0, 0, CALLBACK_NULL);
+
+		if (Result != MMSYSERR_NOERROR) {
+			return false;
+		}
+
+		_MIDI_Handle = (void*)Midi_Out;
+
+		return true;
+	}
+
+	bool Playback_MIDI_Output_WinMM::Is_Open()
+	{
+		return _MIDI_Handle != nullptr;
+	}
+
+	void Playback_MIDI_Output_WinMM::Close()
+	{
+		if (_MIDI_Handle)
+		{
+			midiOutClose((HMIDIOUT)_MIDI_Handle);
+			_MIDI_Handle = nullptr;
+		}
+	}
+
+	bool Playback_MIDI_Output_WinMM::Send_Short_Message(unsigned char status, unsigned char data1, unsigned char data2)
+	{
+		if (!_MIDI_Handle) {
+			return false;
+		}
+
+		// Pack MIDI message into DWORD (status | data1 << 8 | data2 << 16)
+		DWORD Midi_Message = status | (data1 << 8) | (data2 << 16);
+
+		LARGE_INTEGER Start;
+		QueryPerformanceCounter(&Start);
+
+		MMRESULT Result = midiOutShortMsg((HMIDIOUT)_MIDI_Handle, Midi_Message);
+
+		Add_Send_Time(Start.QuadPart);
+
+		return (Result == MMSYSERR_NOERROR);
+	}
+
+	bool Playback_MIDI_Output_WinMM::Send_Long_Message(const unsigned char* data, size_t length)
+	{
+		if (!_MIDI_Handle || length == 0) {
+			return false;
+		}
+
+		HMIDIOUT Midi_Out = (HMIDIOUT)_MIDI_Handle;
+
+		// The driver only reads from the buffer
+		MIDIHDR Header;
+		ZeroMemory(&Header, sizeof(MIDIHDR));
+		Header.lpData = (LPSTR)data;
+		Header.dwBufferLength = (DWORD)length;
+		Header.dwBytesRecorded = (DWORD)length;
+
+		if (midiOutPrepareHeader(Midi_Out, &Header, sizeof(MIDIHDR)) != MMSYSERR_NOERROR) {
+			return false;
+		}
+
+		LARGE_INTEGER Start;
+		QueryPerformanceCounter(&Start);
+
+		MMRESULT Result = midiOutLongMsg(Midi_Out, &Header, sizeof(MIDIHDR));
+
+		// The driver may still be transmitting, header and buffer have to stay valid until it is done
+		while (midiOutUnprepareHeader(Midi_Out, &Header, sizeof(MIDIHDR)) == MIDIERR_STILLPLAYING) {
+			Sleep(0);
+		}
+
+		// Including the wait for the transmission, the caller is blocked for all of it
+		Add_Send_Time(Start.QuadPart);
+
+		return (Result == MMSYSERR_NOERROR);
+	}
+
+	Playback_MIDI_Output_WinMM::Send_Statistics Playback_MIDI_Output_WinMM::Get_Send_Statistics() const
+	{
+		Send_Statistics Result;
+		Result.Call_Count = _Call_Count.load(std::memory_order_relaxed);
+		Result.Time_Total_us = _Time_Total_Ticks.load(std::memory_order_relaxed) * 1000000 / _Counter_Frequency;
+		Result.Time_Max_us = _Time_Max_Ticks.load(std::memory_order_relaxed) * 1000000 / _Counter_Frequency;
+
+		return Result;
+	}
+
+	void Playback_MIDI_Output_WinMM::Reset_Send_Statistics()
+	{
+		_Call_Count.store(0, std::memory_order_relaxed);
+		_Time_Total_Ticks.store(0, std::memory_order_relaxed);
+		_Time_Max_Ticks.store(0, std::memory_order_relaxed);
+	}
+
+	void Playback_MIDI_Output_WinMM::Add_Send_Time(int64_t start_ticks)
+	{
+		LARGE_INTEGER End;
+		QueryPerformanceCounter(&End);
+
+		int64_t Ticks = End.QuadPart - start_ticks;
+
+		// The playback thread and the control thread may both send
+		_Call_Count.fetch_add(1, std::memory_order_relaxed);
+		_Time_Total_Ticks.fetch_add(Ticks, std::memory_order_relaxed);
+
+		int64_t Max_Ticks = _Time_Max_Ticks.load(std::memory_order_relaxed);
+
+		while (Ticks > Max_Ticks && !_Time_Max_Ticks.compare_exchange_weak(Max_Ticks, Ticks, std::memory_order_relaxed)) {
+		}
+	}
+}
+
+#endif
+
+#pragma managed(pop)
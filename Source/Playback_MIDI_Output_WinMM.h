@@ -0,0 +1,47 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#include "Playback_MIDI_Output.h"
+
+namespace MIDILightDrawer
+{
+	// Windows multimedia MIDI output (midiOutShortMsg, midiOutLongMsg for SysEx).
+	// Times every call into the driver, the statistics can be read from any thread
+	class Playback_MIDI_Output_WinMM : public IMidiOutput
+	{
+	public:
+		struct Send_Statistics
+		{
+			uint64_t Call_Count;
+			int64_t Time_Total_us;
+			int64_t Time_Max_us;
+		};
+
+	private:
+		void* _MIDI_Handle;
+
+		int64_t _Counter_Frequency;
+		std::atomic<uint64_t> _Call_Count;
+		std::atomic<int64_t> _Time_Total_Ticks;
+		std::atomic<int64_t> _Time_Max_Ticks;
+
+	public:
+		Playback_MIDI_Output_WinMM();
+		~Playback_MIDI_Output_WinMM();
+
+		bool Open(int device_id);
+
+		bool Is_Open() override;
+		void Close() override;
+		bool Send_Short_Message(unsigned char status, unsigned char data1, unsigned char data2) override;
+		bool Send_Long_Message(const unsigned char* data, size_t length) override;
+
+		Send_Statistics Get_Send_Statistics() const;
+		void Reset_Send_Statistics();
+
+	private:
+		void Add_Send_Time(int64_t start_ticks);
+	};
+}
@@ -0,0 +1,416 @@
+#ifdef _MSC_VER
+#pragma managed(push, off)
+#endif
+
+#include "Playback_MIDI_Port_Router.h"
+
+#include <cstring>
+
+namespace MIDILightDrawer
+{
+	Playback_MIDI_Port_Router::Port::Port(IMidiOutput* output, IClock* wake_clock) :
+		Scheduled_Queue(PORT_QUEUE_CAPACITY),
+		Immediate_Queue(PORT_QUEUE_CAPACITY),
+		Frame_Queue(FRAME_QUEUE_CAPACITY)
+	{
+		Output = output;
+		Wake_Clock = wake_clock;
+		Thread = nullptr;
+
+		Waiting.store(false);
+		Dropped_Count.store(0);
+	}
+
+	Playback_MIDI_Port_Router::Playback_MIDI_Port_Router()
+	{
+		for (int i = 0; i < MAX_TRACKS; i++) {
+			_Track_Ports[i].store(0);
+		}
+
+		for (int i = 0; i < MAX_PORTS; i++) {
+			_Port_Bytes_Per_Second[i].store(0);
+		}
+
+		_Should_Stop.store(false);
+		_Is_Running = false;
+	}
+
+	Playback_MIDI_Port_Router::~Playback_MIDI_Port_Router()
+	{
+		Stop();
+		Remove_All_Ports();
+	}
+
+	int Playback_MIDI_Port_Router::Add_Port(IMidiOutput* output, IClock* wake_clock)
+	{
+		if (_Is_Running || output == nullptr || wake_clock == nullptr || (int)_Ports.size() >= MAX_PORTS) {
+			return -1;
+		}
+
+		int Port_Index = (int)_Ports.size();
+
+		_Ports.push_back(new Port(output, wake_clock));
+		_Ports.back()->Shaper.Set_Bytes_Per_Second(_Port_Bytes_Per_Second[Port_Index].load(std::memory_order_relaxed));
+
+		return Port_Index;
+	}
+
+	void Playback_MIDI_Port_Router::Remove_All_Ports()
+	{
+		if (_Is_Running) {
+			return;
+		}
+
+		for (size_t i = 0; i < _Ports.size(); i++) {
+			delete _Ports[i];
+		}
+
+		_Ports.clear();
+	}
+
+	int Playback_MIDI_Port_Router::Get_Port_Count() const
+	{
+		return (int)_Ports.size();
+	}
+
+	IMidiOutput* Playback_MIDI_Port_Router::Get_Port_Output(int port) const
+	{
+		if (port < 0 || port >= (int)_Ports.size()) {
+			return nullptr;
+		}
+
+		return _Ports[port]->Output;
+	}
+
+	void Playback_MIDI_Port_Router::Set_Track_Port(int track, int port)
+	{
+		if (track < 0 || track >= MAX_TRACKS || port < 0 || port >= MAX_PORTS) {
+			return;
+		}
+
+		_Track_Ports[track].store(port, std::memory_order_relaxed);
+	}
+
+	int Playback_MIDI_Port_Router::Get_Track_Port(int track) const
+	{
+		if (track < 0 || track >= MAX_TRACKS) {
+			return 0;
+		}
+
+		return _Track_Ports[track].load(std::memory_order_relaxed);
+	}
+
+	bool Playback_MIDI_Port_Router::Start()
+	{
+		if (_Is_Running || _Ports.empty()) {
+			return false;
+		}
+
+		_Should_Stop.store(false, std::memory_order_release);
+
+		for (size_t i = 0; i < _Ports.size(); i++)
+		{
+			_Ports[i]->Scheduled_Queue.Reset();
+			_Ports[i]->Immediate_Queue.Reset();
+			_Ports[i]->Frame_Queue.Reset();
+			_Ports[i]->Thread = new std::thread(&Playback_MIDI_Port_Router::Port_Thread_Function, this, _Ports[i]);
+		}
+
+		_Is_Running = true;
+
+		return true;
+	}
+
+	void Playback_MIDI_Port_Router::Stop()
+	{
+		if (!_Is_Running) {
+			return;
+		}
+
+		_Should_Stop.store(true, std::memory_order_release);
+
+		for (size_t i = 0; i < _Ports.size(); i++)
+		{
+			Port* Current_Port = _Ports[i];
+			Current_Port->Wake_Clock->Wake();
+
+			// The thread sends what is still queued before it returns
+			if (Current_Port->Thread->joinable()) {
+				Current_Port->Thread->join();
+			}
+
+			delete Current_Port->Thread;
+			Current_Port->Thread = nullptr;
+
+			// Whatever still waits for the link is outdated by the next start
+			Current_Port->Shaper.Clear();
+		}
+
+		_Is_Running = false;
+	}
+
+	bool Playback_MIDI_Port_Router::Is_Running() const
+	{
+		return _Is_Running;
+	}
+
+	bool Playback_MIDI_Port_Router::Send(const MIDI_Event& event)
+	{
+		if (_Ports.empty()) {
+			return false;
+		}
+
+		Port_Message Message = To_Port_Message(event);
+
+		if (event.Track < 0)
+		{
+			bool Success = true;
+
+			for (size_t i = 0; i < _Ports.size(); i++) {
+				Success &= Push(_Ports[i], _Ports[i]->Scheduled_Queue, Message);
+			}
+
+			return Success;
+		}
+
+		int Port_Index = Resolve_Track_Port(event.Track);
+
+		return Push(_Ports[Port_Index], _Ports[Port_Index]->Scheduled_Queue, Message);
+	}
+
+	bool Playback_MIDI_Port_Router::Send_Frame(int port, const unsigned char* data, size_t length)
+	{
+		if (port < 0 || port >= (int)_Ports.size() || length == 0 || length > Playback_MIDI_Frame_Builder::MAX_FRAME_BYTES) {
+			return false;
+		}
+
+		Port* Target_Port = _Ports[port];
+
+		if (!_Is_Running) {
+			return Target_Port->Output->Send_Long_Message(data, length);
+		}
+
+		// Both queues need room, a frame without its marker would be picked up by the marker of the next frame
+		if (Target_Port->Scheduled_Queue.Size() >= Target_Port->Scheduled_Queue.Capacity()) {
+			Target_Port->Dropped_Count.fetch_add(1, std::memory_order_relaxed);
+			return false;
+		}
+
+		Port_Frame Frame;
+		Frame.Length = length;
+		std::memcpy(Frame.Data, data, length);
+
+		if (!Target_Port->Frame_Queue.Try_Push(Frame)) {
+			Target_Port->Dropped_Count.fetch_add(1, std::memory_order_relaxed);
+			return false;
+		}
+
+		Port_Message Marker;
+		Marker.Status = Playback_MIDI_Frame_Builder::SYSEX_START;
+		Marker.Data1 = 0;
+		Marker.Data2 = 0;
+
+		return Push(Target_Port, Target_Port->Scheduled_Queue, Marker);
+	}
+
+	int Playback_MIDI_Port_Router::Resolve_Track_Port(int track) const
+	{
+		int Port_Index = Get_Track_Port(track);
+
+		// Tracks mapped to a port that does not exist fall back to the first one
+		if (Port_Index >= (int)_Ports.size()) {
+			Port_Index = 0;
+		}
+
+		return Port_Index;
+	}
+
+	bool Playback_MIDI_Port_Router::Send_Immediate(const MIDI_Event& event)
+	{
+		if (_Ports.empty()) {
+			return false;
+		}
+
+		Port_Message Message = To_Port_Message(event);
+
+		if (event.Track < 0) {
+			return Send_Immediate_To_All_Ports(Message.Status, Message.Data1, Message.Data2);
+		}
+
+		int Port_Index = Resolve_Track_Port(event.Track);
+
+		return Push(_Ports[Port_Index], _Ports[Port_Index]->Immediate_Queue, Message);
+	}
+
+	bool Playback_MIDI_Port_Router::Send_Immediate_To_All_Ports(unsigned char status, unsigned char data1, unsigned char data2)
+	{
+		Port_Message Message;
+		Message.Status = status;
+		Message.Data1 = data1;
+		Message.Data2 = data2;
+
+		bool Success = !_Ports.empty();
+
+		for (size_t i = 0; i < _Ports.size(); i++) {
+			Success &= Push(_Ports[i], _Ports[i]->Immediate_Queue, Message);
+		}
+
+		return Success;
+	}
+
+	void Playback_MIDI_Port_Router::Set_Port_Bytes_Per_Second(int port, int bytes_per_second)
+	{
+		if (port < 0 || port >= MAX_PORTS) {
+			return;
+		}
+
+		_Port_Bytes_Per_Second[port].store(bytes_per_second, std::memory_order_relaxed);
+
+		if (port < (int)_Ports.size()) {
+			_Ports[port]->Shaper.Set_Bytes_Per_Second(bytes_per_second);
+		}
+	}
+
+	uint64_t Playback_MIDI_Port_Router::Get_Sent_Count(int port) const
+	{
+		return Get_Link_Statistics(port).Sent_Count;
+	}
+
+	uint64_t Playback_MIDI_Port_Router::Get_Dropped_Count(int port) const
+	{
+		if (port < 0 || port >= (int)_Ports.size()) {
+			return 0;
+		}
+
+		return _Ports[port]->Dropped_Count.load(std::memory_order_relaxed) + _Ports[port]->Shaper.Get_Statistics().Dropped_Count;
+	}
+
+	Playback_MIDI_Link_Shaper::Statistics Playback_MIDI_Port_Router::Get_Link_Statistics(int port) const
+	{
+		if (port < 0 || port >= (int)_Ports.size()) {
+			Playback_MIDI_Link_Shaper::Statistics Empty = {};
+			return Empty;
+		}
+
+		return _Ports[port]->Shaper.Get_Statistics();
+	}
+
+	void Playback_MIDI_Port_Router::Port_Thread_Function(Port* port)
+	{
+		Port_Message Message;
+
+		while (true)
+		{
+			// Immediate messages (notes off, panic) first, then the scheduled ones in their order
+			while (port->Immediate_Queue.Try_Pop(Message)) {
+				Send_Direct(port, Message, false);
+			}
+
+			while (port->Scheduled_Queue.Try_Pop(Message)) {
+				Send_Direct(port, Message, true);
+
+				if (port->Immediate_Queue.Size() > 0) {
+					break;
+				}
+			}
+
+			if (port->Immediate_Queue.Size() > 0 || port->Scheduled_Queue.Size() > 0) {
+				continue;
+			}
+
+			if (_Should_Stop.load(std::memory_order_acquire)) {
+				break;
+			}
+
+			int64_t Wait_us = MAX_IDLE_WAIT_US;
+
+			// Messages held back by the link model go out as soon as the link has room again
+			if (port->Shaper.Has_Pending())
+			{
+				int64_t Now_us = port->Wake_Clock->Now_us();
+				port->Shaper.Drain(Now_us, port->Output);
+
+				int64_t Until_Drain_us = port->Shaper.Get_Next_Drain_us() - Now_us;
+
+				if (Until_Drain_us <= 0) {
+					continue;
+				}
+
+				Wait_us = (Until_Drain_us < Wait_us) ? Until_Drain_us : Wait_us;
+			}
+
+			port->Waiting.store(true, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+
+			// A message may have been queued between the check above and setting the flag
+			if (port->Immediate_Queue.Size() == 0 && port->Scheduled_Queue.Size() == 0) {
+				port->Wake_Clock->Wait_For_us(Wait_us);
+			}
+
+			port->Waiting.store(false, std::memory_order_relaxed);
+		}
+	}
+
+	bool Playback_MIDI_Port_Router::Push(Port* port, Playback_SPSC_Ring<Port_Message>& queue, const Port_Message& message)
+	{
+		// Without running threads the caller sends itself, e.g. a note off while playback is stopped
+		if (!_Is_Running) {
+			return Send_Direct(port, message, false);
+		}
+
+		if (!queue.Try_Push(message)) {
+			port->Dropped_Count.fetch_add(1, std::memory_order_relaxed);
+			return false;
+		}
+
+		// The fence pairs with the one in the port thread, either it sees the message or we see its waiting flag
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+
+		if (port->Waiting.load(std::memory_order_relaxed)) {
+			port->Wake_Clock->Wake();
+		}
+
+		return true;
+	}
+
+	bool Playback_MIDI_Port_Router::Send_Direct(Port* port, const Port_Message& message, bool is_scheduled)
+	{
+		int64_t Now_us = port->Wake_Clock->Now_us();
+
+		if (message.Status == Playback_MIDI_Frame_Builder::SYSEX_START)
+		{
+			// Frames only come through the scheduled queue, the port thread is the consumer of both
+			Port_Frame Frame;
+
+			if (!port->Frame_Queue.Try_Pop(Frame) || !port->Output->Send_Long_Message(Frame.Data, Frame.Length)) {
+				return false;
+			}
+
+			port->Shaper.Account_Sent(Frame.Length, Now_us);
+
+			return true;
+		}
+
+		// Scheduled messages are paced to the link of the port, immediate ones go out right away
+		if (is_scheduled) {
+			port->Shaper.Submit(message.Status, message.Data1, message.Data2, Now_us, port->Output);
+			return true;
+		}
+
+		return port->Shaper.Send_Immediate(message.Status, message.Data1, message.Data2, Now_us, port->Output);
+	}
+
+	Playback_MIDI_Port_Router::Port_Message Playback_MIDI_Port_Router::To_Port_Message(const MIDI_Event& event)
+	{
+		Port_Message Message;
+		Message.Status = (unsigned char)(event.Command | event.Channel);
+		Message.Data1 = event.Data1;
+		Message.Data2 = event.Data2;
+
+		return Message;
+	}
+}
+
+#ifdef _MSC_VER
+#pragma managed(pop)
+#endif
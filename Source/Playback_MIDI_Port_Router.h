@@ -0,0 +1,119 @@
+#pragma once
+
+#include <thread>
+#include <atomic>
+#include <vector>
+#include <cstdint>
+
+#include "Playback_Clock.h"
+#include "Playback_MIDI_Output.h"
+#include "Playback_MIDI_Schedule.h"
+#include "Playback_MIDI_Frame_Builder.h"
+#include "Playback_MIDI_Link_Shaper.h"
+#include "Playback_SPSC_Ring.h"
+
+namespace MIDILightDrawer
+{
+	// Fans the events of the scheduler out to several MIDI outputs. Every timeline track is mapped to one port,
+	// and every port has its own send queue and thread, so a slow interface only delays its own messages.
+	// Works with any IMidiOutput, e.g. several ALSA sequencer ports or recording sinks for tests
+	class Playback_MIDI_Port_Router
+	{
+	public:
+		typedef Playback_MIDI_Schedule::MIDI_Event MIDI_Event;
+
+		static const int MAX_PORTS = 16;
+		static const int MAX_TRACKS = 256;
+
+		// Messages waiting for one port. A port that falls this far behind drops messages instead of stalling the scheduler
+		static const size_t PORT_QUEUE_CAPACITY = 1 << 12;
+		static const size_t FRAME_QUEUE_CAPACITY = 64;
+
+		// Upper bound of one sleep of a port thread, it is woken as soon as a message is queued
+		static const int64_t MAX_IDLE_WAIT_US = 100000;
+
+	private:
+		struct Port_Message
+		{
+			unsigned char Status;
+			unsigned char Data1;
+			unsigned char Data2;
+		};
+
+		// Announced in the scheduled queue by a message with SysEx status, so frames keep their place between the short messages
+		struct Port_Frame
+		{
+			size_t Length;
+			unsigned char Data[Playback_MIDI_Frame_Builder::MAX_FRAME_BYTES];
+		};
+
+		struct Port
+		{
+			IMidiOutput* Output;
+			IClock* Wake_Clock;		// Sleeps and wakes the port thread, its time paces the link shaper
+			std::thread* Thread;
+
+			// Two producers: the playback thread for scheduled events, the control thread for immediate ones
+			Playback_SPSC_Ring<Port_Message> Scheduled_Queue;
+			Playback_SPSC_Ring<Port_Message> Immediate_Queue;
+			Playback_SPSC_Ring<Port_Frame> Frame_Queue;
+			std::atomic<bool> Waiting;
+
+			Playback_MIDI_Link_Shaper Shaper;		// Port thread only while the router runs
+			std::atomic<uint64_t> Dropped_Count;	// Messages that did not fit into the port queues
+
+			Port(IMidiOutput* output, IClock* wake_clock);
+		};
+
+		std::vector<Port*> _Ports;
+		std::atomic<int> _Track_Ports[MAX_TRACKS];
+		std::atomic<int> _Port_Bytes_Per_Second[MAX_PORTS];
+		std::atomic<bool> _Should_Stop;
+		bool _Is_Running;
+
+	public:
+		Playback_MIDI_Port_Router();
+		~Playback_MIDI_Port_Router();
+
+		// Output and clock stay owned by the caller. Ports can only be added or removed while the router is stopped.
+		// Returns the port index, -1 if no more ports are available
+		int Add_Port(IMidiOutput* output, IClock* wake_clock);
+		void Remove_All_Ports();
+		int Get_Port_Count() const;
+		IMidiOutput* Get_Port_Output(int port) const;
+
+		// Tracks start on port 0. Can be changed at any time, takes effect with the next event of the track
+		void Set_Track_Port(int track, int port);
+		int Get_Track_Port(int track) const;
+
+		bool Start();
+		void Stop();
+		bool Is_Running() const;
+
+		// Playback thread only. Events without a timeline track (negative track) go to every port
+		bool Send(const MIDI_Event& event);
+
+		// Playback thread only. Complete SysEx message of at most MAX_FRAME_BYTES
+		bool Send_Frame(int port, const unsigned char* data, size_t length);
+
+		// Port of the track's events, falls back to port 0 for tracks mapped to a port that does not exist
+		int Resolve_Track_Port(int track) const;
+
+		// Control thread only, sent ahead of the scheduled events still waiting for the port
+		bool Send_Immediate(const MIDI_Event& event);
+		bool Send_Immediate_To_All_Ports(unsigned char status, unsigned char data1, unsigned char data2);
+
+		// Link capacity of a port, 0 sends without pacing. Kept for ports added later
+		void Set_Port_Bytes_Per_Second(int port, int bytes_per_second);
+
+		uint64_t Get_Sent_Count(int port) const;
+		uint64_t Get_Dropped_Count(int port) const;
+		Playback_MIDI_Link_Shaper::Statistics Get_Link_Statistics(int port) const;
+
+	private:
+		void Port_Thread_Function(Port* port);
+		bool Push(Port* port, Playback_SPSC_Ring<Port_Message>& queue, const Port_Message& message);
+		bool Send_Direct(Port* port, const Port_Message& message, bool is_scheduled);
+		static Port_Message To_Port_Message(const MIDI_Event& event);
+	};
+}
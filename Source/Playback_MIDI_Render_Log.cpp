@@ -0,0 +1,542 @@
+#ifdef _MSC_VER
+#pragma managed(push, off)
+#endif
+
+#include "Playback_MIDI_Render_Log.h"
+#include "Playback_Tempo_Map.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <cstdio>
+
+namespace MIDILightDrawer
+{
+	static const char FILE_MAGIC[4] = { 'M', 'L', 'R', 'L' };
+
+	// Tempo of a Standard MIDI File until its first tempo event, 120 BPM
+	static const uint32_t SMF_DEFAULT_US_PER_QUARTER = 500000;
+
+	struct Note_Key_Time
+	{
+		uint32_t Key;
+		int64_t Time_us;
+	};
+
+	static void Write_Var_Int(std::vector<unsigned char>& buffer, int64_t value)
+	{
+		uint64_t Zigzag = ((uint64_t)value << 1) ^ (uint64_t)(value >> 63);
+
+		while (Zigzag >= 0x80)
+		{
+			buffer.push_back((unsigned char)(Zigzag | 0x80));
+			Zigzag >>= 7;
+		}
+
+		buffer.push_back((unsigned char)Zigzag);
+	}
+
+	static bool Read_Var_Int(const std::vector<unsigned char>& buffer, size_t& position, int64_t& value)
+	{
+		uint64_t Zigzag = 0;
+
+		for (int Shift = 0; Shift < 64; Shift += 7)
+		{
+			if (position >= buffer.size()) {
+				return false;
+			}
+
+			unsigned char Byte = buffer[position++];
+			Zigzag |= (uint64_t)(Byte & 0x7F) << Shift;
+
+			if ((Byte & 0x80) == 0)
+			{
+				value = (int64_t)(Zigzag >> 1) ^ -(int64_t)(Zigzag & 1);
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	static void Write_Uint(std::vector<unsigned char>& buffer, uint64_t value, int byte_count)
+	{
+		for (int i = 0; i < byte_count; i++) {
+			buffer.push_back((unsigned char)(value >> (8 * i)));
+		}
+	}
+
+	static uint32_t Read_Big_Endian(const std::vector<unsigned char>& data, size_t position, int byte_count)
+	{
+		uint32_t Value = 0;
+
+		for (int i = 0; i < byte_count; i++) {
+			Value = (Value << 8) | data[position + i];
+		}
+
+		return Value;
+	}
+
+	static bool Read_SMF_Var_Len(const std::vector<unsigned char>& data, size_t& position, size_t end, uint32_t& value)
+	{
+		value = 0;
+
+		for (int i = 0; i < 4; i++)
+		{
+			if (position >= end) {
+				return false;
+			}
+
+			unsigned char Byte = data[position++];
+			value = (value << 7) | (Byte & 0x7F);
+
+			if ((Byte & 0x80) == 0) {
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	static bool Read_File(const std::string& filename, std::vector<unsigned char>& data)
+	{
+		std::ifstream File(filename, std::ios::binary);
+
+		if (!File.is_open()) {
+			return false;
+		}
+
+		data.assign(std::istreambuf_iterator<char>(File), std::istreambuf_iterator<char>());
+
+		return !File.bad();
+	}
+
+	// Note On with velocity 0 is a Note Off, the velocity of a Note Off is not compared
+	static bool Get_Note_Key(const Playback_MIDI_Render_Log::Record& record, uint32_t& key)
+	{
+		unsigned char Command = record.Status & 0xF0;
+		unsigned char Channel = record.Status & 0x0F;
+
+		if (Command == 0x90 && record.Data2 > 0) {
+			key = ((uint32_t)(0x90 | Channel) << 16) | ((uint32_t)record.Data1 << 8) | record.Data2;
+			return true;
+		}
+
+		if (Command == 0x80 || Command == 0x90) {
+			key = ((uint32_t)(0x80 | Channel) << 16) | ((uint32_t)record.Data1 << 8);
+			return true;
+		}
+
+		return false;
+	}
+
+	Playback_MIDI_Render_Log::Playback_MIDI_Render_Log()
+	{
+	}
+
+	void Playback_MIDI_Render_Log::Append(const Record& record)
+	{
+		_Records.push_back(record);
+	}
+
+	void Playback_MIDI_Render_Log::Reserve(size_t count)
+	{
+		_Records.reserve(count);
+	}
+
+	void Playback_MIDI_Render_Log::Clear()
+	{
+		_Records.clear();
+	}
+
+	size_t Playback_MIDI_Render_Log::Size() const
+	{
+		return _Records.size();
+	}
+
+	const std::vector<Playback_MIDI_Render_Log::Record>& Playback_MIDI_Render_Log::Get_Records() const
+	{
+		return _Records;
+	}
+
+	bool Playback_MIDI_Render_Log::Save_To_File(const std::string& filename) const
+	{
+		std::vector<unsigned char> Buffer;
+		Buffer.reserve(16 + _Records.size() * 8);
+
+		Buffer.insert(Buffer.end(), FILE_MAGIC, FILE_MAGIC + sizeof(FILE_MAGIC));
+		Write_Uint(Buffer, FILE_VERSION, 4);
+		Write_Uint(Buffer, _Records.size(), 8);
+
+		int64_t Previous_Intended_us = 0;
+
+		for (size_t i = 0; i < _Records.size(); i++)
+		{
+			const Record& Current = _Records[i];
+
+			Write_Var_Int(Buffer, Current.Intended_us - Previous_Intended_us);
+			Write_Var_Int(Buffer, Current.Actual_us - Current.Intended_us);
+			Write_Var_Int(Buffer, Current.Track);
+
+			Buffer.push_back(Current.Status);
+			Buffer.push_back(Current.Data1);
+			Buffer.push_back(Current.Data2);
+
+			Previous_Intended_us = Current.Intended_us;
+		}
+
+		std::ofstream File(filename, std::ios::binary);
+
+		if (!File.is_open()) {
+			return false;
+		}
+
+		File.write(reinterpret_cast<const char*>(Buffer.data()), Buffer.size());
+
+		return File.good();
+	}
+
+	bool Playback_MIDI_Render_Log::Load_From_File(const std::string& filename)
+	{
+		std::vector<unsigned char> Data;
+
+		if (!Read_File(filename, Data) || Data.size() < 16 || !std::equal(FILE_MAGIC, FILE_MAGIC + sizeof(FILE_MAGIC), Data.begin())) {
+			return false;
+		}
+
+		uint32_t Version = 0;
+		uint64_t Count = 0;
+
+		for (int i = 0; i < 4; i++) {
+			Version |= (uint32_t)Data[4 + i] << (8 * i);
+		}
+
+		for (int i = 0; i < 8; i++) {
+			Count |= (uint64_t)Data[8 + i] << (8 * i);
+		}
+
+		if (Version != FILE_VERSION) {
+			return false;
+		}
+
+		std::vector<Record> Records;
+		size_t Position = 16;
+		int64_t Previous_Intended_us = 0;
+
+		for (uint64_t i = 0; i < Count; i++)
+		{
+			int64_t Intended_Delta_us = 0;
+			int64_t Lateness_us = 0;
+			int64_t Track = 0;
+
+			if (!Read_Var_Int(Data, Position, Intended_Delta_us) || !Read_Var_Int(Data, Position, Lateness_us) || !Read_Var_Int(Data, Position, Track) || Position + 3 > Data.size()) {
+				return false;
+			}
+
+			Record Current;
+			Current.Intended_us = Previous_Intended_us + Intended_Delta_us;
+			Current.Actual_us = Current.Intended_us + Lateness_us;
+			Current.Track = (int)Track;
+			Current.Status = Data[Position];
+			Current.Data1 = Data[Position + 1];
+			Current.Data2 = Data[Position + 2];
+			Position += 3;
+
+			Records.push_back(Current);
+			Previous_Intended_us = Current.Intended_us;
+		}
+
+		_Records.swap(Records);
+
+		return true;
+	}
+
+	bool Playback_MIDI_Render_Log::Read_Standard_MIDI_File(const std::string& filename, std::vector<Record>& records)
+	{
+		struct Raw_Event
+		{
+			int64_t Tick;
+			Record Event;
+		};
+
+		struct Tempo_Change
+		{
+			int64_t Tick;
+			uint32_t Us_Per_Quarter;
+		};
+
+		std::vector<unsigned char> Data;
+
+		if (!Read_File(filename, Data) || Data.size() < 14 || Read_Big_Endian(Data, 0, 4) != 0x4D546864) {
+			return false;
+		}
+
+		uint32_t Header_Length = Read_Big_Endian(Data, 4, 4);
+		uint32_t Division = Read_Big_Endian(Data, 12, 2);
+
+		// SMPTE time division is not used by the exporter
+		if (Header_Length < 6 || (Division & 0x8000) != 0 || Division == 0) {
+			return false;
+		}
+
+		std::vector<Raw_Event> Events;
+		std::vector<Tempo_Change> Tempos;
+
+		size_t Position = 8 + Header_Length;
+		int Track_Index = 0;
+
+		while (Position + 8 <= Data.size())
+		{
+			uint32_t Chunk_Type = Read_Big_Endian(Data, Position, 4);
+			uint32_t Chunk_Length = Read_Big_Endian(Data, Position + 4, 4);
+
+			Position += 8;
+
+			size_t Chunk_End = Position + Chunk_Length;
+
+			if (Chunk_End > Data.size()) {
+				return false;
+			}
+
+			// Other chunk types are skipped
+			if (Chunk_Type != 0x4D54726B) {
+				Position = Chunk_End;
+				continue;
+			}
+
+			int64_t Tick = 0;
+			unsigned char Running_Status = 0;
+
+			while (Position < Chunk_End)
+			{
+				uint32_t Delta = 0;
+
+				if (!Read_SMF_Var_Len(Data, Position, Chunk_End, Delta) || Position >= Chunk_End) {
+					return false;
+				}
+
+				Tick += Delta;
+
+				unsigned char Status = Data[Position];
+
+				if (Status == 0xFF)
+				{
+					uint32_t Meta_Length = 0;
+
+					if (Position + 2 > Chunk_End) {
+						return false;
+					}
+
+					unsigned char Meta_Type = Data[Position + 1];
+					Position += 2;
+
+					if (!Read_SMF_Var_Len(Data, Position, Chunk_End, Meta_Length) || Position + Meta_Length > Chunk_End) {
+						return false;
+					}
+
+					if (Meta_Type == 0x51 && Meta_Length == 3) {
+						Tempo_Change Change = { Tick, Read_Big_Endian(Data, Position, 3) };
+						Tempos.push_back(Change);
+					}
+
+					Position += Meta_Length;
+					continue;
+				}
+
+				if (Status == 0xF0 || Status == 0xF7)
+				{
+					uint32_t SysEx_Length = 0;
+					Position++;
+
+					if (!Read_SMF_Var_Len(Data, Position, Chunk_End, SysEx_Length) || Position + SysEx_Length > Chunk_End) {
+						return false;
+					}
+
+					Position += SysEx_Length;
+					continue;
+				}
+
+				if (Status & 0x80) {
+					Running_Status = Status;
+					Position++;
+				}
+				else if (Running_Status == 0) {
+					return false;
+				}
+
+				unsigned char Command = Running_Status & 0xF0;
+				size_t Data_Length = (Command == 0xC0 || Command == 0xD0) ? 1 : 2;
+
+				if (Position + Data_Length > Chunk_End) {
+					return false;
+				}
+
+				Raw_Event Event;
+				Event.Tick = Tick;
+				Event.Event.Intended_us = 0;
+				Event.Event.Actual_us = 0;
+				Event.Event.Track = Track_Index;
+				Event.Event.Status = Running_Status;
+				Event.Event.Data1 = Data[Position];
+				Event.Event.Data2 = (Data_Length == 2) ? Data[Position + 1] : 0;
+
+				Events.push_back(Event);
+				Position += Data_Length;
+			}
+
+			Track_Index++;
+		}
+
+		// Tempo events of all tracks apply to the whole file
+		std::stable_sort(Tempos.begin(), Tempos.end(), [](const Tempo_Change& a, const Tempo_Change& b) { return a.Tick < b.Tick; });
+
+		std::vector<Playback_Tempo_Map::Segment> Segments;
+		Playback_Tempo_Map::Segment Current_Segment = { 0, 0.0, (double)SMF_DEFAULT_US_PER_QUARTER / Division };
+
+		for (size_t i = 0; i < Tempos.size(); i++)
+		{
+			double Start_us = Current_Segment.Start_us + (double)(Tempos[i].Tick - Current_Segment.Start_Tick) * Current_Segment.Us_Per_Tick;
+
+			if (Tempos[i].Tick > Current_Segment.Start_Tick) {
+				Segments.push_back(Current_Segment);
+			}
+
+			Current_Segment.Start_Tick = Tempos[i].Tick;
+			Current_Segment.Start_us = Start_us;
+			Current_Segment.Us_Per_Tick = (double)Tempos[i].Us_Per_Quarter / Division;
+		}
+
+		Segments.push_back(Current_Segment);
+
+		Playback_Tempo_Map Tempo_Map(Segments.data(), Segments.size());
+
+		// Tracks one after the other, the stable sort keeps their order at the same tick
+		std::stable_sort(Events.begin(), Events.end(), [](const Raw_Event& a, const Raw_Event& b) { return a.Tick < b.Tick; });
+
+		records.clear();
+		records.reserve(Events.size());
+
+		for (size_t i = 0; i < Events.size(); i++)
+		{
+			Record Current = Events[i].Event;
+			Current.Intended_us = Tempo_Map.Get_Time_us((double)Events[i].Tick);
+			Current.Actual_us = Current.Intended_us;
+
+			records.push_back(Current);
+		}
+
+		return true;
+	}
+
+	Playback_MIDI_Render_Log::Comparison Playback_MIDI_Render_Log::Compare(const std::vector<Record>& rendered, const std::vector<Record>& reference, int64_t time_offset_us, int64_t tolerance_us)
+	{
+		Comparison Result = Comparison();
+		Result.First_Mismatch_us = -1;
+
+		std::vector<Note_Key_Time> Rendered_Notes;
+		std::vector<Note_Key_Time> Reference_Notes;
+
+		Rendered_Notes.reserve(rendered.size());
+		Reference_Notes.reserve(reference.size());
+
+		for (size_t i = 0; i < rendered.size(); i++)
+		{
+			Note_Key_Time Note;
+
+			if (Get_Note_Key(rendered[i], Note.Key)) {
+				Note.Time_us = rendered[i].Actual_us + time_offset_us;
+				Rendered_Notes.push_back(Note);
+			}
+		}
+
+		for (size_t i = 0; i < reference.size(); i++)
+		{
+			Note_Key_Time Note;
+
+			if (Get_Note_Key(reference[i], Note.Key)) {
+				Note.Time_us = reference[i].Actual_us;
+				Reference_Notes.push_back(Note);
+			}
+		}
+
+		auto By_Key_And_Time = [](const Note_Key_Time& a, const Note_Key_Time& b) {
+			return (a.Key != b.Key) ? a.Key < b.Key : a.Time_us < b.Time_us;
+		};
+
+		std::sort(Rendered_Notes.begin(), Rendered_Notes.end(), By_Key_And_Time);
+		std::sort(Reference_Notes.begin(), Reference_Notes.end(), By_Key_And_Time);
+
+		size_t Rendered_Index = 0;
+		size_t Reference_Index = 0;
+		double Deviation_Sum_us = 0.0;
+
+		while (Rendered_Index < Rendered_Notes.size() || Reference_Index < Reference_Notes.size())
+		{
+			bool Has_Rendered = Rendered_Index < Rendered_Notes.size();
+			bool Has_Reference = Reference_Index < Reference_Notes.size();
+			bool Is_Extra = false;
+
+			if (Has_Rendered && Has_Reference && Rendered_Notes[Rendered_Index].Key == Reference_Notes[Reference_Index].Key)
+			{
+				int64_t Deviation_us = Rendered_Notes[Rendered_Index].Time_us - Reference_Notes[Reference_Index].Time_us;
+				int64_t Distance_us = (Deviation_us < 0) ? -Deviation_us : Deviation_us;
+
+				if (Distance_us <= tolerance_us)
+				{
+					Result.Matched_Count++;
+					Result.Deviation_Max_us = std::max(Result.Deviation_Max_us, Distance_us);
+					Deviation_Sum_us += (double)Distance_us;
+
+					Rendered_Index++;
+					Reference_Index++;
+					continue;
+				}
+
+				Is_Extra = Deviation_us < 0;
+			}
+			else
+			{
+				Is_Extra = Has_Rendered && (!Has_Reference || Rendered_Notes[Rendered_Index].Key < Reference_Notes[Reference_Index].Key);
+			}
+
+			int64_t Mismatch_us = Is_Extra ? Rendered_Notes[Rendered_Index++].Time_us : Reference_Notes[Reference_Index++].Time_us;
+
+			if (Is_Extra) {
+				Result.Extra_Count++;
+			}
+			else {
+				Result.Missing_Count++;
+			}
+
+			if (Result.First_Mismatch_us < 0 || Mismatch_us < Result.First_Mismatch_us) {
+				Result.First_Mismatch_us = Mismatch_us;
+			}
+		}
+
+		Result.Deviation_Average_us = (Result.Matched_Count > 0) ? Deviation_Sum_us / Result.Matched_Count : 0.0;
+
+		return Result;
+	}
+
+	std::string Playback_MIDI_Render_Log::Format_Comparison(const Comparison& comparison)
+	{
+		char Line[256];
+		std::string Text;
+
+		snprintf(Line, sizeof(Line), "Notes: %zu matched, %zu missing, %zu extra\n", comparison.Matched_Count, comparison.Missing_Count, comparison.Extra_Count);
+		Text += Line;
+		snprintf(Line, sizeof(Line), "Deviation (us): average %.1f, max %lld\n", comparison.Deviation_Average_us, (long long)comparison.Deviation_Max_us);
+		Text += Line;
+
+		if (comparison.First_Mismatch_us >= 0) {
+			snprintf(Line, sizeof(Line), "First mismatch at %.3f ms\n", comparison.First_Mismatch_us / 1000.0);
+			Text += Line;
+		}
+
+		return Text;
+	}
+}
+
+#ifdef _MSC_VER
+#pragma managed(pop)
+#endif
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace MIDILightDrawer
+{
+	// Every event sent by a playback run with the time it was meant for and the time it left the scheduler.
+	// Saved as a compact binary file, so renders of the same show can be compared between versions,
+	// or against a Standard MIDI File export of the same timeline
+	class Playback_MIDI_Render_Log
+	{
+	public:
+		struct Record
+		{
+			int64_t Intended_us;		// Timestamp of the event
+			int64_t Actual_us;			// Playback position when it was sent
+			int Track;					// -1 for events without a timeline track
+			unsigned char Status;		// Command including the channel
+			unsigned char Data1;
+			unsigned char Data2;
+		};
+
+		struct Comparison
+		{
+			size_t Matched_Count;
+			size_t Missing_Count;		// In the reference, not sent within the tolerance
+			size_t Extra_Count;			// Sent, not in the reference
+			int64_t Deviation_Max_us;	// Largest time difference of a matched pair
+			double Deviation_Average_us;
+			int64_t First_Mismatch_us;	// Reference time of the first missing or extra event, -1 if there is none
+		};
+
+		// File layout: "MLRL", version, record count, then per record the intended time as a difference to the previous
+		// record, the lateness, the track and the three message bytes. Numbers are zigzag encoded variable length integers
+		static const uint32_t FILE_VERSION = 1;
+
+	private:
+		std::vector<Record> _Records;
+
+	public:
+		Playback_MIDI_Render_Log();
+
+		void Append(const Record& record);
+		void Reserve(size_t count);
+		void Clear();
+		size_t Size() const;
+		const std::vector<Record>& Get_Records() const;
+
+		bool Save_To_File(const std::string& filename) const;
+		bool Load_From_File(const std::string& filename);
+
+		// Channel messages of all tracks, with the times of the tempo map of the file. Intended and actual time are the same
+		static bool Read_Standard_MIDI_File(const std::string& filename, std::vector<Record>& records);
+
+		// Pairs the note messages of both lists by channel, note and velocity in time order. The actual times of the
+		// log are shifted by time_offset_us first, e.g. by the lookahead the scheduler sends ahead of the timestamp.
+		// A Note On with velocity 0 counts as Note Off, other messages are not compared
+		static Comparison Compare(const std::vector<Record>& rendered, const std::vector<Record>& reference, int64_t time_offset_us, int64_t tolerance_us);
+		static std::string Format_Comparison(const Comparison& comparison);
+	};
+}
@@ -0,0 +1,244 @@
+#ifdef _MSC_VER
+#pragma managed(push, off)
+#endif
+
+#include "Playback_MIDI_Schedule.h"
+
+#include <algorithm>
+
+namespace MIDILightDrawer
+{
+	Playback_MIDI_Schedule::Playback_MIDI_Schedule(const MIDI_Event* events, size_t count, const int64_t* checkpoint_times_us, size_t checkpoint_count)
+	{
+		Initialize(events, count, checkpoint_times_us, checkpoint_count);
+	}
+
+	Playback_MIDI_Schedule::Playback_MIDI_Schedule(const MIDI_Event* events, size_t count, const int64_t* checkpoint_times_us, size_t checkpoint_count, const Playback_Tempo_Map& tempo_map) :
+		_Tempo_Map(tempo_map)
+	{
+		Initialize(events, count, checkpoint_times_us, checkpoint_count);
+	}
+
+	void Playback_MIDI_Schedule::Initialize(const MIDI_Event* events, size_t count, const int64_t* checkpoint_times_us, size_t checkpoint_count)
+	{
+		_Entries.resize(count);
+
+		for (size_t i = 0; i < count; i++)
+		{
+			_Entries[i].Execute_Time_Us = static_cast<int64_t>(events[i].Timestamp_ms * 1000.0);
+			_Entries[i].Note_On_Index = NO_NOTE_ON;
+			_Entries[i].Event = events[i];
+		}
+
+		// Stable, a Note Off and the following Note On at the same timestamp keep their order
+		std::stable_sort(_Entries.begin(), _Entries.end(), [](const Entry& a, const Entry& b) {
+			return a.Execute_Time_Us < b.Execute_Time_Us;
+		});
+
+		std::vector<int64_t> Checkpoint_Times_us;
+
+		if (checkpoint_times_us != nullptr) {
+			Checkpoint_Times_us.assign(checkpoint_times_us, checkpoint_times_us + checkpoint_count);
+		}
+
+		std::sort(Checkpoint_Times_us.begin(), Checkpoint_Times_us.end());
+		Checkpoint_Times_us.erase(std::unique(Checkpoint_Times_us.begin(), Checkpoint_Times_us.end()), Checkpoint_Times_us.end());
+
+		Pair_Note_Events(Checkpoint_Times_us);
+	}
+
+	const Playback_Tempo_Map& Playback_MIDI_Schedule::Get_Tempo_Map() const
+	{
+		return _Tempo_Map;
+	}
+
+	size_t Playback_MIDI_Schedule::Size() const
+	{
+		return _Entries.size();
+	}
+
+	const Playback_MIDI_Schedule::Entry& Playback_MIDI_Schedule::Get_Entry(size_t index) const
+	{
+		return _Entries[index];
+	}
+
+	size_t Playback_MIDI_Schedule::Find_First_Index_us(int64_t time_us) const
+	{
+		std::vector<Entry>::const_iterator It = std::lower_bound(_Entries.begin(), _Entries.end(), time_us, [](const Entry& entry, int64_t time) {
+			return entry.Execute_Time_Us < time;
+		});
+
+		return static_cast<size_t>(It - _Entries.begin());
+	}
+
+	void Playback_MIDI_Schedule::Get_Sounding_Notes(int64_t time_us, std::vector<size_t>& note_on_indices) const
+	{
+		note_on_indices.clear();
+
+		size_t Target_Index = Find_First_Index_us(time_us);
+		size_t Replay_Index = 0;
+
+		// Last checkpoint at or before the time
+		std::vector<Checkpoint>::const_iterator It = std::upper_bound(_Checkpoints.begin(), _Checkpoints.end(), time_us, [](int64_t time, const Checkpoint& checkpoint) {
+			return time < checkpoint.Time_us;
+		});
+
+		if (It != _Checkpoints.begin())
+		{
+			--It;
+
+			note_on_indices.assign(_Checkpoint_Notes.begin() + It->First_Note, _Checkpoint_Notes.begin() + It->First_Note + It->Note_Count);
+			Replay_Index = It->Entry_Index;
+		}
+
+		for (size_t i = Replay_Index; i < Target_Index; i++)
+		{
+			const Entry& Current = _Entries[i];
+
+			if (Is_Note_On(Current.Event) && Current.Event.Track >= 0)
+			{
+				// A retriggered note replaces the earlier Note On of the same key, like in the pairing
+				uint32_t Note_Key = Pack_Note_Key(Current.Event.Track, Current.Event.Channel, Current.Event.Data1);
+
+				for (size_t j = 0; j < note_on_indices.size(); j++)
+				{
+					const MIDI_Event& Sounding = _Entries[note_on_indices[j]].Event;
+
+					if (Pack_Note_Key(Sounding.Track, Sounding.Channel, Sounding.Data1) == Note_Key) {
+						Remove_Note(note_on_indices, note_on_indices[j]);
+						break;
+					}
+				}
+
+				note_on_indices.push_back(i);
+			}
+			else if (Is_Note_Off(Current.Event) && Current.Note_On_Index != NO_NOTE_ON)
+			{
+				Remove_Note(note_on_indices, (size_t)Current.Note_On_Index);
+			}
+		}
+	}
+
+	size_t Playback_MIDI_Schedule::Get_Checkpoint_Count() const
+	{
+		return _Checkpoints.size();
+	}
+
+	uint32_t Playback_MIDI_Schedule::Pack_Note_Key(int track, int channel, int note)
+	{
+		return ((uint32_t)track << (NOTE_BITS + CHANNEL_BITS)) | (((uint32_t)channel & 0x0F) << NOTE_BITS) | ((uint32_t)note & 0x7F);
+	}
+
+	bool Playback_MIDI_Schedule::Is_Note_On(const MIDI_Event& event)
+	{
+		return (event.Command & 0xF0) == 0x90 && event.Data2 > 0;
+	}
+
+	bool Playback_MIDI_Schedule::Is_Note_Off(const MIDI_Event& event)
+	{
+		unsigned char Command_Type = event.Command & 0xF0;
+
+		return Command_Type == 0x80 || (Command_Type == 0x90 && event.Data2 == 0);
+	}
+
+	void Playback_MIDI_Schedule::Pair_Note_Events(std::vector<int64_t>& checkpoint_times_us)
+	{
+		int Max_Track = -1;
+
+		for (size_t i = 0; i < _Entries.size(); i++) {
+			Max_Track = (_Entries[i].Event.Track > Max_Track) ? _Entries[i].Event.Track : Max_Track;
+		}
+
+		size_t Key_Count = (size_t)(Max_Track + 1) * NOTE_KEYS_PER_TRACK;
+
+		// Last Note On without a Note Off yet, indexed by the packed note key. Allocated once, the pass itself does not allocate.
+		// The open keys are kept in a compact list as well, so a checkpoint does not have to scan all keys
+		std::vector<int64_t> Open_Notes(Key_Count, (int64_t)NO_NOTE_ON);
+		std::vector<uint32_t> Open_Keys;
+		std::vector<uint32_t> Open_Key_Position(Key_Count, 0);
+
+		_Checkpoints.reserve(checkpoint_times_us.size());
+
+		size_t Next_Checkpoint = 0;
+
+		for (size_t i = 0; i < _Entries.size(); i++)
+		{
+			const Entry& Current = _Entries[i];
+
+			while (Next_Checkpoint < checkpoint_times_us.size() && checkpoint_times_us[Next_Checkpoint] <= Current.Execute_Time_Us) {
+				Add_Checkpoint(checkpoint_times_us[Next_Checkpoint++], i, Open_Notes, Open_Keys);
+			}
+
+			if (Current.Event.Track < 0) {
+				continue;
+			}
+
+			uint32_t Note_Key = Pack_Note_Key(Current.Event.Track, Current.Event.Channel, Current.Event.Data1);
+
+			if (Is_Note_On(Current.Event))
+			{
+				if (Open_Notes[Note_Key] == NO_NOTE_ON)
+				{
+					Open_Key_Position[Note_Key] = (uint32_t)Open_Keys.size();
+					Open_Keys.push_back(Note_Key);
+				}
+
+				Open_Notes[Note_Key] = (int64_t)i;
+			}
+			else if (Is_Note_Off(Current.Event))
+			{
+				_Entries[i].Note_On_Index = Open_Notes[Note_Key];
+
+				if (Open_Notes[Note_Key] != NO_NOTE_ON)
+				{
+					// Swap-remove from the open key list
+					uint32_t Position = Open_Key_Position[Note_Key];
+					uint32_t Last_Key = Open_Keys.back();
+
+					Open_Keys[Position] = Last_Key;
+					Open_Key_Position[Last_Key] = Position;
+					Open_Keys.pop_back();
+
+					Open_Notes[Note_Key] = NO_NOTE_ON;
+				}
+			}
+		}
+
+		// Checkpoints behind the last event
+		while (Next_Checkpoint < checkpoint_times_us.size()) {
+			Add_Checkpoint(checkpoint_times_us[Next_Checkpoint++], _Entries.size(), Open_Notes, Open_Keys);
+		}
+	}
+
+	void Playback_MIDI_Schedule::Add_Checkpoint(int64_t time_us, size_t entry_index, const std::vector<int64_t>& open_notes, const std::vector<uint32_t>& open_keys)
+	{
+		Checkpoint New_Checkpoint;
+		New_Checkpoint.Time_us = time_us;
+		New_Checkpoint.Entry_Index = entry_index;
+		New_Checkpoint.First_Note = _Checkpoint_Notes.size();
+		New_Checkpoint.Note_Count = open_keys.size();
+
+		for (size_t i = 0; i < open_keys.size(); i++) {
+			_Checkpoint_Notes.push_back((size_t)open_notes[open_keys[i]]);
+		}
+
+		_Checkpoints.push_back(New_Checkpoint);
+	}
+
+	void Playback_MIDI_Schedule::Remove_Note(std::vector<size_t>& note_on_indices, size_t note_on_index)
+	{
+		for (size_t i = 0; i < note_on_indices.size(); i++)
+		{
+			if (note_on_indices[i] == note_on_index)
+			{
+				note_on_indices[i] = note_on_indices.back();
+				note_on_indices.pop_back();
+				return;
+			}
+		}
+	}
+}
+
+#ifdef _MSC_VER
+#pragma managed(pop)
+#endif
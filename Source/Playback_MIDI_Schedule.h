@@ -0,0 +1,86 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+#include "Playback_Tempo_Map.h"
+
+namespace MIDILightDrawer
+{
+	// Immutable, time sorted list of all events of a playback. Built once on the UI thread, then only read
+	// by the playback thread through its cursor, so a seek is a binary search instead of a re-queue.
+	// Checkpoints hold the notes sounding at their time, so the light state at any position is restored
+	// from the nearest checkpoint plus a short replay.
+	// Every event keeps its tick, a schedule built with a tempo map keeps the map its times were taken from
+	class Playback_MIDI_Schedule
+	{
+	public:
+		struct MIDI_Event
+		{
+			double Timestamp_ms;		// Timestamp in milliseconds
+			int Tick;					// Timeline position, the timestamp follows from it through the tempo map
+			int Track;					// Track number
+			int Channel;				// MIDI channel (0-15)
+			unsigned char Command;		// MIDI command byte
+			unsigned char Data1;		// First data byte
+			unsigned char Data2;		// Second data byte
+		};
+
+		struct Entry
+		{
+			int64_t Execute_Time_Us;
+			int64_t Note_On_Index;		// Note Off only: index of the matching Note On, NO_NOTE_ON otherwise
+			MIDI_Event Event;
+		};
+
+		static const int64_t NO_NOTE_ON = -1;
+
+		// Packed note key: 7 bits note, 4 bits channel, track above. One track covers NOTE_KEYS_PER_TRACK consecutive keys
+		static const int NOTE_BITS = 7;
+		static const int CHANNEL_BITS = 4;
+		static const uint32_t NOTE_KEYS_PER_TRACK = 1u << (NOTE_BITS + CHANNEL_BITS);
+
+	private:
+		struct Checkpoint
+		{
+			int64_t Time_us;
+			size_t Entry_Index;			// First entry due at or after Time_us
+			size_t First_Note;			// Range in _Checkpoint_Notes
+			size_t Note_Count;
+		};
+
+		std::vector<Entry> _Entries;
+		std::vector<Checkpoint> _Checkpoints;
+		std::vector<size_t> _Checkpoint_Notes;	// Entry indices of the Note Ons sounding at a checkpoint
+		Playback_Tempo_Map _Tempo_Map;			// Empty if the events were not built from a tempo map
+
+	public:
+		// Checkpoint times are typically the measure starts, they do not have to be sorted
+		Playback_MIDI_Schedule(const MIDI_Event* events, size_t count, const int64_t* checkpoint_times_us, size_t checkpoint_count);
+		Playback_MIDI_Schedule(const MIDI_Event* events, size_t count, const int64_t* checkpoint_times_us, size_t checkpoint_count, const Playback_Tempo_Map& tempo_map);
+
+		const Playback_Tempo_Map& Get_Tempo_Map() const;
+
+		size_t Size() const;
+		const Entry& Get_Entry(size_t index) const;
+
+		// Index of the first entry due at or after the given time, Size() if there is none
+		size_t Find_First_Index_us(int64_t time_us) const;
+
+		// Entry indices of the Note Ons still sounding when the entry at Find_First_Index_us(time_us) is due.
+		// Replays from the nearest checkpoint before the time, the vector is cleared first
+		void Get_Sounding_Notes(int64_t time_us, std::vector<size_t>& note_on_indices) const;
+		size_t Get_Checkpoint_Count() const;
+
+		static uint32_t Pack_Note_Key(int track, int channel, int note);
+		static bool Is_Note_On(const MIDI_Event& event);
+		static bool Is_Note_Off(const MIDI_Event& event);
+
+	private:
+		void Initialize(const MIDI_Event* events, size_t count, const int64_t* checkpoint_times_us, size_t checkpoint_count);
+		void Pair_Note_Events(std::vector<int64_t>& checkpoint_times_us);
+		void Add_Checkpoint(int64_t time_us, size_t entry_index, const std::vector<int64_t>& open_notes, const std::vector<uint32_t>& open_keys);
+		static void Remove_Note(std::vector<size_t>& note_on_indices, size_t note_on_index);
+	};
+}
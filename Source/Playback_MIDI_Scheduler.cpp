@@ -0,0 +1,1197 @@
+#ifdef _MSC_VER
+#pragma managed(push, off)
+#endif
+
+#include "Playback_MIDI_Scheduler.h"
+
+#include <algorithm>
+
+namespace MIDILightDrawer
+{
+	Playback_MIDI_Scheduler::Playback_MIDI_Scheduler(IMidiOutput* output, IClock* clock) :
+		_Event_Queue(EVENT_QUEUE_CAPACITY),
+		_Sent_Event_Queue(SENT_EVENT_QUEUE_CAPACITY),
+		_Journal(JOURNAL_CAPACITY),
+		_Retired_Schedules(RETIRED_SCHEDULE_CAPACITY)
+	{
+		_Output = output;
+		_Clock = clock;
+		_Router = nullptr;
+		_Output_Mode.store(Output_Mode::Note_Messages);
+		_Batch_Frames = false;
+		_Batch_Window_us.store(BATCH_WINDOW_US);
+		_Timestamp_Lead_us = 0;
+		_Batch_Deliver_us = DELIVER_NOW;
+		_Last_Deliver_us = INT64_MIN;
+		_Thread = nullptr;
+
+		_Is_Playing.store(false);
+		_Should_Stop.store(false);
+		_Reset_Timing.store(false);
+		_Current_Position_us.store(0);
+		_Waiting_For_Events.store(false);
+		_Playback_Speed.store(1.0);
+		_Clock_Anchored = false;
+		_Anchor_Position_us = 0;
+		_Anchor_Time_us = 0;
+		_Anchor_Speed = 1.0;
+		_Audio_Is_Available.store(false);
+		_Audio_Position_us.store(0);
+		_Audio_Clock = nullptr;
+		_Sent_Events_Dropped.store(0);
+		_Journal_Enabled.store(false);
+		_Journal_Dropped.store(0);
+
+		_Schedule = nullptr;
+		_Schedule_Cursor = 0;
+		_Schedule_Resume_us = 0;
+		_Restore_Notes.reserve(1024);
+		_Previous_Notes.reserve(1024);
+		_Old_Sounding.reserve(1024);
+		_New_Sounding.reserve(1024);
+		_Next_Schedule.store(nullptr);
+		_Unload_Pending.store(false);
+		_Seek_Pending.store(false);
+		_Seek_Position_us.store(0);
+
+		for (int i = 0; i < TRACK_MASK_WORDS; i++) {
+			_Track_Enabled_Mask[i].store(~0ull);
+			_Applied_Track_Mask[i] = ~0ull;
+		}
+
+		_Track_Mask_Changed.store(false);
+
+		_Render_Log = nullptr;
+		_Render_End_us = INT64_MAX;
+	}
+
+	Playback_MIDI_Scheduler::~Playback_MIDI_Scheduler()
+	{
+		Stop();
+
+		delete _Schedule;
+		_Schedule = nullptr;
+	}
+
+	bool Playback_MIDI_Scheduler::Start()
+	{
+		if (_Output == nullptr || !_Output->Is_Open() || _Clock == nullptr) {
+			return false;
+		}
+
+		if (_Thread != nullptr) {
+			// Thread already running
+			return false;
+		}
+
+		_Should_Stop.store(false, std::memory_order_release);
+		_Is_Playing.store(true, std::memory_order_release);
+
+		_Reset_Timing.store(true, std::memory_order_release);
+		_Metrics.Reset();
+
+		// Position the schedule cursor on the start position
+		_Seek_Position_us.store(_Current_Position_us.load(std::memory_order_acquire), std::memory_order_release);
+		_Seek_Pending.store(true, std::memory_order_release);
+
+		Take_Over_Timestamp_Lead();
+
+		_Thread = new std::thread(&Playback_MIDI_Scheduler::Thread_Function, this);
+
+		return true;
+	}
+
+	bool Playback_MIDI_Scheduler::Stop()
+	{
+		if (_Thread == nullptr) {
+			return true;  // Already stopped
+		}
+
+		// Signal thread to stop
+		_Should_Stop.store(true, std::memory_order_release);
+		_Is_Playing.store(false, std::memory_order_release);
+		_Clock->Wake();
+
+		// Wait for thread to finish
+		if (_Thread->joinable()) {
+			_Thread->join();
+		}
+
+		delete _Thread;
+		_Thread = nullptr;
+
+		// Messages still held back by the link model or the timestamped output are outdated by the next start
+		_Shaper.Clear();
+		Cancel_Timestamped_Messages();
+
+		// The schedule belongs to the caller again, take over one the thread has not picked up
+		Free_Retired_Schedules();
+
+		Playback_MIDI_Schedule* Next_Schedule = _Next_Schedule.exchange(nullptr, std::memory_order_acq_rel);
+
+		bool Unload_Pending = _Unload_Pending.exchange(false, std::memory_order_acq_rel);
+
+		if (Next_Schedule != nullptr)
+		{
+			delete _Schedule;
+			_Schedule = Next_Schedule;
+		}
+		else if (Unload_Pending)
+		{
+			delete _Schedule;
+			_Schedule = nullptr;
+		}
+
+		// Clear any remaining events
+		Clear_Queue();
+
+		return true;
+	}
+
+	bool Playback_MIDI_Scheduler::Is_Running() const
+	{
+		return _Thread != nullptr;
+	}
+
+	bool Playback_MIDI_Scheduler::Is_Playing() const
+	{
+		return _Is_Playing.load(std::memory_order_acquire);
+	}
+
+	bool Playback_MIDI_Scheduler::Send_Event(const MIDI_Event& event)
+	{
+		if (_Router != nullptr) {
+			return _Router->Send_Immediate(event);
+		}
+
+		if (_Output == nullptr) {
+			return false;
+		}
+
+		return _Output->Send_Short_Message(event.Command | event.Channel, event.Data1, event.Data2);
+	}
+
+	void Playback_MIDI_Scheduler::Set_Schedule(Playback_MIDI_Schedule* schedule)
+	{
+		Free_Retired_Schedules();
+
+		if (_Thread == nullptr)
+		{
+			delete _Schedule;
+			_Schedule = schedule;
+			_Schedule_Cursor = 0;
+
+			// The cursor is positioned by the seek on the next start
+			return;
+		}
+
+		// A schedule published earlier but not picked up yet was never seen by the thread
+		Playback_MIDI_Schedule* Replaced_Schedule = _Next_Schedule.exchange(schedule, std::memory_order_acq_rel);
+		delete Replaced_Schedule;
+
+		// Stored after the exchange: the thread reads the flag first, so it never unloads while a newer schedule is pending
+		_Unload_Pending.store(schedule == nullptr, std::memory_order_release);
+
+		_Clock->Wake();
+	}
+
+	void Playback_MIDI_Scheduler::Set_Playback_Speed(double speed)
+	{
+		if (!(speed > 0.0)) {
+			return;
+		}
+
+		_Playback_Speed.store(speed, std::memory_order_relaxed);
+
+		// The planned wake time is based on the old speed
+		if (_Thread != nullptr) {
+			_Clock->Wake();
+		}
+	}
+
+	double Playback_MIDI_Scheduler::Get_Playback_Speed() const
+	{
+		return _Playback_Speed.load(std::memory_order_relaxed);
+	}
+
+	bool Playback_MIDI_Scheduler::Queue_Event(const MIDI_Event& event)
+	{
+		Scheduled_MIDI_Event Scheduled;
+		Scheduled.Execute_Time_Us = static_cast<int64_t>(event.Timestamp_ms * 1000.0);
+		Scheduled.Event = event;
+
+		// Never waits for the playback thread. The caller keeps the event and retries when the ring is full
+		if (!_Event_Queue.Try_Push(Scheduled)) {
+			return false;
+		}
+
+		// Only a thread sleeping on an empty queue needs a wake-up, later events never move the next wake time forward.
+		// The fence pairs with the one in the thread, either it sees the new event or we see its waiting flag
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+
+		if (_Waiting_For_Events.load(std::memory_order_relaxed)) {
+			_Clock->Wake();
+		}
+
+		return true;
+	}
+
+	void Playback_MIDI_Scheduler::Clear_Queue()
+	{
+		if (_Thread == nullptr) {
+			_Event_Queue.Reset();
+		}
+		else {
+			// The playback thread is the only consumer, it skips the discarded events on its next read
+			_Event_Queue.Discard_All();
+			_Clock->Wake();
+		}
+	}
+
+	bool Playback_MIDI_Scheduler::Pop_Sent_Event(MIDI_Event& event)
+	{
+		return _Sent_Event_Queue.Try_Pop(event);
+	}
+
+	uint64_t Playback_MIDI_Scheduler::Get_Sent_Events_Dropped() const
+	{
+		return _Sent_Events_Dropped.load(std::memory_order_relaxed);
+	}
+
+	void Playback_MIDI_Scheduler::Set_Journal_Enabled(bool enabled)
+	{
+		_Journal_Enabled.store(enabled, std::memory_order_relaxed);
+	}
+
+	bool Playback_MIDI_Scheduler::Pop_Journal_Event(MIDI_Event& event)
+	{
+		return _Journal.Try_Pop(event);
+	}
+
+	uint64_t Playback_MIDI_Scheduler::Get_Journal_Dropped() const
+	{
+		return _Journal_Dropped.load(std::memory_order_relaxed);
+	}
+
+	int64_t Playback_MIDI_Scheduler::Get_Position_us() const
+	{
+		return _Current_Position_us.load(std::memory_order_acquire);
+	}
+
+	void Playback_MIDI_Scheduler::Set_Position_us(int64_t position_us)
+	{
+		_Current_Position_us.store(position_us, std::memory_order_release);
+
+		if (_Audio_Is_Available.load()) {
+			_Audio_Position_us.store(position_us, std::memory_order_release);
+		}
+
+		// The thread moves the schedule cursor by binary search, nothing has to be queued again
+		_Seek_Position_us.store(position_us, std::memory_order_release);
+		_Seek_Pending.store(true, std::memory_order_release);
+
+		// Seek: the planned wake time is based on the old position
+		if (_Thread != nullptr) {
+			_Clock->Wake();
+		}
+	}
+
+	void Playback_MIDI_Scheduler::Set_Audio_Available(bool available)
+	{
+		_Audio_Is_Available.store(available, std::memory_order_release);
+
+		if (!available) {
+			// Clear audio position when audio stops
+			_Audio_Position_us.store(0, std::memory_order_release);
+		}
+	}
+
+	void Playback_MIDI_Scheduler::Set_Audio_Position_us(int64_t position_us)
+	{
+		_Audio_Position_us.store(position_us, std::memory_order_release);
+
+		// The thread cannot predict the audio clock, let it re-check the queue against the new position
+		if (_Thread != nullptr) {
+			_Clock->Wake();
+		}
+	}
+
+	void Playback_MIDI_Scheduler::Set_Audio_Clock(const Playback_Audio_Clock* audio_clock)
+	{
+		_Audio_Clock = audio_clock;
+	}
+
+	void Playback_MIDI_Scheduler::Set_Port_Router(Playback_MIDI_Port_Router* router)
+	{
+		_Router = router;
+	}
+
+	Playback_MIDI_Port_Router* Playback_MIDI_Scheduler::Get_Port_Router() const
+	{
+		return _Router;
+	}
+
+	void Playback_MIDI_Scheduler::Set_Output_Mode(Output_Mode mode)
+	{
+		_Output_Mode.store(mode, std::memory_order_release);
+	}
+
+	Playback_MIDI_Scheduler::Output_Mode Playback_MIDI_Scheduler::Get_Output_Mode() const
+	{
+		return _Output_Mode.load(std::memory_order_acquire);
+	}
+
+	void Playback_MIDI_Scheduler::Set_Batch_Window_us(int64_t window_us)
+	{
+		if (window_us < 0) {
+			window_us = 0;
+		}
+
+		_Batch_Window_us.store((window_us < LOOKAHEAD_US) ? window_us : (int64_t)LOOKAHEAD_US, std::memory_order_relaxed);
+	}
+
+	int64_t Playback_MIDI_Scheduler::Get_Batch_Window_us() const
+	{
+		return _Batch_Window_us.load(std::memory_order_relaxed);
+	}
+
+	void Playback_MIDI_Scheduler::Set_Link_Bytes_Per_Second(int bytes_per_second)
+	{
+		_Shaper.Set_Bytes_Per_Second(bytes_per_second);
+	}
+
+	Playback_MIDI_Link_Shaper::Statistics Playback_MIDI_Scheduler::Get_Link_Statistics() const
+	{
+		return _Shaper.Get_Statistics();
+	}
+
+	Playback_MIDI_Engine_Metrics::Snapshot Playback_MIDI_Scheduler::Get_Metrics() const
+	{
+		Playback_MIDI_Engine_Metrics::Snapshot Result = _Metrics.Get_Snapshot();
+		Result.Time_us = (_Clock != nullptr) ? _Clock->Now_us() : 0;
+		Result.Position_us = _Current_Position_us.load(std::memory_order_acquire);
+
+		return Result;
+	}
+
+	void Playback_MIDI_Scheduler::Set_Track_Enabled(int track, bool enabled)
+	{
+		if (track < 0 || track >= MAX_TRACKS) {
+			return;
+		}
+
+		uint64_t Bit = 1ull << (track % 64);
+		std::atomic<uint64_t>& Word = _Track_Enabled_Mask[track / 64];
+
+		uint64_t Previous = enabled ? Word.fetch_or(Bit, std::memory_order_acq_rel) : Word.fetch_and(~Bit, std::memory_order_acq_rel);
+
+		if (((Previous & Bit) != 0) == enabled) {
+			return;
+		}
+
+		// The bit is set before the flag, the thread never takes over the flag without the bit
+		_Track_Mask_Changed.store(true, std::memory_order_release);
+
+		if (_Thread != nullptr) {
+			_Clock->Wake();
+		}
+	}
+
+	bool Playback_MIDI_Scheduler::Is_Track_Enabled(int track) const
+	{
+		if (track < 0 || track >= MAX_TRACKS) {
+			return true;
+		}
+
+		return (_Track_Enabled_Mask[track / 64].load(std::memory_order_acquire) & (1ull << (track % 64))) != 0;
+	}
+
+	void Playback_MIDI_Scheduler::Set_Track_Mute_Solo(int track_count, const int* muted_tracks, size_t muted_count, const int* soloed_tracks, size_t soloed_count)
+	{
+		for (int Track = 0; Track < track_count && Track < MAX_TRACKS; Track++) {
+			Set_Track_Enabled(Track, Should_Track_Play(Track, muted_tracks, muted_count, soloed_tracks, soloed_count));
+		}
+	}
+
+	bool Playback_MIDI_Scheduler::Should_Track_Play(int track, const int* muted_tracks, size_t muted_count, const int* soloed_tracks, size_t soloed_count)
+	{
+		if (muted_tracks != nullptr && std::find(muted_tracks, muted_tracks + muted_count, track) != muted_tracks + muted_count) {
+			return false;
+		}
+
+		if (soloed_tracks == nullptr || soloed_count == 0) {
+			return true;
+		}
+
+		return std::find(soloed_tracks, soloed_tracks + soloed_count, track) != soloed_tracks + soloed_count;
+	}
+
+	void Playback_MIDI_Scheduler::Set_Render_Log(Playback_MIDI_Render_Log* render_log)
+	{
+		_Render_Log = render_log;
+	}
+
+	bool Playback_MIDI_Scheduler::Render_Offline(int64_t start_position_us, int64_t end_position_us)
+	{
+		if (_Thread != nullptr || _Output == nullptr || !_Output->Is_Open() || _Clock == nullptr || _Audio_Is_Available.load(std::memory_order_acquire)) {
+			return false;
+		}
+
+		_Should_Stop.store(false, std::memory_order_release);
+		_Is_Playing.store(true, std::memory_order_release);
+		_Reset_Timing.store(true, std::memory_order_release);
+
+		_Current_Position_us.store(start_position_us, std::memory_order_release);
+		_Seek_Position_us.store(start_position_us, std::memory_order_release);
+		_Seek_Pending.store(true, std::memory_order_release);
+		_Metrics.Reset();
+
+		Take_Over_Timestamp_Lead();
+
+		// Same loop as the playback thread, it returns once the position reaches the end
+		_Render_End_us = end_position_us;
+		Thread_Function();
+		_Render_End_us = INT64_MAX;
+
+		_Is_Playing.store(false, std::memory_order_release);
+		_Shaper.Clear();
+		Cancel_Timestamped_Messages();
+		Clear_Queue();
+
+		return true;
+	}
+
+	IMidiOutput* Playback_MIDI_Scheduler::Get_Output() const
+	{
+		return _Output;
+	}
+
+	IClock* Playback_MIDI_Scheduler::Get_Clock() const
+	{
+		return _Clock;
+	}
+
+	void Playback_MIDI_Scheduler::Spin_Until_us(int64_t target_us)
+	{
+		while (_Clock->Now_us() < target_us) {
+			// Busy-wait, only used for the last few hundred microseconds before an event
+		}
+	}
+
+	void Playback_MIDI_Scheduler::Anchor_Clock(int64_t position_us, int64_t now_us, double speed)
+	{
+		_Anchor_Position_us = position_us;
+		_Anchor_Time_us = now_us;
+		_Anchor_Speed = speed;
+		_Clock_Anchored = true;
+	}
+
+	int64_t Playback_MIDI_Scheduler::Get_Anchored_Position_us(int64_t now_us) const
+	{
+		return _Anchor_Position_us + (int64_t)((double)(now_us - _Anchor_Time_us) * _Anchor_Speed);
+	}
+
+	void Playback_MIDI_Scheduler::Thread_Function()
+	{
+		// MIDI thread does not maintains its own clock
+		// It now purely reads from audio position and processes events reactively (If Audio is available)
+		int64_t Last_Update_Time_us = 0;
+
+		// Last observation fed into the audio sync filter
+		int64_t Last_Anchor_Host_Time_us = INT64_MIN;
+		int64_t Last_Fed_Audio_Position_us = INT64_MIN;
+
+		// Events at the start position fall due before playback starts, their lateness counts from there
+		int64_t Earliest_Due_us = INT64_MIN;
+
+		// The first seek positions the cursor for the start, nothing of this run has to be switched off yet
+		bool Has_Sent_Schedule = false;
+
+		_Audio_Sync.Reset();
+
+		while (!_Should_Stop.load(std::memory_order_acquire))
+		{
+			if (!_Is_Playing.load(std::memory_order_acquire))
+			{
+				_Clock->Wait_For_us(MAX_WAIT_US);
+				continue;
+			}
+
+			Adopt_Next_Schedule();
+
+			if (_Seek_Pending.exchange(false, std::memory_order_acq_rel))
+			{
+				int64_t Seek_Position_us = _Seek_Position_us.load(std::memory_order_acquire);
+
+				// Handed over for the old position, the restored notes must not queue up behind them
+				Cancel_Timestamped_Messages();
+
+				Seek_Schedule(Seek_Position_us, Has_Sent_Schedule);
+				Has_Sent_Schedule = true;
+				Earliest_Due_us = Seek_Position_us;
+
+				// Restart the MIDI-only clock from the new position. Stored here as well, so an older value written
+				// by this thread cannot overwrite the one of the seek
+				_Current_Position_us.store(Seek_Position_us, std::memory_order_release);
+				_Reset_Timing.store(true, std::memory_order_release);
+
+				// Held back messages belong to the old position
+				_Shaper.Clear();
+
+				// The audio timeline jumps as well, lock onto it again instead of holding the old position
+				_Audio_Sync.Reset();
+				Last_Anchor_Host_Time_us = INT64_MIN;
+				Last_Fed_Audio_Position_us = INT64_MIN;
+			}
+
+			if (_Track_Mask_Changed.exchange(false, std::memory_order_acq_rel)) {
+				Apply_Track_Mask_Change();
+			}
+
+			// Read current position from audio (or fallback)
+			int64_t Current_Pos_us = 0;
+			double Position_Rate = 1.0;		// Position microseconds per clock microsecond
+
+			bool Audio_Available = _Audio_Is_Available.load(std::memory_order_acquire);
+			bool Audio_Clock_Valid = false;
+
+			if (Audio_Available)
+			{
+				int64_t Now_us = _Clock->Now_us();
+
+				// Audio is master. Its position comes in steps: render clock anchors once per buffer, or the position fed by the UI.
+				// Each new observation goes through the sync filter, which gives a smooth and monotonic timeline in between
+				Playback_Audio_Clock::Anchor Anchor;
+
+				if (_Audio_Clock != nullptr && _Audio_Clock->Get_Anchor(Anchor))
+				{
+					if (Anchor.Host_Time_us != Last_Anchor_Host_Time_us)
+					{
+						// The two sources differ by a constant bias. Treated as a step, it would swing the rate estimate
+						if (Last_Fed_Audio_Position_us != INT64_MIN) {
+							_Audio_Sync.Reset();
+							Last_Fed_Audio_Position_us = INT64_MIN;
+						}
+
+						_Audio_Sync.Update(Anchor.Audio_Position_us, Anchor.Host_Time_us);
+						Last_Anchor_Host_Time_us = Anchor.Host_Time_us;
+					}
+				}
+				else
+				{
+					int64_t Fed_Position_us = _Audio_Position_us.load(std::memory_order_acquire);
+
+					// The fed position has no timestamp, the time it is first seen is the best estimate
+					if (Fed_Position_us != Last_Fed_Audio_Position_us)
+					{
+						if (Last_Anchor_Host_Time_us != INT64_MIN) {
+							_Audio_Sync.Reset();
+							Last_Anchor_Host_Time_us = INT64_MIN;
+						}
+
+						_Audio_Sync.Update(Fed_Position_us, Now_us);
+						Last_Fed_Audio_Position_us = Fed_Position_us;
+					}
+				}
+
+				Audio_Clock_Valid = _Audio_Sync.Get_Position_us(Now_us, Current_Pos_us);
+
+				if (!Audio_Clock_Valid) {
+					Current_Pos_us = _Audio_Position_us.load(std::memory_order_acquire);
+				}
+
+				Last_Update_Time_us = Now_us;
+				_Clock_Anchored = false;
+			}
+			else
+			{
+				// MIDI-only playback: we advance the position ourselves, at the playback speed.
+				// Taken from the anchor each time instead of adding up the steps, so their rounding does not add up
+				int64_t Now_us = _Clock->Now_us();
+				double Speed = _Playback_Speed.load(std::memory_order_relaxed);
+
+				if (_Reset_Timing.exchange(false, std::memory_order_acq_rel) || !_Clock_Anchored) {
+					Anchor_Clock(_Current_Position_us.load(std::memory_order_acquire), Now_us, Speed);
+				}
+				else if (Speed != _Anchor_Speed) {
+					Anchor_Clock(Get_Anchored_Position_us(Now_us), Now_us, Speed);
+				}
+
+				Current_Pos_us = Get_Anchored_Position_us(Now_us);
+				Position_Rate = Speed;
+
+				Last_Update_Time_us = Now_us;
+			}
+
+			// Update shared position for UI
+			_Current_Position_us.store(Current_Pos_us, std::memory_order_release);
+
+			if (Current_Pos_us >= _Render_End_us) {
+				break;
+			}
+
+			_Metrics.Set_Queue_Depth(_Event_Queue.Size());
+
+			// Messages held back by the link model go out before anything newer
+			if (_Shaper.Has_Pending()) {
+				_Shaper.Drain(_Clock->Now_us(), _Output);
+			}
+
+			// Process MIDI events based on audio's time
+			Scheduled_MIDI_Event Next_Event;
+			bool From_Schedule = false;
+
+			// A timestamped output gets the events its lead earlier, in position time
+			int64_t Send_Ahead_us = LOOKAHEAD_US + (int64_t)((double)_Timestamp_Lead_us * Position_Rate);
+
+			// Send events that are due (with lookahead). Both sources are sorted, so only their fronts need to be checked
+			if (Peek_Next_Event(Next_Event, From_Schedule) && Next_Event.Execute_Time_Us <= Current_Pos_us + Send_Ahead_us)
+			{
+				// Store the timestamp of the first event we're processing
+				int64_t Current_Batch_Timestamp = Next_Event.Execute_Time_Us;
+
+				// Send ALL events at this timestamp (within BATCH_WINDOW_US tolerance)
+				// This ensures simultaneous MIDI events are sent together
+				Scheduled_MIDI_Event Batch_Event;
+
+				int64_t Batch_Window_us = _Batch_Window_us.load(std::memory_order_relaxed);
+
+				// Clock time the batch would be sent at without a timestamp lead
+				int64_t Deliver_us = Last_Update_Time_us + (int64_t)((double)(Current_Batch_Timestamp - LOOKAHEAD_US - Current_Pos_us) / Position_Rate);
+
+				Begin_Batch(Deliver_us);
+
+				while (Peek_Next_Event(Batch_Event, From_Schedule) && Batch_Event.Execute_Time_Us <= Current_Batch_Timestamp + Batch_Window_us)
+				{
+					// Muted tracks stay in the schedule, their events are passed over here
+					if (Is_Applied_Track_Enabled(Batch_Event.Event.Track)) {
+						_Metrics.Add_Lateness(Current_Pos_us - std::max(Batch_Event.Execute_Time_Us - LOOKAHEAD_US, Earliest_Due_us));
+						Send_And_Report(Batch_Event.Event);
+					}
+
+					Pop_Next_Event(Batch_Event, From_Schedule);
+				}
+
+				End_Batch();
+				_Metrics.Add_Batch();
+			}
+
+			// Plan the next wake-up
+			int64_t Wait_us = MAX_WAIT_US;
+
+			if (Peek_Next_Event(Next_Event, From_Schedule))
+			{
+				// In clock time, the position may run faster or slower than the clock
+				int64_t Until_Due_us = (int64_t)((double)((Next_Event.Execute_Time_Us - Send_Ahead_us) - Current_Pos_us) / Position_Rate);
+
+				if (_Timestamp_Lead_us > 0)
+				{
+					// The output delivers at the exact time, the handover needs no spinning
+					if (Until_Due_us <= 0) {
+						continue;
+					}
+
+					Wait_us = (Until_Due_us < MAX_WAIT_US) ? Until_Due_us : MAX_WAIT_US;
+				}
+				else if (Audio_Available && !Audio_Clock_Valid)
+				{
+					// Nothing observed yet, the position only moves when the audio side publishes. Spinning would not help
+					Wait_us = (Until_Due_us < MAX_WAIT_US) ? Until_Due_us : MAX_WAIT_US;
+				}
+				else if (Until_Due_us <= SPIN_THRESHOLD_US)
+				{
+					_Metrics.Add_Spin();
+					Spin_Until_us(Last_Update_Time_us + Until_Due_us);
+					continue;
+				}
+				else
+				{
+					Wait_us = (Until_Due_us - SPIN_THRESHOLD_US < MAX_WAIT_US) ? Until_Due_us - SPIN_THRESHOLD_US : MAX_WAIT_US;
+				}
+			}
+			else
+			{
+				_Waiting_For_Events.store(true, std::memory_order_relaxed);
+				std::atomic_thread_fence(std::memory_order_seq_cst);
+
+				// An event may have been queued between the check above and setting the flag
+				if (Peek_Next_Event(Next_Event, From_Schedule)) {
+					_Waiting_For_Events.store(false, std::memory_order_relaxed);
+					continue;
+				}
+			}
+
+			// Wake up when the link has room for the held back messages again
+			if (_Shaper.Has_Pending())
+			{
+				int64_t Until_Drain_us = _Shaper.Get_Next_Drain_us() - _Clock->Now_us();
+
+				if (Until_Drain_us < Wait_us) {
+					Wait_us = (Until_Drain_us > 0) ? Until_Drain_us : 0;
+				}
+			}
+
+			_Clock->Wait_For_us(Wait_us);
+			_Waiting_For_Events.store(false, std::memory_order_relaxed);
+
+			_Metrics.Add_Wakeup();
+		}
+	}
+
+	void Playback_MIDI_Scheduler::Adopt_Next_Schedule()
+	{
+		// The replaced schedule needs a retire slot. Without one, the next schedule stays pending until the control thread has collected
+		if (_Schedule != nullptr && _Retired_Schedules.Size() >= _Retired_Schedules.Capacity()) {
+			return;
+		}
+
+		bool Unload_Pending = _Unload_Pending.exchange(false, std::memory_order_acq_rel);
+		Playback_MIDI_Schedule* Next_Schedule = _Next_Schedule.exchange(nullptr, std::memory_order_acq_rel);
+
+		if (Next_Schedule == nullptr)
+		{
+			if (Unload_Pending) {
+				Unload_Schedule();
+			}
+
+			return;
+		}
+
+		Playback_MIDI_Schedule* Old_Schedule = _Schedule;
+		_Schedule = Next_Schedule;
+
+		bool Seek_Pending = _Seek_Pending.load(std::memory_order_acquire);
+
+		// Continue behind what the old schedule has already sent
+		_Schedule_Cursor = _Schedule->Find_First_Index_us(_Schedule_Resume_us);
+
+		// A pending seek restores the light state at its position anyway
+		if (Old_Schedule != nullptr && !Seek_Pending) {
+			Reconcile_Sounding_Notes(*Old_Schedule);
+		}
+
+		// Deleted by the control thread, the slot was checked above and only the control thread frees slots
+		if (Old_Schedule != nullptr) {
+			_Retired_Schedules.Try_Push(Old_Schedule);
+		}
+	}
+
+	void Playback_MIDI_Scheduler::Unload_Schedule()
+	{
+		if (_Schedule == nullptr) {
+			return;
+		}
+
+		// Like a seek: the handed over messages are dropped, then everything the schedule may have switched on is switched off
+		Cancel_Timestamped_Messages();
+		Switch_Off_Sent_Notes();
+
+		_Retired_Schedules.Try_Push(_Schedule);
+
+		_Schedule = nullptr;
+		_Schedule_Cursor = 0;
+	}
+
+	void Playback_MIDI_Scheduler::Reconcile_Sounding_Notes(const Playback_MIDI_Schedule& old_schedule)
+	{
+		// What the old schedule has switched on up to the resume point against what the new one expects there
+		old_schedule.Get_Sounding_Notes(_Schedule_Resume_us, _Previous_Notes);
+		_Schedule->Get_Sounding_Notes(_Schedule_Resume_us, _Restore_Notes);
+
+		Collect_Sounding_Notes(old_schedule, _Previous_Notes, _Old_Sounding);
+		Collect_Sounding_Notes(*_Schedule, _Restore_Notes, _New_Sounding);
+
+		Begin_Batch(DELIVER_NOW);
+
+		size_t Old_Index = 0;
+		size_t New_Index = 0;
+
+		// Both lists are sorted by note key and hold every key at most once
+		while (Old_Index < _Old_Sounding.size() || New_Index < _New_Sounding.size())
+		{
+			bool Has_Old = Old_Index < _Old_Sounding.size();
+			bool Has_New = New_Index < _New_Sounding.size();
+
+			if (Has_Old && (!Has_New || _Old_Sounding[Old_Index].Key < _New_Sounding[New_Index].Key))
+			{
+				// Removed by the edit, its Note Off is not in the new schedule
+				MIDI_Event Event = old_schedule.Get_Entry(_Old_Sounding[Old_Index].Entry_Index).Event;
+				Event.Command = 0x80;
+				Event.Data2 = 0;
+
+				if (Is_Applied_Track_Enabled(Event.Track)) {
+					Send_And_Report(Event);
+				}
+
+				Old_Index++;
+			}
+			else if (Has_New && (!Has_Old || _New_Sounding[New_Index].Key < _Old_Sounding[Old_Index].Key))
+			{
+				// Added by the edit and already due
+				const MIDI_Event& Event = _Schedule->Get_Entry(_New_Sounding[New_Index].Entry_Index).Event;
+
+				if (Is_Applied_Track_Enabled(Event.Track)) {
+					Send_And_Report(Event);
+				}
+
+				New_Index++;
+			}
+			else
+			{
+				// Sounding in both, a different velocity is a different color
+				const MIDI_Event& Old_Event = old_schedule.Get_Entry(_Old_Sounding[Old_Index].Entry_Index).Event;
+				const MIDI_Event& New_Event = _Schedule->Get_Entry(_New_Sounding[New_Index].Entry_Index).Event;
+
+				if (Old_Event.Data2 != New_Event.Data2 && Is_Applied_Track_Enabled(New_Event.Track)) {
+					Send_And_Report(New_Event);
+				}
+
+				Old_Index++;
+				New_Index++;
+			}
+		}
+
+		End_Batch();
+	}
+
+	void Playback_MIDI_Scheduler::Collect_Sounding_Notes(const Playback_MIDI_Schedule& schedule, const std::vector<size_t>& note_on_indices, std::vector<Sounding_Note>& notes)
+	{
+		notes.clear();
+
+		for (size_t i = 0; i < note_on_indices.size(); i++)
+		{
+			const MIDI_Event& Event = schedule.Get_Entry(note_on_indices[i]).Event;
+
+			Sounding_Note Note;
+			Note.Key = Playback_MIDI_Schedule::Pack_Note_Key(Event.Track, Event.Channel, Event.Data1);
+			Note.Entry_Index = note_on_indices[i];
+
+			notes.push_back(Note);
+		}
+
+		std::sort(notes.begin(), notes.end(), [](const Sounding_Note& a, const Sounding_Note& b) { return a.Key < b.Key; });
+	}
+
+	void Playback_MIDI_Scheduler::Seek_Schedule(int64_t position_us, bool switch_off_sent_notes)
+	{
+		// Switch off the lights of the old position first, on this thread, so no Note On sent before the seek can come after them
+		if (switch_off_sent_notes) {
+			Switch_Off_Sent_Notes();
+		}
+
+		_Schedule_Resume_us = position_us;
+
+		// The notes of muted tracks are not restored, a change of the mask after this point switches them on or off
+		Take_Over_Track_Mask();
+
+		if (_Schedule == nullptr) {
+			return;
+		}
+
+		_Schedule_Cursor = _Schedule->Find_First_Index_us(position_us);
+
+		// Switch on the notes that started before the position and are still sounding, their Note Offs follow from the schedule
+		_Schedule->Get_Sounding_Notes(position_us, _Restore_Notes);
+
+		Begin_Batch(DELIVER_NOW);
+
+		for (size_t i = 0; i < _Restore_Notes.size(); i++)
+		{
+			const MIDI_Event& Event = _Schedule->Get_Entry(_Restore_Notes[i]).Event;
+
+			if (Is_Applied_Track_Enabled(Event.Track)) {
+				Send_And_Report(Event);
+			}
+		}
+
+		End_Batch();
+	}
+
+	void Playback_MIDI_Scheduler::Switch_Off_Sent_Notes()
+	{
+		if (_Schedule == nullptr) {
+			return;
+		}
+
+		// Notes sounding where the schedule has been sent up to. With a timestamped output, the messages not yet delivered
+		// were cancelled: a Note Off among them never arrives. The notes of the time span that may still have been pending
+		// are switched off as well, that is every note sounding at its start plus every note switched on within it
+		int64_t Pending_Span_us = 0;
+
+		if (_Timestamp_Lead_us > 0)
+		{
+			double Speed = _Playback_Speed.load(std::memory_order_relaxed);
+			Pending_Span_us = LOOKAHEAD_US + static_cast<int64_t>(_Timestamp_Lead_us * ((Speed > 1.0) ? Speed : 1.0));
+		}
+
+		int64_t Span_Start_us = _Schedule_Resume_us - Pending_Span_us;
+
+		_Schedule->Get_Sounding_Notes(Span_Start_us, _Restore_Notes);
+
+		for (size_t i = _Schedule->Find_First_Index_us(Span_Start_us); i < _Schedule_Cursor && i < _Schedule->Size(); i++)
+		{
+			const MIDI_Event& Event = _Schedule->Get_Entry(i).Event;
+
+			if ((Event.Command & 0xF0) == 0x90 && Event.Data2 > 0) {
+				_Restore_Notes.push_back(i);
+			}
+		}
+
+		Begin_Batch(DELIVER_NOW);
+
+		for (size_t i = 0; i < _Restore_Notes.size(); i++)
+		{
+			MIDI_Event Event = _Schedule->Get_Entry(_Restore_Notes[i]).Event;
+			Event.Command = 0x80;
+			Event.Data2 = 0;
+
+			Send_And_Report(Event);
+		}
+
+		End_Batch();
+	}
+
+	void Playback_MIDI_Scheduler::Take_Over_Track_Mask()
+	{
+		for (int i = 0; i < TRACK_MASK_WORDS; i++) {
+			_Applied_Track_Mask[i] = _Track_Enabled_Mask[i].load(std::memory_order_acquire);
+		}
+	}
+
+	void Playback_MIDI_Scheduler::Apply_Track_Mask_Change()
+	{
+		uint64_t Changed_Tracks[TRACK_MASK_WORDS];
+		bool Any_Changed = false;
+
+		for (int i = 0; i < TRACK_MASK_WORDS; i++)
+		{
+			uint64_t Mask = _Track_Enabled_Mask[i].load(std::memory_order_acquire);
+
+			Changed_Tracks[i] = Mask ^ _Applied_Track_Mask[i];
+			_Applied_Track_Mask[i] = Mask;
+
+			Any_Changed |= (Changed_Tracks[i] != 0);
+		}
+
+		if (!Any_Changed || _Schedule == nullptr) {
+			return;
+		}
+
+		// Notes sounding at the point the schedule has been sent up to. A muted track gets their Note Offs,
+		// an enabled one its lights back without waiting for the next Note On
+		_Schedule->Get_Sounding_Notes(_Schedule_Resume_us, _Restore_Notes);
+
+		Begin_Batch(DELIVER_NOW);
+
+		for (size_t i = 0; i < _Restore_Notes.size(); i++)
+		{
+			MIDI_Event Event = _Schedule->Get_Entry(_Restore_Notes[i]).Event;
+
+			if (Event.Track < 0 || Event.Track >= MAX_TRACKS || (Changed_Tracks[Event.Track / 64] & (1ull << (Event.Track % 64))) == 0) {
+				continue;
+			}
+
+			if (!Is_Applied_Track_Enabled(Event.Track)) {
+				Event.Command = 0x80;
+				Event.Data2 = 0;
+			}
+
+			Send_And_Report(Event);
+		}
+
+		End_Batch();
+	}
+
+	bool Playback_MIDI_Scheduler::Is_Applied_Track_Enabled(int track) const
+	{
+		if (track < 0 || track >= MAX_TRACKS) {
+			return true;
+		}
+
+		return (_Applied_Track_Mask[track / 64] & (1ull << (track % 64))) != 0;
+	}
+
+	bool Playback_MIDI_Scheduler::Peek_Next_Event(Scheduled_MIDI_Event& event, bool& from_schedule)
+	{
+		bool Has_Schedule_Event = false;
+
+		if (_Schedule != nullptr)
+		{
+			while (_Schedule_Cursor < _Schedule->Size())
+			{
+				const Playback_MIDI_Schedule::Entry& Entry = _Schedule->Get_Entry(_Schedule_Cursor);
+
+				// Orphan Note Off without any Note On before it
+				if (Playback_MIDI_Schedule::Is_Note_Off(Entry.Event) && Entry.Note_On_Index == Playback_MIDI_Schedule::NO_NOTE_ON) {
+					_Schedule_Cursor++;
+					continue;
+				}
+
+				event.Execute_Time_Us = Entry.Execute_Time_Us;
+				event.Event = Entry.Event;
+				Has_Schedule_Event = true;
+				break;
+			}
+		}
+
+		Scheduled_MIDI_Event Queued_Event;
+
+		if (_Event_Queue.Peek(Queued_Event) && (!Has_Schedule_Event || Queued_Event.Execute_Time_Us < event.Execute_Time_Us))
+		{
+			event = Queued_Event;
+			from_schedule = false;
+			return true;
+		}
+
+		from_schedule = true;
+		return Has_Schedule_Event;
+	}
+
+	void Playback_MIDI_Scheduler::Pop_Next_Event(const Scheduled_MIDI_Event& event, bool from_schedule)
+	{
+		if (from_schedule)
+		{
+			_Schedule_Cursor++;
+			_Schedule_Resume_us = event.Execute_Time_Us + 1;
+		}
+		else
+		{
+			_Event_Queue.Pop();
+		}
+	}
+
+	void Playback_MIDI_Scheduler::Begin_Batch(int64_t deliver_at_us)
+	{
+		_Batch_Frames = (_Output_Mode.load(std::memory_order_acquire) == Output_Mode::SysEx_Frames);
+
+		if (_Timestamp_Lead_us <= 0) {
+			return;
+		}
+
+		// Never before what was handed over already: a Note Off of a mute cannot be overtaken by a pending Note On
+		int64_t Deliver_us = (deliver_at_us != DELIVER_NOW) ? deliver_at_us : _Clock->Now_us();
+
+		_Batch_Deliver_us = (Deliver_us > _Last_Deliver_us) ? Deliver_us : _Last_Deliver_us;
+		_Last_Deliver_us = _Batch_Deliver_us;
+	}
+
+	void Playback_MIDI_Scheduler::Send_And_Report(const MIDI_Event& event)
+	{
+		bool Is_In_Frame = false;
+
+		if (_Batch_Frames && event.Track >= 0)
+		{
+			int Port_Index = (_Router != nullptr) ? _Router->Resolve_Track_Port(event.Track) : 0;
+			Is_In_Frame = _Frame_Builders[Port_Index].Add((unsigned char)(event.Command | event.Channel), event.Data1, event.Data2);
+		}
+
+		// Notes packed into a frame are sent with it at the end of the batch
+		if (!Is_In_Frame)
+		{
+			// The port threads do the actual sending, a slow port cannot hold up the schedule
+			if (_Router != nullptr) {
+				_Router->Send(event);
+			}
+			else if (_Output != nullptr && _Timestamp_Lead_us > 0) {
+				_Output->Send_Short_Message_At(_Batch_Deliver_us, (unsigned char)(event.Command | event.Channel), event.Data1, event.Data2);
+			}
+			else if (_Output != nullptr) {
+				_Shaper.Submit((unsigned char)(event.Command | event.Channel), event.Data1, event.Data2, _Clock->Now_us(), _Output);
+			}
+		}
+
+		_Metrics.Add_Event_Sent();
+
+		// Hand the event to the UI thread without waiting for it
+		if (!_Sent_Event_Queue.Try_Push(event)) {
+			_Sent_Events_Dropped.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		if (_Journal_Enabled.load(std::memory_order_relaxed) && !_Journal.Try_Push(event)) {
+			_Journal_Dropped.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		if (_Render_Log != nullptr)
+		{
+			Playback_MIDI_Render_Log::Record Record;
+			Record.Intended_us = static_cast<int64_t>(event.Timestamp_ms * 1000.0);
+			Record.Actual_us = _Clock_Anchored ? Get_Anchored_Position_us(_Clock->Now_us()) : _Current_Position_us.load(std::memory_order_relaxed);
+			Record.Track = event.Track;
+			Record.Status = (unsigned char)(event.Command | event.Channel);
+			Record.Data1 = event.Data1;
+			Record.Data2 = event.Data2;
+
+			_Render_Log->Append(Record);
+		}
+	}
+
+	void Playback_MIDI_Scheduler::End_Batch()
+	{
+		if (!_Batch_Frames) {
+			return;
+		}
+
+		_Batch_Frames = false;
+
+		int Port_Count = (_Router != nullptr) ? _Router->Get_Port_Count() : 1;
+
+		for (int Port_Index = 0; Port_Index < Port_Count; Port_Index++)
+		{
+			Playback_MIDI_Frame_Builder& Builder = _Frame_Builders[Port_Index];
+
+			if (Builder.Is_Empty()) {
+				continue;
+			}
+
+			size_t Frame_Count = Builder.Finish();
+
+			for (size_t i = 0; i < Frame_Count; i++)
+			{
+				size_t Length = 0;
+				const unsigned char* Frame = Builder.Get_Frame(i, Length);
+
+				if (_Router != nullptr) {
+					_Router->Send_Frame(Port_Index, Frame, Length);
+				}
+				else if (_Output != nullptr && _Timestamp_Lead_us > 0) {
+					_Output->Send_Long_Message_At(_Batch_Deliver_us, Frame, Length);
+				}
+				else if (_Output != nullptr && _Output->Send_Long_Message(Frame, Length)) {
+					_Shaper.Account_Sent(Length, _Clock->Now_us());
+				}
+			}
+		}
+	}
+
+	void Playback_MIDI_Scheduler::Take_Over_Timestamp_Lead()
+	{
+		// The port threads of the router send right away, timestamps are only used on the direct output
+		int64_t Lead_us = (_Router == nullptr) ? _Output->Get_Timestamp_Lead_us() : 0;
+
+		_Timestamp_Lead_us = (Lead_us > 0) ? Lead_us : 0;
+		_Last_Deliver_us = INT64_MIN;
+	}
+
+	void Playback_MIDI_Scheduler::Cancel_Timestamped_Messages()
+	{
+		if (_Timestamp_Lead_us <= 0) {
+			return;
+		}
+
+		_Output->Cancel_Pending();
+		_Last_Deliver_us = INT64_MIN;
+	}
+
+	void Playback_MIDI_Scheduler::Free_Retired_Schedules()
+	{
+		Playback_MIDI_Schedule* Retired_Schedule = nullptr;
+
+		while (_Retired_Schedules.Try_Pop(Retired_Schedule)) {
+			delete Retired_Schedule;
+		}
+	}
+}
+
+#ifdef _MSC_VER
+#pragma managed(pop)
+#endif
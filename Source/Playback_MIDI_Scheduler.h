@@ -0,0 +1,262 @@
+#pragma once
+
+#include <thread>
+#include <atomic>
+#include <vector>
+#include <cstdint>
+
+#include "Playback_Clock.h"
+#include "Playback_Audio_Clock.h"
+#include "Playback_Clock_Sync_Filter.h"
+#include "Playback_MIDI_Output.h"
+#include "Playback_MIDI_Schedule.h"
+#include "Playback_MIDI_Port_Router.h"
+#include "Playback_MIDI_Frame_Builder.h"
+#include "Playback_MIDI_Link_Shaper.h"
+#include "Playback_MIDI_Engine_Metrics.h"
+#include "Playback_MIDI_Render_Log.h"
+#include "Playback_SPSC_Ring.h"
+
+namespace MIDILightDrawer
+{
+	// Platform independent MIDI playback thread. Sends queued events to an IMidiOutput when they are due
+	// on the IClock, or on the audio position when audio is available.
+	// Events come from the loaded Playback_MIDI_Schedule and from the queue for events added on the fly
+	class Playback_MIDI_Scheduler
+	{
+	public:
+		typedef Playback_MIDI_Schedule::MIDI_Event MIDI_Event;
+
+		// Lookahead time: Process events slightly ahead of current position
+		// This compensates for MIDI output latency (~2-5ms typical)
+		static const int64_t LOOKAHEAD_US = 5000;
+
+		// The thread sleeps until shortly before the next event is due and busy-waits only for the last part.
+		// This absorbs the wake-up error of the clock without keeping a core busy between events
+		static const int64_t SPIN_THRESHOLD_US = 500;
+
+		// Upper bound of one sleep, keeps the position for the UI current when no event is due for a while
+		static const int64_t MAX_WAIT_US = 5000;
+
+		// Events due within this time after the first event of a batch are sent together with it.
+		// A wider window lets the link shaper and the frame mode merge more updates of the same light
+		static const int64_t BATCH_WINDOW_US = 100;
+
+		// Tracks with an enable bit, tracks above and events without a track always play
+		static const int MAX_TRACKS = Playback_MIDI_Port_Router::MAX_TRACKS;
+
+		// Batch time of Begin_Batch for messages that are not tied to a time of the schedule
+		static const int64_t DELIVER_NOW = INT64_MIN;
+
+		enum class Output_Mode
+		{
+			Note_Messages,		// Every event as its own short message
+			SysEx_Frames		// Note events of a batch packed into Playback_MIDI_Frame_Builder frames, one or more per port
+		};
+
+	private:
+		struct Scheduled_MIDI_Event
+		{
+			int64_t Execute_Time_Us;  // When to send this event
+			MIDI_Event Event;
+		};
+
+		struct Sounding_Note
+		{
+			uint32_t Key;				// Playback_MIDI_Schedule::Pack_Note_Key
+			size_t Entry_Index;			// Note On in its schedule
+		};
+
+		// Scheduled events: UI thread produces, playback thread consumes
+		static const size_t EVENT_QUEUE_CAPACITY		= 1 << 16;
+		// Sent events: playback thread produces, UI thread consumes. Events are dropped if the UI does not keep up
+		static const size_t SENT_EVENT_QUEUE_CAPACITY	= 1 << 14;
+		// Sent events for the MIDI log: playback thread produces, the log timer consumes. Only filled while enabled
+		static const size_t JOURNAL_CAPACITY			= 1 << 14;
+		// Replaced schedules: playback thread produces, UI thread deletes them. A new schedule is only taken over
+		// while a slot is free, the playback thread never deletes one itself
+		static const size_t RETIRED_SCHEDULE_CAPACITY	= 4;
+
+		static const int TRACK_MASK_WORDS = MAX_TRACKS / 64;
+
+		IMidiOutput* _Output;
+		IClock* _Clock;
+		Playback_MIDI_Port_Router* _Router;		// Replaces _Output for sending when several ports are in use
+
+		std::atomic<Output_Mode> _Output_Mode;
+		bool _Batch_Frames;		// The current batch collects its notes in the frame builders, playback thread only
+		Playback_MIDI_Frame_Builder _Frame_Builders[Playback_MIDI_Port_Router::MAX_PORTS];
+
+		std::atomic<int64_t> _Batch_Window_us;
+		Playback_MIDI_Link_Shaper _Shaper;		// Paces _Output while sending without the router
+
+		// Timestamped output without the router: batches are handed over ahead with the clock time they are due at.
+		// Taken from the output when the thread starts, the delivery times belong to the playback thread
+		int64_t _Timestamp_Lead_us;
+		int64_t _Batch_Deliver_us;
+		int64_t _Last_Deliver_us;		// Latest time handed over, nothing may be delivered before it
+
+		std::thread* _Thread;
+		std::atomic<bool> _Is_Playing;
+		std::atomic<bool> _Should_Stop;
+		std::atomic<bool> _Reset_Timing;
+		std::atomic<int64_t> _Current_Position_us;
+		std::atomic<bool> _Waiting_For_Events;	// Thread sleeps because the event queue is empty
+
+		// MIDI-only playback: the position runs at the playback speed from an anchor, set again on every jump and speed change.
+		// Anchor members belong to the playback thread
+		std::atomic<double> _Playback_Speed;
+		bool _Clock_Anchored;
+		int64_t _Anchor_Position_us;
+		int64_t _Anchor_Time_us;
+		double _Anchor_Speed;
+
+		std::atomic<bool> _Audio_Is_Available;
+		std::atomic<int64_t> _Audio_Position_us;
+		const Playback_Audio_Clock* _Audio_Clock;	// Render clock anchors, preferred over _Audio_Position_us
+		Playback_Clock_Sync_Filter _Audio_Sync;		// Smoothed audio timeline, playback thread only
+
+		Playback_SPSC_Ring<Scheduled_MIDI_Event> _Event_Queue;
+		Playback_SPSC_Ring<MIDI_Event> _Sent_Event_Queue;
+		std::atomic<uint64_t> _Sent_Events_Dropped;
+		Playback_SPSC_Ring<MIDI_Event> _Journal;
+		std::atomic<bool> _Journal_Enabled;
+		std::atomic<uint64_t> _Journal_Dropped;
+
+		// The active schedule and its cursor belong to the playback thread while it runs, to the caller otherwise
+		Playback_MIDI_Schedule* _Schedule;
+		size_t _Schedule_Cursor;
+		int64_t _Schedule_Resume_us;	// Everything before this time has been sent from the schedule
+		std::vector<size_t> _Restore_Notes;
+
+		// Notes sounding in the replaced and in the new schedule, compared when a schedule is swapped in during playback
+		std::vector<size_t> _Previous_Notes;
+		std::vector<Sounding_Note> _Old_Sounding;
+		std::vector<Sounding_Note> _New_Sounding;
+
+		std::atomic<Playback_MIDI_Schedule*> _Next_Schedule;
+		std::atomic<bool> _Unload_Pending;		// Set_Schedule(nullptr) while running, a pending _Next_Schedule wins
+		Playback_SPSC_Ring<Playback_MIDI_Schedule*> _Retired_Schedules;
+
+		std::atomic<bool> _Seek_Pending;
+		std::atomic<int64_t> _Seek_Position_us;
+
+		// Mute and solo: written by the control thread, the playback thread works on its own copy and switches
+		// the sounding notes of a changed track off or on again when it takes over the new mask
+		std::atomic<uint64_t> _Track_Enabled_Mask[TRACK_MASK_WORDS];
+		std::atomic<bool> _Track_Mask_Changed;
+		uint64_t _Applied_Track_Mask[TRACK_MASK_WORDS];
+
+		// Offline render: every sent event goes to the log, the run ends at the end position. Set while the thread is stopped
+		Playback_MIDI_Render_Log* _Render_Log;
+		int64_t _Render_End_us;
+
+		// Reset on every start of the thread
+		Playback_MIDI_Engine_Metrics _Metrics;
+
+	public:
+		Playback_MIDI_Scheduler(IMidiOutput* output, IClock* clock);
+		~Playback_MIDI_Scheduler();
+
+		bool Start();
+		bool Stop();
+		bool Is_Running() const;
+		bool Is_Playing() const;
+
+		// Sends immediately, bypassing the queue. Call from the control thread only
+		bool Send_Event(const MIDI_Event& event);
+
+		// Takes ownership of the schedule, nullptr unloads it. Picked up by a running thread at its current position,
+		// where the notes that differ between the two schedules are switched off or on. Unloading switches off
+		// every note the old schedule has sent
+		void Set_Schedule(Playback_MIDI_Schedule* schedule);
+
+		// Deletes the schedules the running thread has replaced. Control thread only, call it regularly during playback:
+		// the thread takes over no further schedule while all retire slots are in use
+		void Free_Retired_Schedules();
+
+		// Rate of the MIDI-only clock, 1.0 is real time. Takes effect right away, the position is kept.
+		// With audio, the audio position is followed and the speed is not used
+		void Set_Playback_Speed(double speed);
+		double Get_Playback_Speed() const;
+
+		bool Queue_Event(const MIDI_Event& event);
+		void Clear_Queue();
+		bool Pop_Sent_Event(MIDI_Event& event);
+		uint64_t Get_Sent_Events_Dropped() const;
+
+		// Second copy of the sent events with its own reader, so the log drains at its own pace
+		void Set_Journal_Enabled(bool enabled);
+		bool Pop_Journal_Event(MIDI_Event& event);
+		uint64_t Get_Journal_Dropped() const;
+
+		int64_t Get_Position_us() const;
+		void Set_Position_us(int64_t position_us);
+
+		void Set_Audio_Available(bool available);
+		void Set_Audio_Position_us(int64_t position_us);
+
+		// Must share the time base of the IClock. Set before the thread starts
+		void Set_Audio_Clock(const Playback_Audio_Clock* audio_clock);
+
+		// Routes all sends through the port threads of the router, nullptr sends to the output directly. Set before the thread starts
+		void Set_Port_Router(Playback_MIDI_Port_Router* router);
+		Playback_MIDI_Port_Router* Get_Port_Router() const;
+
+		// Can be switched at any time, takes effect with the next batch
+		void Set_Output_Mode(Output_Mode mode);
+		Output_Mode Get_Output_Mode() const;
+
+		// Limited to LOOKAHEAD_US, events are never sent earlier than the lookahead allows
+		void Set_Batch_Window_us(int64_t window_us);
+		int64_t Get_Batch_Window_us() const;
+
+		// Link capacity of the output when sending without the router, 0 sends without pacing
+		void Set_Link_Bytes_Per_Second(int bytes_per_second);
+		Playback_MIDI_Link_Shaper::Statistics Get_Link_Statistics() const;
+
+		// Counters of the current or last run. The send times are left at 0, they are measured by the outputs
+		Playback_MIDI_Engine_Metrics::Snapshot Get_Metrics() const;
+
+		// Mute and solo without touching the schedule, can be called from any thread at any time
+		void Set_Track_Enabled(int track, bool enabled);
+		bool Is_Track_Enabled(int track) const;
+
+		// Enables the tracks below track_count from the mute and solo lists of the timeline. A muted track never plays,
+		// while any track is soloed only the soloed ones play. Every track is set, not only the ones in the lists
+		void Set_Track_Mute_Solo(int track_count, const int* muted_tracks, size_t muted_count, const int* soloed_tracks, size_t soloed_count);
+		static bool Should_Track_Play(int track, const int* muted_tracks, size_t muted_count, const int* soloed_tracks, size_t soloed_count);
+
+		// Records every sent event with its timestamp and the position it was sent at, nullptr stops recording. Set before the thread starts
+		void Set_Render_Log(Playback_MIDI_Render_Log* render_log);
+
+		// Plays from start to end position on the calling thread instead of the playback thread and returns at the end.
+		// On a Playback_Clock_Virtual the run is deterministic and takes no real time. MIDI-only, fails while the thread runs or audio is available
+		bool Render_Offline(int64_t start_position_us, int64_t end_position_us);
+
+		IMidiOutput* Get_Output() const;
+		IClock* Get_Clock() const;
+
+	private:
+		void Thread_Function();
+		void Adopt_Next_Schedule();
+		void Unload_Schedule();
+		void Reconcile_Sounding_Notes(const Playback_MIDI_Schedule& old_schedule);
+		static void Collect_Sounding_Notes(const Playback_MIDI_Schedule& schedule, const std::vector<size_t>& note_on_indices, std::vector<Sounding_Note>& notes);
+		void Seek_Schedule(int64_t position_us, bool switch_off_sent_notes);
+		void Switch_Off_Sent_Notes();
+		void Take_Over_Track_Mask();
+		void Apply_Track_Mask_Change();
+		bool Is_Applied_Track_Enabled(int track) const;
+		bool Peek_Next_Event(Scheduled_MIDI_Event& event, bool& from_schedule);
+		void Pop_Next_Event(const Scheduled_MIDI_Event& event, bool from_schedule);
+		void Begin_Batch(int64_t deliver_at_us);
+		void Send_And_Report(const MIDI_Event& event);
+		void End_Batch();
+		void Take_Over_Timestamp_Lead();
+		void Cancel_Timestamped_Messages();
+		void Spin_Until_us(int64_t target_us);
+		void Anchor_Clock(int64_t position_us, int64_t now_us, double speed);
+		int64_t Get_Anchored_Position_us(int64_t now_us) const;
+	};
+}
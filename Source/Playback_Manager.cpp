@@ -5,11 +5,10 @@
 #include "MIDI_Event_Raster.h"
 #include "Playback_Event_Queue_Manager.h"
 #include "Widget_Audio_Container.h"
-#include "Form_MIDI_Log.h"
 
 namespace MIDILightDrawer
 {
-	Playback_Manager::Playback_Manager(Widget_Timeline^ timeline, MIDI_Event_Raster^ midi_event_raster, Widget_Audio_Container^ audio_container, Form_MIDI_Log^ form_midi_log)
+	Playback_Manager::Playback_Manager(Widget_Timeline^ timeline, MIDI_Event_Raster^ midi_event_raster, Widget_Audio_Container^ audio_container)
 	{
 		_Timeline = timeline;
 		_MIDI_Event_Raster = midi_event_raster;
@@ -18,9 +17,12 @@ namespace MIDILightDrawer
 		_MIDI_Engine = gcnew Playback_MIDI_Engine();
 		_Audio_Engine = gcnew Playback_Audio_Engine();
 
-		_Event_Queue_Manager = gcnew Playback_Event_Queue_Manager(_MIDI_Engine, _MIDI_Event_Raster, form_midi_log);
+		_Event_Queue_Manager = gcnew Playback_Event_Queue_Manager(_MIDI_Engine, _MIDI_Event_Raster);
 		_MIDI_Engine->Set_Event_Queue_Manager(_Event_Queue_Manager);
 
+		// Every executed, undone or redone edit. During playback the schedule is rebuilt and swapped in live
+		_Timeline->CommandManager()->CommandStateChanged += gcnew TimelineCommandManager::CommandStateChangedHandler(this, &Playback_Manager::On_Timeline_Edited);
+
 		_Current_State = Playback_State::Stopped;
 		_Playback_Position_ms = 0.0;
 		_Playback_Speed = 1.0;
@@ -41,6 +43,21 @@ namespace MIDILightDrawer
 		return _MIDI_Engine->Initialize(device_id);
 	}
 
+	int Playback_Manager::Add_MIDI_Output_Port(int device_id)
+	{
+		// Ports are added while stopped only, the send threads are set up before the playback thread starts
+		if (Is_Playing()) {
+			return -1;
+		}
+
+		return _MIDI_Engine->Add_Output_Port(device_id);
+	}
+
+	void Playback_Manager::Set_Track_MIDI_Port(int track_index, int port)
+	{
+		_MIDI_Engine->Set_Track_Port(track_index, port);
+	}
+
 	bool Playback_Manager::Initialize_Audio(String^ device_id, int buffer_size)
 	{
 		bool Success = _Audio_Engine->Initialize(device_id, buffer_size);
@@ -112,7 +129,7 @@ namespace MIDILightDrawer
 
 			if (!_Event_Queue_Manager->Is_Cache_Valid())
 			{
-				bool Success = _Event_Queue_Manager->Raster_And_Cache_Events(_Timeline->Tracks, _Timeline->Measures, Muted_Tracks, Soloed_Tracks, Settings::Get_Instance()->Global_MIDI_Output_Channel);
+				bool Success = _Event_Queue_Manager->Raster_And_Cache_Events(_Timeline->Tracks, _Timeline->Measures, Muted_Tracks, Soloed_Tracks);
 
 				if (!Success) {
 					return false;
@@ -133,6 +150,10 @@ namespace MIDILightDrawer
 			_MIDI_Engine->Set_Current_Position_ms(_Playback_Position_ms);
 			_MIDI_Engine->Send_All_Notes_Off(Math::Max(Settings::Get_Instance()->Global_MIDI_Output_Channel - 1, 0));
 
+			if (_Current_State == Playback_State::Stopped) {
+				_MIDI_Engine->Start_Metrics_Recording(METRICS_INTERVAL_MS);
+			}
+
 			// Start MIDI playback thread
 			Success &= _MIDI_Engine->Start_Playback();
 
@@ -169,7 +190,8 @@ namespace MIDILightDrawer
 
 			bool Success = true;
 
-			// Send Note Off for all active notes FIRST
+			// Pick up the notes sent since the last UI update, then send Note Off for all active notes FIRST
+			_MIDI_Engine->Service_Event_Queues();
 			_Event_Queue_Manager->Send_All_Active_Notes_Off();
 			_Event_Queue_Manager->Invalidate_Cache();
 
@@ -206,7 +228,8 @@ namespace MIDILightDrawer
 
 			bool Success = true;
 
-			// Send Note Off for all active notes FIRST
+			// Pick up the notes sent since the last UI update, then send Note Off for all active notes FIRST
+			_MIDI_Engine->Service_Event_Queues();
 			_Event_Queue_Manager->Send_All_Active_Notes_Off();
 
 			// Stop MIDI playback thread
@@ -214,6 +237,7 @@ namespace MIDILightDrawer
 
 			_MIDI_Engine->Clear_Event_Queue();
 			_MIDI_Engine->Set_Audio_Available(false);
+			_MIDI_Engine->Stop_Metrics_Recording();
 			_MIDI_Engine->Send_All_Notes_Off(Math::Max(Settings::Get_Instance()->Global_MIDI_Output_Channel - 1, 0));
 
 			// Stop audio if loaded
@@ -238,9 +262,8 @@ namespace MIDILightDrawer
 		
 		bool Was_Playing = (_Current_State == Playback_State::Playing);
 
-		// Pause playback during seek
 		if (Was_Playing) {
-			Pause();
+			return Seek_While_Playing(position_ms);
 		}
 
 		_Playback_Position_ms = position_ms;
@@ -256,11 +279,34 @@ namespace MIDILightDrawer
 		_Audio_Container->Update_Cursor();
 		_Timeline->Playback_Auto_Scroll(true);
 
-		// Resume playback if it was playing
-		if (Was_Playing) {
-			Play();
+		return true;
+	}
+
+	bool Playback_Manager::Seek_While_Playing(double position_ms)
+	{
+		System::Threading::Monitor::Enter(_State_Lock);
+
+		try {
+			if (_Current_State != Playback_State::Playing) {
+				return false;
+			}
+
+			// The cached schedule stays loaded, the playback thread only moves its cursor.
+			// It also switches off the notes of the old position, ordered with everything it has sent before
+			_Playback_Position_ms = position_ms;
+			_MIDI_Engine->Set_Current_Position_ms(position_ms);
+
+			if (_Audio_Engine && Is_Audio_Loaded) {
+				_Audio_Engine->Set_Current_Position_ms(position_ms);
+			}
+		}
+		finally {
+			System::Threading::Monitor::Exit(_State_Lock);
 		}
 
+		_Audio_Container->Update_Cursor();
+		_Timeline->Playback_Auto_Scroll(true);
+
 		return true;
 	}
 
@@ -271,7 +317,8 @@ namespace MIDILightDrawer
 			_Timeline->Tracks[track_index]->IsMuted = is_muted;
 		}
 
-		if (_Current_State == Playback_State::Playing)
+		// Only switches the track in the engine, so it is applied while stopped as well. The cached events are reused by the next Play
+		if (_Timeline)
 		{
 			double Current_Pos = Get_Playback_Position_ms();
 			List<int>^ Muted = _Timeline->TrackNumbersMuted;
@@ -288,7 +335,8 @@ namespace MIDILightDrawer
 			_Timeline->Tracks[track_index]->IsSoloed = is_soloed;
 		}
 
-		if (_Current_State == Playback_State::Playing)
+		// Only switches the track in the engine, so it is applied while stopped as well. The cached events are reused by the next Play
+		if (_Timeline)
 		{
 			double Current_Pos = Get_Playback_Position_ms();
 			List<int>^ Muted = _Timeline->TrackNumbersMuted;
@@ -298,6 +346,19 @@ namespace MIDILightDrawer
 		}
 	}
 
+	void Playback_Manager::On_Timeline_Edited()
+	{
+		if (_Current_State == Playback_State::Playing && _Timeline)
+		{
+			// The playback thread goes on with the old schedule until it swaps in the new one, nothing is stopped or queued again
+			_Event_Queue_Manager->Rebuild_During_Playback(_Timeline->Tracks, _Timeline->Measures, _Timeline->TrackNumbersMuted, _Timeline->TrackNumbersSoloed);
+		}
+		else
+		{
+			_Event_Queue_Manager->Invalidate_Cache();
+		}
+	}
+
 	Playback_State Playback_Manager::Get_State()
 	{
 		System::Threading::Monitor::Enter(_State_Lock);
@@ -325,6 +386,9 @@ namespace MIDILightDrawer
 			// Get position from MIDI engine if playing (it's the master clock)
 			if (Current == Playback_State::Playing)
 			{
+				// Refill the native event queue and report sent events, this runs on every UI position update
+				_MIDI_Engine->Service_Event_Queues();
+
 				double MIDI_Pos = _MIDI_Engine->Get_Current_Position_ms();
 
 				// Sync audio engine with MIDI position
@@ -374,6 +438,9 @@ namespace MIDILightDrawer
 	{
 		if (speed > 0.0) {
 			_Playback_Speed = speed;
+
+			// Applied by the MIDI-only clock right away, also during playback. With audio, the audio position leads
+			_MIDI_Engine->Set_Playback_Speed(speed);
 		}
 	}
 
@@ -412,4 +479,46 @@ namespace MIDILightDrawer
 	{
 		return _MIDI_Engine->Send_Event(event);
 	}
+
+	bool Playback_Manager::Render_Timeline_Log(String^ filename, String^% report)
+	{
+		System::Threading::Monitor::Enter(_State_Lock);
+
+		try {
+			if (!_Event_Queue_Manager->Is_Cache_Valid())
+			{
+				bool Success = _Event_Queue_Manager->Raster_And_Cache_Events(_Timeline->Tracks, _Timeline->Measures, _Timeline->TrackNumbersMuted, _Timeline->TrackNumbersSoloed);
+
+				if (!Success) {
+					return false;
+				}
+			}
+
+			return _Event_Queue_Manager->Render_Offline_Log(filename, report);
+		}
+		finally {
+			System::Threading::Monitor::Exit(_State_Lock);
+		}
+	}
+
+	String^ Playback_Manager::Create_Bandwidth_Report()
+	{
+		System::Threading::Monitor::Enter(_State_Lock);
+
+		try {
+			if (!_Event_Queue_Manager->Is_Cache_Valid())
+			{
+				bool Success = _Event_Queue_Manager->Raster_And_Cache_Events(_Timeline->Tracks, _Timeline->Measures, _Timeline->TrackNumbersMuted, _Timeline->TrackNumbersSoloed);
+
+				if (!Success) {
+					return nullptr;
+				}
+			}
+
+			return _Event_Queue_Manager->Create_Bandwidth_Report();
+		}
+		finally {
+			System::Threading::Monitor::Exit(_State_Lock);
+		}
+	}
 }
\ No newline at end of file
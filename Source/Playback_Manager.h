@@ -12,7 +12,6 @@ namespace MIDILightDrawer
 	ref class MIDI_Event_Raster;
 	ref class Playback_Event_Queue_Manager;
 	ref class Widget_Audio_Container;
-	ref class Form_MIDI_Log;
 	
 	public enum class Playback_State
 	{
@@ -40,12 +39,17 @@ namespace MIDILightDrawer
 
 		System::Object^ _State_Lock;
 
+		// Every playback from the stopped state records the engine metrics, kept until the next one for saving them
+		literal double METRICS_INTERVAL_MS = 100.0;
+
 	public:
-		Playback_Manager(Widget_Timeline^ timeline, MIDI_Event_Raster^ midi_event_raster, Widget_Audio_Container^ audio_container, Form_MIDI_Log^ form_midi_log);
+		Playback_Manager(Widget_Timeline^ timeline, MIDI_Event_Raster^ midi_event_raster, Widget_Audio_Container^ audio_container);
 		~Playback_Manager();
 
 		// Initialization
 		bool Initialize_MIDI(int device_id);
+		int Add_MIDI_Output_Port(int device_id);
+		void Set_Track_MIDI_Port(int track_index, int port);
 		bool Initialize_Audio(String^ device_id, int buffer_size);
 		void Stop_And_Cleanup();
 
@@ -83,6 +87,12 @@ namespace MIDILightDrawer
 		// MIDI control
 		bool Send_MIDI_Event(Playback_MIDI_Event^ event);
 
+		// Renders the whole timeline without a device into a log of every sent event and its timing
+		bool Render_Timeline_Log(String^ filename, String^% report);
+
+		// Link usage of the whole timeline sent as note messages and as SysEx frames, nullptr without a timeline
+		String^ Create_Bandwidth_Report();
+
 	public:
 		property bool Is_Audio_Loaded {
 			bool get() { return _Audio_Engine->Is_Audio_Loaded; }
@@ -120,9 +130,18 @@ namespace MIDILightDrawer
 			Playback_Audio_Engine^ get() { return _Audio_Engine; }
 		}
 
+		// Metrics and their CSV dump
+		property Playback_MIDI_Engine^ MIDI_Engine {
+			Playback_MIDI_Engine^ get() { return _MIDI_Engine; }
+		}
+
 		property Waveform_Render_Data^ Audio_Waveform_Data {
 			Waveform_Render_Data^ get() { return _Audio_Engine->Waveform_Data; }
 		}
+
+	private:
+		bool Seek_While_Playing(double position_ms);
+		void On_Timeline_Edited();
 	};
 }
 
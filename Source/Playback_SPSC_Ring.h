@@ -0,0 +1,136 @@
+#pragma once
+
+#include <atomic>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace MIDILightDrawer
+{
+	// Bounded lock-free ring for exactly one producer thread and one consumer thread.
+	// Head and tail are running counters, the slot index is the counter masked by the capacity
+	template <typename T>
+	class Playback_SPSC_Ring
+	{
+	private:
+		static const size_t CACHE_LINE_SIZE = 64;
+
+		std::vector<T> _Slots;
+		size_t _Mask;
+
+		// Producer and consumer counters live on separate cache lines so the threads do not share them
+		char _Pad_Start[CACHE_LINE_SIZE];
+		std::atomic<uint64_t> _Head;			// Written by the producer only
+		char _Pad_Head[CACHE_LINE_SIZE - sizeof(std::atomic<uint64_t>)];
+		std::atomic<uint64_t> _Tail;			// Written by the consumer only
+		char _Pad_Tail[CACHE_LINE_SIZE - sizeof(std::atomic<uint64_t>)];
+		std::atomic<uint64_t> _Discard_Before;	// Items below this counter are skipped by the consumer
+		char _Pad_End[CACHE_LINE_SIZE - sizeof(std::atomic<uint64_t>)];
+
+	public:
+		// Capacity is rounded up to the next power of two
+		explicit Playback_SPSC_Ring(size_t capacity) : _Head(0), _Tail(0), _Discard_Before(0)
+		{
+			size_t Rounded_Capacity = 1;
+			while (Rounded_Capacity < capacity) {
+				Rounded_Capacity <<= 1;
+			}
+
+			_Slots.resize(Rounded_Capacity);
+			_Mask = Rounded_Capacity - 1;
+		}
+
+		// Producer side. Returns false if the ring is full, the item is not stored in that case
+		bool Try_Push(const T& item)
+		{
+			uint64_t Head = _Head.load(std::memory_order_relaxed);
+			uint64_t Tail = _Tail.load(std::memory_order_acquire);
+
+			if (Head - Tail > _Mask) {
+				return false;
+			}
+
+			_Slots[(size_t)(Head & _Mask)] = item;
+			_Head.store(Head + 1, std::memory_order_release);
+
+			return true;
+		}
+
+		// Producer side. Everything pushed so far is dropped, items pushed afterwards are kept
+		void Discard_All()
+		{
+			_Discard_Before.store(_Head.load(std::memory_order_relaxed), std::memory_order_release);
+		}
+
+		// Consumer side. Copies the oldest item without removing it
+		bool Peek(T& item)
+		{
+			uint64_t Tail = Skip_Discarded();
+
+			if (Tail == _Head.load(std::memory_order_acquire)) {
+				return false;
+			}
+
+			item = _Slots[(size_t)(Tail & _Mask)];
+
+			return true;
+		}
+
+		// Consumer side. Removes the item returned by the last successful Peek
+		void Pop()
+		{
+			uint64_t Tail = _Tail.load(std::memory_order_relaxed);
+			uint64_t Discard_Before = _Discard_Before.load(std::memory_order_acquire);
+
+			_Tail.store((Discard_Before > Tail) ? Discard_Before : Tail + 1, std::memory_order_release);
+		}
+
+		// Consumer side
+		bool Try_Pop(T& item)
+		{
+			if (!Peek(item)) {
+				return false;
+			}
+
+			Pop();
+
+			return true;
+		}
+
+		// Only valid while neither the producer nor the consumer is active
+		void Reset()
+		{
+			_Head.store(0, std::memory_order_relaxed);
+			_Tail.store(0, std::memory_order_relaxed);
+			_Discard_Before.store(0, std::memory_order_release);
+		}
+
+		// Snapshot only, the other thread may change it at any time
+		size_t Size() const
+		{
+			uint64_t Head = _Head.load(std::memory_order_acquire);
+			uint64_t Tail = _Tail.load(std::memory_order_acquire);
+
+			return (size_t)(Head - Tail);
+		}
+
+		size_t Capacity() const
+		{
+			return _Mask + 1;
+		}
+
+	private:
+		uint64_t Skip_Discarded()
+		{
+			uint64_t Tail = _Tail.load(std::memory_order_relaxed);
+			uint64_t Discard_Before = _Discard_Before.load(std::memory_order_acquire);
+
+			if (Discard_Before > Tail) {
+				_Tail.store(Discard_Before, std::memory_order_release);
+				return Discard_Before;
+			}
+
+			return Tail;
+		}
+	};
+}
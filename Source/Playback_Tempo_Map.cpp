@@ -0,0 +1,86 @@
+#ifdef _MSC_VER
+#pragma managed(push, off)
+#endif
+
+#include "Playback_Tempo_Map.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace MIDILightDrawer
+{
+	Playback_Tempo_Map::Playback_Tempo_Map()
+	{
+	}
+
+	Playback_Tempo_Map::Playback_Tempo_Map(const Segment* segments, size_t count)
+	{
+		_Segments.reserve(count);
+
+		for (size_t i = 0; i < count; i++)
+		{
+			if (segments[i].Us_Per_Tick > 0.0) {
+				_Segments.push_back(segments[i]);
+			}
+		}
+
+		std::stable_sort(_Segments.begin(), _Segments.end(), [](const Segment& a, const Segment& b) {
+			return a.Start_Tick < b.Start_Tick;
+		});
+	}
+
+	bool Playback_Tempo_Map::Is_Empty() const
+	{
+		return _Segments.empty();
+	}
+
+	size_t Playback_Tempo_Map::Get_Segment_Count() const
+	{
+		return _Segments.size();
+	}
+
+	int64_t Playback_Tempo_Map::Get_Time_us(double tick) const
+	{
+		if (_Segments.empty()) {
+			return 0;
+		}
+
+		const Segment& Current = Find_Segment_By_Tick(tick);
+
+		return (int64_t)std::llround(Current.Start_us + (tick - (double)Current.Start_Tick) * Current.Us_Per_Tick);
+	}
+
+	double Playback_Tempo_Map::Get_Tick(int64_t time_us) const
+	{
+		if (_Segments.empty()) {
+			return 0.0;
+		}
+
+		const Segment& Current = Find_Segment_By_Time((double)time_us);
+
+		return (double)Current.Start_Tick + ((double)time_us - Current.Start_us) / Current.Us_Per_Tick;
+	}
+
+	const Playback_Tempo_Map::Segment& Playback_Tempo_Map::Find_Segment_By_Tick(double tick) const
+	{
+		// Last segment starting at or before the tick
+		std::vector<Segment>::const_iterator It = std::upper_bound(_Segments.begin(), _Segments.end(), tick, [](double value, const Segment& segment) {
+			return value < (double)segment.Start_Tick;
+		});
+
+		return (It == _Segments.begin()) ? *It : *(It - 1);
+	}
+
+	const Playback_Tempo_Map::Segment& Playback_Tempo_Map::Find_Segment_By_Time(double time_us) const
+	{
+		std::vector<Segment>::const_iterator It = std::upper_bound(_Segments.begin(), _Segments.end(), time_us, [](double value, const Segment& segment) {
+			return value < segment.Start_us;
+		});
+
+		return (It == _Segments.begin()) ? *It : *(It - 1);
+	}
+}
+
+#ifdef _MSC_VER
+#pragma managed(pop)
+#endif
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace MIDILightDrawer
+{
+	// Piecewise linear mapping between timeline ticks and playback time, one segment per tempo, typically one per measure.
+	// Immutable once built
+	class Playback_Tempo_Map
+	{
+	public:
+		struct Segment
+		{
+			int64_t Start_Tick;
+			double Start_us;
+			double Us_Per_Tick;
+		};
+
+	private:
+		std::vector<Segment> _Segments;		// Sorted by Start_Tick
+
+	public:
+		Playback_Tempo_Map();
+
+		// Segments do not have to be sorted, segments without a positive tick length are ignored
+		Playback_Tempo_Map(const Segment* segments, size_t count);
+
+		bool Is_Empty() const;
+		size_t Get_Segment_Count() const;
+
+		// Before the first segment and behind the last one, the tempo of the nearest segment continues
+		int64_t Get_Time_us(double tick) const;
+		double Get_Tick(int64_t time_us) const;
+
+	private:
+		const Segment& Find_Segment_By_Tick(double tick) const;
+		const Segment& Find_Segment_By_Time(double time_us) const;
+	};
+}
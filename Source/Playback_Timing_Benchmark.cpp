@@ -0,0 +1,483 @@
+#ifdef _MSC_VER
+#pragma managed(push, off)
+#endif
+
+#include "Playback_Timing_Benchmark.h"
+#include "Playback_Clock_Steady.h"
+#include "Playback_MIDI_Output_Recording.h"
+#include "Playback_MIDI_Scheduler.h"
+#include "Playback_MIDI_Output_ALSA.h"
+#include "Playback_MIDI_Capture_ALSA.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <ctime>
+#include <thread>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#endif
+
+namespace MIDILightDrawer
+{
+	// Time before the first event, lets the scheduler thread start up before anything is due
+	static const double LEAD_IN_MS = 20.0;
+
+	// Time after the last event before the run is considered stuck
+	static const int TIMEOUT_MARGIN_MS = 2000;
+
+	static const unsigned char COMMAND_NOTE_ON	= 0x90;
+	static const unsigned char COMMAND_NOTE_OFF	= 0x80;
+
+	Playback_Timing_Benchmark::Config::Config()
+	{
+		Pattern = Stream_Pattern::Mixed;
+		Duration_ms = 5000;
+		Interval_ms = 10.0;
+		Track_Count = 4;
+		Backend = Output_Backend::Recording;
+		Timestamp_Lead_us = 0;
+	}
+
+	Playback_Timing_Benchmark::Report Playback_Timing_Benchmark::Run(const Config& config)
+	{
+		Report Result = Report();
+		Result.Pattern = config.Pattern;
+		Result.Backend = config.Backend;
+		Result.Timestamp_Lead_us = (config.Timestamp_Lead_us > 0) ? config.Timestamp_Lead_us : 0;
+		Result.Latency_Histogram.assign(HISTOGRAM_BUCKET_COUNT, 0);
+
+		std::vector<Synthetic_Event> Events = Create_Stream(config);
+		Result.Event_Count = Events.size();
+
+		if (Events.empty()) {
+			return Result;
+		}
+
+		Playback_Clock_Steady Clock;
+		Playback_MIDI_Output_Recording Recording_Output(&Clock);
+		IMidiOutput* Output = &Recording_Output;
+
+		Recording_Output.Set_Timestamp_Lead_us(Result.Timestamp_Lead_us);
+
+#ifdef PLAYBACK_HAS_ALSA
+		Playback_MIDI_Output_ALSA ALSA_Output;
+		Playback_MIDI_Capture_ALSA Capture;
+		std::vector<Playback_MIDI_Capture_ALSA::Captured_Message> Captured;
+
+		if (config.Backend == Output_Backend::ALSA_Loopback)
+		{
+			if (!ALSA_Output.Open("MIDI Light Drawer Benchmark", -1, 0)) {
+				return Result;
+			}
+
+			if (Result.Timestamp_Lead_us > 0 && !ALSA_Output.Enable_Queue(&Clock, Result.Timestamp_Lead_us)) {
+				return Result;
+			}
+
+			if (!Capture.Open("MIDI Light Drawer Benchmark Capture", ALSA_Output.Get_Client_ID(), ALSA_Output.Get_Port(), &Clock)) {
+				return Result;
+			}
+
+			Captured.reserve(Events.size());
+			Output = &ALSA_Output;
+		}
+#else
+		if (config.Backend == Output_Backend::ALSA_Loopback) {
+			return Result;
+		}
+#endif
+
+		Result.Output_Available = true;
+
+		Playback_MIDI_Scheduler Scheduler(Output, &Clock);
+
+		double CPU_Start_ms = Get_Process_CPU_Time_ms();
+
+		Scheduler.Set_Position_us(0);
+		Scheduler.Start();
+
+		// The thread starts counting from zero after this point, latencies therefore include its start-up time
+		int64_t Origin_us = Clock.Now_us();
+
+		size_t Queued_Count = 0;
+		size_t Sent_Count = 0;
+		int64_t Timeout_us = Origin_us + static_cast<int64_t>((Events.back().Timestamp_ms + TIMEOUT_MARGIN_MS) * 1000.0);
+
+		while (Sent_Count + Scheduler.Get_Sent_Events_Dropped() < Events.size() && Clock.Now_us() < Timeout_us)
+		{
+			// Same feeding as the UI thread: fill the ring and keep the rest for later
+			while (Queued_Count < Events.size())
+			{
+				const Synthetic_Event& Source = Events[Queued_Count];
+
+				Playback_MIDI_Scheduler::MIDI_Event Event;
+				Event.Timestamp_ms	= Source.Timestamp_ms;
+				Event.Tick			= 0;
+				Event.Track			= Source.Track;
+				Event.Channel		= Source.Channel;
+				Event.Command		= Source.Command;
+				Event.Data1			= Source.Data1;
+				Event.Data2			= Source.Data2;
+
+				if (!Scheduler.Queue_Event(Event)) {
+					break;
+				}
+
+				Queued_Count++;
+			}
+
+			Playback_MIDI_Scheduler::MIDI_Event Sent_Event;
+			while (Scheduler.Pop_Sent_Event(Sent_Event)) {
+				Sent_Count++;
+			}
+
+#ifdef PLAYBACK_HAS_ALSA
+			if (Capture.Is_Open()) {
+				Capture.Read(Captured);
+			}
+#endif
+
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+
+		// Handed over is not delivered yet with a lead, and stopping cancels what is still pending
+		if (Result.Timestamp_Lead_us > 0) {
+			std::this_thread::sleep_for(std::chrono::microseconds(Result.Timestamp_Lead_us + DELIVERY_MARGIN_US));
+		}
+
+		Scheduler.Stop();
+
+#ifdef PLAYBACK_HAS_ALSA
+		if (Capture.Is_Open())
+		{
+			// Messages sent right away may still be on their way to the capture port
+			std::this_thread::sleep_for(std::chrono::microseconds(DELIVERY_MARGIN_US));
+			Capture.Read(Captured);
+			Capture.Close();
+		}
+
+		ALSA_Output.Close();
+#endif
+
+		Result.Wall_Time_ms = (Clock.Now_us() - Origin_us) / 1000.0;
+		Result.CPU_Time_ms = Get_Process_CPU_Time_ms() - CPU_Start_ms;
+		Result.CPU_Load_Percent = (Result.Wall_Time_ms > 0.0) ? 100.0 * Result.CPU_Time_ms / Result.Wall_Time_ms : 0.0;
+
+		// The queue is sent in order, so the n-th delivered message belongs to the n-th event
+		std::vector<int64_t> Delivery_Times;
+
+		if (config.Backend == Output_Backend::Recording)
+		{
+			for (const Playback_MIDI_Output_Recording::Recorded_Message& Message : Recording_Output.Get_Messages()) {
+				Delivery_Times.push_back(Message.Time_us);
+			}
+		}
+#ifdef PLAYBACK_HAS_ALSA
+		else
+		{
+			for (const Playback_MIDI_Capture_ALSA::Captured_Message& Message : Captured) {
+				Delivery_Times.push_back(Message.Time_us);
+			}
+		}
+#endif
+
+		if (Delivery_Times.size() > Events.size()) {
+			Delivery_Times.resize(Events.size());
+		}
+
+		Result.Sent_Count = Delivery_Times.size();
+
+		if (Delivery_Times.empty()) {
+			return Result;
+		}
+
+		std::vector<int64_t> Latencies;
+		Latencies.reserve(Delivery_Times.size());
+
+		size_t Current_Batch_Size = 0;
+		double Latency_Sum = 0.0;
+		double Latency_Square_Sum = 0.0;
+
+		for (size_t i = 0; i < Delivery_Times.size(); i++)
+		{
+			int64_t Due_us = Origin_us + static_cast<int64_t>(Events[i].Timestamp_ms * 1000.0) - Playback_MIDI_Scheduler::LOOKAHEAD_US;
+			int64_t Latency_us = Delivery_Times[i] - Due_us;
+
+			Latency_Sum += (double)Latency_us;
+			Latency_Square_Sum += (double)Latency_us * (double)Latency_us;
+
+			Latencies.push_back(Latency_us);
+
+			int Bucket = (Latency_us <= 0) ? 0 : static_cast<int>(Latency_us / HISTOGRAM_BUCKET_US);
+			Result.Latency_Histogram[(Bucket < HISTOGRAM_BUCKET_COUNT) ? Bucket : HISTOGRAM_BUCKET_COUNT - 1]++;
+
+			if (i > 0 && Delivery_Times[i] - Delivery_Times[i - 1] > BATCH_GAP_US)
+			{
+				Result.Batch_Count++;
+				Result.Batch_Size_Max = (Current_Batch_Size > Result.Batch_Size_Max) ? Current_Batch_Size : Result.Batch_Size_Max;
+				Current_Batch_Size = 0;
+			}
+
+			Current_Batch_Size++;
+		}
+
+		Result.Batch_Count++;
+		Result.Batch_Size_Max = (Current_Batch_Size > Result.Batch_Size_Max) ? Current_Batch_Size : Result.Batch_Size_Max;
+		Result.Batch_Size_Average = static_cast<double>(Delivery_Times.size()) / Result.Batch_Count;
+
+		double Latency_Mean = Latency_Sum / (double)Delivery_Times.size();
+		double Latency_Variance = Latency_Square_Sum / (double)Delivery_Times.size() - Latency_Mean * Latency_Mean;
+		Result.Latency_Std_Dev_us = (Latency_Variance > 0.0) ? std::sqrt(Latency_Variance) : 0.0;
+
+		std::sort(Latencies.begin(), Latencies.end());
+
+		Result.Latency_Min_us = Latencies.front();
+		Result.Latency_P50_us = Latencies[(Latencies.size() - 1) * 50 / 100];
+		Result.Latency_P99_us = Latencies[(Latencies.size() - 1) * 99 / 100];
+		Result.Latency_Max_us = Latencies.back();
+
+		return Result;
+	}
+
+	std::vector<Playback_Timing_Benchmark::Report> Playback_Timing_Benchmark::Run_All(int duration_ms)
+	{
+		std::vector<Report> Reports;
+
+		Config Strobe_Config;
+		Strobe_Config.Pattern = Stream_Pattern::Dense_Strobe;
+		Strobe_Config.Duration_ms = duration_ms;
+		Strobe_Config.Interval_ms = 5.0;
+		Reports.push_back(Run(Strobe_Config));
+
+		Config Chord_Config;
+		Chord_Config.Pattern = Stream_Pattern::RGB_Chords;
+		Chord_Config.Duration_ms = duration_ms;
+		Chord_Config.Interval_ms = 20.0;
+		Chord_Config.Track_Count = 8;
+		Reports.push_back(Run(Chord_Config));
+
+		Config Mixed_Config;
+		Mixed_Config.Duration_ms = duration_ms;
+		Reports.push_back(Run(Mixed_Config));
+
+		return Reports;
+	}
+
+	std::vector<Playback_Timing_Benchmark::Report> Playback_Timing_Benchmark::Run_Jitter_Comparison(const Config& config)
+	{
+		std::vector<Report> Reports;
+
+		Config Immediate_Config = config;
+		Immediate_Config.Timestamp_Lead_us = 0;
+		Reports.push_back(Run(Immediate_Config));
+
+		Reports.push_back(Run(config));
+
+		return Reports;
+	}
+
+	std::string Playback_Timing_Benchmark::Format_Comparison(const std::vector<Report>& reports)
+	{
+		char Line[256];
+		std::string Text;
+
+		Text += "Lead (us)   Delivered   Std dev (us)   p50 (us)   p99 (us)   max (us)\n";
+
+		for (const Report& Current : reports)
+		{
+			if (!Current.Output_Available)
+			{
+				snprintf(Line, sizeof(Line), "%9lld   %s output not available\n", (long long)Current.Timestamp_Lead_us, Backend_Name(Current.Backend));
+				Text += Line;
+				continue;
+			}
+
+			snprintf(Line, sizeof(Line), "%9lld   %9zu   %12.1f   %8lld   %8lld   %8lld\n",
+				(long long)Current.Timestamp_Lead_us, Current.Sent_Count, Current.Latency_Std_Dev_us,
+				(long long)Current.Latency_P50_us, (long long)Current.Latency_P99_us, (long long)Current.Latency_Max_us);
+			Text += Line;
+		}
+
+		return Text;
+	}
+
+	std::string Playback_Timing_Benchmark::Format_Report(const Report& report)
+	{
+		char Line[256];
+		std::string Text;
+
+		snprintf(Line, sizeof(Line), "Pattern: %s\n", Pattern_Name(report.Pattern));
+		Text += Line;
+		snprintf(Line, sizeof(Line), "Output: %s, timestamp lead %lld us%s\n", Backend_Name(report.Backend), (long long)report.Timestamp_Lead_us,
+			report.Output_Available ? "" : ", not available");
+		Text += Line;
+		snprintf(Line, sizeof(Line), "Events: %zu queued, %zu sent\n", report.Event_Count, report.Sent_Count);
+		Text += Line;
+		snprintf(Line, sizeof(Line), "Latency (us): min %lld, p50 %lld, p99 %lld, max %lld\n",
+			(long long)report.Latency_Min_us, (long long)report.Latency_P50_us, (long long)report.Latency_P99_us, (long long)report.Latency_Max_us);
+		Text += Line;
+		snprintf(Line, sizeof(Line), "Jitter: standard deviation %.1f us\n", report.Latency_Std_Dev_us);
+		Text += Line;
+		snprintf(Line, sizeof(Line), "Batches: %zu, average size %.2f, max size %zu\n", report.Batch_Count, report.Batch_Size_Average, report.Batch_Size_Max);
+		Text += Line;
+		snprintf(Line, sizeof(Line), "CPU: %.1f ms in %.1f ms wall time (%.2f%%)\n", report.CPU_Time_ms, report.Wall_Time_ms, report.CPU_Load_Percent);
+		Text += Line;
+
+		Text += "Latency histogram:\n";
+
+		for (int i = 0; i < (int)report.Latency_Histogram.size(); i++)
+		{
+			if (report.Latency_Histogram[i] == 0) {
+				continue;
+			}
+
+			if (i == (int)report.Latency_Histogram.size() - 1) {
+				snprintf(Line, sizeof(Line), "  >= %5lld us: %zu\n", (long long)(i * HISTOGRAM_BUCKET_US), report.Latency_Histogram[i]);
+			}
+			else {
+				snprintf(Line, sizeof(Line), "  %5lld - %5lld us: %zu\n", (long long)(i * HISTOGRAM_BUCKET_US), (long long)((i + 1) * HISTOGRAM_BUCKET_US), report.Latency_Histogram[i]);
+			}
+
+			Text += Line;
+		}
+
+		return Text;
+	}
+
+	std::vector<Playback_Timing_Benchmark::Synthetic_Event> Playback_Timing_Benchmark::Create_Stream(const Config& config)
+	{
+		std::vector<Synthetic_Event> Events;
+
+		if (config.Interval_ms <= 0.0 || config.Duration_ms <= 0) {
+			return Events;
+		}
+
+		if (config.Pattern == Stream_Pattern::Dense_Strobe || config.Pattern == Stream_Pattern::Mixed) {
+			Add_Strobe(Events, config);
+		}
+
+		if (config.Pattern == Stream_Pattern::RGB_Chords || config.Pattern == Stream_Pattern::Mixed) {
+			Add_Chords(Events, config);
+		}
+
+		// The scheduler expects the queue in timestamp order. Stable, so the off events stay in front of the on events
+		std::stable_sort(Events.begin(), Events.end(), [](const Synthetic_Event& a, const Synthetic_Event& b) {
+			return a.Timestamp_ms < b.Timestamp_ms;
+		});
+
+		return Events;
+	}
+
+	void Playback_Timing_Benchmark::Add_Strobe(std::vector<Synthetic_Event>& events, const Config& config)
+	{
+		bool Is_On = true;
+
+		for (double Time_ms = LEAD_IN_MS; Time_ms < LEAD_IN_MS + config.Duration_ms; Time_ms += config.Interval_ms)
+		{
+			Synthetic_Event Event;
+			Event.Timestamp_ms	= Time_ms;
+			Event.Track			= 0;
+			Event.Channel		= 0;
+			Event.Command		= Is_On ? COMMAND_NOTE_ON : COMMAND_NOTE_OFF;
+			Event.Data1			= 60;
+			Event.Data2			= Is_On ? 127 : 0;
+
+			events.push_back(Event);
+			Is_On = !Is_On;
+		}
+	}
+
+	void Playback_Timing_Benchmark::Add_Chords(std::vector<Synthetic_Event>& events, const Config& config)
+	{
+		int Step = 0;
+
+		for (double Time_ms = LEAD_IN_MS; Time_ms < LEAD_IN_MS + config.Duration_ms; Time_ms += config.Interval_ms, Step++)
+		{
+			for (int Track = 0; Track < config.Track_Count; Track++)
+			{
+				// Same layout as the color notes of a track: red, green and blue on consecutive notes
+				for (int Color = 0; Color < 3; Color++)
+				{
+					unsigned char Note = static_cast<unsigned char>(24 + (Track % 8) * 12 + Color);
+
+					if (Step > 0)
+					{
+						Synthetic_Event Off_Event;
+						Off_Event.Timestamp_ms	= Time_ms;
+						Off_Event.Track			= Track + 1;
+						Off_Event.Channel		= (Track + 1) % 16;
+						Off_Event.Command		= COMMAND_NOTE_OFF;
+						Off_Event.Data1			= Note;
+						Off_Event.Data2			= 0;
+
+						events.push_back(Off_Event);
+					}
+
+					Synthetic_Event On_Event;
+					On_Event.Timestamp_ms	= Time_ms;
+					On_Event.Track			= Track + 1;
+					On_Event.Channel		= (Track + 1) % 16;
+					On_Event.Command		= COMMAND_NOTE_ON;
+					On_Event.Data1			= Note;
+					On_Event.Data2			= static_cast<unsigned char>(1 + (Step * 37 + Color * 53) % 127);
+
+					events.push_back(On_Event);
+				}
+			}
+		}
+	}
+
+	double Playback_Timing_Benchmark::Get_Process_CPU_Time_ms()
+	{
+#if defined(_WIN32)
+		FILETIME Creation_Time, Exit_Time, Kernel_Time, User_Time;
+
+		if (!GetProcessTimes(GetCurrentProcess(), &Creation_Time, &Exit_Time, &Kernel_Time, &User_Time)) {
+			return 0.0;
+		}
+
+		ULARGE_INTEGER Kernel, User;
+		Kernel.LowPart = Kernel_Time.dwLowDateTime;
+		Kernel.HighPart = Kernel_Time.dwHighDateTime;
+		User.LowPart = User_Time.dwLowDateTime;
+		User.HighPart = User_Time.dwHighDateTime;
+
+		// FILETIME counts in 100 ns units
+		return (Kernel.QuadPart + User.QuadPart) / 10000.0;
+#else
+		// Process CPU time on POSIX systems
+		return 1000.0 * std::clock() / CLOCKS_PER_SEC;
+#endif
+	}
+
+	const char* Playback_Timing_Benchmark::Pattern_Name(Stream_Pattern pattern)
+	{
+		switch (pattern)
+		{
+			case Stream_Pattern::Dense_Strobe:	return "Dense strobe";
+			case Stream_Pattern::RGB_Chords:	return "RGB chords";
+			case Stream_Pattern::Mixed:			return "Mixed";
+		}
+
+		return "Unknown";
+	}
+
+	const char* Playback_Timing_Benchmark::Backend_Name(Output_Backend backend)
+	{
+		switch (backend)
+		{
+			case Output_Backend::Recording:		return "Recording";
+			case Output_Backend::ALSA_Loopback:	return "ALSA loopback";
+		}
+
+		return "Unknown";
+	}
+}
+
+#ifdef _MSC_VER
+#pragma managed(pop)
+#endif
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace MIDILightDrawer
+{
+	// Runs the MIDI scheduler against the recording output on the steady clock with a synthetic event stream
+	// and measures how late every event leaves the scheduler. Needs no MIDI device, audio or UI.
+	// Built with PLAYBACK_HAS_ALSA on Linux, the stream can also go through the ALSA sequencer to a capture port of the benchmark,
+	// which measures when the messages are actually delivered. Sent right away or ahead with timestamps, to compare the jitter of both
+	class Playback_Timing_Benchmark
+	{
+	public:
+		enum class Stream_Pattern
+		{
+			Dense_Strobe,		// One note toggled on and off at a short fixed interval
+			RGB_Chords,			// Red, green and blue note of every track switched at the same timestamp
+			Mixed				// Both patterns interleaved
+		};
+
+		enum class Output_Backend
+		{
+			Recording,			// Time of the send, or of the timestamp as an output without jitter would deliver it
+			ALSA_Loopback		// Arrival at an ALSA capture port, stamped by the sequencer. Only with PLAYBACK_HAS_ALSA
+		};
+
+		struct Config
+		{
+			Stream_Pattern Pattern;
+			int Duration_ms;
+			double Interval_ms;		// Distance between two strobe steps or two chords
+			int Track_Count;		// Number of tracks taking part in a chord
+			Output_Backend Backend;
+			int64_t Timestamp_Lead_us;	// 0 sends every event when it is due, otherwise the output delivers it at its timestamp
+
+			Config();
+		};
+
+		struct Report
+		{
+			Stream_Pattern Pattern;
+			Output_Backend Backend;
+			int64_t Timestamp_Lead_us;
+			bool Output_Available;		// False if the backend could not be opened, nothing was measured
+			size_t Event_Count;
+			size_t Sent_Count;			// Delivered messages
+
+			// Send time minus the time the scheduler is meant to send the event (timestamp minus lookahead)
+			int64_t Latency_Min_us;
+			int64_t Latency_P50_us;
+			int64_t Latency_P99_us;
+			int64_t Latency_Max_us;
+			double Latency_Std_Dev_us;				// Jitter
+			std::vector<size_t> Latency_Histogram;	// Buckets of HISTOGRAM_BUCKET_US, the last bucket collects everything above
+
+			// Messages sent back to back form one batch
+			size_t Batch_Count;
+			double Batch_Size_Average;
+			size_t Batch_Size_Max;
+
+			double Wall_Time_ms;
+			double CPU_Time_ms;			// Process CPU time spent during the run
+			double CPU_Load_Percent;	// CPU time relative to wall time, 100 equals one busy core
+		};
+
+		static const int64_t HISTOGRAM_BUCKET_US = 250;
+		static const int HISTOGRAM_BUCKET_COUNT = 20;
+
+		// Two sends closer than this are counted as one batch
+		static const int64_t BATCH_GAP_US = 50;
+
+		// Time after the last handover for the timestamped messages to be delivered
+		static const int64_t DELIVERY_MARGIN_US = 20000;
+
+		static Report Run(const Config& config);
+		static std::vector<Report> Run_All(int duration_ms);
+		static std::string Format_Report(const Report& report);
+
+		// The same stream sent right away and with the timestamp lead of the config, in this order
+		static std::vector<Report> Run_Jitter_Comparison(const Config& config);
+		static std::string Format_Comparison(const std::vector<Report>& reports);
+
+	private:
+		struct Synthetic_Event
+		{
+			double Timestamp_ms;
+			int Track;
+			int Channel;
+			unsigned char Command;
+			unsigned char Data1;
+			unsigned char Data2;
+		};
+
+		static std::vector<Synthetic_Event> Create_Stream(const Config& config);
+		static void Add_Strobe(std::vector<Synthetic_Event>& events, const Config& config);
+		static void Add_Chords(std::vector<Synthetic_Event>& events, const Config& config);
+		static double Get_Process_CPU_Time_ms();
+		static const char* Pattern_Name(Stream_Pattern pattern);
+		static const char* Backend_Name(Output_Backend backend);
+	};
+}
@@ -38,6 +38,10 @@ namespace MIDILightDrawer
 		_MIDI_Note_Blue = 4;	// E
 
 		_MIDI_Export_Anti_Flicker = false;
+		_MIDI_Export_Merge_Identical_Notes = false;
+
+		_MIDI_Fade_Adaptive_Steps = false;
+		_MIDI_Fade_Max_Step_Rate = 100;		// Steps per second
 
 		_ColorPresets = gcnew List<String^>();
 
@@ -60,6 +64,7 @@ namespace MIDILightDrawer
 		_Global_MIDI_Output_Channel = 1;     // Default to MIDI channel 1
 		_Selected_Audio_Output_Device = ""; // Empty string means use system default
 		_Audio_Buffer_Size = 1024;           // Default buffer size
+		_Playback_SysEx_Frames = false;
 
 		// Recent files defaults
 		_Recent_GP_Files = gcnew List<String^>();
@@ -108,12 +113,16 @@ namespace MIDILightDrawer
 		sb->AppendLine(String::Format("  \"MidiNoteGreen\": {0},", _MIDI_Note_Green));
 		sb->AppendLine(String::Format("  \"MidiNoteBlue\": {0},", _MIDI_Note_Blue));
 		sb->AppendLine(String::Format("  \"MidiExportAntiFlicker\": {0},", _MIDI_Export_Anti_Flicker ? "true" : "false"));
+		sb->AppendLine(String::Format("  \"MidiExportMergeIdenticalNotes\": {0},", _MIDI_Export_Merge_Identical_Notes ? "true" : "false"));
+		sb->AppendLine(String::Format("  \"MidiFadeAdaptiveSteps\": {0},", _MIDI_Fade_Adaptive_Steps ? "true" : "false"));
+		sb->AppendLine(String::Format("  \"MidiFadeMaxStepRate\": {0},", _MIDI_Fade_Max_Step_Rate));
 
 		// Add playback device settings
 		sb->AppendLine(String::Format("  \"SelectedMidiOutputDevice\": \"{0}\",", _Selected_MIDI_Output_Device->Replace("\"", "\\\"")));
 		sb->AppendLine(String::Format("  \"GlobalMidiOutputChannel\": {0},", _Global_MIDI_Output_Channel));
 		sb->AppendLine(String::Format("  \"SelectedAudioOutputDevice\": \"{0}\",", _Selected_Audio_Output_Device->Replace("\"", "\\\"")));
 		sb->AppendLine(String::Format("  \"AudioBufferSize\": {0},", _Audio_Buffer_Size));
+		sb->AppendLine(String::Format("  \"PlaybackSysExFrames\": {0},", _Playback_SysEx_Frames ? "true" : "false"));
 
 		// Add octave entries
 		sb->AppendLine("  \"OctaveEntries\": [");
@@ -264,6 +273,18 @@ namespace MIDILightDrawer
 					String^ valueStr = currentLine->Split(':')[1]->Trim();
 					_MIDI_Export_Anti_Flicker = (valueStr == "true");
 				}
+				else if (currentLine->StartsWith("\"MidiExportMergeIdenticalNotes\":")) {
+					String^ valueStr = currentLine->Split(':')[1]->Trim();
+					_MIDI_Export_Merge_Identical_Notes = (valueStr == "true");
+				}
+				else if (currentLine->StartsWith("\"MidiFadeAdaptiveSteps\":")) {
+					String^ valueStr = currentLine->Split(':')[1]->Trim();
+					_MIDI_Fade_Adaptive_Steps = (valueStr == "true");
+				}
+				else if (currentLine->StartsWith("\"MidiFadeMaxStepRate\":")) {
+					String^ valueStr = currentLine->Split(':')[1]->Trim();
+					_MIDI_Fade_Max_Step_Rate = Int32::Parse(valueStr);
+				}
 				// Parse playback device settings
 				else if (currentLine->StartsWith("\"SelectedMidiOutputDevice\":")) {
 					String^ valueStr = currentLine->Split(gcnew array<Char> {':'}, 2)[1]->Trim()->Trim('"');
@@ -281,6 +302,10 @@ namespace MIDILightDrawer
 					String^ valueStr = currentLine->Split(':')[1]->Trim();
 					_Audio_Buffer_Size = Int32::Parse(valueStr);
 				}
+				else if (currentLine->StartsWith("\"PlaybackSysExFrames\":")) {
+					String^ valueStr = currentLine->Split(':')[1]->Trim();
+					_Playback_SysEx_Frames = (valueStr == "true");
+				}
 
 				// Check for Color Preset settings
 				if (currentLine == "\"ColorPresets\": [") {
@@ -437,6 +462,42 @@ namespace MIDILightDrawer
 		Save_To_File();
 	}
 
+	bool Settings::MIDI_Export_Merge_Identical_Notes::get()
+	{
+		return _MIDI_Export_Merge_Identical_Notes;
+	}
+
+	void Settings::MIDI_Export_Merge_Identical_Notes::set(bool value)
+	{
+		_MIDI_Export_Merge_Identical_Notes = value;
+		Save_To_File();
+	}
+
+	bool Settings::MIDI_Fade_Adaptive_Steps::get()
+	{
+		return _MIDI_Fade_Adaptive_Steps;
+	}
+
+	void Settings::MIDI_Fade_Adaptive_Steps::set(bool value)
+	{
+		_MIDI_Fade_Adaptive_Steps = value;
+		Save_To_File();
+	}
+
+	int Settings::MIDI_Fade_Max_Step_Rate::get()
+	{
+		return _MIDI_Fade_Max_Step_Rate;
+	}
+
+	void Settings::MIDI_Fade_Max_Step_Rate::set(int value)
+	{
+		if (value < 1 || value > 1000)
+			throw gcnew ArgumentOutOfRangeException("value", "Fade step rate must be between 1 and 1000 steps per second");
+
+		_MIDI_Fade_Max_Step_Rate = value;
+		Save_To_File();
+	}
+
 	List<Settings::Octave_Entry^>^ Settings::Octave_Entries::get()
 	{
 		return _Octave_Entries;
@@ -534,6 +595,17 @@ namespace MIDILightDrawer
 		Save_To_File();
 	}
 
+	bool Settings::Playback_SysEx_Frames::get()
+	{
+		return _Playback_SysEx_Frames;
+	}
+
+	void Settings::Playback_SysEx_Frames::set(bool value)
+	{
+		_Playback_SysEx_Frames = value;
+		Save_To_File();
+	}
+
 	// Recent Files Properties
 	List<String^>^ Settings::Recent_GP_Files::get()
 	{
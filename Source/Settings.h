@@ -34,6 +34,10 @@ namespace MIDILightDrawer
 		int _MIDI_Note_Blue;
 
 		bool _MIDI_Export_Anti_Flicker;
+		bool _MIDI_Export_Merge_Identical_Notes;
+
+		bool _MIDI_Fade_Adaptive_Steps;
+		int _MIDI_Fade_Max_Step_Rate;
 
 		List<String^>^ _ColorPresets;
 
@@ -42,6 +46,7 @@ namespace MIDILightDrawer
 		int _Global_MIDI_Output_Channel;
 		String^ _Selected_Audio_Output_Device;
 		int _Audio_Buffer_Size;
+		bool _Playback_SysEx_Frames;
 
 		// Recent Files Lists
 		List<String^>^ _Recent_GP_Files;
@@ -90,6 +95,27 @@ namespace MIDILightDrawer
 			void set(bool value);
 		}
 
+		// Consecutive notes with the same color value are written as one longer note
+		property bool MIDI_Export_Merge_Identical_Notes
+		{
+			bool get();
+			void set(bool value);
+		}
+
+		// Fades place steps where the color changes by one MIDI velocity unit instead of every quantization step
+		property bool MIDI_Fade_Adaptive_Steps
+		{
+			bool get();
+			void set(bool value);
+		}
+
+		// Upper limit for adaptive fade steps per second
+		property int MIDI_Fade_Max_Step_Rate
+		{
+			int get();
+			void set(int value);
+		}
+
 		property List<Octave_Entry^>^ Octave_Entries
 		{
 			List<Octave_Entry^>^ get();
@@ -132,6 +158,13 @@ namespace MIDILightDrawer
 			void set(int value);
 		}
 
+		// Playback sends the note changes of a batch as SysEx light frames instead of note messages
+		property bool Playback_SysEx_Frames
+		{
+			bool get();
+			void set(bool value);
+		}
+
 		// Recent Files Properties
 		property List<String^>^ Recent_GP_Files
 		{
@@ -329,7 +329,9 @@ namespace MIDILightDrawer
 
 		this->_IgnoreForOverlap = false;
 
-		PreRasterMIDIEvents();
+		this->_Playback_Rastered_Events = nullptr;
+		this->_Raster_Version = 1;
+		this->_Playback_Rastered_Version = 0;
 	}
 
 	BarEvent::BarEvent(Track^ track, int start_tick, int duration_in_ticks, BarEventFadeInfo^ fade_info)
@@ -355,7 +357,9 @@ namespace MIDILightDrawer
 
 		this->_IgnoreForOverlap = false;
 
-		PreRasterMIDIEvents();
+		this->_Playback_Rastered_Events = nullptr;
+		this->_Raster_Version = 1;
+		this->_Playback_Rastered_Version = 0;
 	}
 
 	BarEvent::BarEvent(Track^ track, int start_tick, int duration_in_ticks, BarEventStrobeInfo^ strobe_info)
@@ -380,7 +384,9 @@ namespace MIDILightDrawer
 
 		this->_IgnoreForOverlap = false;
 
-		PreRasterMIDIEvents();
+		this->_Playback_Rastered_Events = nullptr;
+		this->_Raster_Version = 1;
+		this->_Playback_Rastered_Version = 0;
 	}
 
 	void BarEvent::BasicInfoCopyWorkingToOriginal()
@@ -396,11 +402,19 @@ namespace MIDILightDrawer
 		this->_Working.DurationInTicks	= this->_Original.DurationInTicks;
 		this->_Working.Track			= this->_Original.Track;
 
-		PreRasterMIDIEvents();
+		InvalidateRaster();
+	}
+
+	void BarEvent::InvalidateRaster()
+	{
+		// Only marks the cached events as stale, rasterization happens on the next read
+		this->_Raster_Version++;
 	}
 
 	void BarEvent::PreRasterMIDIEvents()
 	{
+		this->_Playback_Rastered_Version = this->_Raster_Version;
+
 		if (this->ContainingTrack == nullptr || this->ContainingTrack->Event_Raster == nullptr) {
 			this->_Playback_Rastered_Events = gcnew List<Playback_MIDI_Event^>;
 			return;
@@ -408,15 +422,24 @@ namespace MIDILightDrawer
 
 		MIDI_Event_Raster^ MIDI_Event_Raster = this->ContainingTrack->Event_Raster;
 
-		int Octave_Note_Offset = (this->ContainingTrack->Octave + MIDI_Event_Raster::OCTAVE_OFFSET) * MIDI_Event_Raster::NOTES_PER_OCTAVE;
-		this->_Playback_Rastered_Events = MIDI_Event_Raster->Raster_Bar_For_Playback(this, this->ContainingTrack->Index, Settings::Get_Instance()->Global_MIDI_Output_Channel, Octave_Note_Offset, Settings::Get_Instance()->MIDI_Export_Anti_Flicker);
+		Color_MIDI_Mapping Mapping = MIDI_Event_Raster::Capture_Playback_Color_MIDI_Mapping().For_Track(this->ContainingTrack->Index, this->ContainingTrack->Octave);
+		this->_Playback_Rastered_Events = MIDI_Event_Raster->Raster_Bar_For_Playback(this, Mapping);
+	}
+
+	List<Playback_MIDI_Event^>^ BarEvent::Playback_Rastered_Events::get()
+	{
+		if (this->_Playback_Rastered_Events == nullptr || this->_Playback_Rastered_Version != this->_Raster_Version) {
+			PreRasterMIDIEvents();
+		}
+
+		return this->_Playback_Rastered_Events;
 	}
 
 	void BarEvent::ContainingTrack::set(Track^ track)
 	{
 		_Working.Track = track;
 
-		PreRasterMIDIEvents();
+		InvalidateRaster();
 	}
 
 	void BarEvent::StartTick::set(int value)
@@ -426,7 +449,7 @@ namespace MIDILightDrawer
 		}
 		_Working.StartTick = value;
 
-		PreRasterMIDIEvents();
+		InvalidateRaster();
 	}
 
 	void BarEvent::Duration::set(int value)
@@ -435,7 +458,7 @@ namespace MIDILightDrawer
 			_Working.DurationInTicks = value;
 		}
 
-		PreRasterMIDIEvents();
+		InvalidateRaster();
 	}
 
 	System::Drawing::Color BarEvent::Color::get()
@@ -456,7 +479,7 @@ namespace MIDILightDrawer
 			this->_Color = color;
 		}
 
-		PreRasterMIDIEvents();
+		InvalidateRaster();
 	}
 		
 
@@ -466,7 +489,7 @@ namespace MIDILightDrawer
 		{
 			this->_FadeInfo = fade_info;
 
-			PreRasterMIDIEvents();
+			InvalidateRaster();
 		}
 	}
 
@@ -476,7 +499,7 @@ namespace MIDILightDrawer
 		{
 			this->_StrobeInfo = strobe_info;
 
-			PreRasterMIDIEvents();
+			InvalidateRaster();
 		}
 	}
 
@@ -317,9 +317,14 @@ namespace MIDILightDrawer
 
 		bool _IgnoreForOverlap;
 
+		// Pre-rastered events are computed on first access. Every change bumps _Raster_Version,
+		// the cached list is only valid while _Playback_Rastered_Version matches it
 		List<Playback_MIDI_Event^>^ _Playback_Rastered_Events;
+		unsigned int _Raster_Version;
+		unsigned int _Playback_Rastered_Version;
 
 	private:
+		void InvalidateRaster();
 		void PreRasterMIDIEvents();
 
 	public:
@@ -387,7 +392,7 @@ namespace MIDILightDrawer
 		}
 
 		property List<Playback_MIDI_Event^>^ Playback_Rastered_Events{
-			List<Playback_MIDI_Event^>^ get() { return _Playback_Rastered_Events; }
+			List<Playback_MIDI_Event^>^ get();
 		}
 	};
 
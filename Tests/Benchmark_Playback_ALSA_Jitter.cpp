@@ -0,0 +1,41 @@
+#include "Playback_Timing_Benchmark.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+using namespace MIDILightDrawer;
+
+// Sends the mixed stream through an ALSA sequencer loopback, once right away and once with a timestamp lead,
+// and prints the arrival jitter of both. Usage: Benchmark_Playback_ALSA_Jitter [lead_us] [duration_ms].
+// Returns 1 if the sequencer could not be opened
+static const int64_t DEFAULT_LEAD_US	= 20000;
+static const int DEFAULT_DURATION_MS	= 5000;
+
+int main(int argc, char** argv)
+{
+	Playback_Timing_Benchmark::Config Config;
+	Config.Pattern				= Playback_Timing_Benchmark::Stream_Pattern::Mixed;
+	Config.Backend				= Playback_Timing_Benchmark::Output_Backend::ALSA_Loopback;
+	Config.Timestamp_Lead_us	= (argc > 1) ? atoll(argv[1]) : DEFAULT_LEAD_US;
+	Config.Duration_ms			= (argc > 2) ? atoi(argv[2]) : DEFAULT_DURATION_MS;
+
+	if (Config.Timestamp_Lead_us <= 0) {
+		Config.Timestamp_Lead_us = DEFAULT_LEAD_US;
+	}
+
+	if (Config.Duration_ms <= 0) {
+		Config.Duration_ms = DEFAULT_DURATION_MS;
+	}
+
+	std::vector<Playback_Timing_Benchmark::Report> Reports = Playback_Timing_Benchmark::Run_Jitter_Comparison(Config);
+	bool Available = true;
+
+	for (const Playback_Timing_Benchmark::Report& Current : Reports) {
+		Available &= Current.Output_Available;
+	}
+
+	printf("%s", Playback_Timing_Benchmark::Format_Comparison(Reports).c_str());
+
+	return Available ? 0 : 1;
+}
@@ -0,0 +1,32 @@
+#include "Playback_Timing_Benchmark.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+using namespace MIDILightDrawer;
+
+// Runs every stream pattern of Playback_Timing_Benchmark against the recording output and prints the reports.
+// Usage: Benchmark_Playback_Timing [duration_ms]. Returns 1 if a run did not deliver all of its events
+static const int DEFAULT_DURATION_MS = 5000;
+
+int main(int argc, char** argv)
+{
+	int Duration_ms = (argc > 1) ? atoi(argv[1]) : DEFAULT_DURATION_MS;
+
+	if (Duration_ms <= 0) {
+		Duration_ms = DEFAULT_DURATION_MS;
+	}
+
+	std::vector<Playback_Timing_Benchmark::Report> Reports = Playback_Timing_Benchmark::Run_All(Duration_ms);
+	bool Complete = true;
+
+	for (const Playback_Timing_Benchmark::Report& Current : Reports)
+	{
+		printf("%s\n", Playback_Timing_Benchmark::Format_Report(Current).c_str());
+
+		Complete &= Current.Output_Available && Current.Sent_Count == Current.Event_Count;
+	}
+
+	return Complete ? 0 : 1;
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstdio>
+
+// Minimal checks for the headless playback tests. A failed check is printed and the test continues,
+// the test returns Test_Result() from main so CTest sees the failure
+namespace MIDILightDrawer_Tests
+{
+	inline int& Failure_Count()
+	{
+		static int Count = 0;
+		return Count;
+	}
+
+	inline int Test_Result()
+	{
+		if (Failure_Count() > 0) {
+			printf("%d check(s) failed\n", Failure_Count());
+			return 1;
+		}
+
+		printf("All checks passed\n");
+		return 0;
+	}
+}
+
+#define TEST_CHECK(condition) \
+	do { \
+		if (!(condition)) { \
+			printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+			MIDILightDrawer_Tests::Failure_Count()++; \
+		} \
+	} while (0)
+
+#define TEST_CHECK_MESSAGE(condition, ...) \
+	do { \
+		if (!(condition)) { \
+			printf("%s:%d: check failed: %s: ", __FILE__, __LINE__, #condition); \
+			printf(__VA_ARGS__); \
+			printf("\n"); \
+			MIDILightDrawer_Tests::Failure_Count()++; \
+		} \
+	} while (0)
@@ -0,0 +1,187 @@
+#include "Test_Common.h"
+
+#include "Playback_Clock.h"
+#include "Playback_Audio_Clock.h"
+
+#include <atomic>
+#include <thread>
+
+using namespace MIDILightDrawer;
+
+// Host time under the control of the test. Waits move it forward instead of sleeping
+class Fake_Clock : public IClock
+{
+private:
+	std::atomic<int64_t> _Now_us;
+
+public:
+	Fake_Clock(int64_t start_us) : _Now_us(start_us) { }
+
+	int64_t Now_us() override				{ return _Now_us.load(); }
+	void Wait_For_us(int64_t timeout_us) override	{ _Now_us.fetch_add(timeout_us); }
+	void Wake() override					{ }
+	void Advance_us(int64_t duration_us)	{ _Now_us.fetch_add(duration_us); }
+};
+
+static void Test_Interpolation()
+{
+	Fake_Clock Clock(5000000);
+	Playback_Audio_Clock Audio_Clock;
+	int64_t Position_us = 0;
+
+	TEST_CHECK(!Audio_Clock.Get_Position_us(Clock.Now_us(), Position_us));
+
+	Audio_Clock.Publish(1000000, Clock.Now_us());
+
+	TEST_CHECK(Audio_Clock.Get_Position_us(Clock.Now_us(), Position_us));
+	TEST_CHECK(Position_us == 1000000);
+
+	// Between two anchors the position runs with the host time
+	Clock.Advance_us(250);
+	TEST_CHECK(Audio_Clock.Get_Position_us(Clock.Now_us(), Position_us));
+	TEST_CHECK(Position_us == 1000250);
+
+	Clock.Advance_us(10000);
+	Audio_Clock.Publish(1010000, Clock.Now_us() - 250);
+	TEST_CHECK(Audio_Clock.Get_Position_us(Clock.Now_us(), Position_us));
+	TEST_CHECK(Position_us == 1010250);
+
+	// A host time before the anchor, e.g. read by another thread before the publication, goes back by the same amount
+	TEST_CHECK(Audio_Clock.Get_Position_us(Clock.Now_us() - 1250, Position_us));
+	TEST_CHECK(Position_us == 1009000);
+
+	Audio_Clock.Invalidate();
+	TEST_CHECK(!Audio_Clock.Get_Position_us(Clock.Now_us(), Position_us));
+}
+
+static void Test_Extrapolation_Cap()
+{
+	Fake_Clock Clock(0);
+	Playback_Audio_Clock Audio_Clock;
+	int64_t Position_us = 0;
+
+	Audio_Clock.Publish(2000000, Clock.Now_us());
+
+	// Right at the cap the position still follows the host time
+	Clock.Advance_us(Playback_Audio_Clock::MAX_EXTRAPOLATION_US);
+	TEST_CHECK(Audio_Clock.Get_Position_us(Clock.Now_us(), Position_us));
+	TEST_CHECK(Position_us == 2000000 + Playback_Audio_Clock::MAX_EXTRAPOLATION_US);
+
+	// The audio thread stalls: the position holds instead of running away from the audio
+	Clock.Advance_us(1);
+	TEST_CHECK(Audio_Clock.Get_Position_us(Clock.Now_us(), Position_us));
+	TEST_CHECK(Position_us == 2000000 + Playback_Audio_Clock::MAX_EXTRAPOLATION_US);
+
+	Clock.Wait_For_us(5000000);
+	TEST_CHECK(Audio_Clock.Get_Position_us(Clock.Now_us(), Position_us));
+	TEST_CHECK(Position_us == 2000000 + Playback_Audio_Clock::MAX_EXTRAPOLATION_US);
+
+	// The next anchor takes over again
+	Audio_Clock.Publish(2150000, Clock.Now_us());
+	Clock.Advance_us(40);
+	TEST_CHECK(Audio_Clock.Get_Position_us(Clock.Now_us(), Position_us));
+	TEST_CHECK(Position_us == 2150040);
+
+	Playback_Audio_Clock::Anchor Anchor;
+	Anchor.Audio_Position_us = 0;
+	Anchor.Host_Time_us = 0;
+	TEST_CHECK(Playback_Audio_Clock::Interpolate_us(Anchor, INT64_MAX / 2) == Playback_Audio_Clock::MAX_EXTRAPOLATION_US);
+}
+
+static void Test_Device_Position()
+{
+	TEST_CHECK(Playback_Audio_Clock::Device_Position_To_us(0, 48000) == 0);
+	TEST_CHECK(Playback_Audio_Clock::Device_Position_To_us(48000 * 3 + 24000, 48000) == 3500000);
+	TEST_CHECK(Playback_Audio_Clock::Device_Position_To_us(1, 44100) == 22);
+	TEST_CHECK(Playback_Audio_Clock::Device_Position_To_us(12345, 0) == 0);
+
+	// 30 days on the 10 MHz position counter of WASAPI. Multiplied by 10^6 first, the position would overflow 64 bits
+	const uint64_t Frequency = 10000000;
+	const uint64_t Position = 30ULL * 24 * 3600 * Frequency + 1234567;
+
+	TEST_CHECK(Position > UINT64_MAX / 1000000ULL);
+	TEST_CHECK(Playback_Audio_Clock::Device_Position_To_us(Position, Frequency) == 30LL * 24 * 3600 * 1000000 + 123456);
+
+	// Same at a sample rate frequency, the remainder keeps its fraction of a second
+	const uint64_t Sample_Rate = 192000;
+	const uint64_t Frames = 1000000ULL * 24 * 3600 * Sample_Rate + 96000;
+
+	TEST_CHECK(Frames > UINT64_MAX / 1000000ULL);
+	TEST_CHECK(Playback_Audio_Clock::Device_Position_To_us(Frames, Sample_Rate) == 1000000LL * 24 * 3600 * 1000000 + 500000);
+}
+
+static void Test_Seqlock()
+{
+	// The writer publishes pairs with a fixed distance between host time and position. A reader that ever sees
+	// one half of an old anchor with one half of a new one gets a different distance
+	const int64_t Offset_us = 777777;
+	const int PUBLISH_COUNT = 200000;
+
+	Fake_Clock Clock(Offset_us);
+	Playback_Audio_Clock Audio_Clock;
+	Audio_Clock.Publish(0, Clock.Now_us());
+
+	std::atomic<bool> Writer_Done(false);
+	std::atomic<int> Torn_Reads(0);
+	std::atomic<int> Backward_Reads(0);
+	std::atomic<int> Read_Count(0);
+
+	std::thread Reader([&]() {
+		int64_t Last_Position_us = 0;
+
+		while (!Writer_Done.load())
+		{
+			Playback_Audio_Clock::Anchor Anchor;
+
+			if (!Audio_Clock.Get_Anchor(Anchor)) {
+				continue;
+			}
+
+			if (Anchor.Host_Time_us - Anchor.Audio_Position_us != Offset_us) {
+				Torn_Reads++;
+			}
+
+			if (Anchor.Audio_Position_us < Last_Position_us) {
+				Backward_Reads++;
+			}
+
+			Last_Position_us = Anchor.Audio_Position_us;
+			Read_Count++;
+		}
+	});
+
+	for (int i = 1; i <= PUBLISH_COUNT; i++)
+	{
+		Clock.Advance_us(10);
+		Audio_Clock.Publish(Clock.Now_us() - Offset_us, Clock.Now_us());
+
+		if (i % 1000 == 0) {
+			std::this_thread::yield();
+		}
+	}
+
+	Writer_Done.store(true);
+	Reader.join();
+
+	printf("Seqlock: %d reads during %d publications\n", Read_Count.load(), PUBLISH_COUNT);
+
+	TEST_CHECK_MESSAGE(Torn_Reads.load() == 0, "%d torn anchors", Torn_Reads.load());
+	TEST_CHECK_MESSAGE(Backward_Reads.load() == 0, "%d anchors older than the one read before", Backward_Reads.load());
+
+	Playback_Audio_Clock::Anchor Last_Anchor;
+	TEST_CHECK(Audio_Clock.Get_Anchor(Last_Anchor));
+	TEST_CHECK(Last_Anchor.Audio_Position_us == PUBLISH_COUNT * 10LL);
+
+	Audio_Clock.Invalidate();
+	TEST_CHECK(!Audio_Clock.Get_Anchor(Last_Anchor));
+}
+
+int main()
+{
+	Test_Interpolation();
+	Test_Extrapolation_Cap();
+	Test_Device_Position();
+	Test_Seqlock();
+
+	return MIDILightDrawer_Tests::Test_Result();
+}
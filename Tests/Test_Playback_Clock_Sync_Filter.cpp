@@ -0,0 +1,240 @@
+#include "Test_Common.h"
+
+#include "Playback_Clock_Sync_Filter.h"
+
+#include <cmath>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <sstream>
+
+using namespace MIDILightDrawer;
+
+// Feeds recorded (host time, audio position) traces from Traces/ through the filter and reads the position
+// every millisecond in between, as the playback thread does between two observations
+struct Trace_Entry
+{
+	bool Is_Seek;				// The playback seeks here, the filter is reset
+	int64_t Host_Time_us;
+	int64_t Audio_Position_us;
+};
+
+struct Trace_Result
+{
+	size_t Observation_Count;
+	size_t Reset_Count;
+	uint64_t Resync_Count;
+	size_t Backward_Steps;				// Outside the first reading after a reset or resync
+	double Rate;						// Estimate at the end of the trace
+	double Settled_Rate_Average;		// Average estimate after the settle time, the estimate wanders with the jitter of the feed
+	double Settled_Error_Max_us;		// Against the true timeline, after the settle time
+};
+
+static const int64_t QUERY_INTERVAL_US	= 1000;
+static const int64_t TRACE_ORIGIN_US	= 1000000;	// Host time of audio position 0 in the traces
+static const int64_t SETTLE_TIME_US		= 3000000;
+
+static bool Load_Trace(const char* filename, std::vector<Trace_Entry>& entries)
+{
+	std::ifstream File(std::string("Traces/") + filename);
+
+	if (!File) {
+		return false;
+	}
+
+	std::string Line;
+
+	while (std::getline(File, Line))
+	{
+		if (Line.empty() || Line[0] == '#') {
+			continue;
+		}
+
+		Trace_Entry Entry = Trace_Entry();
+
+		if (Line == "seek")
+		{
+			Entry.Is_Seek = true;
+			entries.push_back(Entry);
+			continue;
+		}
+
+		char Separator = 0;
+		long long Host_Time_us = 0;
+		long long Audio_Position_us = 0;
+
+		std::istringstream Stream(Line);
+		Stream >> Host_Time_us >> Separator >> Audio_Position_us;
+
+		if (!Stream || Separator != ',') {
+			return false;
+		}
+
+		Entry.Host_Time_us = Host_Time_us;
+		Entry.Audio_Position_us = Audio_Position_us;
+		entries.push_back(Entry);
+	}
+
+	return !entries.empty();
+}
+
+// true_rate > 0 measures the error against the timeline audio = (host - origin) * true_rate
+static Trace_Result Run_Trace(const std::vector<Trace_Entry>& entries, double true_rate)
+{
+	Trace_Result Result = Trace_Result();
+	Playback_Clock_Sync_Filter Filter;
+
+	int64_t Last_Output_us = INT64_MIN;
+	int64_t Last_Host_Time_us = INT64_MIN;
+	bool Step_Allowed = true;		// The first reading after a reset may go anywhere
+	uint64_t Resync_Count = 0;
+	double Settled_Rate_Sum = 0.0;
+	size_t Settled_Rate_Count = 0;
+
+	for (const Trace_Entry& Entry : entries)
+	{
+		if (Entry.Is_Seek)
+		{
+			Filter.Reset();
+			Result.Reset_Count++;
+			Step_Allowed = true;
+			continue;
+		}
+
+		int64_t Position_us = 0;
+
+		if (Last_Host_Time_us == INT64_MIN) {
+			TEST_CHECK(!Filter.Get_Position_us(Entry.Host_Time_us, Position_us));
+		}
+
+		// Readings of the playback thread until the next observation
+		for (int64_t Host_Time_us = Last_Host_Time_us + QUERY_INTERVAL_US; Last_Host_Time_us != INT64_MIN && Host_Time_us < Entry.Host_Time_us; Host_Time_us += QUERY_INTERVAL_US)
+		{
+			if (!Filter.Get_Position_us(Host_Time_us, Position_us)) {
+				continue;
+			}
+
+			if (Position_us < Last_Output_us && !Step_Allowed) {
+				Result.Backward_Steps++;
+			}
+
+			if (true_rate > 0.0 && Host_Time_us - TRACE_ORIGIN_US > SETTLE_TIME_US)
+			{
+				double Error_us = std::fabs((double)Position_us - (double)(Host_Time_us - TRACE_ORIGIN_US) * true_rate);
+				Result.Settled_Error_Max_us = (Error_us > Result.Settled_Error_Max_us) ? Error_us : Result.Settled_Error_Max_us;
+			}
+
+			Last_Output_us = Position_us;
+			Step_Allowed = false;
+		}
+
+		Filter.Update(Entry.Audio_Position_us, Entry.Host_Time_us);
+		Result.Observation_Count++;
+
+		// Locked from the first observation on
+		TEST_CHECK(Filter.Is_Locked());
+
+		if (Entry.Host_Time_us - TRACE_ORIGIN_US > SETTLE_TIME_US)
+		{
+			Settled_Rate_Sum += Filter.Get_Rate();
+			Settled_Rate_Count++;
+		}
+
+		if (Filter.Get_Resync_Count() != Resync_Count)
+		{
+			Resync_Count = Filter.Get_Resync_Count();
+			Step_Allowed = true;
+		}
+
+		Last_Host_Time_us = Entry.Host_Time_us;
+	}
+
+	Result.Resync_Count = Filter.Get_Resync_Count();
+	Result.Rate = Filter.Get_Rate();
+	Result.Settled_Rate_Average = (Settled_Rate_Count > 0) ? Settled_Rate_Sum / (double)Settled_Rate_Count : 0.0;
+
+	return Result;
+}
+
+static void Test_Trace(const char* filename, double true_rate, size_t expected_resets, uint64_t expected_resyncs, double max_rate_error, double max_error_us)
+{
+	std::vector<Trace_Entry> Entries;
+	bool Loaded = Load_Trace(filename, Entries);
+
+	TEST_CHECK_MESSAGE(Loaded, "%s", filename);
+
+	if (!Loaded) {
+		return;
+	}
+
+	Trace_Result Result = Run_Trace(Entries, true_rate);
+
+	printf("%-36s %5zu observations, rate %.6f (average %.6f), settled error max %6.0f us, resets %zu, resyncs %llu, backward steps %zu\n",
+		filename, Result.Observation_Count, Result.Rate, Result.Settled_Rate_Average, Result.Settled_Error_Max_us, Result.Reset_Count, (unsigned long long)Result.Resync_Count, Result.Backward_Steps);
+
+	TEST_CHECK_MESSAGE(Result.Backward_Steps == 0, "%s", filename);
+	TEST_CHECK_MESSAGE(Result.Reset_Count == expected_resets, "%s", filename);
+	TEST_CHECK_MESSAGE(Result.Resync_Count == expected_resyncs, "%s", filename);
+
+	if (true_rate > 0.0)
+	{
+		TEST_CHECK_MESSAGE(std::fabs(Result.Settled_Rate_Average - true_rate) <= max_rate_error, "%s: rate %.6f, expected %.6f", filename, Result.Settled_Rate_Average, true_rate);
+		TEST_CHECK_MESSAGE(Result.Settled_Error_Max_us <= max_error_us, "%s: error %.0f us", filename, Result.Settled_Error_Max_us);
+	}
+}
+
+static void Test_Resync_Threshold()
+{
+	// Exact observations keep the rate at 1.0, so the error of the jump is exactly its size
+	Playback_Clock_Sync_Filter Filter;
+	int64_t Host_Time_us = 0;
+	int64_t Audio_Position_us = 0;
+	int64_t Position_us = 0;
+
+	for (int i = 0; i < 10; i++, Host_Time_us += 10000, Audio_Position_us += 10000) {
+		Filter.Update(Audio_Position_us, Host_Time_us);
+	}
+
+	TEST_CHECK(Filter.Get_Rate() == 1.0);
+
+	// Up to the threshold the jump is treated as an error of the clock and pulled in gradually
+	Audio_Position_us += Playback_Clock_Sync_Filter::RESYNC_THRESHOLD_US;
+	Filter.Update(Audio_Position_us, Host_Time_us);
+
+	TEST_CHECK(Filter.Get_Resync_Count() == 0);
+	TEST_CHECK(Filter.Get_Position_us(Host_Time_us, Position_us));
+	TEST_CHECK(Position_us < Audio_Position_us);
+
+	// Beyond it the filter locks to the new position at once
+	Filter.Reset();
+	Filter.Update(0, 0);
+	Filter.Update(10000, 10000);
+
+	Filter.Update(20000 + Playback_Clock_Sync_Filter::RESYNC_THRESHOLD_US + 1, 20000);
+
+	TEST_CHECK(Filter.Get_Resync_Count() == 1);
+	TEST_CHECK(Filter.Is_Locked());
+	TEST_CHECK(Filter.Get_Position_us(20000, Position_us));
+	TEST_CHECK(Position_us == 20000 + Playback_Clock_Sync_Filter::RESYNC_THRESHOLD_US + 1);
+
+	// Same backwards, and the position may step back after the relock
+	Filter.Update(30000 - Playback_Clock_Sync_Filter::RESYNC_THRESHOLD_US - 1, 30000);
+
+	TEST_CHECK(Filter.Get_Resync_Count() == 2);
+	TEST_CHECK(Filter.Get_Position_us(30000, Position_us));
+	TEST_CHECK(Position_us == 30000 - Playback_Clock_Sync_Filter::RESYNC_THRESHOLD_US - 1);
+}
+
+int main()
+{
+	Test_Resync_Threshold();
+
+	// The render clock is read together with its host time, the error is the quantization to sample frames.
+	// The UI feed reads the position up to 4 ms late, 2 ms on average
+	Test_Trace("Render_Clock_10ms.csv",				1.0,	0, 0, 50e-6, 500.0);
+	Test_Trace("Render_Clock_10ms_Drift_Fast.csv",	1.0005,	0, 0, 50e-6, 500.0);
+	Test_Trace("UI_Feed_16ms_Drift_Slow.csv",		0.9995,	0, 0, 100e-6, 5000.0);
+	Test_Trace("Render_Clock_10ms_Seek_Stall.csv",	0.0,	1, 1, 0.0, 0.0);
+
+	return MIDILightDrawer_Tests::Test_Result();
+}
@@ -0,0 +1,98 @@
+#include "Test_Common.h"
+
+#include "Playback_MIDI_Engine_Metrics.h"
+
+#include <algorithm>
+#include <string>
+
+using namespace MIDILightDrawer;
+
+// Counters of Playback_MIDI_Engine_Metrics and the CSV rows saved from the metrics recording
+typedef Playback_MIDI_Engine_Metrics::Snapshot Snapshot;
+
+static Snapshot Create_Snapshot(int64_t time_us, uint64_t events_sent)
+{
+	Snapshot Result = Snapshot();
+	Result.Time_us				= time_us;
+	Result.Position_us			= time_us - 249500;
+	Result.Events_Sent			= events_sent;
+	Result.Batch_Count			= 50;
+	Result.Wakeup_Count			= 60;
+	Result.Spin_Count			= 7;
+	Result.Queue_Depth			= 3;
+	Result.Queue_Depth_Max		= 12;
+	Result.Late_Count			= 2;
+	Result.Lateness_Max_us		= 1500;
+	Result.Lateness_Average_us	= 250.5;
+	Result.Send_Call_Count		= events_sent;
+	Result.Send_Time_Total_us	= 3675;
+	Result.Send_Time_Max_us		= 80;
+	Result.Send_Time_Average_us	= 12.25;
+
+	return Result;
+}
+
+static void Test_Counters()
+{
+	Playback_MIDI_Engine_Metrics Metrics;
+
+	Metrics.Add_Event_Sent();
+	Metrics.Add_Event_Sent();
+	Metrics.Add_Batch();
+	Metrics.Add_Wakeup();
+	Metrics.Add_Spin();
+	Metrics.Set_Queue_Depth(9);
+	Metrics.Set_Queue_Depth(4);
+
+	// Early sends count as no lateness, only the one beyond LATE_THRESHOLD_US is late
+	Metrics.Add_Lateness(-200);
+	Metrics.Add_Lateness(400);
+	Metrics.Add_Lateness(Playback_MIDI_Engine_Metrics::LATE_THRESHOLD_US + 500);
+
+	Snapshot Current = Metrics.Get_Snapshot();
+
+	TEST_CHECK(Current.Events_Sent == 2 && Current.Batch_Count == 1 && Current.Wakeup_Count == 1 && Current.Spin_Count == 1);
+	TEST_CHECK(Current.Queue_Depth == 4 && Current.Queue_Depth_Max == 9);
+	TEST_CHECK(Current.Late_Count == 1);
+	TEST_CHECK(Current.Lateness_Max_us == Playback_MIDI_Engine_Metrics::LATE_THRESHOLD_US + 500);
+	TEST_CHECK(Current.Lateness_Average_us == (400.0 + Playback_MIDI_Engine_Metrics::LATE_THRESHOLD_US + 500) / 3.0);
+
+	Metrics.Reset();
+	Current = Metrics.Get_Snapshot();
+
+	TEST_CHECK(Current.Events_Sent == 0 && Current.Queue_Depth_Max == 0 && Current.Lateness_Max_us == 0 && Current.Lateness_Average_us == 0.0);
+}
+
+static void Test_CSV_Row()
+{
+	Snapshot Previous = Create_Snapshot(1000000, 100);
+	Snapshot Current = Create_Snapshot(1500000, 300);
+
+	// 200 events in half a second
+	std::string Row = Playback_MIDI_Engine_Metrics::Format_CSV_Row(Current, &Previous);
+	std::string Expected = "1500.000,1250.500,300,400.0,50,60,7,3,12,2,1500,250.5,300,80,12.25\n";
+
+	TEST_CHECK_MESSAGE(Row == Expected, "row is %s", Row.c_str());
+
+	// One value per column of the header
+	std::string Header = Playback_MIDI_Engine_Metrics::Format_CSV_Header();
+
+	TEST_CHECK(std::count(Row.begin(), Row.end(), ',') == std::count(Header.begin(), Header.end(), ','));
+	TEST_CHECK(Header.back() == '\n');
+
+	// The first row of a recording has no rate, neither has a row after the counters were reset by a new start
+	Row = Playback_MIDI_Engine_Metrics::Format_CSV_Row(Current, nullptr);
+	TEST_CHECK_MESSAGE(Row.find(",300,0.0,") != std::string::npos, "row is %s", Row.c_str());
+
+	Snapshot Restarted = Create_Snapshot(1600000, 10);
+	Row = Playback_MIDI_Engine_Metrics::Format_CSV_Row(Restarted, &Current);
+	TEST_CHECK_MESSAGE(Row.find(",10,0.0,") != std::string::npos, "row is %s", Row.c_str());
+}
+
+int main()
+{
+	Test_Counters();
+	Test_CSV_Row();
+
+	return MIDILightDrawer_Tests::Test_Result();
+}
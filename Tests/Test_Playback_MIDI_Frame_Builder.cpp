@@ -0,0 +1,158 @@
+#include "Test_Common.h"
+
+#include "Playback_MIDI_Frame_Builder.h"
+
+#include <vector>
+
+using namespace MIDILightDrawer;
+
+// Byte layout of the SysEx light frames as documented in Playback_MIDI_Frame_Builder.h
+static const unsigned char FRAME_HEADER[] = { 0xF0, 0x7D, 'L', 'D', 0x01 };
+
+static std::vector<unsigned char> Get_Frame(const Playback_MIDI_Frame_Builder& builder, size_t index)
+{
+	size_t Length = 0;
+	const unsigned char* Data = builder.Get_Frame(index, Length);
+
+	return (Data == nullptr) ? std::vector<unsigned char>() : std::vector<unsigned char>(Data, Data + Length);
+}
+
+static bool Has_Header(const std::vector<unsigned char>& frame)
+{
+	if (frame.size() < Playback_MIDI_Frame_Builder::HEADER_BYTES + 1) {
+		return false;
+	}
+
+	for (size_t i = 0; i < Playback_MIDI_Frame_Builder::HEADER_BYTES; i++)
+	{
+		if (frame[i] != FRAME_HEADER[i]) {
+			return false;
+		}
+	}
+
+	return frame.back() == Playback_MIDI_Frame_Builder::SYSEX_END;
+}
+
+static void Test_Layout()
+{
+	Playback_MIDI_Frame_Builder Builder;
+
+	// Added out of order on two channels, the frame lists channel 0 first and the notes ascending
+	TEST_CHECK(Builder.Add(0x92, 40, 100));
+	TEST_CHECK(Builder.Add(0x90, 62, 127));
+	TEST_CHECK(Builder.Add(0x80, 61, 0));
+	TEST_CHECK(Builder.Add(0x90, 60, 0));
+
+	TEST_CHECK(Builder.Finish() == 1);
+
+	const unsigned char Expected[] = {
+		0xF0, 0x7D, 0x4C, 0x44, 0x01,
+		0x00, 0x03, 60, 0, 61, 0, 62, 127,
+		0x02, 0x01, 40, 100,
+		0xF7
+	};
+
+	std::vector<unsigned char> Frame = Get_Frame(Builder, 0);
+
+	TEST_CHECK_MESSAGE(Frame == std::vector<unsigned char>(Expected, Expected + sizeof(Expected)), "frame of %zu bytes differs from the documented layout", Frame.size());
+	TEST_CHECK(Builder.Is_Empty());
+}
+
+// A color change within a batch: the Note Off and the Note On of the same light become one entry with the new value
+static void Test_Off_On_Collapses()
+{
+	Playback_MIDI_Frame_Builder Builder;
+
+	Builder.Add(0x81, 48, 0);
+	Builder.Add(0x91, 48, 90);
+
+	TEST_CHECK(Builder.Finish() == 1);
+
+	const unsigned char Expected[] = { 0xF0, 0x7D, 0x4C, 0x44, 0x01, 0x01, 0x01, 48, 90, 0xF7 };
+
+	TEST_CHECK(Get_Frame(Builder, 0) == std::vector<unsigned char>(Expected, Expected + sizeof(Expected)));
+
+	// The other way round the light ends switched off
+	Builder.Add(0x91, 48, 90);
+	Builder.Add(0x81, 48, 0);
+
+	TEST_CHECK(Builder.Finish() == 1);
+
+	std::vector<unsigned char> Frame = Get_Frame(Builder, 0);
+
+	TEST_CHECK(Frame.size() == 10 && Frame[7] == 48 && Frame[8] == 0);
+}
+
+static void Test_Other_Messages_Rejected()
+{
+	Playback_MIDI_Frame_Builder Builder;
+
+	TEST_CHECK(!Builder.Add(0xB0, 7, 100));
+	TEST_CHECK(!Builder.Add(0xC0, 1, 0));
+	TEST_CHECK(Builder.Is_Empty());
+	TEST_CHECK(Builder.Finish() == 0);
+	TEST_CHECK(Builder.Get_Frame_Count() == 0);
+}
+
+// Every light of all 16 channels changes: complete frames of at most MAX_FRAME_BYTES that together carry every light once
+static void Test_Split_Into_Frames()
+{
+	Playback_MIDI_Frame_Builder Builder;
+
+	for (int Channel = 0; Channel < 16; Channel++)
+	{
+		for (int Note = 0; Note < 128; Note++) {
+			Builder.Add((unsigned char)(0x90 | Channel), (unsigned char)Note, (unsigned char)(1 + (Note + Channel) % 127));
+		}
+	}
+
+	size_t Frame_Count = Builder.Finish();
+	TEST_CHECK(Frame_Count > 1);
+
+	bool Seen[16][128] = {};
+	size_t Entry_Count = 0;
+
+	for (size_t i = 0; i < Frame_Count; i++)
+	{
+		std::vector<unsigned char> Frame = Get_Frame(Builder, i);
+
+		TEST_CHECK(Has_Header(Frame));
+		TEST_CHECK_MESSAGE(Frame.size() <= Playback_MIDI_Frame_Builder::MAX_FRAME_BYTES, "frame %zu has %zu bytes", i, Frame.size());
+
+		size_t Position = Playback_MIDI_Frame_Builder::HEADER_BYTES;
+
+		while (Position + 1 < Frame.size())
+		{
+			int Channel = Frame[Position];
+			size_t Count = Frame[Position + 1];
+			Position += 2;
+
+			TEST_CHECK(Channel < 16 && Count >= 1 && Count <= Playback_MIDI_Frame_Builder::MAX_GROUP_NOTES);
+
+			for (size_t n = 0; n < Count && Position + 1 < Frame.size(); n++, Position += 2)
+			{
+				int Note = Frame[Position];
+
+				TEST_CHECK(Frame[Position + 1] == (unsigned char)(1 + (Note + Channel) % 127));
+				TEST_CHECK(!Seen[Channel & 0x0F][Note & 0x7F]);
+
+				Seen[Channel & 0x0F][Note & 0x7F] = true;
+				Entry_Count++;
+			}
+		}
+
+		TEST_CHECK(Position == Frame.size() - 1);
+	}
+
+	TEST_CHECK_MESSAGE(Entry_Count == 16 * 128, "%zu lights in the frames", Entry_Count);
+}
+
+int main()
+{
+	Test_Layout();
+	Test_Off_On_Collapses();
+	Test_Other_Messages_Rejected();
+	Test_Split_Into_Frames();
+
+	return MIDILightDrawer_Tests::Test_Result();
+}
@@ -0,0 +1,244 @@
+#include "Test_Common.h"
+
+#include "Playback_Clock_Virtual.h"
+#include "Playback_MIDI_Link_Shaper.h"
+#include "Playback_MIDI_Output_Recording.h"
+
+#include <vector>
+
+using namespace MIDILightDrawer;
+
+// Queueing of the Playback_MIDI_Link_Shaper on a DIN link, driven by the virtual clock.
+// Every test first fills the link with two controllers of FILL_CHANNEL, so the messages submitted afterwards wait in the shaper
+static const unsigned char FILL_CHANNEL	= 15;
+static const int FILL_MESSAGE_COUNT		= 2;
+static const int64_t DRAIN_DELAY_US		= 20000;
+
+typedef Playback_MIDI_Output_Recording::Recorded_Message Recorded_Message;
+
+struct Test_Link
+{
+	Playback_Clock_Virtual Clock;
+	Playback_MIDI_Output_Recording Output;
+	Playback_MIDI_Link_Shaper Shaper;
+
+	Test_Link() : Output(&Clock)
+	{
+		Shaper.Set_Bytes_Per_Second(Playback_MIDI_Link_Shaper::DIN_BYTES_PER_SECOND);
+
+		for (int i = 0; i < FILL_MESSAGE_COUNT; i++) {
+			Submit(0xB0 | FILL_CHANNEL, 1, (unsigned char)i);
+		}
+	}
+
+	size_t Submit(unsigned char status, unsigned char data1, unsigned char data2)
+	{
+		return Shaper.Submit(status, data1, data2, Clock.Peek_us(), &Output);
+	}
+
+	size_t Drain_Later(int64_t delay_us)
+	{
+		Clock.Advance_us(delay_us);
+
+		return Shaper.Drain(Clock.Peek_us(), &Output);
+	}
+
+	// Drains at the times the shaper asks for until nothing waits. Returns the number of drains that sent something
+	int Drain_Until_Empty()
+	{
+		int Drain_Count = 0;
+
+		while (Shaper.Has_Pending())
+		{
+			int64_t Next_Drain_us = Shaper.Get_Next_Drain_us();
+
+			if (Next_Drain_us > Clock.Peek_us()) {
+				Clock.Advance_us(Next_Drain_us - Clock.Peek_us());
+			}
+
+			Drain_Count += (Shaper.Drain(Clock.Peek_us(), &Output) > 0) ? 1 : 0;
+		}
+
+		return Drain_Count;
+	}
+
+	// The messages sent after the ones filling the link
+	std::vector<Recorded_Message> Get_Sent() const
+	{
+		const std::vector<Recorded_Message>& Messages = Output.Get_Messages();
+
+		return std::vector<Recorded_Message>(Messages.begin() + FILL_MESSAGE_COUNT, Messages.end());
+	}
+};
+
+static bool Is_Message(const Recorded_Message& message, unsigned char status, unsigned char data1, unsigned char data2)
+{
+	return message.Status == status && message.Data1 == data1 && message.Data2 == data2;
+}
+
+static void Test_Link_Fills()
+{
+	Test_Link Link;
+
+	TEST_CHECK(Link.Output.Get_Messages().size() == FILL_MESSAGE_COUNT);
+	TEST_CHECK(Link.Submit(0x90, 60, 100) == 0);
+	TEST_CHECK(Link.Shaper.Has_Pending());
+
+	// Nothing fits before the link has sent the filling messages
+	TEST_CHECK(Link.Shaper.Drain(Link.Clock.Peek_us(), &Link.Output) == 0);
+	TEST_CHECK(Link.Shaper.Get_Next_Drain_us() > Link.Clock.Peek_us());
+
+	TEST_CHECK(Link.Drain_Later(DRAIN_DELAY_US) == 1);
+	TEST_CHECK(!Link.Shaper.Has_Pending());
+}
+
+// A Note On followed by its Note Off before the link had room: the On is never sent, only the Off
+static void Test_On_Off_Cancelled()
+{
+	Test_Link Link;
+
+	Link.Submit(0x90, 60, 100);
+	Link.Submit(0x80, 60, 0);
+
+	TEST_CHECK(Link.Shaper.Get_Statistics().Coalesced_Count == 1);
+	TEST_CHECK(Link.Drain_Later(DRAIN_DELAY_US) == 1);
+
+	std::vector<Recorded_Message> Sent = Link.Get_Sent();
+
+	TEST_CHECK_MESSAGE(Sent.size() == 1, "%zu messages sent", Sent.size());
+	TEST_CHECK(Sent.size() == 1 && Is_Message(Sent[0], 0x80, 60, 0));
+}
+
+// A second Note On of the same note replaces the velocity of the waiting one
+static void Test_Velocity_Replaced()
+{
+	Test_Link Link;
+
+	Link.Submit(0x91, 61, 10);
+	Link.Submit(0x91, 61, 90);
+
+	TEST_CHECK(Link.Shaper.Get_Statistics().Coalesced_Count == 1);
+	TEST_CHECK(Link.Drain_Later(DRAIN_DELAY_US) == 1);
+
+	std::vector<Recorded_Message> Sent = Link.Get_Sent();
+
+	TEST_CHECK(Sent.size() == 1 && Is_Message(Sent[0], 0x91, 61, 90));
+}
+
+// Submitted as Note On, controller, Note Off, drained as Note Off, controller, Note On
+static void Test_Drain_Order()
+{
+	Test_Link Link;
+
+	Link.Submit(0x90, 62, 100);
+	Link.Submit(0xB0, 7, 50);
+	Link.Submit(0x80, 63, 0);
+
+	// Two messages fit into the burst of the link, the third one waits for the next drain
+	TEST_CHECK(Link.Drain_Later(DRAIN_DELAY_US) == 2);
+	TEST_CHECK(Link.Drain_Until_Empty() == 1);
+
+	std::vector<Recorded_Message> Sent = Link.Get_Sent();
+
+	TEST_CHECK_MESSAGE(Sent.size() == 3, "%zu messages sent", Sent.size());
+
+	if (Sent.size() == 3)
+	{
+		TEST_CHECK(Is_Message(Sent[0], 0x80, 63, 0));
+		TEST_CHECK(Is_Message(Sent[1], 0xB0, 7, 50));
+		TEST_CHECK(Is_Message(Sent[2], 0x90, 62, 100));
+	}
+
+	// Paced to the link: the third message leaves once the first two are no further ahead than the burst
+	const int64_t Message_us = 3 * 1000000 / Playback_MIDI_Link_Shaper::DIN_BYTES_PER_SECOND;
+
+	if (Sent.size() == 3) {
+		TEST_CHECK_MESSAGE(Sent[2].Time_us - Sent[0].Time_us >= 2 * Message_us - Playback_MIDI_Link_Shaper::MAX_BURST_US, "sent %lld us apart", (long long)(Sent[2].Time_us - Sent[0].Time_us));
+	}
+}
+
+// All Sound Off, queued or sent right away, drops the waiting notes of its channel and only of its channel
+static void Test_All_Sound_Off_Drops_Channel()
+{
+	Test_Link Queued_Link;
+
+	Queued_Link.Submit(0x90, 64, 100);
+	Queued_Link.Submit(0x91, 65, 100);
+	Queued_Link.Submit(0xB0, 123, 0);
+
+	TEST_CHECK(Queued_Link.Shaper.Get_Statistics().Coalesced_Count == 1);
+	TEST_CHECK(Queued_Link.Drain_Later(DRAIN_DELAY_US) == 2);
+
+	std::vector<Recorded_Message> Sent = Queued_Link.Get_Sent();
+
+	TEST_CHECK(Sent.size() == 2);
+
+	if (Sent.size() == 2)
+	{
+		TEST_CHECK(Is_Message(Sent[0], 0xB0, 123, 0));
+		TEST_CHECK(Is_Message(Sent[1], 0x91, 65, 100));
+	}
+
+	Test_Link Immediate_Link;
+
+	Immediate_Link.Submit(0x90, 64, 100);
+	Immediate_Link.Submit(0x80, 66, 0);
+	Immediate_Link.Submit(0x91, 65, 100);
+
+	TEST_CHECK(Immediate_Link.Shaper.Send_Immediate(0xB0, 123, 0, Immediate_Link.Clock.Peek_us(), &Immediate_Link.Output));
+	TEST_CHECK(Immediate_Link.Shaper.Get_Statistics().Coalesced_Count == 2);
+	TEST_CHECK(Immediate_Link.Drain_Later(DRAIN_DELAY_US) == 1);
+
+	Sent = Immediate_Link.Get_Sent();
+
+	TEST_CHECK(Sent.size() == 2);
+
+	if (Sent.size() == 2)
+	{
+		TEST_CHECK(Is_Message(Sent[0], 0xB0, 123, 0));
+		TEST_CHECK(Is_Message(Sent[1], 0x91, 65, 100));
+	}
+}
+
+static void Test_Late_And_Dropped()
+{
+	Test_Link Link;
+
+	// Sent right away when the link has room again: neither late nor waiting
+	TEST_CHECK(Link.Shaper.Get_Statistics().Late_Count == 0);
+	TEST_CHECK(Link.Shaper.Get_Statistics().Wait_Max_us == 0);
+
+	Link.Submit(0x90, 67, 100);
+	TEST_CHECK(Link.Drain_Later(DRAIN_DELAY_US) == 1);
+
+	Playback_MIDI_Link_Shaper::Statistics Statistics = Link.Shaper.Get_Statistics();
+
+	TEST_CHECK(Statistics.Late_Count == 1);
+	TEST_CHECK_MESSAGE(Statistics.Wait_Max_us == DRAIN_DELAY_US, "waited %lld us", (long long)Statistics.Wait_Max_us);
+	TEST_CHECK(Statistics.Dropped_Count == 0);
+
+	// Controllers beyond the capacity of the queue are dropped, notes never, they replace each other instead
+	Test_Link Full_Link;
+	const int Extra_Count = 3;
+
+	for (size_t i = 0; i < Playback_MIDI_Link_Shaper::OTHER_QUEUE_CAPACITY + Extra_Count; i++) {
+		Full_Link.Submit(0xB0, 1, (unsigned char)(i & 0x7F));
+	}
+
+	TEST_CHECK(Full_Link.Shaper.Get_Statistics().Dropped_Count == Extra_Count);
+
+	Full_Link.Shaper.Reset_Statistics();
+	TEST_CHECK(Full_Link.Shaper.Get_Statistics().Dropped_Count == 0);
+}
+
+int main()
+{
+	Test_Link_Fills();
+	Test_On_Off_Cancelled();
+	Test_Velocity_Replaced();
+	Test_Drain_Order();
+	Test_All_Sound_Off_Drops_Channel();
+	Test_Late_And_Dropped();
+
+	return MIDILightDrawer_Tests::Test_Result();
+}
@@ -0,0 +1,151 @@
+#include "Test_Common.h"
+
+#include "Playback_MIDI_Offline_Render.h"
+#include "Playback_MIDI_Render_Log.h"
+#include "Playback_MIDI_Scheduler.h"
+#include "Playback_Tempo_Map.h"
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace MIDILightDrawer;
+
+// Renders a fixed schedule on the virtual clock and compares the log with the checked-in reference render.
+// A change of what the scheduler sends or when it sends it shows up here as missing, extra or moved events.
+// After an intended change, run the test with --update-reference from the Tests folder and commit the new reference
+static const char* REFERENCE_FILENAME	= "Reference/Offline_Render_Fixed_Schedule.mlrl";
+
+static const int TICKS_PER_QUARTER		= 960;
+static const int TICKS_PER_MEASURE		= 4 * TICKS_PER_QUARTER;
+static const int MEASURE_COUNT			= 16;
+static const int TEMPO_CHANGE_MEASURE	= 8;
+static const int TRACK_COUNT			= 4;
+
+typedef Playback_MIDI_Schedule::MIDI_Event MIDI_Event;
+
+// 120 BPM for the first half, 90 BPM from TEMPO_CHANGE_MEASURE on
+static Playback_Tempo_Map Create_Tempo_Map()
+{
+	Playback_Tempo_Map::Segment Segments[2];
+
+	Segments[0].Start_Tick	= 0;
+	Segments[0].Start_us	= 0.0;
+	Segments[0].Us_Per_Tick	= 500000.0 / TICKS_PER_QUARTER;
+
+	Segments[1].Start_Tick	= (int64_t)TEMPO_CHANGE_MEASURE * TICKS_PER_MEASURE;
+	Segments[1].Start_us	= Segments[1].Start_Tick * Segments[0].Us_Per_Tick;
+	Segments[1].Us_Per_Tick	= 666667.0 / TICKS_PER_QUARTER;
+
+	return Playback_Tempo_Map(Segments, 2);
+}
+
+static void Add_Event(std::vector<MIDI_Event>& events, const Playback_Tempo_Map& tempo_map, int tick, int track, unsigned char command, unsigned char data1, unsigned char data2)
+{
+	MIDI_Event Event = MIDI_Event();
+	Event.Timestamp_ms	= tempo_map.Get_Time_us((double)tick) / 1000.0;
+	Event.Tick			= tick;
+	Event.Track			= track;
+	Event.Channel		= track;
+	Event.Command		= command;
+	Event.Data1			= data1;
+	Event.Data2			= data2;
+
+	events.push_back(Event);
+}
+
+// Per track a color change every sixteenth or eighth note, notes that end where the next one starts, a long note
+// held across the tempo change and a controller per measure. Velocities vary, so each note pair is distinct
+static Playback_MIDI_Schedule* Create_Fixed_Schedule()
+{
+	Playback_Tempo_Map Tempo_Map = Create_Tempo_Map();
+
+	std::vector<MIDI_Event> Events;
+	std::vector<int64_t> Checkpoint_Times_us;
+
+	for (int Measure = 0; Measure < MEASURE_COUNT; Measure++) {
+		Checkpoint_Times_us.push_back(Tempo_Map.Get_Time_us((double)Measure * TICKS_PER_MEASURE));
+	}
+
+	for (int Track = 0; Track < TRACK_COUNT; Track++)
+	{
+		int Step_Ticks = (Track % 2 == 0) ? TICKS_PER_QUARTER / 4 : TICKS_PER_QUARTER / 2;
+		int End_Tick = MEASURE_COUNT * TICKS_PER_MEASURE;
+
+		for (int Tick = 0, Step = 0; Tick < End_Tick; Tick += Step_Ticks, Step++)
+		{
+			unsigned char Note = (unsigned char)(24 + Track * 12 + Step % 3);
+			unsigned char Velocity = (unsigned char)(1 + (Step * 37 + Track * 11) % 127);
+
+			Add_Event(Events, Tempo_Map, Tick, Track, 0x90, Note, Velocity);
+			Add_Event(Events, Tempo_Map, Tick + Step_Ticks, Track, 0x80, Note, 0);
+		}
+
+		int Held_Start_Tick = (TEMPO_CHANGE_MEASURE - 1) * TICKS_PER_MEASURE + Track * TICKS_PER_QUARTER;
+
+		Add_Event(Events, Tempo_Map, Held_Start_Tick, Track, 0x90, 100, (unsigned char)(64 + Track));
+		Add_Event(Events, Tempo_Map, Held_Start_Tick + 2 * TICKS_PER_MEASURE, Track, 0x80, 100, 0);
+
+		for (int Measure = 0; Measure < MEASURE_COUNT; Measure++) {
+			Add_Event(Events, Tempo_Map, Measure * TICKS_PER_MEASURE, Track, 0xB0, 7, (unsigned char)(Measure * 8));
+		}
+	}
+
+	return new Playback_MIDI_Schedule(Events.data(), Events.size(), Checkpoint_Times_us.data(), Checkpoint_Times_us.size(), Tempo_Map);
+}
+
+static bool Records_Equal(const Playback_MIDI_Render_Log::Record& a, const Playback_MIDI_Render_Log::Record& b)
+{
+	return a.Intended_us == b.Intended_us && a.Actual_us == b.Actual_us && a.Track == b.Track && a.Status == b.Status && a.Data1 == b.Data1 && a.Data2 == b.Data2;
+}
+
+int main(int argc, char** argv)
+{
+	Playback_MIDI_Render_Log Log;
+	Playback_MIDI_Offline_Render::Report Report = Playback_MIDI_Offline_Render::Render(Create_Fixed_Schedule(), 0, Log);
+
+	printf("%s", Playback_MIDI_Offline_Render::Format_Report(Report).c_str());
+
+	TEST_CHECK(Report.Success);
+	TEST_CHECK_MESSAGE(Report.Sent_Count == Report.Event_Count, "%zu of %zu events sent", Report.Sent_Count, Report.Event_Count);
+
+	if (argc > 1 && strcmp(argv[1], "--update-reference") == 0)
+	{
+		TEST_CHECK(Log.Save_To_File(REFERENCE_FILENAME));
+		printf("Reference written to %s\n", REFERENCE_FILENAME);
+
+		return MIDILightDrawer_Tests::Test_Result();
+	}
+
+	Playback_MIDI_Render_Log Reference;
+
+	if (!Reference.Load_From_File(REFERENCE_FILENAME))
+	{
+		TEST_CHECK_MESSAGE(false, "cannot load %s", REFERENCE_FILENAME);
+		return MIDILightDrawer_Tests::Test_Result();
+	}
+
+	// Both are renders on the virtual clock, compared as they are and without any tolerance
+	Playback_MIDI_Render_Log::Comparison Comparison = Playback_MIDI_Render_Log::Compare(Log.Get_Records(), Reference.Get_Records(), 0, 0);
+
+	printf("%s", Playback_MIDI_Render_Log::Format_Comparison(Comparison).c_str());
+
+	TEST_CHECK(Comparison.Matched_Count > 0);
+	TEST_CHECK(Comparison.Missing_Count == 0);
+	TEST_CHECK(Comparison.Extra_Count == 0);
+	TEST_CHECK(Comparison.Deviation_Max_us == 0);
+
+	// Compare pairs the notes only, the controllers and the send order are checked record by record
+	TEST_CHECK_MESSAGE(Log.Size() == Reference.Size(), "%zu records rendered, %zu in the reference", Log.Size(), Reference.Size());
+
+	for (size_t i = 0; i < Log.Size() && i < Reference.Size(); i++)
+	{
+		if (!Records_Equal(Log.Get_Records()[i], Reference.Get_Records()[i]))
+		{
+			TEST_CHECK_MESSAGE(false, "record %zu differs from the reference at %lld us", i, (long long)Reference.Get_Records()[i].Intended_us);
+			break;
+		}
+	}
+
+	return MIDILightDrawer_Tests::Test_Result();
+}
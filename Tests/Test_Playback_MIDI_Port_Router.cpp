@@ -0,0 +1,258 @@
+#include "Test_Common.h"
+
+#include "Playback_Clock_Steady.h"
+#include "Playback_MIDI_Output_Recording.h"
+#include "Playback_MIDI_Port_Router.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace MIDILightDrawer;
+
+// Routing of the Playback_MIDI_Port_Router with two recording ports. Every port records through a gate that can hold
+// its port thread inside the output, standing in for an interface that blocks, so the order of the queues can be observed
+static const int PORT_COUNT				= 2;
+static const int64_t WAIT_TIMEOUT_US	= 2000000;
+
+typedef Playback_MIDI_Port_Router::MIDI_Event MIDI_Event;
+
+class Gated_Output : public IMidiOutput
+{
+private:
+	Playback_MIDI_Output_Recording* _Recording;
+	std::mutex _Mutex;
+	std::condition_variable _Opened;
+	bool _Is_Gate_Open;
+
+public:
+	std::atomic<int> Entered_Count;		// Messages the port thread has started to send
+	std::atomic<int> Sent_Count;
+
+	Gated_Output(Playback_MIDI_Output_Recording* recording)
+	{
+		_Recording = recording;
+		_Is_Gate_Open = true;
+
+		Entered_Count.store(0);
+		Sent_Count.store(0);
+	}
+
+	void Set_Gate_Open(bool is_open)
+	{
+		std::lock_guard<std::mutex> Lock(_Mutex);
+		_Is_Gate_Open = is_open;
+
+		_Opened.notify_all();
+	}
+
+	bool Is_Open() override { return true; }
+	void Close() override { }
+
+	bool Send_Short_Message(unsigned char status, unsigned char data1, unsigned char data2) override
+	{
+		Entered_Count.fetch_add(1);
+
+		{
+			std::unique_lock<std::mutex> Lock(_Mutex);
+			_Opened.wait(Lock, [this]() { return _Is_Gate_Open; });
+		}
+
+		bool Success = _Recording->Send_Short_Message(status, data1, data2);
+		Sent_Count.fetch_add(1);
+
+		return Success;
+	}
+
+	bool Send_Long_Message(const unsigned char* data, size_t length) override
+	{
+		return _Recording->Send_Long_Message(data, length);
+	}
+};
+
+struct Test_Ports
+{
+	Playback_Clock_Steady Clocks[PORT_COUNT];
+	Playback_MIDI_Output_Recording* Recordings[PORT_COUNT];
+	Gated_Output* Outputs[PORT_COUNT];
+	Playback_MIDI_Port_Router Router;
+
+	Test_Ports()
+	{
+		for (int i = 0; i < PORT_COUNT; i++)
+		{
+			Recordings[i] = new Playback_MIDI_Output_Recording(&Clocks[i]);
+			Outputs[i] = new Gated_Output(Recordings[i]);
+
+			Router.Add_Port(Outputs[i], &Clocks[i]);
+		}
+	}
+
+	~Test_Ports()
+	{
+		for (int i = 0; i < PORT_COUNT; i++) {
+			Outputs[i]->Set_Gate_Open(true);
+		}
+
+		Router.Stop();
+		Router.Remove_All_Ports();
+
+		for (int i = 0; i < PORT_COUNT; i++)
+		{
+			delete Outputs[i];
+			delete Recordings[i];
+		}
+	}
+};
+
+static MIDI_Event Create_Event(int track, unsigned char command, unsigned char data1, unsigned char data2)
+{
+	MIDI_Event Event = MIDI_Event();
+	Event.Track		= track;
+	Event.Channel	= (track < 0) ? 0 : track;
+	Event.Command	= command;
+	Event.Data1		= data1;
+	Event.Data2		= data2;
+
+	return Event;
+}
+
+static bool Wait_For_Count(const std::atomic<int>& count, int expected)
+{
+	Playback_Clock_Steady Clock;
+	int64_t End_us = Clock.Now_us() + WAIT_TIMEOUT_US;
+
+	while (Clock.Now_us() < End_us)
+	{
+		if (count.load() >= expected) {
+			return true;
+		}
+
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+
+	return false;
+}
+
+static bool Has_Message(const Playback_MIDI_Output_Recording& recording, unsigned char status, unsigned char data1)
+{
+	for (const Playback_MIDI_Output_Recording::Recorded_Message& Message : recording.Get_Messages())
+	{
+		if (Message.Status == status && Message.Data1 == data1) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+// Track 0 on port 0, tracks 1 and 2 on port 1, events without a track on both
+static void Test_Track_Mapping()
+{
+	Test_Ports Ports;
+
+	Ports.Router.Set_Track_Port(1, 1);
+	Ports.Router.Set_Track_Port(2, 1);
+	TEST_CHECK(Ports.Router.Start());
+
+	TEST_CHECK(Ports.Router.Send(Create_Event(0, 0x90, 60, 100)));
+	TEST_CHECK(Ports.Router.Send(Create_Event(1, 0x90, 61, 100)));
+	TEST_CHECK(Ports.Router.Send(Create_Event(2, 0x90, 62, 100)));
+	TEST_CHECK(Ports.Router.Send(Create_Event(-1, 0xB0, 7, 127)));
+
+	// A track mapped to a port that does not exist falls back to port 0
+	Ports.Router.Set_Track_Port(3, 5);
+	TEST_CHECK(Ports.Router.Resolve_Track_Port(3) == 0);
+	TEST_CHECK(Ports.Router.Send(Create_Event(3, 0x90, 63, 100)));
+
+	Ports.Router.Stop();
+
+	const Playback_MIDI_Output_Recording& Port_0 = *Ports.Recordings[0];
+	const Playback_MIDI_Output_Recording& Port_1 = *Ports.Recordings[1];
+
+	TEST_CHECK_MESSAGE(Port_0.Get_Messages().size() == 3, "port 0 received %zu messages", Port_0.Get_Messages().size());
+	TEST_CHECK_MESSAGE(Port_1.Get_Messages().size() == 3, "port 1 received %zu messages", Port_1.Get_Messages().size());
+
+	TEST_CHECK(Has_Message(Port_0, 0x90, 60) && !Has_Message(Port_1, 0x90, 60));
+	TEST_CHECK(Has_Message(Port_1, 0x91, 61) && !Has_Message(Port_0, 0x91, 61));
+	TEST_CHECK(Has_Message(Port_1, 0x92, 62) && !Has_Message(Port_0, 0x92, 62));
+	TEST_CHECK(Has_Message(Port_0, 0x93, 63));
+	TEST_CHECK(Has_Message(Port_0, 0xB0, 7) && Has_Message(Port_1, 0xB0, 7));
+
+	TEST_CHECK(Ports.Router.Get_Sent_Count(0) == 3 && Ports.Router.Get_Sent_Count(1) == 3);
+	TEST_CHECK(Ports.Router.Get_Dropped_Count(0) == 0 && Ports.Router.Get_Dropped_Count(1) == 0);
+}
+
+// While the port thread is held inside the output, scheduled events and an immediate one are queued.
+// After the held message, the immediate one goes out first and the scheduled ones follow in their order
+static void Test_Immediate_Overtakes_Scheduled()
+{
+	Test_Ports Ports;
+	Gated_Output& Output = *Ports.Outputs[0];
+
+	TEST_CHECK(Ports.Router.Start());
+
+	Output.Set_Gate_Open(false);
+	TEST_CHECK(Ports.Router.Send(Create_Event(0, 0x90, 60, 100)));
+	TEST_CHECK(Wait_For_Count(Output.Entered_Count, 1));
+
+	TEST_CHECK(Ports.Router.Send(Create_Event(0, 0x90, 61, 100)));
+	TEST_CHECK(Ports.Router.Send(Create_Event(0, 0x90, 62, 100)));
+	TEST_CHECK(Ports.Router.Send_Immediate(Create_Event(0, 0xB0, 123, 0)));
+
+	Output.Set_Gate_Open(true);
+	TEST_CHECK(Wait_For_Count(Output.Sent_Count, 4));
+
+	Ports.Router.Stop();
+
+	const std::vector<Playback_MIDI_Output_Recording::Recorded_Message>& Messages = Ports.Recordings[0]->Get_Messages();
+	const unsigned char Expected_Data1[] = { 60, 123, 61, 62 };
+
+	TEST_CHECK_MESSAGE(Messages.size() == 4, "%zu messages sent", Messages.size());
+
+	for (size_t i = 0; i < Messages.size() && i < 4; i++) {
+		TEST_CHECK_MESSAGE(Messages[i].Data1 == Expected_Data1[i], "message %zu is %d, expected %d", i, Messages[i].Data1, Expected_Data1[i]);
+	}
+
+	TEST_CHECK(Ports.Recordings[1]->Get_Messages().empty());
+}
+
+// Port 0 is held inside its output, port 1 goes on sending its own messages meanwhile
+static void Test_Blocked_Port_Does_Not_Delay_Others()
+{
+	Test_Ports Ports;
+
+	Ports.Router.Set_Track_Port(1, 1);
+	TEST_CHECK(Ports.Router.Start());
+
+	Ports.Outputs[0]->Set_Gate_Open(false);
+	TEST_CHECK(Ports.Router.Send(Create_Event(0, 0x90, 60, 100)));
+	TEST_CHECK(Wait_For_Count(Ports.Outputs[0]->Entered_Count, 1));
+
+	for (int i = 0; i < 8; i++) {
+		TEST_CHECK(Ports.Router.Send(Create_Event(1, 0x90, (unsigned char)(70 + i), 100)));
+	}
+
+	TEST_CHECK(Wait_For_Count(Ports.Outputs[1]->Sent_Count, 8));
+	TEST_CHECK(Ports.Outputs[0]->Sent_Count.load() == 0);
+
+	Ports.Outputs[0]->Set_Gate_Open(true);
+	TEST_CHECK(Wait_For_Count(Ports.Outputs[0]->Sent_Count, 1));
+
+	Ports.Router.Stop();
+
+	TEST_CHECK(Ports.Recordings[0]->Get_Messages().size() == 1);
+	TEST_CHECK(Ports.Recordings[1]->Get_Messages().size() == 8);
+}
+
+int main()
+{
+	Test_Track_Mapping();
+	Test_Immediate_Overtakes_Scheduled();
+	Test_Blocked_Port_Does_Not_Delay_Others();
+
+	return MIDILightDrawer_Tests::Test_Result();
+}
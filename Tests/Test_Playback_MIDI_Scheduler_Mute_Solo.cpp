@@ -0,0 +1,176 @@
+#include "Test_Common.h"
+
+#include "Playback_Clock_Steady.h"
+#include "Playback_MIDI_Output_Recording.h"
+#include "Playback_MIDI_Scheduler.h"
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace MIDILightDrawer;
+
+// Mute and solo of three timeline tracks through Set_Track_Mute_Solo, the way the event queue manager applies them.
+// Every track holds one note for the whole test, so the sent events tell which tracks sound at any time
+static const int TRACK_COUNT			= 3;
+static const double NOTE_ON_MS			= 20.0;
+static const double NOTE_OFF_MS			= 60000.0;
+static const int64_t WAIT_TIMEOUT_US	= 2000000;
+
+typedef Playback_MIDI_Scheduler::MIDI_Event MIDI_Event;
+
+struct Track_States
+{
+	bool Sounding[TRACK_COUNT];
+};
+
+static Playback_MIDI_Schedule* Create_Held_Notes()
+{
+	std::vector<MIDI_Event> Events;
+
+	for (int Track = 0; Track < TRACK_COUNT; Track++)
+	{
+		MIDI_Event Event = MIDI_Event();
+		Event.Timestamp_ms	= NOTE_ON_MS;
+		Event.Track			= Track;
+		Event.Channel		= Track;
+		Event.Command		= 0x90;
+		Event.Data1			= (unsigned char)(60 + Track);
+		Event.Data2			= 127;
+
+		Events.push_back(Event);
+
+		Event.Timestamp_ms	= NOTE_OFF_MS;
+		Event.Command		= 0x80;
+		Event.Data2			= 0;
+
+		Events.push_back(Event);
+	}
+
+	return new Playback_MIDI_Schedule(Events.data(), Events.size(), nullptr, 0);
+}
+
+static void Read_Sent_Events(Playback_MIDI_Scheduler& scheduler, Track_States& states)
+{
+	MIDI_Event Sent_Event;
+
+	while (scheduler.Pop_Sent_Event(Sent_Event))
+	{
+		if (Sent_Event.Track < 0 || Sent_Event.Track >= TRACK_COUNT) {
+			continue;
+		}
+
+		unsigned char Command = Sent_Event.Command & 0xF0;
+
+		if (Command == 0x90 && Sent_Event.Data2 > 0) {
+			states.Sounding[Sent_Event.Track] = true;
+		}
+		else if (Command == 0x80 || Command == 0x90) {
+			states.Sounding[Sent_Event.Track] = false;
+		}
+	}
+}
+
+// Waits until the sounding tracks match the expected ones, false on timeout
+static bool Wait_For_States(Playback_MIDI_Scheduler& scheduler, IClock& clock, Track_States& states, bool track_0, bool track_1, bool track_2)
+{
+	int64_t End_us = clock.Now_us() + WAIT_TIMEOUT_US;
+
+	while (clock.Now_us() < End_us)
+	{
+		Read_Sent_Events(scheduler, states);
+
+		if (states.Sounding[0] == track_0 && states.Sounding[1] == track_1 && states.Sounding[2] == track_2) {
+			return true;
+		}
+
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+
+	printf("Sounding tracks: %d %d %d, expected %d %d %d\n", states.Sounding[0], states.Sounding[1], states.Sounding[2], track_0, track_1, track_2);
+
+	return false;
+}
+
+static void Test_Should_Track_Play()
+{
+	const int Muted[] = { 0 };
+	const int Soloed[] = { 1 };
+
+	TEST_CHECK(Playback_MIDI_Scheduler::Should_Track_Play(2, nullptr, 0, nullptr, 0));
+	TEST_CHECK(!Playback_MIDI_Scheduler::Should_Track_Play(0, Muted, 1, nullptr, 0));
+	TEST_CHECK(Playback_MIDI_Scheduler::Should_Track_Play(1, Muted, 1, nullptr, 0));
+
+	// A solo silences every track that is not soloed, also the ones in neither list
+	TEST_CHECK(Playback_MIDI_Scheduler::Should_Track_Play(1, nullptr, 0, Soloed, 1));
+	TEST_CHECK(!Playback_MIDI_Scheduler::Should_Track_Play(2, nullptr, 0, Soloed, 1));
+
+	// Mute wins over solo
+	TEST_CHECK(!Playback_MIDI_Scheduler::Should_Track_Play(1, Soloed, 1, Soloed, 1));
+}
+
+static void Test_Solo_During_Playback()
+{
+	Playback_Clock_Steady Clock;
+	Playback_MIDI_Output_Recording Output(&Clock);
+	Playback_MIDI_Scheduler Scheduler(&Output, &Clock);
+
+	const int Track_1[] = { 1 };
+	Track_States States = Track_States();
+
+	Scheduler.Set_Schedule(Create_Held_Notes());
+	Scheduler.Set_Track_Mute_Solo(TRACK_COUNT, nullptr, 0, nullptr, 0);
+	Scheduler.Set_Position_us(0);
+	TEST_CHECK(Scheduler.Start());
+
+	TEST_CHECK(Wait_For_States(Scheduler, Clock, States, true, true, true));
+
+	// Solo one of three tracks, the other two go silent
+	Scheduler.Set_Track_Mute_Solo(TRACK_COUNT, nullptr, 0, Track_1, 1);
+	TEST_CHECK(Wait_For_States(Scheduler, Clock, States, false, true, false));
+	TEST_CHECK(!Scheduler.Is_Track_Enabled(0) && Scheduler.Is_Track_Enabled(1) && !Scheduler.Is_Track_Enabled(2));
+
+	// Clearing the last solo brings them back
+	Scheduler.Set_Track_Mute_Solo(TRACK_COUNT, nullptr, 0, nullptr, 0);
+	TEST_CHECK(Wait_For_States(Scheduler, Clock, States, true, true, true));
+
+	// The soloed track muted as well: nothing plays
+	Scheduler.Set_Track_Mute_Solo(TRACK_COUNT, Track_1, 1, Track_1, 1);
+	TEST_CHECK(Wait_For_States(Scheduler, Clock, States, false, false, false));
+
+	TEST_CHECK(Scheduler.Stop());
+}
+
+// Set while stopped, the next start plays the soloed track only
+static void Test_Solo_While_Stopped()
+{
+	Playback_Clock_Steady Clock;
+	Playback_MIDI_Output_Recording Output(&Clock);
+	Playback_MIDI_Scheduler Scheduler(&Output, &Clock);
+
+	const int Track_2[] = { 2 };
+	Track_States States = Track_States();
+
+	Scheduler.Set_Schedule(Create_Held_Notes());
+	Scheduler.Set_Track_Mute_Solo(TRACK_COUNT, nullptr, 0, Track_2, 1);
+	Scheduler.Set_Position_us(0);
+	TEST_CHECK(Scheduler.Start());
+
+	TEST_CHECK(Wait_For_States(Scheduler, Clock, States, false, false, true));
+
+	// Give the other tracks time to show up if they were not filtered
+	std::this_thread::sleep_for(std::chrono::milliseconds(50));
+	Read_Sent_Events(Scheduler, States);
+
+	TEST_CHECK(!States.Sounding[0] && !States.Sounding[1] && States.Sounding[2]);
+	TEST_CHECK(Scheduler.Stop());
+}
+
+int main()
+{
+	Test_Should_Track_Play();
+	Test_Solo_During_Playback();
+	Test_Solo_While_Stopped();
+
+	return MIDILightDrawer_Tests::Test_Result();
+}
@@ -0,0 +1,233 @@
+#include "Test_Common.h"
+
+#include "Playback_Clock_Steady.h"
+#include "Playback_MIDI_Output_Recording.h"
+#include "Playback_MIDI_Scheduler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace MIDILightDrawer;
+
+// Swaps and unloads schedules while the playback thread runs. The notes are held far beyond the end of every test,
+// so each Note Off in the recording was sent by the scheduler to switch off a note of a replaced or unloaded schedule
+static const int NOTE_COUNT				= 8;
+static const double NOTE_ON_MS			= 20.0;
+static const double NOTE_OFF_MS			= 60000.0;
+static const int64_t WAIT_TIMEOUT_US	= 2000000;
+static const int SWAP_BURST_COUNT		= 50;
+
+typedef Playback_MIDI_Scheduler::MIDI_Event MIDI_Event;
+
+static Playback_MIDI_Schedule* Create_Held_Notes(int first_note)
+{
+	std::vector<MIDI_Event> Events;
+
+	for (int i = 0; i < NOTE_COUNT; i++)
+	{
+		MIDI_Event Event = MIDI_Event();
+		Event.Timestamp_ms	= NOTE_ON_MS;
+		Event.Command		= 0x90;
+		Event.Data1			= (unsigned char)(first_note + i);
+		Event.Data2			= 127;
+
+		Events.push_back(Event);
+
+		Event.Timestamp_ms	= NOTE_OFF_MS;
+		Event.Command		= 0x80;
+		Event.Data2			= 0;
+
+		Events.push_back(Event);
+	}
+
+	return new Playback_MIDI_Schedule(Events.data(), Events.size(), nullptr, 0);
+}
+
+// Pops sent events until the given number of Note Ons with a note of [first_note, first_note + NOTE_COUNT) has been sent
+static bool Wait_For_Note_Ons(Playback_MIDI_Scheduler& scheduler, IClock& clock, int first_note, int count)
+{
+	int64_t End_us = clock.Now_us() + WAIT_TIMEOUT_US;
+	int Note_On_Count = 0;
+
+	while (clock.Now_us() < End_us)
+	{
+		MIDI_Event Sent_Event;
+
+		while (scheduler.Pop_Sent_Event(Sent_Event))
+		{
+			if (Sent_Event.Command == 0x90 && Sent_Event.Data2 > 0 && Sent_Event.Data1 >= first_note && Sent_Event.Data1 < first_note + NOTE_COUNT) {
+				Note_On_Count++;
+			}
+		}
+
+		if (Note_On_Count >= count) {
+			return true;
+		}
+
+		scheduler.Free_Retired_Schedules();
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+
+	return false;
+}
+
+static void Drain_For_ms(Playback_MIDI_Scheduler& scheduler, int duration_ms)
+{
+	for (int i = 0; i < duration_ms; i++)
+	{
+		MIDI_Event Sent_Event;
+
+		while (scheduler.Pop_Sent_Event(Sent_Event)) {
+		}
+
+		scheduler.Free_Retired_Schedules();
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+}
+
+// Messages in the order of their delivery time, the recording keeps them in the order they were handed over
+static std::vector<Playback_MIDI_Output_Recording::Recorded_Message> Get_Delivered(const Playback_MIDI_Output_Recording& output)
+{
+	std::vector<Playback_MIDI_Output_Recording::Recorded_Message> Messages = output.Get_Messages();
+
+	std::stable_sort(Messages.begin(), Messages.end(),
+		[](const Playback_MIDI_Output_Recording::Recorded_Message& a, const Playback_MIDI_Output_Recording::Recorded_Message& b) { return a.Time_us < b.Time_us; });
+
+	return Messages;
+}
+
+static int Count_Sounding_Notes(const Playback_MIDI_Output_Recording& output, int first_note)
+{
+	bool Sounding[128] = {};
+
+	for (const Playback_MIDI_Output_Recording::Recorded_Message& Message : Get_Delivered(output))
+	{
+		if ((Message.Status & 0xF0) == 0x90 && Message.Data2 > 0) {
+			Sounding[Message.Data1 & 0x7F] = true;
+		}
+		else if ((Message.Status & 0xF0) == 0x80 || (Message.Status & 0xF0) == 0x90) {
+			Sounding[Message.Data1 & 0x7F] = false;
+		}
+	}
+
+	int Count = 0;
+
+	for (int i = first_note; i < first_note + NOTE_COUNT; i++) {
+		Count += Sounding[i] ? 1 : 0;
+	}
+
+	return Count;
+}
+
+static int Count_Note_Ons(const Playback_MIDI_Output_Recording& output, int first_note)
+{
+	int Count = 0;
+
+	for (const Playback_MIDI_Output_Recording::Recorded_Message& Message : output.Get_Messages())
+	{
+		if ((Message.Status & 0xF0) == 0x90 && Message.Data2 > 0 && Message.Data1 >= first_note && Message.Data1 < first_note + NOTE_COUNT) {
+			Count++;
+		}
+	}
+
+	return Count;
+}
+
+// Set_Schedule(nullptr) while running switches off what the schedule has sent and plays nothing of it afterwards
+static void Test_Unload_While_Running(int64_t timestamp_lead_us)
+{
+	Playback_Clock_Steady Clock;
+	Playback_MIDI_Output_Recording Output(&Clock);
+	Playback_MIDI_Scheduler Scheduler(&Output, &Clock);
+
+	Output.Set_Timestamp_Lead_us(timestamp_lead_us);
+	Scheduler.Set_Schedule(Create_Held_Notes(60));
+	Scheduler.Set_Position_us(0);
+	TEST_CHECK(Scheduler.Start());
+
+	TEST_CHECK(Wait_For_Note_Ons(Scheduler, Clock, 60, NOTE_COUNT));
+	Drain_For_ms(Scheduler, 10 + (int)(timestamp_lead_us / 1000));
+
+	Scheduler.Set_Schedule(nullptr);
+	Drain_For_ms(Scheduler, 50);
+
+	TEST_CHECK(Scheduler.Stop());
+
+	int Sounding_Count = Count_Sounding_Notes(Output, 60);
+	TEST_CHECK_MESSAGE(Sounding_Count == 0, "lead %lld us: %d notes still sounding after the unload", (long long)timestamp_lead_us, Sounding_Count);
+	TEST_CHECK(Count_Note_Ons(Output, 60) == NOTE_COUNT);
+}
+
+// Unload and load in quick succession: the order of the calls decides, whatever the thread has picked up in between
+static void Test_Unload_And_Load()
+{
+	Playback_Clock_Steady Clock;
+	Playback_MIDI_Output_Recording Output(&Clock);
+	Playback_MIDI_Scheduler Scheduler(&Output, &Clock);
+
+	Scheduler.Set_Schedule(Create_Held_Notes(60));
+	Scheduler.Set_Position_us(0);
+	TEST_CHECK(Scheduler.Start());
+	TEST_CHECK(Wait_For_Note_Ons(Scheduler, Clock, 60, NOTE_COUNT));
+
+	// Unload followed by a load plays the loaded schedule
+	Scheduler.Set_Schedule(nullptr);
+	Scheduler.Set_Schedule(Create_Held_Notes(80));
+	TEST_CHECK(Wait_For_Note_Ons(Scheduler, Clock, 80, NOTE_COUNT));
+
+	// Load followed by an unload ends with nothing loaded
+	Scheduler.Set_Schedule(Create_Held_Notes(100));
+	Scheduler.Set_Schedule(nullptr);
+	Drain_For_ms(Scheduler, 50);
+
+	TEST_CHECK(Scheduler.Stop());
+
+	TEST_CHECK(Count_Sounding_Notes(Output, 60) == 0);
+	TEST_CHECK(Count_Sounding_Notes(Output, 80) == 0);
+	TEST_CHECK(Count_Sounding_Notes(Output, 100) == 0);
+}
+
+// Many schedules published faster than the thread picks them up, the retired ones collected alongside.
+// The last one published is the one that plays, none of the replaced notes keeps sounding
+static void Test_Swap_Burst()
+{
+	Playback_Clock_Steady Clock;
+	Playback_MIDI_Output_Recording Output(&Clock);
+	Playback_MIDI_Scheduler Scheduler(&Output, &Clock);
+
+	Scheduler.Set_Schedule(Create_Held_Notes(20));
+	Scheduler.Set_Position_us(0);
+	TEST_CHECK(Scheduler.Start());
+	TEST_CHECK(Wait_For_Note_Ons(Scheduler, Clock, 20, NOTE_COUNT));
+
+	for (int i = 0; i < SWAP_BURST_COUNT; i++)
+	{
+		Scheduler.Set_Schedule(Create_Held_Notes((i % 2 == 0) ? 40 : 20));
+
+		if (i % 5 == 0) {
+			std::this_thread::sleep_for(std::chrono::microseconds(200));
+		}
+	}
+
+	Scheduler.Set_Schedule(Create_Held_Notes(100));
+	TEST_CHECK(Wait_For_Note_Ons(Scheduler, Clock, 100, NOTE_COUNT));
+	Drain_For_ms(Scheduler, 20);
+
+	TEST_CHECK(Scheduler.Stop());
+
+	TEST_CHECK(Count_Sounding_Notes(Output, 20) == 0);
+	TEST_CHECK(Count_Sounding_Notes(Output, 40) == 0);
+	TEST_CHECK(Count_Sounding_Notes(Output, 100) == NOTE_COUNT);
+}
+
+int main()
+{
+	Test_Unload_While_Running(0);
+	Test_Unload_While_Running(50000);
+	Test_Unload_And_Load();
+	Test_Swap_Burst();
+
+	return MIDILightDrawer_Tests::Test_Result();
+}
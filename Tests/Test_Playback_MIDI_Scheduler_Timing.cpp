@@ -0,0 +1,110 @@
+#include "Test_Common.h"
+
+#include "Playback_Clock_Steady.h"
+#include "Playback_MIDI_Output_Recording.h"
+#include "Playback_MIDI_Scheduler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace MIDILightDrawer;
+
+// Plays a strobe on the steady clock into the recording output and checks when every message left the scheduler.
+// The origin is taken right after Start, so all latencies share an offset of the thread start-up. The jitter around
+// the median is checked tighter than the median itself. The percentiles leave room for the odd preemption on
+// a loaded CI machine, a scheduler that polls or oversleeps by a millisecond still fails them
+static const int EVENT_COUNT			= 400;
+static const double FIRST_EVENT_MS		= 20.0;
+static const double INTERVAL_MS			= 5.0;
+static const int64_t MAX_EARLY_US		= 1000;
+static const int64_t MAX_MEDIAN_US		= 2000;
+static const int64_t MAX_JITTER_P95_US	= 500;
+
+int main()
+{
+	Playback_Clock_Steady Clock;
+	Playback_MIDI_Output_Recording Output(&Clock);
+	Playback_MIDI_Scheduler Scheduler(&Output, &Clock);
+
+	std::vector<Playback_MIDI_Scheduler::MIDI_Event> Events;
+
+	for (int i = 0; i < EVENT_COUNT; i++)
+	{
+		Playback_MIDI_Scheduler::MIDI_Event Event = Playback_MIDI_Scheduler::MIDI_Event();
+		Event.Timestamp_ms	= FIRST_EVENT_MS + i * INTERVAL_MS;
+		Event.Track			= 0;
+		Event.Channel		= 0;
+		Event.Command		= (i % 2 == 0) ? 0x90 : 0x80;
+		Event.Data1			= (unsigned char)(60 + i % 12);
+		Event.Data2			= (i % 2 == 0) ? 127 : 0;
+
+		Events.push_back(Event);
+		TEST_CHECK(Scheduler.Queue_Event(Event));
+	}
+
+	Scheduler.Set_Position_us(0);
+	TEST_CHECK(Scheduler.Start());
+
+	int64_t Origin_us = Clock.Now_us();
+	int64_t End_us = Origin_us + (int64_t)((Events.back().Timestamp_ms + 1000.0) * 1000.0);
+
+	size_t Sent_Count = 0;
+
+	while (Sent_Count < Events.size() && Clock.Now_us() < End_us)
+	{
+		Playback_MIDI_Scheduler::MIDI_Event Sent_Event;
+
+		while (Scheduler.Pop_Sent_Event(Sent_Event)) {
+			Sent_Count++;
+		}
+
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+
+	TEST_CHECK(Scheduler.Stop());
+
+	const std::vector<Playback_MIDI_Output_Recording::Recorded_Message>& Messages = Output.Get_Messages();
+	TEST_CHECK_MESSAGE(Messages.size() == Events.size(), "%zu of %zu messages sent", Messages.size(), Events.size());
+
+	std::vector<int64_t> Latencies;
+
+	for (size_t i = 0; i < Messages.size() && i < Events.size(); i++)
+	{
+		TEST_CHECK(Messages[i].Status == (Events[i].Command | Events[i].Channel));
+		TEST_CHECK(Messages[i].Data1 == Events[i].Data1);
+		TEST_CHECK(Messages[i].Data2 == Events[i].Data2);
+
+		int64_t Due_us = Origin_us + (int64_t)(Events[i].Timestamp_ms * 1000.0) - Playback_MIDI_Scheduler::LOOKAHEAD_US;
+		int64_t Latency_us = Messages[i].Time_us - Due_us;
+
+		TEST_CHECK_MESSAGE(Latency_us >= -MAX_EARLY_US, "event %zu sent %lld us early", i, (long long)-Latency_us);
+		Latencies.push_back(Latency_us);
+	}
+
+	if (!Latencies.empty())
+	{
+		std::sort(Latencies.begin(), Latencies.end());
+
+		int64_t Median_us = Latencies[(Latencies.size() - 1) / 2];
+
+		std::vector<int64_t> Jitter;
+
+		for (int64_t Latency_us : Latencies) {
+			Jitter.push_back((Latency_us > Median_us) ? Latency_us - Median_us : Median_us - Latency_us);
+		}
+
+		std::sort(Jitter.begin(), Jitter.end());
+
+		int64_t Jitter_P95_us = Jitter[(Jitter.size() - 1) * 95 / 100];
+
+		printf("Latency (us): min %lld, median %lld, max %lld, jitter p95 %lld\n",
+			(long long)Latencies.front(), (long long)Median_us, (long long)Latencies.back(), (long long)Jitter_P95_us);
+
+		TEST_CHECK_MESSAGE(Median_us <= MAX_MEDIAN_US, "median latency %lld us", (long long)Median_us);
+		TEST_CHECK_MESSAGE(Jitter_P95_us <= MAX_JITTER_P95_US, "p95 jitter %lld us", (long long)Jitter_P95_us);
+	}
+
+	return MIDILightDrawer_Tests::Test_Result();
+}